@@ -0,0 +1,469 @@
+/**
+ * Stellar Data Recovery Pro Free - Benchmarks
+ *
+ * Throughput of the recovery hot paths on synthetic disks: signature
+ * scanning (also past an injected bad sector), NTFS/FAT32/ext4 parsing,
+ * result sorting and file recovery.
+ * Rates are reported per second of wall time so runs on different image
+ * sizes and machines compare directly. Images are kept in the disk
+ * directory; the first run at a size includes writing them, later runs
+ * reuse them. Repeated iterations are served from the page cache, so the
+ * figures measure the code, not the device.
+ *
+ * Options, given before any Google Benchmark option:
+ *   --disk-dir=DIR          Where images are kept (default: <temp>/stellar-bench)
+ *   --disk-sizes=LIST       Image sizes in GiB, e.g. 1,10,100 (default 1)
+ *   --fill=X                Share of each volume holding deleted files (default 0.5)
+ *   --fragmentation=X       Share of files split into fragments (default 0.1)
+ *   --mix=LIST              Type weights, e.g. photo:4,video:1 (default: all equal)
+ *   --seed=N                Layout and content seed (default 1)
+ *   --recover-limit=GIB     File data recovered per RecoverFiles run (default 1)
+ *   --sort-rows=N           Rows in the sorting benchmarks (default 1000000)
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "synthetic_disk.h"
+#include "dedup_index.h"
+#include "disk_imager.h"
+#include "filesystem_scanner.h"
+#include "image_source.h"
+#include "recovery_pipeline.h"
+#include "result_store.h"
+#include "scan_scheduler.h"
+#include "signature_carver.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Stellar::Recovery;
+
+namespace {
+
+    struct BenchmarkConfig {
+        std::string diskDirectory;
+        std::vector<uint64_t> sizes;            // GiB
+        SyntheticDiskOptions disk;              // Template; size and file system set per image
+        uint64_t recoverLimit = 1 * GiB;
+        size_t sortRows = 1000000;
+    };
+
+    BenchmarkConfig config;
+    std::map<std::string, SyntheticDisk> disks;
+
+    constexpr size_t KERNEL_BUFFER_SIZE = 256 * MiB;
+
+    const char* KernelName(CarverKernel kernel) {
+        switch (kernel) {
+            case CarverKernel::SCALAR: return "scalar";
+            case CarverKernel::SSSE3: return "ssse3";
+            case CarverKernel::AVX2: return "avx2";
+            case CarverKernel::AVX512: return "avx512";
+        }
+        return "unknown";
+    }
+
+    // Image of the given file system and size, written on first use
+    const SyntheticDisk& Disk(SyntheticFileSystem fileSystem, uint64_t sizeGiB) {
+        SyntheticDiskOptions options = config.disk;
+        options.fileSystem = fileSystem;
+        options.size = sizeGiB * GiB;
+        const std::string name = SyntheticDiskName(options);
+        auto found = disks.find(name);
+        if (found == disks.end()) {
+            found = disks.emplace(name, CreateSyntheticDisk(config.diskDirectory, options)).first;
+        }
+        return found->second;
+    }
+
+    // Files a scan of the disk reports, as RecoverFiles hands them to the pipeline
+    std::vector<RecoveryItem> ScanItems(SectorSource& source, uint64_t limit) {
+        std::vector<RecoveryItem> items;
+        std::unique_ptr<FileSystemScanner> scanner = CreateFileSystemScanner(source);
+        if (!scanner) {
+            return items;
+        }
+        uint64_t total = 0;
+        for (const auto& file : scanner->ScanDeleted()) {
+            if (total >= limit) {
+                break;
+            }
+            RecoveryItem item;
+            item.fileName = std::string(file.fileName);
+            item.fileSize = file.fileSize;
+            item.extents.assign(file.extents.begin(), file.extents.end());
+            item.inlineData.assign(file.inlineData.begin(), file.inlineData.end());
+            item.tag = items.size();
+            total += file.fileSize;
+            items.push_back(std::move(item));
+        }
+        return items;
+    }
+
+    void SignatureScan(benchmark::State& state, uint64_t sizeGiB, size_t workers) {
+        const SyntheticDisk& disk = Disk(SyntheticFileSystem::RAW, sizeGiB);
+        std::unique_ptr<SectorSource> source = OpenSectorSource(disk.path);
+        SignatureCarver carver(TargetFileType::ALL_DATA);
+        ParallelScanOptions options;
+        options.workers = workers;
+
+        size_t hits = 0;
+        for (auto _ : state) {
+            ParallelScanner scanner(*source, carver, options);
+            std::vector<CarveHit> found = scanner.Run();
+            hits = found.size();
+            benchmark::DoNotOptimize(found.data());
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source->Size()));
+        state.counters["hits"] = static_cast<double>(hits);
+        state.counters["files"] = static_cast<double>(disk.files.size());
+        state.SetLabel(KernelName(carver.Kernel()));
+    }
+
+    /**
+     * Deep scan of a disk with one unreadable sector in the middle, the
+     * way a failing drive presents. The scan must finish and lose only
+     * the hits inside the zero filled sector.
+     */
+    void SignatureScanBadSector(benchmark::State& state, uint64_t sizeGiB) {
+        const SyntheticDisk& disk = Disk(SyntheticFileSystem::RAW, sizeGiB);
+        std::unique_ptr<SectorSource> source = OpenSectorSource(disk.path);
+        SignatureCarver carver(TargetFileType::ALL_DATA);
+        ParallelScanOptions options;
+        options.workers = 4;
+        options.extentSize = 4 * MiB;
+        const size_t cleanHits = ParallelScanner(*source, carver, options).Run().size();
+
+        FaultInjectingSource faulty(*source);
+        const uint64_t badSector = source->Size() / 2 / source->SectorSize() * source->SectorSize();
+        faulty.AddFault(badSector, source->SectorSize());
+
+        size_t hits = 0;
+        for (auto _ : state) {
+            try {
+                ParallelScanner scanner(faulty, carver, options);
+                std::vector<CarveHit> found = scanner.Run();
+                hits = found.size();
+                benchmark::DoNotOptimize(found.data());
+            } catch (const SectorReadError& e) {
+                state.SkipWithError(e.what());
+                break;
+            }
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source->Size()));
+        state.counters["hits"] = static_cast<double>(hits);
+        state.counters["hits_lost"] = static_cast<double>(cleanHits) - static_cast<double>(hits);
+        state.counters["read_errors"] = benchmark::Counter(static_cast<double>(faulty.FailedReads()),
+                                                           benchmark::Counter::kAvgIterations);
+        state.SetLabel(KernelName(carver.Kernel()));
+    }
+
+    void CarverKernelScan(benchmark::State& state, bool matchFooters) {
+        const SyntheticDisk& disk = Disk(SyntheticFileSystem::RAW, config.sizes.front());
+        std::unique_ptr<SectorSource> source = OpenSectorSource(disk.path);
+        std::vector<uint8_t> buffer(static_cast<size_t>(std::min<uint64_t>(KERNEL_BUFFER_SIZE, source->Size())));
+        buffer.resize(source->ReadAt(0, buffer.data(), buffer.size()));
+
+        CarverOptions options;
+        options.matchFooters = matchFooters;
+        SignatureCarver carver(TargetFileType::ALL_DATA, options);
+        std::vector<CarveHit> hits;
+        for (auto _ : state) {
+            hits.clear();
+            carver.Scan(buffer.data(), buffer.size(), 0, hits);
+            benchmark::DoNotOptimize(hits.data());
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+        state.counters["hits"] = static_cast<double>(hits.size());
+        state.SetLabel(KernelName(carver.Kernel()));
+    }
+
+    void FileSystemParse(benchmark::State& state, SyntheticFileSystem fileSystem, uint64_t sizeGiB) {
+        const SyntheticDisk& disk = Disk(fileSystem, sizeGiB);
+        std::unique_ptr<SectorSource> source = OpenSectorSource(disk.path);
+
+        uint64_t metadataBytes = 0;
+        size_t found = 0;
+        for (auto _ : state) {
+            std::unique_ptr<FileSystemScanner> scanner = CreateFileSystemScanner(*source);
+            if (!scanner) {
+                state.SkipWithError("file system not recognized");
+                break;
+            }
+            std::vector<RecoverableFile> files = scanner->ScanDeleted();
+            metadataBytes += scanner->BytesRead();
+            found = files.size();
+            benchmark::DoNotOptimize(files.data());
+        }
+        if (found != disk.files.size() && !state.error_occurred()) {
+            state.SkipWithError(("parsed " + std::to_string(found) + " of " +
+                                 std::to_string(disk.files.size()) + " files").c_str());
+        }
+        // Metadata actually read, and the volume it describes
+        state.SetBytesProcessed(static_cast<int64_t>(metadataBytes));
+        state.counters["volume_rate"] = benchmark::Counter(static_cast<double>(source->Size()),
+                                                           benchmark::Counter::kIsIterationInvariantRate,
+                                                           benchmark::Counter::kIs1024);
+        state.counters["files"] = static_cast<double>(found);
+    }
+
+    // Result store shaped like a deep scan: mostly carved rows, names in a few directories
+    const ResultStore& SortStore() {
+        static ResultStore store;
+        if (store.Empty()) {
+            uint64_t random = 0x853C49E6748FEA9Bull;
+            auto next = [&random]() {
+                random ^= random >> 12;
+                random ^= random << 25;
+                random ^= random >> 27;
+                return random * 0x2545F4914F6CDD1Dull;
+            };
+            store.Reserve(config.sortRows, config.sortRows * 16);
+            for (size_t row = 0; row < config.sortRows; row++) {
+                const FileSignature& signature = FILE_SIGNATURES[next() % FILE_SIGNATURE_COUNT];
+                std::ostringstream name;
+                name << "file" << next() % 10000000 << signature.extension;
+                const std::string fileName = name.str();
+                const std::string path = "\\Recovered\\" + std::to_string(next() % 64) + "\\" + fileName;
+
+                ResultRecord record;
+                record.fileName = fileName;
+                record.originalPath = path;
+                record.fileType = signature.type;
+                record.sourceOffset = (next() % (100 * GiB)) & ~uint64_t(511);
+                record.fileSize = next() % (64 * MiB);
+                record.dateModified = std::chrono::system_clock::time_point(std::chrono::seconds(next() % 1800000000));
+                record.confidence = static_cast<double>(next() % 1000) / 1000.0;
+                store.Add(record);
+            }
+        }
+        return store;
+    }
+
+    void ResultSort(benchmark::State& state, ResultSortKey key) {
+        const ResultStore& store = SortStore();
+        const ResultSelection all = store.All();
+        for (auto _ : state) {
+            ResultSelection rows = all;
+            store.Sort(rows, key, true);
+            benchmark::DoNotOptimize(rows.data());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * all.size()));
+    }
+
+    void CarveHitSort(benchmark::State& state) {
+        uint64_t random = 0x9E3779B97F4A7C15ull;
+        std::vector<CarveHit> unsorted(config.sortRows);
+        for (auto& hit : unsorted) {
+            random ^= random >> 12;
+            random ^= random << 25;
+            random ^= random >> 27;
+            hit = CarveHit(((random * 0x2545F4914F6CDD1Dull) % (100 * GiB)) & ~uint64_t(511),
+                           &FILE_SIGNATURES[random % FILE_SIGNATURE_COUNT]);
+        }
+        for (auto _ : state) {
+            std::vector<CarveHit> hits = unsorted;
+            SortCarveHits(hits);
+            benchmark::DoNotOptimize(hits.data());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * unsorted.size()));
+    }
+
+    /**
+     * The recovery half of RecoverFiles: duplicate detection, then the
+     * pipeline with the options the application uses
+     */
+    void RecoverFiles(benchmark::State& state, SyntheticFileSystem fileSystem, uint64_t sizeGiB) {
+        const SyntheticDisk& disk = Disk(fileSystem, sizeGiB);
+        std::unique_ptr<SectorSource> source = OpenSectorSource(disk.path);
+        const std::vector<RecoveryItem> items = ScanItems(*source, config.recoverLimit);
+        if (items.empty()) {
+            state.SkipWithError("no files to recover");
+            return;
+        }
+
+        const std::filesystem::path work = std::filesystem::u8path(config.diskDirectory) /
+                                           ("recover-" + std::string(SyntheticFileSystemName(fileSystem)));
+        const std::filesystem::path output = work / "output";
+        const std::string indexPath = (work / "dedup.idx").u8string();
+
+        RecoveryPipelineOptions options;
+        options.elevatorReads = source->IncursSeekPenalty();
+        options.directCopy = true;
+        options.checksum = HashAlgorithm::SHA256;
+
+        uint64_t written = 0;
+        uint64_t files = 0;
+        uint64_t skipped = 0;
+        for (auto _ : state) {
+            state.PauseTiming();
+            std::filesystem::remove_all(work);
+            std::filesystem::create_directories(work);
+            state.ResumeTiming();
+
+            DedupIndex index(indexPath);
+            DuplicateFinder finder(*source, index);
+            const std::vector<DuplicateMatch> matches = finder.Find(items);
+
+            RecoveryPipeline pipeline(*source, options);
+            for (size_t i = 0; i < items.size(); i++) {
+                if (!matches[i].IsDuplicate()) {
+                    pipeline.Add(items[i]);
+                }
+            }
+            RecoveryPipelineStats stats = pipeline.Run(output.u8string());
+            written += stats.bytesWritten;
+            files += stats.completed + stats.partial;
+            skipped += stats.skipped + stats.failed;
+        }
+        std::filesystem::remove_all(work);
+
+        state.SetBytesProcessed(static_cast<int64_t>(written));
+        state.counters["files"] = benchmark::Counter(static_cast<double>(files), benchmark::Counter::kIsRate);
+        state.counters["skipped"] = benchmark::Counter(static_cast<double>(skipped), benchmark::Counter::kAvgIterations);
+    }
+
+    std::string SizeName(uint64_t sizeGiB) {
+        return std::to_string(sizeGiB) + "GiB";
+    }
+
+    void RegisterBenchmarks() {
+        const SyntheticFileSystem fileSystems[] = {
+            SyntheticFileSystem::NTFS, SyntheticFileSystem::FAT32, SyntheticFileSystem::EXT4
+        };
+
+        benchmark::RegisterBenchmark("CarverKernel/headers", CarverKernelScan, false)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("CarverKernel/footers", CarverKernelScan, true)->Unit(benchmark::kMillisecond);
+        for (uint64_t size : config.sizes) {
+            const std::string prefix = "SignatureScan/raw/" + SizeName(size);
+            benchmark::RegisterBenchmark((prefix + "/threads:1").c_str(), SignatureScan, size, size_t(1))
+                ->Unit(benchmark::kMillisecond)->UseRealTime();
+            benchmark::RegisterBenchmark((prefix + "/threads:all").c_str(), SignatureScan, size, size_t(0))
+                ->Unit(benchmark::kMillisecond)->UseRealTime();
+            benchmark::RegisterBenchmark((prefix + "/bad_sector").c_str(), SignatureScanBadSector, size)
+                ->Unit(benchmark::kMillisecond)->UseRealTime();
+        }
+        for (uint64_t size : config.sizes) {
+            for (SyntheticFileSystem fileSystem : fileSystems) {
+                const std::string name = std::string("FileSystemParse/") + SyntheticFileSystemName(fileSystem) +
+                                         "/" + SizeName(size);
+                benchmark::RegisterBenchmark(name.c_str(), FileSystemParse, fileSystem, size)
+                    ->Unit(benchmark::kMillisecond)->UseRealTime();
+            }
+        }
+
+        const std::pair<const char*, ResultSortKey> keys[] = {
+            {"offset", ResultSortKey::OFFSET}, {"size", ResultSortKey::SIZE}, {"name", ResultSortKey::NAME},
+            {"type", ResultSortKey::TYPE}, {"confidence", ResultSortKey::CONFIDENCE},
+            {"modified", ResultSortKey::MODIFIED}
+        };
+        for (const auto& key : keys) {
+            benchmark::RegisterBenchmark((std::string("ResultSort/") + key.first).c_str(), ResultSort, key.second)
+                ->Unit(benchmark::kMillisecond);
+        }
+        benchmark::RegisterBenchmark("ResultSort/carve_hits", CarveHitSort)->Unit(benchmark::kMillisecond);
+
+        for (uint64_t size : config.sizes) {
+            for (SyntheticFileSystem fileSystem : fileSystems) {
+                const std::string name = std::string("RecoverFiles/") + SyntheticFileSystemName(fileSystem) +
+                                         "/" + SizeName(size);
+                benchmark::RegisterBenchmark(name.c_str(), RecoverFiles, fileSystem, size)
+                    ->Unit(benchmark::kMillisecond)->UseRealTime();
+            }
+        }
+    }
+
+    bool ParseNumberList(const std::string& text, std::vector<uint64_t>& values) {
+        values.clear();
+        std::istringstream in(text);
+        std::string item;
+        while (std::getline(in, item, ',')) {
+            try {
+                size_t used = 0;
+                unsigned long long value = std::stoull(item, &used);
+                if (used != item.size() || value == 0) {
+                    return false;
+                }
+                values.push_back(value);
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+        return !values.empty();
+    }
+
+    /**
+     * Take our options out of argv, leaving the rest for Google
+     * Benchmark. Returns false with error set on a bad value.
+     */
+    bool ParseOptions(int& argc, char** argv, std::string& error) {
+        config.diskDirectory = (std::filesystem::temp_directory_path() / "stellar-bench").u8string();
+        config.sizes = {1};
+
+        int kept = 1;
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            const size_t equals = argument.find('=');
+            const std::string name = argument.substr(0, equals);
+            const std::string value = equals == std::string::npos ? std::string() : argument.substr(equals + 1);
+            try {
+                if (name == "--disk-dir") {
+                    config.diskDirectory = value;
+                } else if (name == "--disk-sizes") {
+                    if (!ParseNumberList(value, config.sizes)) {
+                        error = "Bad size list '" + value + "'";
+                        return false;
+                    }
+                } else if (name == "--fill") {
+                    config.disk.fill = std::stod(value);
+                } else if (name == "--fragmentation") {
+                    config.disk.fragmentation = std::stod(value);
+                } else if (name == "--mix") {
+                    if (!ParseSyntheticMix(value, config.disk.mix, error)) {
+                        return false;
+                    }
+                } else if (name == "--seed") {
+                    config.disk.seed = std::stoull(value);
+                } else if (name == "--recover-limit") {
+                    config.recoverLimit = static_cast<uint64_t>(std::stod(value) * GiB);
+                } else if (name == "--sort-rows") {
+                    config.sortRows = std::stoull(value);
+                } else {
+                    argv[kept++] = argv[i];
+                }
+            } catch (const std::exception&) {
+                error = "Bad value in '" + argument + "'";
+                return false;
+            }
+        }
+        argc = kept;
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string error;
+    if (!ParseOptions(argc, argv, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    RegisterBenchmarks();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,951 @@
+/**
+ * Stellar Data Recovery Pro Free - Synthetic Disk
+ *
+ * Layout first, bytes second: files are placed from the start of the data
+ * area in order, with "live" clusters between the fragments of a split
+ * file, then each file system's metadata is derived from that placement.
+ * Writing streams the image front to back once, generating file bodies
+ * and noise from per-purpose generators so every byte follows from the
+ * seed.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "synthetic_disk.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            // Bump when the generated bytes change for the same options
+            constexpr uint32_t LAYOUT_VERSION = 1;
+
+            constexpr uint32_t SECTOR_SIZE = 512;
+            constexpr uint64_t RAW_DATA_START = 1 * MiB;
+            constexpr size_t WRITE_CHUNK_SIZE = 4 * MiB;
+            constexpr uint64_t MAX_GAP_UNITS = 16;          // Live units between two fragments
+
+            constexpr uint32_t NTFS_CLUSTER_SIZE = 4096;
+            constexpr uint32_t NTFS_RECORD_SIZE = 1024;
+            constexpr uint64_t NTFS_MIRROR_LCN = 2;
+            constexpr uint64_t NTFS_MFT_LCN = 16;
+            constexpr uint64_t NTFS_FIRST_FILE_RECORD = 16;
+            constexpr uint32_t NTFS_MAX_RUNS = 16;
+
+            constexpr uint32_t FAT_RESERVED_SECTORS = 32;
+            constexpr uint32_t FAT_MIN_CLUSTERS = 65525;
+            constexpr uint32_t FAT_FILES_PER_DIRECTORY = 1000;
+            constexpr uint32_t FAT_ENTRIES_PER_FILE = 3;    // Two long-name entries and the short one
+            constexpr size_t FAT_LONG_NAME_UNITS = 13;
+            constexpr uint32_t FAT_END_OF_CHAIN = 0x0FFFFFFF;
+
+            constexpr uint32_t EXT_BLOCK_SIZE = 4096;
+            constexpr uint32_t EXT_BLOCKS_PER_GROUP = 32768;
+            constexpr uint32_t EXT_INODE_SIZE = 256;
+            constexpr uint32_t EXT_FIRST_FILE_INODE = 12;
+            constexpr uint32_t EXT_MAX_EXTENTS = 4;         // Held in the inode itself
+            constexpr uint32_t EXT_MAX_EXTENT_BLOCKS = 32768;
+
+            // 2026-01-01 00:00:00 UTC
+            constexpr uint32_t UNIX_TIME = 1767225600u;
+            constexpr uint64_t FILETIME = (static_cast<uint64_t>(UNIX_TIME) + 11644473600ull) * 10000000ull;
+
+            const char* const TYPE_NAMES[SYNTHETIC_TYPE_COUNT] = {
+                "photo", "video", "audio", "document", "email", "archive", "executable", "database"
+            };
+
+            /**
+             * xorshift64*: fast, and the same sequence on every platform
+             */
+            class Random {
+            public:
+                explicit Random(uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ull + 0x2545F4914F6CDD1Dull) {
+                    if (state == 0) {
+                        state = 1;
+                    }
+                }
+
+                uint64_t Next() {
+                    state ^= state >> 12;
+                    state ^= state << 25;
+                    state ^= state >> 27;
+                    return state * 0x2545F4914F6CDD1Dull;
+                }
+
+                uint64_t Below(uint64_t bound) { return bound ? Next() % bound : 0; }
+                double Unit() { return static_cast<double>(Next() >> 11) * (1.0 / 9007199254740992.0); }
+
+                void Fill(uint8_t* out, size_t length) {
+                    size_t i = 0;
+                    for (; i + 8 <= length; i += 8) {
+                        uint64_t value = Next();
+                        std::memcpy(out + i, &value, 8);
+                    }
+                    if (i < length) {
+                        uint64_t value = Next();
+                        std::memcpy(out + i, &value, length - i);
+                    }
+                }
+
+            private:
+                uint64_t state;
+            };
+
+            void PutLE16(uint8_t* out, uint16_t value) { std::memcpy(out, &value, sizeof(value)); }
+            void PutLE32(uint8_t* out, uint32_t value) { std::memcpy(out, &value, sizeof(value)); }
+            void PutLE64(uint8_t* out, uint64_t value) { std::memcpy(out, &value, sizeof(value)); }
+
+            uint64_t DivideUp(uint64_t value, uint64_t divisor) { return (value + divisor - 1) / divisor; }
+
+            // Bytes of a signed little-endian field that holds value
+            size_t SignedBytes(int64_t value) {
+                size_t bytes = 1;
+                while (bytes < 8 && (value < -(int64_t(1) << (bytes * 8 - 1)) || value >= (int64_t(1) << (bytes * 8 - 1)))) {
+                    bytes++;
+                }
+                return bytes;
+            }
+
+            struct Geometry {
+                uint64_t unit;                      // Allocation unit
+                uint64_t dataStart;                 // First byte files may use
+                uint64_t dataEnd;
+                size_t capacity;                    // Most files the metadata has room for
+
+                // FAT32
+                uint32_t sectorsPerCluster = 0;
+                uint32_t fatSectors = 0;
+                uint32_t rootClusters = 0;
+                uint32_t directoryClusters = 0;     // Per directory
+                uint32_t directories = 0;
+
+                // NTFS
+                uint64_t mftRecords = 0;
+                uint64_t mftClusters = 0;
+                uint64_t bitmapLcn = 0;
+                uint64_t bitmapClusters = 0;
+
+                // ext4
+                uint64_t groups = 0;
+                uint32_t inodesPerGroup = 0;
+                uint64_t gdtBlocks = 0;
+                uint64_t blockBitmapStart = 0;
+                uint64_t inodeBitmapStart = 0;
+                uint64_t inodeTableStart = 0;
+                uint64_t inodeTableBlocks = 0;      // Per group
+            };
+
+            struct Extent {
+                uint64_t offset;
+                uint64_t length;
+            };
+
+            // Metadata written at a fixed offset
+            using Blobs = std::vector<std::pair<uint64_t, std::vector<uint8_t>>>;
+
+            uint64_t MeanFileSize(const SyntheticDiskOptions& options) {
+                double low = static_cast<double>(options.minFileSize);
+                double high = static_cast<double>(options.maxFileSize);
+                return high > low ? static_cast<uint64_t>((high - low) / std::log(high / low))
+                                  : options.minFileSize;
+            }
+
+            Geometry PlanGeometry(const SyntheticDiskOptions& options) {
+                Geometry geometry;
+                const uint64_t size = options.size - options.size % SECTOR_SIZE;
+
+                // Metadata is sized for several times the files the fill should need
+                auto capacityFor = [&](uint64_t dataBytes) {
+                    double expected = options.fill * static_cast<double>(dataBytes) /
+                                      static_cast<double>(std::max<uint64_t>(MeanFileSize(options), 1));
+                    return static_cast<size_t>(4 * expected) + 64;
+                };
+
+                switch (options.fileSystem) {
+                    case SyntheticFileSystem::RAW:
+                        geometry.unit = 4096;
+                        geometry.dataStart = RAW_DATA_START;
+                        geometry.dataEnd = size - size % geometry.unit;
+                        geometry.capacity = SIZE_MAX;
+                        break;
+
+                    case SyntheticFileSystem::NTFS: {
+                        geometry.unit = NTFS_CLUSTER_SIZE;
+                        // The boot sector leaves the last sector for its backup
+                        const uint64_t clusters = (size / SECTOR_SIZE - 1) / (NTFS_CLUSTER_SIZE / SECTOR_SIZE);
+                        geometry.capacity = capacityFor(size);
+                        geometry.mftRecords = NTFS_FIRST_FILE_RECORD + geometry.capacity;
+                        geometry.mftClusters = DivideUp(geometry.mftRecords * NTFS_RECORD_SIZE, NTFS_CLUSTER_SIZE);
+                        geometry.bitmapLcn = NTFS_MFT_LCN + geometry.mftClusters;
+                        geometry.bitmapClusters = DivideUp(DivideUp(clusters, 8), NTFS_CLUSTER_SIZE);
+                        geometry.dataStart = (geometry.bitmapLcn + geometry.bitmapClusters) * NTFS_CLUSTER_SIZE;
+                        geometry.dataEnd = clusters * NTFS_CLUSTER_SIZE;
+                        break;
+                    }
+
+                    case SyntheticFileSystem::FAT32: {
+                        // Cluster sizes Windows picks by volume size
+                        const uint64_t clusterSize = size <= 8 * GiB ? 4096 : size <= 16 * GiB ? 8192
+                                                   : size <= 32 * GiB ? 16384 : 32768;
+                        const uint64_t totalSectors = size / SECTOR_SIZE;
+                        if (totalSectors > UINT32_MAX) {
+                            throw std::invalid_argument("FAT32 images are limited to 2 TiB");
+                        }
+                        geometry.unit = clusterSize;
+                        geometry.sectorsPerCluster = static_cast<uint32_t>(clusterSize / SECTOR_SIZE);
+                        const uint64_t roughClusters = (totalSectors - FAT_RESERVED_SECTORS) / geometry.sectorsPerCluster;
+                        geometry.fatSectors = static_cast<uint32_t>(DivideUp((roughClusters + 2) * 4, SECTOR_SIZE));
+                        const uint64_t dataSector = FAT_RESERVED_SECTORS + 2ull * geometry.fatSectors;
+                        const uint64_t clusters = (totalSectors - dataSector) / geometry.sectorsPerCluster;
+                        if (clusters < FAT_MIN_CLUSTERS) {
+                            throw std::invalid_argument("Image too small for FAT32 at " + std::to_string(clusterSize) +
+                                                        "-byte clusters");
+                        }
+
+                        geometry.capacity = capacityFor(size);
+                        geometry.directories = static_cast<uint32_t>(DivideUp(geometry.capacity, FAT_FILES_PER_DIRECTORY));
+                        geometry.rootClusters = static_cast<uint32_t>(DivideUp(geometry.directories * 32ull, clusterSize));
+                        geometry.directoryClusters = static_cast<uint32_t>(DivideUp((FAT_FILES_PER_DIRECTORY * FAT_ENTRIES_PER_FILE + 2) * 32ull,
+                                                                                    clusterSize));
+                        const uint64_t firstFree = 2ull + geometry.rootClusters +
+                                                   static_cast<uint64_t>(geometry.directories) * geometry.directoryClusters;
+                        geometry.dataStart = dataSector * SECTOR_SIZE + (firstFree - 2) * clusterSize;
+                        geometry.dataEnd = dataSector * SECTOR_SIZE + clusters * clusterSize;
+                        break;
+                    }
+
+                    case SyntheticFileSystem::EXT4: {
+                        geometry.unit = EXT_BLOCK_SIZE;
+                        const uint64_t blocks = size / EXT_BLOCK_SIZE;
+                        geometry.groups = DivideUp(blocks, EXT_BLOCKS_PER_GROUP);
+                        geometry.capacity = capacityFor(size);
+                        const uint64_t inodes = geometry.capacity + EXT_FIRST_FILE_INODE;
+                        const uint32_t inodesPerBlock = EXT_BLOCK_SIZE / EXT_INODE_SIZE;
+                        geometry.inodesPerGroup = static_cast<uint32_t>(
+                            DivideUp(DivideUp(inodes, geometry.groups), inodesPerBlock) * inodesPerBlock);
+                        geometry.inodeTableBlocks = geometry.inodesPerGroup / inodesPerBlock;
+                        // Flexible groups: every group's bitmaps and inode table up front
+                        geometry.gdtBlocks = DivideUp(geometry.groups * 64, EXT_BLOCK_SIZE);
+                        geometry.blockBitmapStart = 1 + geometry.gdtBlocks;
+                        geometry.inodeBitmapStart = geometry.blockBitmapStart + geometry.groups;
+                        geometry.inodeTableStart = geometry.inodeBitmapStart + geometry.groups;
+                        geometry.dataStart = (geometry.inodeTableStart + geometry.groups * geometry.inodeTableBlocks) *
+                                             EXT_BLOCK_SIZE;
+                        geometry.dataEnd = blocks * EXT_BLOCK_SIZE;
+                        break;
+                    }
+                }
+                if (geometry.dataStart >= geometry.dataEnd) {
+                    throw std::invalid_argument("Image too small for its metadata");
+                }
+                return geometry;
+            }
+
+            std::string FileName(SyntheticFileSystem fileSystem, size_t index, const FileSignature& signature) {
+                std::ostringstream name;
+                if (fileSystem == SyntheticFileSystem::EXT4) {
+                    name << "inode_" << (EXT_FIRST_FILE_INODE + index) << signature.extension;
+                } else {
+                    name << "file" << std::setw(7) << std::setfill('0') << index << signature.extension;
+                }
+                return name.str();
+            }
+
+            /**
+             * Place files from the start of the data area until the fill
+             * target, the space or the metadata capacity runs out
+             */
+            void PlaceFiles(SyntheticDisk& disk, const Geometry& geometry, std::vector<Extent>& live) {
+                const SyntheticDiskOptions& options = disk.options;
+                Random random(options.seed);
+
+                std::vector<const FileSignature*> byType[SYNTHETIC_TYPE_COUNT];
+                for (const auto& signature : FILE_SIGNATURES) {
+                    size_t type = static_cast<size_t>(signature.type);
+                    if (type < SYNTHETIC_TYPE_COUNT) {
+                        byType[type].push_back(&signature);
+                    }
+                }
+                double totalWeight = 0;
+                for (size_t type = 0; type < SYNTHETIC_TYPE_COUNT; type++) {
+                    totalWeight += byType[type].empty() ? 0 : std::max(options.mix[type], 0.0);
+                }
+                if (totalWeight <= 0) {
+                    throw std::invalid_argument("File type mix has no weight");
+                }
+
+                uint64_t maxFileSize = options.maxFileSize;
+                uint32_t maxFragments = std::max<uint32_t>(options.maxFragments, 1);
+                if (options.fileSystem == SyntheticFileSystem::FAT32) {
+                    maxFileSize = std::min<uint64_t>(maxFileSize, UINT32_MAX);
+                } else if (options.fileSystem == SyntheticFileSystem::EXT4) {
+                    maxFileSize = std::min<uint64_t>(maxFileSize, static_cast<uint64_t>(EXT_MAX_EXTENT_BLOCKS) * EXT_BLOCK_SIZE);
+                    maxFragments = std::min(maxFragments, EXT_MAX_EXTENTS);
+                } else if (options.fileSystem == SyntheticFileSystem::NTFS) {
+                    maxFragments = std::min(maxFragments, NTFS_MAX_RUNS);
+                }
+                const uint64_t minFileSize = std::min(std::max<uint64_t>(options.minFileSize, 1), maxFileSize);
+                const double logLow = std::log(static_cast<double>(minFileSize));
+                const double logHigh = std::log(static_cast<double>(maxFileSize));
+
+                const uint64_t unit = geometry.unit;
+                const uint64_t target = static_cast<uint64_t>(options.fill * static_cast<double>(geometry.dataEnd - geometry.dataStart));
+                uint64_t cursor = geometry.dataStart;
+
+                while (disk.files.size() < geometry.capacity && disk.fileBytes < target) {
+                    // Type by weight, then any of its signatures
+                    double pick = random.Unit() * totalWeight;
+                    size_t type = 0;
+                    for (; type + 1 < SYNTHETIC_TYPE_COUNT; type++) {
+                        double weight = byType[type].empty() ? 0 : std::max(options.mix[type], 0.0);
+                        if (pick < weight) {
+                            break;
+                        }
+                        pick -= weight;
+                    }
+                    while (byType[type].empty()) {
+                        type--;
+                    }
+                    const FileSignature* signature = byType[type][random.Below(byType[type].size())];
+
+                    uint64_t size = static_cast<uint64_t>(std::exp(logLow + (logHigh - logLow) * random.Unit()));
+                    const uint64_t smallest = static_cast<uint64_t>(signature->headerOffset) + signature->headerLength +
+                                              signature->footerLength + signature->footerTrailer;
+                    size = std::min(std::max(size, smallest), std::max(maxFileSize, smallest));
+                    const uint64_t units = DivideUp(size, unit);
+
+                    // Split points between units, each fragment followed by live data
+                    std::vector<uint64_t> cuts;
+                    if (units >= 2 && maxFragments >= 2 && random.Unit() < options.fragmentation) {
+                        uint64_t fragments = 2 + random.Below(std::min<uint64_t>(maxFragments, units) - 1);
+                        while (cuts.size() + 1 < fragments) {
+                            uint64_t cut = 1 + random.Below(units - 1);
+                            if (std::find(cuts.begin(), cuts.end(), cut) == cuts.end()) {
+                                cuts.push_back(cut);
+                            }
+                        }
+                        std::sort(cuts.begin(), cuts.end());
+                    }
+                    std::vector<uint64_t> gaps(cuts.size());
+                    uint64_t span = units;
+                    for (auto& gap : gaps) {
+                        gap = 1 + random.Below(MAX_GAP_UNITS);
+                        span += gap;
+                    }
+                    if (cursor + span * unit > geometry.dataEnd) {
+                        break;
+                    }
+
+                    SyntheticFile file;
+                    file.name = FileName(options.fileSystem, disk.files.size(), *signature);
+                    file.signature = signature;
+                    file.size = size;
+                    uint64_t first = 0;
+                    for (size_t fragment = 0; fragment <= cuts.size(); fragment++) {
+                        uint64_t last = fragment < cuts.size() ? cuts[fragment] : units;
+                        uint64_t bytes = std::min((last - first) * unit, size - first * unit);
+                        file.extents.push_back(FileExtent{cursor, bytes});
+                        cursor += (last - first) * unit;
+                        if (fragment < cuts.size()) {
+                            live.push_back(Extent{cursor, gaps[fragment] * unit});
+                            cursor += gaps[fragment] * unit;
+                        }
+                        first = last;
+                    }
+                    disk.fileBytes += size;
+                    disk.files.push_back(std::move(file));
+                }
+            }
+
+            // NTFS -----------------------------------------------------------
+
+            std::vector<uint8_t> NtfsResident(uint32_t type, const std::vector<uint8_t>& value) {
+                std::vector<uint8_t> attribute(DivideUp(24 + value.size(), 8) * 8, 0);
+                PutLE32(attribute.data(), type);
+                PutLE32(attribute.data() + 4, static_cast<uint32_t>(attribute.size()));
+                PutLE32(attribute.data() + 0x10, static_cast<uint32_t>(value.size()));
+                PutLE16(attribute.data() + 0x14, 24);
+                std::copy(value.begin(), value.end(), attribute.begin() + 24);
+                return attribute;
+            }
+
+            std::vector<uint8_t> NtfsNonResident(uint32_t type, const std::vector<std::pair<uint64_t, uint64_t>>& runs,
+                                                 uint64_t size) {
+                std::vector<uint8_t> runlist;
+                int64_t previous = 0;
+                uint64_t clusters = 0;
+                for (const auto& run : runs) {
+                    const int64_t delta = static_cast<int64_t>(run.first) - previous;
+                    previous = static_cast<int64_t>(run.first);
+                    const size_t lengthBytes = SignedBytes(static_cast<int64_t>(run.second));
+                    const size_t offsetBytes = SignedBytes(delta);
+                    runlist.push_back(static_cast<uint8_t>(lengthBytes | (offsetBytes << 4)));
+                    for (size_t i = 0; i < lengthBytes; i++) {
+                        runlist.push_back(static_cast<uint8_t>(run.second >> (i * 8)));
+                    }
+                    for (size_t i = 0; i < offsetBytes; i++) {
+                        runlist.push_back(static_cast<uint8_t>(static_cast<uint64_t>(delta) >> (i * 8)));
+                    }
+                    clusters += run.second;
+                }
+                runlist.push_back(0);
+
+                std::vector<uint8_t> attribute(DivideUp(0x40 + runlist.size(), 8) * 8, 0);
+                PutLE32(attribute.data(), type);
+                PutLE32(attribute.data() + 4, static_cast<uint32_t>(attribute.size()));
+                attribute[8] = 1;
+                PutLE64(attribute.data() + 0x18, clusters - 1);
+                PutLE16(attribute.data() + 0x20, 0x40);
+                PutLE64(attribute.data() + 0x28, clusters * NTFS_CLUSTER_SIZE);
+                PutLE64(attribute.data() + 0x30, size);
+                PutLE64(attribute.data() + 0x38, size);
+                std::copy(runlist.begin(), runlist.end(), attribute.begin() + 0x40);
+                return attribute;
+            }
+
+            std::vector<uint8_t> NtfsStandardInformation() {
+                std::vector<uint8_t> value(48, 0);
+                for (size_t i = 0; i < 4; i++) {
+                    PutLE64(value.data() + i * 8, FILETIME);
+                }
+                PutLE32(value.data() + 32, 0x20);
+                return NtfsResident(0x10, value);
+            }
+
+            std::vector<uint8_t> NtfsFileName(const std::string& name, uint64_t size, uint8_t nameSpace) {
+                std::vector<uint8_t> value(66 + name.size() * 2, 0);
+                PutLE64(value.data(), 5 | (5ull << 48));            // Root directory, sequence 5
+                for (size_t i = 0; i < 4; i++) {
+                    PutLE64(value.data() + 8 + i * 8, FILETIME);
+                }
+                PutLE64(value.data() + 0x28, DivideUp(size, NTFS_CLUSTER_SIZE) * NTFS_CLUSTER_SIZE);
+                PutLE64(value.data() + 0x30, size);
+                value[0x40] = static_cast<uint8_t>(name.size());
+                value[0x41] = nameSpace;
+                for (size_t i = 0; i < name.size(); i++) {
+                    value[0x42 + i * 2] = static_cast<uint8_t>(name[i]);   // Generated names are ASCII
+                }
+                return NtfsResident(0x30, value);
+            }
+
+            void NtfsRecord(uint8_t* record, uint32_t number, uint16_t flags, uint16_t sequence,
+                            const std::vector<std::vector<uint8_t>>& attributes) {
+                constexpr uint16_t USA_OFFSET = 0x30;
+                constexpr uint16_t USA_COUNT = NTFS_RECORD_SIZE / SECTOR_SIZE + 1;
+                constexpr uint16_t USN = 0x0001;
+
+                std::memset(record, 0, NTFS_RECORD_SIZE);
+                std::memcpy(record, "FILE", 4);
+                PutLE16(record + 4, USA_OFFSET);
+                PutLE16(record + 6, USA_COUNT);
+                PutLE16(record + 0x10, sequence);
+                PutLE16(record + 0x12, 1);
+                PutLE16(record + 0x14, 0x38);
+                PutLE16(record + 0x16, flags);
+                PutLE32(record + 0x1C, NTFS_RECORD_SIZE);
+                PutLE32(record + 0x2C, number);
+
+                size_t position = 0x38;
+                for (const auto& attribute : attributes) {
+                    std::memcpy(record + position, attribute.data(), attribute.size());
+                    position += attribute.size();
+                }
+                PutLE32(record + position, 0xFFFFFFFF);
+                position += 8;
+                PutLE32(record + 0x18, static_cast<uint32_t>(position));
+
+                // Update sequence: the last two bytes of each sector move into the array
+                PutLE16(record + USA_OFFSET, USN);
+                for (uint16_t i = 1; i < USA_COUNT; i++) {
+                    uint8_t* tail = record + i * SECTOR_SIZE - 2;
+                    std::memcpy(record + USA_OFFSET + i * 2, tail, 2);
+                    PutLE16(tail, USN);
+                }
+            }
+
+            void BuildNtfs(const SyntheticDisk& disk, const Geometry& geometry, const std::vector<Extent>& live, Blobs& blobs) {
+                const uint64_t clusters = geometry.dataEnd / NTFS_CLUSTER_SIZE;
+
+                std::vector<uint8_t> boot(SECTOR_SIZE, 0);
+                boot[0] = 0xEB; boot[1] = 0x52; boot[2] = 0x90;
+                std::memcpy(boot.data() + 3, "NTFS    ", 8);
+                PutLE16(boot.data() + 0x0B, SECTOR_SIZE);
+                boot[0x0D] = NTFS_CLUSTER_SIZE / SECTOR_SIZE;
+                boot[0x15] = 0xF8;
+                PutLE64(boot.data() + 0x28, disk.options.size / SECTOR_SIZE - 1);
+                PutLE64(boot.data() + 0x30, NTFS_MFT_LCN);
+                PutLE64(boot.data() + 0x38, NTFS_MIRROR_LCN);
+                boot[0x40] = 0xF6;                                  // 2^10-byte records
+                boot[0x44] = 1;
+                boot[510] = 0x55; boot[511] = 0xAA;
+                blobs.emplace_back(0, std::move(boot));
+
+                std::vector<uint8_t> mft(geometry.mftClusters * NTFS_CLUSTER_SIZE, 0);
+                auto record = [&](uint64_t number) { return mft.data() + number * NTFS_RECORD_SIZE; };
+                const uint64_t mftBytes = geometry.mftRecords * NTFS_RECORD_SIZE;
+                NtfsRecord(record(0), 0, 1, 1, {NtfsStandardInformation(), NtfsFileName("$MFT", mftBytes, 3),
+                           NtfsNonResident(0x80, {{NTFS_MFT_LCN, geometry.mftClusters}}, mftBytes)});
+                NtfsRecord(record(5), 5, 3, 5, {NtfsStandardInformation(), NtfsFileName(".", 0, 3)});
+                const uint64_t bitmapBytes = DivideUp(clusters, 8);
+                NtfsRecord(record(6), 6, 1, 6, {NtfsStandardInformation(), NtfsFileName("$Bitmap", bitmapBytes, 3),
+                           NtfsNonResident(0x80, {{geometry.bitmapLcn, geometry.bitmapClusters}}, bitmapBytes)});
+
+                for (size_t i = 0; i < disk.files.size(); i++) {
+                    const SyntheticFile& file = disk.files[i];
+                    std::vector<std::pair<uint64_t, uint64_t>> runs;
+                    for (const auto& extent : file.extents) {
+                        runs.emplace_back(extent.offset / NTFS_CLUSTER_SIZE, DivideUp(extent.length, NTFS_CLUSTER_SIZE));
+                    }
+                    const uint64_t number = NTFS_FIRST_FILE_RECORD + i;
+                    // Deleted: not in use, sequence already bumped
+                    NtfsRecord(record(number), static_cast<uint32_t>(number), 0, 2,
+                               {NtfsStandardInformation(), NtfsFileName(file.name, file.size, 1),
+                                NtfsNonResident(0x80, runs, file.size)});
+                }
+                blobs.emplace_back(NTFS_MIRROR_LCN * NTFS_CLUSTER_SIZE,
+                                   std::vector<uint8_t>(mft.begin(), mft.begin() + NTFS_CLUSTER_SIZE));
+                blobs.emplace_back(NTFS_MFT_LCN * NTFS_CLUSTER_SIZE, std::move(mft));
+
+                // Metadata and live fragments are allocated; deleted files are not
+                std::vector<uint8_t> bitmap(geometry.bitmapClusters * NTFS_CLUSTER_SIZE, 0);
+                auto mark = [&](uint64_t first, uint64_t count) {
+                    for (uint64_t cluster = first; cluster < first + count; cluster++) {
+                        bitmap[cluster / 8] |= static_cast<uint8_t>(1u << (cluster % 8));
+                    }
+                };
+                mark(0, geometry.dataStart / NTFS_CLUSTER_SIZE);
+                for (const auto& extent : live) {
+                    mark(extent.offset / NTFS_CLUSTER_SIZE, extent.length / NTFS_CLUSTER_SIZE);
+                }
+                blobs.emplace_back(geometry.bitmapLcn * NTFS_CLUSTER_SIZE, std::move(bitmap));
+            }
+
+            // FAT32 ----------------------------------------------------------
+
+            void FatEntry(uint8_t* entry, const char* name, uint8_t attributes, uint32_t cluster, uint32_t size) {
+                std::memcpy(entry, name, 11);
+                entry[11] = attributes;
+                PutLE16(entry + 14, 0x6000);                        // 12:00:00
+                PutLE16(entry + 16, 0x5C21);                        // 2026-01-01
+                PutLE16(entry + 18, 0x5C21);
+                PutLE16(entry + 20, static_cast<uint16_t>(cluster >> 16));
+                PutLE16(entry + 22, 0x6000);
+                PutLE16(entry + 24, 0x5C21);
+                PutLE16(entry + 26, static_cast<uint16_t>(cluster & 0xFFFF));
+                PutLE32(entry + 28, size);
+            }
+
+            void BuildFat32(const SyntheticDisk& disk, const Geometry& geometry, const std::vector<Extent>& live, Blobs& blobs) {
+                const uint64_t clusterSize = geometry.unit;
+                const uint64_t fatOffset = static_cast<uint64_t>(FAT_RESERVED_SECTORS) * SECTOR_SIZE;
+                const uint64_t dataOffset = fatOffset + 2ull * geometry.fatSectors * SECTOR_SIZE;
+                auto clusterOf = [&](uint64_t offset) { return static_cast<uint32_t>((offset - dataOffset) / clusterSize + 2); };
+                auto offsetOf = [&](uint32_t cluster) { return dataOffset + static_cast<uint64_t>(cluster - 2) * clusterSize; };
+
+                std::vector<uint8_t> boot(SECTOR_SIZE, 0);
+                boot[0] = 0xEB; boot[1] = 0x58; boot[2] = 0x90;
+                std::memcpy(boot.data() + 3, "MSDOS5.0", 8);
+                PutLE16(boot.data() + 0x0B, SECTOR_SIZE);
+                boot[0x0D] = static_cast<uint8_t>(geometry.sectorsPerCluster);
+                PutLE16(boot.data() + 0x0E, FAT_RESERVED_SECTORS);
+                boot[0x10] = 2;
+                boot[0x15] = 0xF8;
+                PutLE16(boot.data() + 0x18, 63);
+                PutLE16(boot.data() + 0x1A, 255);
+                PutLE32(boot.data() + 0x20, static_cast<uint32_t>(disk.options.size / SECTOR_SIZE));
+                PutLE32(boot.data() + 0x24, geometry.fatSectors);
+                PutLE32(boot.data() + 0x2C, 2);
+                PutLE16(boot.data() + 0x30, 1);
+                PutLE16(boot.data() + 0x32, 6);
+                boot[0x42] = 0x29;
+                std::memcpy(boot.data() + 0x47, "SYNTHETIC  ", 11);
+                std::memcpy(boot.data() + 0x52, "FAT32   ", 8);
+                boot[510] = 0x55; boot[511] = 0xAA;
+                blobs.emplace_back(0, std::move(boot));
+
+                std::vector<uint8_t> fat(static_cast<size_t>(geometry.fatSectors) * SECTOR_SIZE, 0);
+                auto chain = [&](uint32_t first, uint64_t count) {
+                    for (uint64_t i = 0; i < count; i++) {
+                        uint32_t cluster = first + static_cast<uint32_t>(i);
+                        PutLE32(fat.data() + cluster * 4ull, i + 1 < count ? cluster + 1 : FAT_END_OF_CHAIN);
+                    }
+                };
+                PutLE32(fat.data(), 0x0FFFFFF8);
+                PutLE32(fat.data() + 4, FAT_END_OF_CHAIN);
+                chain(2, geometry.rootClusters);
+
+                // Root lists the directories; each directory holds deleted short-name entries
+                std::vector<uint8_t> root(geometry.rootClusters * clusterSize, 0);
+                const uint32_t firstDirectory = 2 + geometry.rootClusters;
+                for (uint32_t d = 0; d < geometry.directories; d++) {
+                    const uint32_t cluster = firstDirectory + d * geometry.directoryClusters;
+                    chain(cluster, geometry.directoryClusters);
+
+                    std::ostringstream name;
+                    name << "DIR" << std::setw(5) << std::setfill('0') << d << "   ";
+                    FatEntry(root.data() + d * 32ull, name.str().c_str(), 0x10, cluster, 0);
+
+                    std::vector<uint8_t> directory(geometry.directoryClusters * clusterSize, 0);
+                    FatEntry(directory.data(), ".          ", 0x10, cluster, 0);
+                    FatEntry(directory.data() + 32, "..         ", 0x10, 0, 0);
+                    const size_t first = static_cast<size_t>(d) * FAT_FILES_PER_DIRECTORY;
+                    const size_t last = std::min(disk.files.size(), first + FAT_FILES_PER_DIRECTORY);
+                    for (size_t i = first; i < last; i++) {
+                        const SyntheticFile& file = disk.files[i];
+                        uint8_t* entry = directory.data() + (2 + (i - first) * FAT_ENTRIES_PER_FILE) * 32;
+
+                        // Short name "F0000001JPG"; the long name keeps the full extension
+                        std::ostringstream shortName;
+                        shortName << 'F' << std::setw(7) << std::setfill('0') << i;
+                        std::string extension = file.signature->extension + 1;
+                        extension.resize(3, ' ');
+                        std::transform(extension.begin(), extension.end(), extension.begin(),
+                                       [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+                        const std::string shortText = shortName.str() + extension;
+                        uint8_t checksum = 0;
+                        for (unsigned char c : shortText) {
+                            checksum = static_cast<uint8_t>(((checksum & 1) << 7) + (checksum >> 1) + c);
+                        }
+
+                        std::vector<uint16_t> units(file.name.begin(), file.name.end());
+                        units.push_back(0);
+                        units.resize(FAT_LONG_NAME_UNITS * (FAT_ENTRIES_PER_FILE - 1), 0xFFFF);
+                        static const size_t UNIT_OFFSETS[FAT_LONG_NAME_UNITS] = {1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30};
+                        for (uint32_t part = 0; part + 1 < FAT_ENTRIES_PER_FILE; part++) {
+                            // Stored last part first; every entry of a deleted file starts with 0xE5
+                            uint8_t* longEntry = entry + (FAT_ENTRIES_PER_FILE - 2 - part) * 32;
+                            longEntry[0] = 0xE5;
+                            longEntry[11] = 0x0F;
+                            longEntry[13] = checksum;
+                            for (size_t u = 0; u < FAT_LONG_NAME_UNITS; u++) {
+                                PutLE16(longEntry + UNIT_OFFSETS[u], units[part * FAT_LONG_NAME_UNITS + u]);
+                            }
+                        }
+                        std::string deletedName = shortText;
+                        deletedName[0] = static_cast<char>(0xE5);
+                        FatEntry(entry + (FAT_ENTRIES_PER_FILE - 1) * 32, deletedName.c_str(), 0x20,
+                                 clusterOf(file.extents.front().offset), static_cast<uint32_t>(file.size));
+                    }
+                    blobs.emplace_back(offsetOf(cluster), std::move(directory));
+                }
+                blobs.emplace_back(offsetOf(2), std::move(root));
+
+                // Live data between fragments; the chains of deleted files are zeroed
+                for (const auto& extent : live) {
+                    chain(clusterOf(extent.offset), extent.length / clusterSize);
+                }
+                blobs.emplace_back(fatOffset, fat);
+                blobs.emplace_back(fatOffset + static_cast<uint64_t>(geometry.fatSectors) * SECTOR_SIZE, std::move(fat));
+            }
+
+            // ext4 -----------------------------------------------------------
+
+            void BuildExt4(const SyntheticDisk& disk, const Geometry& geometry, const std::vector<Extent>& live, Blobs& blobs) {
+                const uint64_t blocks = geometry.dataEnd / EXT_BLOCK_SIZE;
+
+                std::vector<uint8_t> superblock(1024, 0);
+                uint8_t* sb = superblock.data();
+                PutLE32(sb + 0x00, static_cast<uint32_t>(geometry.groups * geometry.inodesPerGroup));
+                PutLE32(sb + 0x04, static_cast<uint32_t>(blocks));
+                PutLE32(sb + 0x14, 0);
+                PutLE32(sb + 0x18, 2);                              // 4 KiB blocks
+                PutLE32(sb + 0x1C, 2);
+                PutLE32(sb + 0x20, EXT_BLOCKS_PER_GROUP);
+                PutLE32(sb + 0x24, EXT_BLOCKS_PER_GROUP);
+                PutLE32(sb + 0x28, geometry.inodesPerGroup);
+                PutLE16(sb + 0x38, 0xEF53);
+                PutLE16(sb + 0x3A, 1);
+                PutLE16(sb + 0x3C, 1);
+                PutLE32(sb + 0x4C, 1);
+                PutLE32(sb + 0x54, EXT_FIRST_FILE_INODE - 1);
+                PutLE16(sb + 0x58, EXT_INODE_SIZE);
+                PutLE32(sb + 0x60, 0x0002 | 0x0040 | 0x0080 | 0x0200);   // FILETYPE, EXTENTS, 64BIT, FLEX_BG
+                PutLE16(sb + 0xFE, 64);
+                PutLE32(sb + 0x150, static_cast<uint32_t>(blocks >> 32));
+                blobs.emplace_back(1024, std::move(superblock));
+
+                std::vector<uint8_t> descriptors(geometry.gdtBlocks * EXT_BLOCK_SIZE, 0);
+                for (uint64_t group = 0; group < geometry.groups; group++) {
+                    uint8_t* descriptor = descriptors.data() + group * 64;
+                    const uint64_t blockBitmap = geometry.blockBitmapStart + group;
+                    const uint64_t inodeBitmap = geometry.inodeBitmapStart + group;
+                    const uint64_t inodeTable = geometry.inodeTableStart + group * geometry.inodeTableBlocks;
+                    PutLE32(descriptor + 0x00, static_cast<uint32_t>(blockBitmap));
+                    PutLE32(descriptor + 0x04, static_cast<uint32_t>(inodeBitmap));
+                    PutLE32(descriptor + 0x08, static_cast<uint32_t>(inodeTable));
+                    PutLE32(descriptor + 0x20, static_cast<uint32_t>(blockBitmap >> 32));
+                    PutLE32(descriptor + 0x24, static_cast<uint32_t>(inodeBitmap >> 32));
+                    PutLE32(descriptor + 0x28, static_cast<uint32_t>(inodeTable >> 32));
+                }
+                blobs.emplace_back(EXT_BLOCK_SIZE, std::move(descriptors));
+
+                std::vector<uint8_t> bitmaps(geometry.groups * EXT_BLOCK_SIZE, 0);
+                auto mark = [&](uint64_t first, uint64_t count) {
+                    for (uint64_t block = first; block < first + count; block++) {
+                        uint64_t group = block / EXT_BLOCKS_PER_GROUP;
+                        uint64_t bit = block % EXT_BLOCKS_PER_GROUP;
+                        bitmaps[group * EXT_BLOCK_SIZE + bit / 8] |= static_cast<uint8_t>(1u << (bit % 8));
+                    }
+                };
+                mark(0, geometry.dataStart / EXT_BLOCK_SIZE);
+                for (const auto& extent : live) {
+                    mark(extent.offset / EXT_BLOCK_SIZE, extent.length / EXT_BLOCK_SIZE);
+                }
+                blobs.emplace_back(geometry.blockBitmapStart * EXT_BLOCK_SIZE, std::move(bitmaps));
+
+                // Deleted regular files that still map their blocks, as ext2 leaves them
+                std::vector<uint8_t> tables(geometry.groups * geometry.inodeTableBlocks * EXT_BLOCK_SIZE, 0);
+                for (size_t i = 0; i < disk.files.size(); i++) {
+                    const SyntheticFile& file = disk.files[i];
+                    const uint64_t index = EXT_FIRST_FILE_INODE + i - 1;
+                    const uint64_t group = index / geometry.inodesPerGroup;
+                    uint8_t* inode = tables.data() + group * geometry.inodeTableBlocks * EXT_BLOCK_SIZE +
+                                     (index % geometry.inodesPerGroup) * EXT_INODE_SIZE;
+                    PutLE16(inode + 0x00, 0x81A4);
+                    PutLE32(inode + 0x04, static_cast<uint32_t>(file.size));
+                    PutLE32(inode + 0x08, UNIX_TIME);
+                    PutLE32(inode + 0x0C, UNIX_TIME);
+                    PutLE32(inode + 0x10, UNIX_TIME);
+                    PutLE32(inode + 0x14, UNIX_TIME + 3600);
+                    PutLE32(inode + 0x1C, static_cast<uint32_t>(DivideUp(file.size, EXT_BLOCK_SIZE) * (EXT_BLOCK_SIZE / SECTOR_SIZE)));
+                    PutLE32(inode + 0x20, 0x80000);                 // Extents
+                    PutLE16(inode + 0x28, 0xF30A);
+                    PutLE16(inode + 0x2A, static_cast<uint16_t>(file.extents.size()));
+                    PutLE16(inode + 0x2C, EXT_MAX_EXTENTS);
+                    uint32_t logical = 0;
+                    for (size_t e = 0; e < file.extents.size(); e++) {
+                        uint8_t* entry = inode + 0x34 + e * 12;
+                        const uint64_t start = file.extents[e].offset / EXT_BLOCK_SIZE;
+                        const uint32_t length = static_cast<uint32_t>(DivideUp(file.extents[e].length, EXT_BLOCK_SIZE));
+                        PutLE32(entry, logical);
+                        PutLE16(entry + 4, static_cast<uint16_t>(length));
+                        PutLE16(entry + 6, static_cast<uint16_t>(start >> 32));
+                        PutLE32(entry + 8, static_cast<uint32_t>(start));
+                        logical += length;
+                    }
+                    PutLE32(inode + 0x6C, static_cast<uint32_t>(file.size >> 32));
+                    PutLE16(inode + 0x80, 32);
+                    PutLE32(inode + 0x90, UNIX_TIME);
+                }
+                blobs.emplace_back(geometry.inodeTableStart * EXT_BLOCK_SIZE, std::move(tables));
+            }
+
+            // Writing --------------------------------------------------------
+
+            /**
+             * Content of one file: random bytes with its signature's magic
+             * at the header offset and its footer (plus trailer) at the end
+             */
+            void FileContent(const SyntheticFile& file, uint64_t fileOffset, uint8_t* out, size_t length, Random& random) {
+                random.Fill(out, length);
+                const FileSignature& signature = *file.signature;
+                auto overlay = [&](uint64_t at, const char* bytes, size_t count) {
+                    for (size_t i = 0; i < count; i++) {
+                        if (at + i >= fileOffset && at + i < fileOffset + length) {
+                            out[at + i - fileOffset] = static_cast<uint8_t>(bytes[i]);
+                        }
+                    }
+                };
+                overlay(signature.headerOffset, signature.header, signature.headerLength);
+                if (signature.footer) {
+                    overlay(file.size - signature.footerTrailer - signature.footerLength, signature.footer,
+                            signature.footerLength);
+                }
+            }
+
+            void WriteImage(const SyntheticDisk& disk, const Geometry& geometry, const Blobs& blobs, const std::string& path) {
+                struct Piece {
+                    uint64_t offset;
+                    uint64_t length;
+                    const std::vector<uint8_t>* blob;   // Metadata, or null for a file fragment
+                    size_t file;
+                    uint64_t fileOffset;
+                };
+                std::vector<Piece> pieces;
+                for (const auto& blob : blobs) {
+                    pieces.push_back(Piece{blob.first, blob.second.size(), &blob.second, 0, 0});
+                }
+                for (size_t i = 0; i < disk.files.size(); i++) {
+                    uint64_t fileOffset = 0;
+                    for (const auto& extent : disk.files[i].extents) {
+                        pieces.push_back(Piece{extent.offset, extent.length, nullptr, i, fileOffset});
+                        fileOffset += extent.length;
+                    }
+                }
+                std::sort(pieces.begin(), pieces.end(), [](const Piece& a, const Piece& b) { return a.offset < b.offset; });
+
+                const std::string partial = path + ".partial";
+                std::ofstream out(std::filesystem::u8path(partial), std::ios::binary | std::ios::trunc);
+                if (!out) {
+                    throw std::runtime_error("Cannot create " + partial);
+                }
+
+                std::vector<uint8_t> buffer(WRITE_CHUNK_SIZE);
+                Random noise(disk.options.seed ^ 0x6E6F697365ull);
+                Random content(0);
+                uint64_t position = 0;
+
+                // Metadata areas are zero; everything else unused holds noise
+                auto fill = [&](uint64_t end) {
+                    while (position < end) {
+                        size_t length = static_cast<size_t>(std::min<uint64_t>(end - position, buffer.size()));
+                        if (position < geometry.dataStart) {
+                            length = static_cast<size_t>(std::min<uint64_t>(length, geometry.dataStart - position));
+                            std::fill(buffer.begin(), buffer.begin() + length, 0);
+                        } else {
+                            noise.Fill(buffer.data(), length);
+                        }
+                        out.write(reinterpret_cast<const char*>(buffer.data()), length);
+                        position += length;
+                    }
+                };
+
+                for (const auto& piece : pieces) {
+                    if (piece.offset < position) {
+                        throw std::logic_error("Overlapping regions in synthetic layout");
+                    }
+                    fill(piece.offset);
+                    if (piece.blob) {
+                        out.write(reinterpret_cast<const char*>(piece.blob->data()), piece.blob->size());
+                        position += piece.length;
+                        continue;
+                    }
+                    const SyntheticFile& file = disk.files[piece.file];
+                    if (piece.fileOffset == 0) {
+                        content = Random(disk.options.seed * 0x100000001B3ull + piece.file);
+                    }
+                    for (uint64_t done = 0; done < piece.length;) {
+                        size_t length = static_cast<size_t>(std::min<uint64_t>(piece.length - done, buffer.size()));
+                        FileContent(file, piece.fileOffset + done, buffer.data(), length, content);
+                        out.write(reinterpret_cast<const char*>(buffer.data()), length);
+                        done += length;
+                    }
+                    position += piece.length;
+                }
+                fill(disk.options.size);
+
+                out.close();
+                if (!out) {
+                    throw std::runtime_error("Cannot write " + partial);
+                }
+                std::filesystem::rename(std::filesystem::u8path(partial), std::filesystem::u8path(path));
+            }
+
+        } // namespace
+
+        SyntheticDisk CreateSyntheticDisk(const std::string& directory, const SyntheticDiskOptions& options) {
+            SyntheticDisk disk;
+            disk.options = options;
+            disk.options.size -= disk.options.size % SECTOR_SIZE;
+            disk.fileBytes = 0;
+            disk.metadataBytes = 0;
+            disk.path = (std::filesystem::u8path(directory) / SyntheticDiskName(disk.options)).u8string();
+
+            const Geometry geometry = PlanGeometry(disk.options);
+            std::vector<Extent> live;
+            PlaceFiles(disk, geometry, live);
+
+            Blobs blobs;
+            switch (disk.options.fileSystem) {
+                case SyntheticFileSystem::RAW: break;
+                case SyntheticFileSystem::NTFS: BuildNtfs(disk, geometry, live, blobs); break;
+                case SyntheticFileSystem::FAT32: BuildFat32(disk, geometry, live, blobs); break;
+                case SyntheticFileSystem::EXT4: BuildExt4(disk, geometry, live, blobs); break;
+            }
+            for (const auto& blob : blobs) {
+                disk.metadataBytes += blob.second.size();
+            }
+
+            // The name covers every option, so a complete file of the right size is this image
+            std::error_code error;
+            const auto existing = std::filesystem::file_size(std::filesystem::u8path(disk.path), error);
+            if (error || existing != disk.options.size) {
+                std::filesystem::create_directories(std::filesystem::u8path(directory));
+                WriteImage(disk, geometry, blobs, disk.path);
+            }
+            return disk;
+        }
+
+        std::string SyntheticDiskName(const SyntheticDiskOptions& options) {
+            std::ostringstream key;
+            key << LAYOUT_VERSION << '|' << options.size << '|' << static_cast<int>(options.fileSystem) << '|'
+                << options.fill << '|' << options.fragmentation << '|' << options.maxFragments << '|'
+                << options.minFileSize << '|' << options.maxFileSize << '|' << options.seed;
+            for (double weight : options.mix) {
+                key << '|' << weight;
+            }
+            // FNV-1a
+            uint64_t hash = 0xCBF29CE484222325ull;
+            for (unsigned char c : key.str()) {
+                hash = (hash ^ c) * 0x100000001B3ull;
+            }
+
+            std::ostringstream name;
+            name << "stellar-" << SyntheticFileSystemName(options.fileSystem) << '-' << options.size / MiB << "m-"
+                 << std::hex << std::setw(16) << std::setfill('0') << hash << ".img";
+            return name.str();
+        }
+
+        const char* SyntheticFileSystemName(SyntheticFileSystem fileSystem) {
+            switch (fileSystem) {
+                case SyntheticFileSystem::RAW: return "raw";
+                case SyntheticFileSystem::NTFS: return "ntfs";
+                case SyntheticFileSystem::FAT32: return "fat32";
+                case SyntheticFileSystem::EXT4: return "ext4";
+            }
+            return "raw";
+        }
+
+        bool ParseSyntheticFileSystem(const std::string& name, SyntheticFileSystem& fileSystem) {
+            for (auto candidate : {SyntheticFileSystem::RAW, SyntheticFileSystem::NTFS,
+                                   SyntheticFileSystem::FAT32, SyntheticFileSystem::EXT4}) {
+                if (name == SyntheticFileSystemName(candidate)) {
+                    fileSystem = candidate;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool ParseSyntheticMix(const std::string& text, std::array<double, SYNTHETIC_TYPE_COUNT>& mix,
+                               std::string& error) {
+            std::array<double, SYNTHETIC_TYPE_COUNT> parsed{};
+            std::istringstream in(text);
+            std::string item;
+            while (std::getline(in, item, ',')) {
+                const size_t colon = item.find(':');
+                const std::string name = item.substr(0, colon);
+                const size_t type = std::find(std::begin(TYPE_NAMES), std::end(TYPE_NAMES), name) - std::begin(TYPE_NAMES);
+                if (type == SYNTHETIC_TYPE_COUNT) {
+                    error = "Unknown file type '" + name + "'";
+                    return false;
+                }
+                try {
+                    parsed[type] = colon == std::string::npos ? 1.0 : std::stod(item.substr(colon + 1));
+                } catch (const std::exception&) {
+                    error = "Bad weight in '" + item + "'";
+                    return false;
+                }
+                if (parsed[type] < 0) {
+                    error = "Negative weight in '" + item + "'";
+                    return false;
+                }
+            }
+            mix = parsed;
+            return true;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
@@ -0,0 +1,107 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Synthetic Disk
+ *
+ * Deterministic disk images for the benchmarks. A seed and a handful of
+ * parameters fix every byte: which files exist, their types, sizes and
+ * fragments, and the NTFS, FAT32 or ext4 metadata describing them as
+ * deleted. Space not taken by files or metadata is filled with noise, so
+ * the carver sees a realistic mix of signatures and garbage. Images are
+ * written once and reused while their parameters do not change.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_SYNTHETIC_DISK_H
+#define STELLAR_SYNTHETIC_DISK_H
+
+#include "stellar_recovery.h"
+#include "file_signatures.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        enum class SyntheticFileSystem {
+            RAW,        // Files and noise, no metadata
+            NTFS,       // 4 KiB clusters, deleted MFT records
+            FAT32,      // Deleted short-name entries, zeroed chains
+            EXT4        // Deleted inodes that kept their extents
+        };
+
+        // Concrete file types, ALL_DATA excluded
+        constexpr size_t SYNTHETIC_TYPE_COUNT = static_cast<size_t>(TargetFileType::ALL_DATA);
+
+        struct SyntheticDiskOptions {
+            uint64_t size;                          // Image bytes
+            SyntheticFileSystem fileSystem;
+            double fill;                            // Share of the data area holding deleted files
+            double fragmentation;                   // Share of files split into fragments
+            uint32_t maxFragments;                  // Per fragmented file; ext4 keeps at most 4 in the inode
+            uint64_t minFileSize;                   // File sizes are log-uniform in [min, max]
+            uint64_t maxFileSize;
+            std::array<double, SYNTHETIC_TYPE_COUNT> mix;  // Relative weight of each TargetFileType
+            uint64_t seed;
+
+            SyntheticDiskOptions() :
+                size(1 * GiB),
+                fileSystem(SyntheticFileSystem::RAW),
+                fill(0.5),
+                fragmentation(0.1),
+                maxFragments(4),
+                minFileSize(4 * KiB),
+                maxFileSize(8 * MiB),
+                seed(1) {
+                mix.fill(1.0);
+            }
+        };
+
+        /**
+         * One deleted file placed on the image
+         */
+        struct SyntheticFile {
+            std::string name;
+            const FileSignature* signature;
+            uint64_t size;
+            std::vector<FileExtent> extents;        // Absolute image offsets, in file order
+        };
+
+        struct SyntheticDisk {
+            std::string path;
+            SyntheticDiskOptions options;
+            std::vector<SyntheticFile> files;
+            uint64_t fileBytes;                     // Sum of file sizes
+            uint64_t metadataBytes;                 // Boot sectors, tables and directories
+        };
+
+        /**
+         * Lay out the image described by options and write it into
+         * directory, unless a complete image with the same parameters is
+         * already there. The layout is rebuilt from the seed either way.
+         * Throws std::runtime_error when the image cannot be written.
+         */
+        SyntheticDisk CreateSyntheticDisk(const std::string& directory, const SyntheticDiskOptions& options);
+
+        // File name of the image; differs whenever any option does
+        std::string SyntheticDiskName(const SyntheticDiskOptions& options);
+
+        const char* SyntheticFileSystemName(SyntheticFileSystem fileSystem);
+        bool ParseSyntheticFileSystem(const std::string& name, SyntheticFileSystem& fileSystem);
+
+        /**
+         * Parse a type mix such as "photo:4,video:1,document:2". Types not
+         * listed get weight 0. Returns false with error set on bad input.
+         */
+        bool ParseSyntheticMix(const std::string& text, std::array<double, SYNTHETIC_TYPE_COUNT>& mix,
+                               std::string& error);
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_SYNTHETIC_DISK_H
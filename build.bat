@@ -26,6 +26,9 @@ if not exist "src\*.cpp" (
 
 echo C++ source files detected. Attempting build...
 
+REM "build.bat bench" builds the benchmark suite instead of the application
+if /i "%~1"=="bench" goto :build_bench
+
 REM Check for build tools
 echo.
 echo Detecting build tools...
@@ -65,7 +68,7 @@ echo.
 echo Building with Visual Studio compiler...
 cd src
 if not exist "obj" mkdir obj
-cl /std:c++17 /EHsc /O2 /DWIN32_LEAN_AND_MEAN /DNDEBUG /I. main.cpp utils.cpp /link setupapi.lib cfgmgr32.lib kernel32.lib user32.lib advapi32.lib /OUT:"..\bin\stellar-recovery.exe"
+cl /std:c++17 /EHsc /O2 /constexpr:steps10000000 /DWIN32_LEAN_AND_MEAN /DNOMINMAX /DNDEBUG /I. main.cpp utils.cpp cpu_features.cpp device_enumerator.cpp sector_reader.cpp signature_automaton.cpp signature_carver.cpp format_validators.cpp fragment_carver.cpp scan_scheduler.cpp scan_arena.cpp filesystem_scanner.cpp ntfs_scanner.cpp fat_scanner.cpp ext4_scanner.cpp image_source.cpp io_queue.cpp recovery_planner.cpp extent_copier.cpp file_hasher.cpp dedup_index.cpp partition_recovery.cpp disk_imager.cpp batch_runner.cpp metrics.cpp result_store.cpp result_index.cpp scan_checkpoint.cpp recovery_pipeline.cpp /link setupapi.lib cfgmgr32.lib kernel32.lib user32.lib advapi32.lib /OUT:"..\bin\stellar-recovery.exe"
 if %ERRORLEVEL% equ 0 (
     echo Build successful!
     cd ..
@@ -81,7 +84,7 @@ echo.
 echo Building with MinGW-w64 compiler...
 cd src
 if not exist "obj" mkdir obj
-g++ -std=c++17 -Wall -Wextra -O2 -DWIN32_LEAN_AND_MEAN -DNDEBUG -static-libgcc -static-libstdc++ main.cpp utils.cpp -o "..\bin\stellar-recovery.exe" -lsetupapi -lcfgmgr32 -lkernel32 -luser32 -ladvapi32
+g++ -std=c++17 -Wall -Wextra -O2 -DWIN32_LEAN_AND_MEAN -DNOMINMAX -DNDEBUG -static-libgcc -static-libstdc++ main.cpp utils.cpp cpu_features.cpp device_enumerator.cpp sector_reader.cpp signature_automaton.cpp signature_carver.cpp format_validators.cpp fragment_carver.cpp scan_scheduler.cpp scan_arena.cpp filesystem_scanner.cpp ntfs_scanner.cpp fat_scanner.cpp ext4_scanner.cpp image_source.cpp io_queue.cpp recovery_planner.cpp extent_copier.cpp file_hasher.cpp dedup_index.cpp partition_recovery.cpp disk_imager.cpp batch_runner.cpp metrics.cpp result_store.cpp result_index.cpp scan_checkpoint.cpp recovery_pipeline.cpp -o "..\bin\stellar-recovery.exe" -lsetupapi -lcfgmgr32 -lkernel32 -luser32 -ladvapi32
 if %ERRORLEVEL% equ 0 (
     echo Build successful!
     cd ..
@@ -97,7 +100,7 @@ echo.
 echo Building with CMake...
 if not exist "build" mkdir build
 cd build
-cmake ..\src -DCMAKE_BUILD_TYPE=Release
+cmake .. -DCMAKE_BUILD_TYPE=Release -DSTELLAR_OUTPUT_DIRECTORY="%~dp0bin"
 if %ERRORLEVEL% neq 0 (
     echo CMake configuration failed!
     cd ..
@@ -114,6 +117,38 @@ if %ERRORLEVEL% equ 0 (
     goto :build_failed
 )
 
+:build_bench
+echo.
+echo Building benchmarks (requires Google Benchmark)...
+where cl >nul 2>&1
+if %ERRORLEVEL% equ 0 goto :bench_vs
+where g++ >nul 2>&1
+if %ERRORLEVEL% equ 0 goto :bench_mingw
+echo No suitable build tools found!
+goto :build_failed
+
+:bench_vs
+cd src
+cl /std:c++17 /EHsc /O2 /constexpr:steps10000000 /DWIN32_LEAN_AND_MEAN /DNOMINMAX /DNDEBUG /I. /I..\bench ..\bench\recovery_benchmarks.cpp ..\bench\synthetic_disk.cpp utils.cpp cpu_features.cpp device_enumerator.cpp sector_reader.cpp signature_automaton.cpp signature_carver.cpp format_validators.cpp fragment_carver.cpp scan_scheduler.cpp scan_arena.cpp filesystem_scanner.cpp ntfs_scanner.cpp fat_scanner.cpp ext4_scanner.cpp image_source.cpp io_queue.cpp recovery_planner.cpp extent_copier.cpp file_hasher.cpp dedup_index.cpp partition_recovery.cpp disk_imager.cpp batch_runner.cpp metrics.cpp result_store.cpp result_index.cpp scan_checkpoint.cpp recovery_pipeline.cpp /link benchmark.lib shlwapi.lib setupapi.lib cfgmgr32.lib kernel32.lib user32.lib advapi32.lib /OUT:"..\bin\stellar-bench.exe"
+goto :bench_result
+
+:bench_mingw
+cd src
+g++ -std=c++17 -Wall -Wextra -O2 -DWIN32_LEAN_AND_MEAN -DNOMINMAX -DNDEBUG -I. -I..\bench ..\bench\recovery_benchmarks.cpp ..\bench\synthetic_disk.cpp utils.cpp cpu_features.cpp device_enumerator.cpp sector_reader.cpp signature_automaton.cpp signature_carver.cpp format_validators.cpp fragment_carver.cpp scan_scheduler.cpp scan_arena.cpp filesystem_scanner.cpp ntfs_scanner.cpp fat_scanner.cpp ext4_scanner.cpp image_source.cpp io_queue.cpp recovery_planner.cpp extent_copier.cpp file_hasher.cpp dedup_index.cpp partition_recovery.cpp disk_imager.cpp batch_runner.cpp metrics.cpp result_store.cpp result_index.cpp scan_checkpoint.cpp recovery_pipeline.cpp -o "..\bin\stellar-bench.exe" -lbenchmark -lshlwapi -lsetupapi -lcfgmgr32 -lkernel32 -luser32 -ladvapi32
+
+:bench_result
+if %ERRORLEVEL% equ 0 (
+    echo Build successful!
+    echo.
+    echo Run bin\stellar-bench.exe --disk-sizes=1,10,100 to benchmark 1, 10 and 100 GiB images.
+    cd ..
+    goto :end
+) else (
+    echo Build failed!
+    cd ..
+    goto :build_failed
+)
+
 :build_success
 echo.
 echo ========================================
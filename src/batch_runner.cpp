@@ -0,0 +1,433 @@
+/**
+ * Stellar Data Recovery Pro Free - Batch Runner
+ *
+ * Argument and job file parsing, the read budget, JSON events and the
+ * job scheduler.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "batch_runner.h"
+#include "scan_scheduler.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            const std::pair<const char*, ScanMode> MODE_NAMES[] = {
+                {"quick", ScanMode::QUICK_SCAN},
+                {"deep", ScanMode::DEEP_SCAN},
+                {"raw", ScanMode::RAW_RECOVERY},
+                {"partition", ScanMode::PARTITION_RECOVERY}
+            };
+
+            const std::pair<const char*, TargetFileType> TYPE_NAMES[] = {
+                {"photo", TargetFileType::PHOTO},
+                {"video", TargetFileType::VIDEO},
+                {"audio", TargetFileType::AUDIO},
+                {"document", TargetFileType::DOCUMENT},
+                {"email", TargetFileType::EMAIL},
+                {"archive", TargetFileType::ARCHIVE},
+                {"all", TargetFileType::ALL_DATA}
+            };
+
+            std::string EventPrefix(const std::string& job, const char* event) {
+                return "{\"job\":" + Utils::JsonString(job) + ",\"event\":\"" + event + "\"";
+            }
+
+            bool ParseCount(const std::string& text, uint64_t& value) {
+                try {
+                    size_t used = 0;
+                    unsigned long long parsed = std::stoull(text, &used);
+                    value = parsed;
+                    return used == text.size();
+                } catch (const std::exception&) {
+                    return false;
+                }
+            }
+
+            // Split a job file line on spaces; double quotes group words
+            std::vector<std::string> SplitArguments(const std::string& line) {
+                std::vector<std::string> words;
+                std::string word;
+                bool quoted = false;
+                bool any = false;
+                for (char c : line) {
+                    if (c == '"') {
+                        quoted = !quoted;
+                        any = true;
+                    } else if (!quoted && (c == ' ' || c == '\t')) {
+                        if (any) {
+                            words.push_back(word);
+                        }
+                        word.clear();
+                        any = false;
+                    } else {
+                        word += c;
+                        any = true;
+                    }
+                }
+                if (any) {
+                    words.push_back(word);
+                }
+                return words;
+            }
+
+            /**
+             * Apply the job option at arguments[i] (consuming its value).
+             * Returns false with error set when it is not a valid job option.
+             */
+            bool ParseJobOption(const std::vector<std::string>& arguments, size_t& i, JobSpec& job, std::string& error) {
+                const std::string& name = arguments[i];
+                if (i + 1 >= arguments.size()) {
+                    error = name + " needs a value";
+                    return false;
+                }
+                const std::string& value = arguments[++i];
+                uint64_t number = 0;
+                if (name == "--id") {
+                    job.id = value;
+                } else if (name == "--source") {
+                    job.source = value;
+                } else if (name == "--output") {
+                    job.output = value;
+                } else if (name == "--image-dir") {
+                    job.imageDirectory = value;
+                } else if (name == "--mode") {
+                    auto it = std::find_if(std::begin(MODE_NAMES), std::end(MODE_NAMES),
+                                           [&](const auto& entry) { return value == entry.first; });
+                    if (it == std::end(MODE_NAMES)) {
+                        error = "Unknown mode " + value;
+                        return false;
+                    }
+                    job.mode = it->second;
+                } else if (name == "--types") {
+                    job.types.clear();
+                    std::istringstream list(value);
+                    std::string type;
+                    while (std::getline(list, type, ',')) {
+                        auto it = std::find_if(std::begin(TYPE_NAMES), std::end(TYPE_NAMES),
+                                               [&](const auto& entry) { return type == entry.first; });
+                        if (it == std::end(TYPE_NAMES)) {
+                            error = "Unknown file type " + type;
+                            return false;
+                        }
+                        if (it->second == TargetFileType::ALL_DATA) {
+                            job.types.clear();
+                            break;
+                        }
+                        job.types.push_back(it->second);
+                    }
+                } else if (name == "--workers" && ParseCount(value, number)) {
+                    job.workers = static_cast<size_t>(number);
+                } else if (name == "--memory" && ParseCount(value, number)) {
+                    job.memoryBudget = static_cast<size_t>(number) * 1024 * 1024;
+                } else if (name == "--queue-depth" && ParseCount(value, number)) {
+                    job.queueDepth = static_cast<size_t>(number);
+                } else if (name == "--chunk-size" && ParseCount(value, number)) {
+                    job.chunkSize = static_cast<size_t>(number) * 1024 * 1024;
+                } else {
+                    error = "Invalid option " + name + " " + value;
+                    return false;
+                }
+                return true;
+            }
+
+            bool LoadJobFile(const std::string& path, std::vector<JobSpec>& jobs, std::string& error) {
+                std::ifstream in(path);
+                if (!in) {
+                    error = "Cannot read job file " + path;
+                    return false;
+                }
+                std::string line;
+                for (size_t number = 1; std::getline(in, line); number++) {
+                    if (!line.empty() && line.back() == '\r') {
+                        line.pop_back();
+                    }
+                    std::vector<std::string> words = SplitArguments(line);
+                    if (words.empty() || words[0][0] == '#') {
+                        continue;
+                    }
+                    JobSpec job;
+                    for (size_t i = 0; i < words.size(); i++) {
+                        if (!ParseJobOption(words, i, job, error)) {
+                            error = path + ":" + std::to_string(number) + ": " + error;
+                            return false;
+                        }
+                    }
+                    if (job.id.empty()) {
+                        job.id = "job" + std::to_string(number);
+                    }
+                    jobs.push_back(job);
+                }
+                return true;
+            }
+
+        } // namespace
+
+        std::string ScanModeName(ScanMode mode) {
+            for (const auto& entry : MODE_NAMES) {
+                if (entry.second == mode) {
+                    return entry.first;
+                }
+            }
+            return "custom";
+        }
+
+        std::string TargetFileTypeName(TargetFileType type) {
+            for (const auto& entry : TYPE_NAMES) {
+                if (entry.second == type) {
+                    return entry.first;
+                }
+            }
+            return "other";
+        }
+
+        const char* BatchUsage() {
+            return "Usage: stellar_recovery [job options] [batch options]\n"
+                   "       stellar_recovery --jobs-file FILE [batch options]\n"
+                   "\n"
+                   "Job options (also one job per line of a job file):\n"
+                   "  --source PATH        Drive letter, device or disk image\n"
+                   "  --mode MODE          quick, deep, raw or partition (default quick)\n"
+                   "  --types LIST         Comma-separated: photo, video, audio, document,\n"
+                   "                       email, archive or all (default all)\n"
+                   "  --output DIR         Recover the files found into DIR; omit to scan only\n"
+                   "  --image-dir DIR      Image the source into DIR before a deep scan\n"
+                   "  --workers N          Scan threads for this job\n"
+                   "  --memory MIB         Recovery buffer budget for this job\n"
+                   "  --queue-depth N      Reads kept in flight (default 32, or 2 on rotating disks)\n"
+                   "  --chunk-size MIB     Bytes per read, 1-64 (default 1, or 8 on rotating disks)\n"
+                   "  --id NAME            Job name used in events\n"
+                   "\n"
+                   "Batch options:\n"
+                   "  --jobs-file FILE     Run the jobs listed in FILE\n"
+                   "  --parallel N         Jobs run at once (default 1)\n"
+                   "  --threads N          Scan threads shared by running jobs (default: all cores)\n"
+                   "  --io-limit MIB       Read budget of the whole batch in MiB/s (default unlimited)\n"
+                   "  --metrics FILE       Write batch metrics to FILE: Prometheus text format,\n"
+                   "                       or JSON lines when FILE ends in .jsonl\n"
+                   "  --metrics-interval MS  Milliseconds between metrics samples (default 1000)\n"
+                   "\n"
+                   "Progress and messages are written to standard output as JSON lines.\n"
+                   "The exit code is 0 when every job succeeded, 1 when one failed and\n"
+                   "2 on a usage error.\n";
+        }
+
+        bool ParseBatchCommandLine(const std::vector<std::string>& arguments, BatchOptions& options,
+                                   std::vector<JobSpec>& jobs, std::string& error) {
+            JobSpec job;
+            bool commandLineJob = false;
+            for (size_t i = 0; i < arguments.size(); i++) {
+                const std::string& name = arguments[i];
+                uint64_t number = 0;
+                if (name == "--jobs-file" || name == "--parallel" || name == "--threads" || name == "--io-limit" ||
+                    name == "--metrics" || name == "--metrics-interval") {
+                    if (i + 1 >= arguments.size()) {
+                        error = name + " needs a value";
+                        return false;
+                    }
+                    const std::string& value = arguments[++i];
+                    if (name == "--jobs-file") {
+                        if (!LoadJobFile(value, jobs, error)) {
+                            return false;
+                        }
+                    } else if (name == "--metrics") {
+                        options.metricsPath = value;
+                    } else if (!ParseCount(value, number)) {
+                        error = "Invalid option " + name + " " + value;
+                        return false;
+                    } else if (name == "--parallel") {
+                        options.parallelJobs = std::max<size_t>(static_cast<size_t>(number), 1);
+                    } else if (name == "--threads") {
+                        options.threads = static_cast<size_t>(number);
+                    } else if (name == "--metrics-interval") {
+                        options.metricsInterval = static_cast<uint32_t>(std::max<uint64_t>(number, 1));
+                    } else {
+                        options.readBytesPerSecond = number * 1024 * 1024;
+                    }
+                } else if (!ParseJobOption(arguments, i, job, error)) {
+                    return false;
+                } else {
+                    commandLineJob = true;
+                }
+            }
+            if (commandLineJob) {
+                if (job.id.empty()) {
+                    job.id = "job" + std::to_string(jobs.size() + 1);
+                }
+                jobs.push_back(job);
+            }
+            if (jobs.empty()) {
+                error = "No job given";
+                return false;
+            }
+            for (const JobSpec& spec : jobs) {
+                if (spec.source.empty()) {
+                    error = "Job " + spec.id + " has no --source";
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        IoBudget::IoBudget(uint64_t bytesPerSecond) :
+            rate(bytesPerSecond),
+            tokens(static_cast<double>(bytesPerSecond)),
+            refilled(std::chrono::steady_clock::now()) {}
+
+        void IoBudget::Acquire(uint64_t bytes) {
+            if (rate == 0 || bytes == 0) {
+                return;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            // Go into debt and sleep it off, so reads larger than the burst still pass
+            auto now = std::chrono::steady_clock::now();
+            tokens = std::min(tokens + std::chrono::duration<double>(now - refilled).count() * rate,
+                              static_cast<double>(rate));
+            refilled = now;
+            tokens -= static_cast<double>(bytes);
+            if (tokens >= 0) {
+                return;
+            }
+            auto wait = std::chrono::duration<double>(-tokens / rate);
+            lock.unlock();
+            std::this_thread::sleep_for(wait);
+        }
+
+        size_t BudgetedSource::ReadAt(uint64_t offset, void* buffer, size_t length) {
+            budget.Acquire(length);
+            return inner->ReadAt(offset, buffer, length);
+        }
+
+        void BudgetedSource::Admit(size_t length) {
+            budget.Acquire(length);
+            inner->Admit(length);
+        }
+
+        const uint8_t* BudgetedSource::View(uint64_t offset, size_t length) {
+            // A view is read lazily and often only in part, so it cannot be charged up front;
+            // with a limit every byte goes through ReadAt and is charged as it is read
+            return budget.Limited() ? nullptr : inner->View(offset, length);
+        }
+
+        void JobEventWriter::Write(const std::string& line) {
+            std::lock_guard<std::mutex> lock(mutex);
+            out << line << '\n';
+            out.flush();
+        }
+
+        void JobEventWriter::Progress(const std::string& job, int percentage, const std::string& operation) {
+            Write(EventPrefix(job, "progress") + ",\"percent\":" + std::to_string(percentage) +
+                  ",\"operation\":" + Utils::JsonString(operation) + "}");
+        }
+
+        void JobEventWriter::Log(const std::string& job, const std::string& stream, const std::string& text) {
+            Write(EventPrefix(job, "log") + ",\"stream\":" + Utils::JsonString(stream) + ",\"text\":" + Utils::JsonString(text) + "}");
+        }
+
+        void JobEventWriter::Started(const std::string& job, const JobSpec& spec, size_t workers) {
+            std::string types;
+            for (TargetFileType type : spec.types) {
+                types += (types.empty() ? "" : ",") + Utils::JsonString(TargetFileTypeName(type));
+            }
+            Write(EventPrefix(job, "started") + ",\"source\":" + Utils::JsonString(spec.source) +
+                  ",\"mode\":" + Utils::JsonString(ScanModeName(spec.mode)) + ",\"types\":[" + types + "]" +
+                  ",\"output\":" + Utils::JsonString(spec.output) + ",\"workers\":" + std::to_string(workers) + "}");
+        }
+
+        void JobEventWriter::Finished(const std::string& job, int exitCode, double seconds) {
+            char elapsed[32];
+            std::snprintf(elapsed, sizeof(elapsed), "%.3f", seconds);
+            Write(EventPrefix(job, "finished") + ",\"exitCode\":" + std::to_string(exitCode) +
+                  ",\"seconds\":" + elapsed + "}");
+        }
+
+        JobLogBuffer::~JobLogBuffer() {
+            Flush();
+        }
+
+        JobLogBuffer::int_type JobLogBuffer::overflow(int_type c) {
+            if (traits_type::eq_int_type(c, traits_type::eof())) {
+                return traits_type::not_eof(c);
+            }
+            char ch = traits_type::to_char_type(c);
+            if (ch == '\n') {
+                Flush();
+            } else if (ch != '\r') {
+                line += ch;
+            }
+            return c;
+        }
+
+        int JobLogBuffer::sync() {
+            // std::flush and std::endl land here; only whole lines become events
+            return 0;
+        }
+
+        void JobLogBuffer::Flush() {
+            if (!line.empty()) {
+                writer.Log(job, stream, line);
+                line.clear();
+            }
+        }
+
+        size_t RunBatch(const std::vector<JobSpec>& jobs, const BatchOptions& options, JobEventWriter& events,
+                        const JobFunction& run) {
+            const size_t running = std::max<size_t>(std::min(options.parallelJobs, jobs.size()), 1);
+            const size_t threads = options.threads ? options.threads : GetDefaultWorkerCount();
+            const size_t share = std::max<size_t>(threads / running, 1);
+
+            std::mutex mutex;
+            size_t next = 0;
+            size_t failed = 0;
+            auto worker = [&] {
+                while (true) {
+                    size_t index;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (next == jobs.size()) {
+                            return;
+                        }
+                        index = next++;
+                    }
+                    const JobSpec& job = jobs[index];
+                    const size_t workers = job.workers ? job.workers : share;
+                    const auto started = std::chrono::steady_clock::now();
+                    events.Started(job.id, job, workers);
+                    int exitCode = 1;
+                    try {
+                        exitCode = run(job, workers);
+                    } catch (const std::exception& e) {
+                        events.Log(job.id, "stderr", e.what());
+                    }
+                    events.Finished(job.id, exitCode,
+                                    std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+                    if (exitCode != 0) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        failed++;
+                    }
+                }
+            };
+
+            std::vector<std::thread> pool;
+            for (size_t i = 1; i < running; i++) {
+                pool.emplace_back(worker);
+            }
+            worker();
+            for (std::thread& thread : pool) {
+                thread.join();
+            }
+            return failed;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
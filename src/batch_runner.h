@@ -0,0 +1,176 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Batch Runner
+ *
+ * Unattended operation: jobs come from the command line or a job file,
+ * several run at once under a shared thread and read-bandwidth budget,
+ * and all output is written as JSON lines so a supervisor can follow
+ * progress without scraping text.
+ *
+ * Job file: one job per line, using the job options of the command
+ * line. Blank lines and lines starting with '#' are ignored.
+ *
+ *   --source D: --mode deep --types photo,video --output E:\Recovered
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_BATCH_RUNNER_H
+#define STELLAR_BATCH_RUNNER_H
+
+#include "stellar_recovery.h"
+#include "sector_reader.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        struct JobSpec {
+            std::string id;                         // Defaults to job<line or position>
+            std::string source;                     // Drive letter, device or image file
+            ScanMode mode;
+            std::vector<TargetFileType> types;      // Empty = all data
+            std::string output;                     // Recovery directory; empty = scan only
+            std::string imageDirectory;             // Image the source here before a deep scan
+            size_t workers;                         // 0 = share of the batch thread budget
+            size_t memoryBudget;                    // Recovery stage bytes; 0 = default
+            size_t queueDepth;                      // Streaming reads in flight; 0 = by device
+            size_t chunkSize;                       // Streaming read bytes; 0 = by device
+
+            JobSpec() : mode(ScanMode::QUICK_SCAN), workers(0), memoryBudget(0), queueDepth(0), chunkSize(0) {}
+        };
+
+        struct BatchOptions {
+            size_t parallelJobs;                    // Jobs run at once
+            size_t threads;                         // Worker threads shared by running jobs; 0 = logical processors
+            uint64_t readBytesPerSecond;            // Read budget shared by all jobs; 0 = unlimited
+            std::string metricsPath;                // Prometheus text file, or JSON lines for .jsonl; empty = none
+            uint32_t metricsInterval;               // Milliseconds between metrics samples
+
+            BatchOptions() : parallelJobs(1), threads(0), readBytesPerSecond(0), metricsInterval(1000) {}
+        };
+
+        /**
+         * Parse the command line (argv[0] excluded) into batch options and
+         * jobs, loading --jobs-file if given. Returns false with error set
+         * on a usage error.
+         */
+        bool ParseBatchCommandLine(const std::vector<std::string>& arguments, BatchOptions& options,
+                                   std::vector<JobSpec>& jobs, std::string& error);
+
+        // Command line help text
+        const char* BatchUsage();
+
+        /**
+         * Token bucket shared by every source of a batch. Acquire blocks
+         * until the bytes fit the rate; bursts up to one second of budget.
+         */
+        class IoBudget {
+        public:
+            explicit IoBudget(uint64_t bytesPerSecond);
+
+            void Acquire(uint64_t bytes);
+            bool Limited() const { return rate != 0; }
+
+        private:
+            uint64_t rate;
+            double tokens;
+            std::chrono::steady_clock::time_point refilled;
+            std::mutex mutex;
+        };
+
+        /**
+         * Source whose reads are charged to an IoBudget. Views are offered
+         * only while the budget is unlimited.
+         */
+        class BudgetedSource : public SectorSource {
+        public:
+            BudgetedSource(std::unique_ptr<SectorSource> inner, IoBudget& budget) :
+                inner(std::move(inner)), budget(budget) {}
+
+            const std::string& Path() const override { return inner->Path(); }
+            uint64_t Size() const override { return inner->Size(); }
+            uint32_t SectorSize() const override { return inner->SectorSize(); }
+            size_t ReadAt(uint64_t offset, void* buffer, size_t length) override;
+            const uint8_t* View(uint64_t offset, size_t length) override;
+            bool IncursSeekPenalty() const override { return inner->IncursSeekPenalty(); }
+            SectorSource* Passthrough() override { return inner.get(); }
+            void Admit(size_t length) override;
+
+        private:
+            std::unique_ptr<SectorSource> inner;
+            IoBudget& budget;
+        };
+
+        /**
+         * Thread-safe JSON lines writer. Every event carries the job id
+         * and the event name; one line is written whole or not at all.
+         */
+        class JobEventWriter {
+        public:
+            explicit JobEventWriter(std::ostream& out) : out(out) {}
+
+            void Progress(const std::string& job, int percentage, const std::string& operation);
+            void Log(const std::string& job, const std::string& stream, const std::string& text);
+            void Started(const std::string& job, const JobSpec& spec, size_t workers);
+            void Finished(const std::string& job, int exitCode, double seconds);
+
+        private:
+            void Write(const std::string& line);
+
+            std::ostream& out;
+            std::mutex mutex;
+        };
+
+        /**
+         * Stream buffer that turns each complete line written to it into
+         * a log event of one job
+         */
+        class JobLogBuffer : public std::streambuf {
+        public:
+            JobLogBuffer(JobEventWriter& writer, const std::string& job, const std::string& stream) :
+                writer(writer), job(job), stream(stream) {}
+            ~JobLogBuffer() override;
+
+        protected:
+            int_type overflow(int_type c) override;
+            int sync() override;
+
+        private:
+            void Flush();
+
+            JobEventWriter& writer;
+            std::string job;
+            std::string stream;
+            std::string line;
+        };
+
+        // Runs one job with the given worker count; returns its exit code (0 = success)
+        using JobFunction = std::function<int(const JobSpec& job, size_t workers)>;
+
+        /**
+         * Run jobs, up to options.parallelJobs at a time, each on its own
+         * thread. Exceptions escaping a job count as exit code 1.
+         * Returns the number of jobs that did not succeed.
+         */
+        size_t RunBatch(const std::vector<JobSpec>& jobs, const BatchOptions& options, JobEventWriter& events,
+                        const JobFunction& run);
+
+        std::string ScanModeName(ScanMode mode);
+        std::string TargetFileTypeName(TargetFileType type);
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_BATCH_RUNNER_H
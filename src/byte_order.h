@@ -0,0 +1,72 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Byte Order Helpers
+ *
+ * Little-endian readers for on-disk structures, writers for the
+ * checkpoint and dedup index records, and the big-endian reader the
+ * jbd2 journal needs.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_BYTE_ORDER_H
+#define STELLAR_BYTE_ORDER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        // On-disk structures are little-endian, as are all supported hosts
+        inline uint16_t ReadLE16(const uint8_t* data) {
+            uint16_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        inline uint32_t ReadLE32(const uint8_t* data) {
+            uint32_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        inline uint64_t ReadLE64(const uint8_t* data) {
+            uint64_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        // Writers for the little-endian records of checkpoints and the dedup index
+        inline void PutLE32(std::vector<uint8_t>& out, uint32_t value) {
+            for (int i = 0; i < 4; i++) {
+                out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+            }
+        }
+
+        inline void PutLE64(std::vector<uint8_t>& out, uint64_t value) {
+            for (int i = 0; i < 8; i++) {
+                out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+            }
+        }
+
+        // u32 length, then the bytes
+        inline void PutString(std::vector<uint8_t>& out, const std::string& value) {
+            PutLE32(out, static_cast<uint32_t>(value.size()));
+            out.insert(out.end(), value.begin(), value.end());
+        }
+
+        // Big-endian reader for the jbd2 journal
+        inline uint32_t ReadBE32(const uint8_t* data) {
+            return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+                   (static_cast<uint32_t>(data[2]) << 8) | data[3];
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_BYTE_ORDER_H
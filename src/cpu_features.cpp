@@ -0,0 +1,88 @@
+/**
+ * Stellar Data Recovery Pro Free - CPU Feature Detection
+ *
+ * CPUID/XGETBV based detection for MSVC, GCC and Clang.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "cpu_features.h"
+#include <cstdint>
+
+#ifdef STELLAR_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+#ifdef STELLAR_X86
+            void QueryCpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#ifdef _MSC_VER
+                int info[4];
+                __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+                for (int i = 0; i < 4; i++) {
+                    regs[i] = static_cast<uint32_t>(info[i]);
+                }
+#else
+                __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+            }
+
+            uint64_t ReadXcr0() {
+#ifdef _MSC_VER
+                return _xgetbv(0);
+#else
+                uint32_t eax, edx;
+                __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+                return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+            }
+#endif
+
+            CpuFeatures Detect() {
+                CpuFeatures features;
+#ifdef STELLAR_X86
+                uint32_t regs[4];
+                QueryCpuid(0, 0, regs);
+                uint32_t maxLeaf = regs[0];
+
+                QueryCpuid(1, 0, regs);
+                features.sse2 = (regs[3] & (1u << 26)) != 0;
+                features.ssse3 = (regs[2] & (1u << 9)) != 0;
+                features.sse42 = (regs[2] & (1u << 20)) != 0;
+
+                // AVX state must be enabled by the OS before AVX2/AVX-512 can be used
+                bool osxsave = (regs[2] & (1u << 27)) != 0;
+                uint64_t xcr0 = osxsave ? ReadXcr0() : 0;
+                bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+                bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+
+                if (maxLeaf >= 7) {
+                    QueryCpuid(7, 0, regs);
+                    features.avx2 = ymmEnabled && (regs[1] & (1u << 5)) != 0;
+                    features.avx512f = zmmEnabled && (regs[1] & (1u << 16)) != 0;
+                    features.avx512bw = zmmEnabled && (regs[1] & (1u << 30)) != 0;
+                    features.shaNi = (regs[1] & (1u << 29)) != 0;
+                }
+#endif
+                return features;
+            }
+
+        } // namespace
+
+        const CpuFeatures& GetCpuFeatures() {
+            static const CpuFeatures features = Detect();
+            return features;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
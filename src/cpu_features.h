@@ -0,0 +1,57 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - CPU Feature Detection
+ *
+ * Runtime detection of the instruction set extensions used by the
+ * SIMD scan kernels.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_CPU_FEATURES_H
+#define STELLAR_CPU_FEATURES_H
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define STELLAR_X86 1
+#endif
+
+// Per-function ISA targeting so kernels build without global -m flags
+#if defined(STELLAR_X86) && (defined(__GNUC__) || defined(__clang__))
+#define STELLAR_TARGET(isa) __attribute__((target(isa)))
+#else
+#define STELLAR_TARGET(isa)
+#endif
+
+namespace Stellar {
+    namespace Recovery {
+
+        struct CpuFeatures {
+            bool sse2;
+            bool ssse3;
+            bool sse42;
+            bool avx2;
+            bool avx512f;
+            bool avx512bw;
+            bool shaNi;
+
+            CpuFeatures() :
+                sse2(false),
+                ssse3(false),
+                sse42(false),
+                avx2(false),
+                avx512f(false),
+                avx512bw(false),
+                shaNi(false) {}
+        };
+
+        /**
+         * Features of the executing CPU (detected once, OS support included)
+         */
+        const CpuFeatures& GetCpuFeatures();
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_CPU_FEATURES_H
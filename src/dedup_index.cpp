@@ -0,0 +1,321 @@
+/**
+ * Stellar Data Recovery Pro Free - Duplicate Detection
+ *
+ * Index file encoding and the size, sample and digest passes.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "dedup_index.h"
+#include "file_hasher.h"
+#include "byte_order.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            constexpr char DEDUP_MAGIC[8] = {'S', 'T', 'L', 'R', 'D', 'U', 'P', '\0'};
+            constexpr uint32_t DEDUP_VERSION = 1;
+            constexpr const char* DEDUP_FILE = "recovered.dedup";
+
+            constexpr size_t HEADER_BYTES = sizeof(DEDUP_MAGIC) + 4;
+            constexpr size_t RECORD_HEADER = 8;    // u32 length, u32 CRC32C of the payload
+            constexpr size_t HASH_CHUNK = 1024 * 1024;
+
+            std::string EntryKey(uint64_t size, const std::string& digest) {
+                return std::to_string(size) + ":" + digest;
+            }
+
+            // Length-prefixed string at data[position]; false when it runs past end
+            bool GetString(const uint8_t* data, size_t end, size_t& position, std::string& value) {
+                if (end - position < 4) {
+                    return false;
+                }
+                uint32_t length = ReadLE32(data + position);
+                position += 4;
+                if (end - position < length) {
+                    return false;
+                }
+                value.assign(reinterpret_cast<const char*>(data + position), length);
+                position += length;
+                return true;
+            }
+
+        } // namespace
+
+        DedupIndex::DedupIndex(const std::string& path) : path(path) {
+            Load();
+        }
+
+        void DedupIndex::Load() {
+            std::ifstream in(std::filesystem::u8path(path), std::ios::binary);
+            if (!in) {
+                return;
+            }
+            std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            if (data.size() < HEADER_BYTES || std::memcmp(data.data(), DEDUP_MAGIC, sizeof(DEDUP_MAGIC)) != 0 ||
+                ReadLE32(data.data() + sizeof(DEDUP_MAGIC)) != DEDUP_VERSION) {
+                return;
+            }
+
+            // Replay records up to the first torn or corrupt one
+            size_t position = HEADER_BYTES;
+            size_t valid = position;
+            while (data.size() - position >= RECORD_HEADER) {
+                uint32_t length = ReadLE32(data.data() + position);
+                uint32_t checksum = ReadLE32(data.data() + position + 4);
+                size_t start = position + RECORD_HEADER;
+                if (data.size() - start < length || length < 8 || Crc32c(data.data() + start, length) != checksum) {
+                    break;
+                }
+                const size_t end = start + length;
+                size_t cursor = start + 8;
+                std::string digest, recovered;
+                if (!GetString(data.data(), end, cursor, digest) || !GetString(data.data(), end, cursor, recovered)) {
+                    break;
+                }
+                uint64_t size = ReadLE64(data.data() + start);
+                entries[EntryKey(size, digest)] = recovered;
+                sizes.insert(size);
+                position = end;
+                valid = position;
+            }
+            if (valid < data.size()) {
+                std::error_code error;
+                std::filesystem::resize_file(std::filesystem::u8path(path), valid, error);
+            }
+        }
+
+        const std::string* DedupIndex::Find(uint64_t size, const std::string& digest) const {
+            auto found = entries.find(EntryKey(size, digest));
+            return found == entries.end() ? nullptr : &found->second;
+        }
+
+        void DedupIndex::Add(uint64_t size, const std::string& digest, const std::string& recovered) {
+            std::string key = EntryKey(size, digest);
+            auto found = entries.find(key);
+            if (found != entries.end() && found->second == recovered) {
+                return;
+            }
+            entries[key] = recovered;
+            sizes.insert(size);
+
+            std::vector<uint8_t> payload;
+            PutLE64(payload, size);
+            PutString(payload, digest);
+            PutString(payload, recovered);
+            PutLE32(pending, static_cast<uint32_t>(payload.size()));
+            PutLE32(pending, Crc32c(payload.data(), payload.size()));
+            pending.insert(pending.end(), payload.begin(), payload.end());
+        }
+
+        bool DedupIndex::Save() {
+            if (pending.empty()) {
+                return true;
+            }
+            std::error_code error;
+            std::filesystem::path location = std::filesystem::u8path(path);
+            if (location.has_parent_path()) {
+                std::filesystem::create_directories(location.parent_path(), error);
+            }
+            const bool fresh = !std::filesystem::exists(location, error) || std::filesystem::file_size(location, error) == 0;
+            std::ofstream out(location, std::ios::binary | std::ios::app);
+            if (fresh) {
+                std::vector<uint8_t> header(DEDUP_MAGIC, DEDUP_MAGIC + sizeof(DEDUP_MAGIC));
+                PutLE32(header, DEDUP_VERSION);
+                out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+            }
+            out.write(reinterpret_cast<const char*>(pending.data()), static_cast<std::streamsize>(pending.size()));
+            out.close();
+            if (!out) {
+                return false;
+            }
+            pending.clear();
+            return true;
+        }
+
+        std::string DedupIndexPath(const std::string& directory) {
+            return (std::filesystem::u8path(directory) / DEDUP_FILE).u8string();
+        }
+
+        DuplicateFinder::DuplicateFinder(SectorSource& source, const DedupIndex& index, const DedupOptions& options) :
+            source(source), index(index), options(options), pool(options.workers) {
+            this->options.sampleLength = std::max<size_t>(this->options.sampleLength, 1);
+        }
+
+        std::vector<DuplicateMatch> DuplicateFinder::Find(const std::vector<RecoveryItem>& items,
+                                                          const ProgressCallback& progress) {
+            stats = DedupStats();
+            stats.files = items.size();
+            std::vector<DuplicateMatch> matches(items.size());
+
+            // Sizes no other file has are unique without reading anything
+            std::unordered_map<uint64_t, size_t> sizeCounts;
+            for (const auto& item : items) {
+                sizeCounts[item.fileSize]++;
+            }
+            std::vector<size_t> sampled;
+            for (size_t i = 0; i < items.size(); i++) {
+                const uint64_t size = items[i].fileSize;
+                if (size > 0 && (sizeCounts[size] > 1 || index.HasSize(size))) {
+                    sampled.push_back(i);
+                }
+            }
+
+            std::vector<std::vector<uint8_t>> buffers(pool.WorkerCount());
+            std::atomic<uint64_t> bytesRead(0);
+            std::atomic<size_t> done(0);
+            auto runAll = [&](const std::vector<size_t>& work, const char* operation,
+                              const std::function<void(size_t item, std::vector<uint8_t>& buffer, uint64_t& read)>& task) {
+                done = 0;
+                for (size_t n = 0; n < work.size(); n++) {
+                    pool.Submit(n, [&, n](size_t worker) {
+                        uint64_t read = 0;
+                        try {
+                            task(work[n], buffers[worker], read);
+                        } catch (const SectorReadError&) {
+                            // Unreadable items stay unique
+                        }
+                        bytesRead += read;
+                        done++;
+                    });
+                }
+                while (!pool.WaitIdleFor(std::chrono::milliseconds(100))) {
+                    if (progress && !work.empty()) {
+                        progress(static_cast<int>(done.load() * 100 / work.size()), operation);
+                    }
+                }
+            };
+
+            // Head, middle and tail samples split the shared sizes
+            std::vector<uint32_t> samples(items.size(), 0);
+            std::vector<uint8_t> sampleValid(items.size(), 0);
+            runAll(sampled, "Comparing files...", [&](size_t item, std::vector<uint8_t>& buffer, uint64_t& read) {
+                samples[item] = Sample(items[item], buffer, read);
+                sampleValid[item] = 1;
+            });
+
+            std::unordered_map<std::string, size_t> sampleCounts;
+            auto sampleKey = [&](size_t item) {
+                return std::to_string(items[item].fileSize) + ":" + std::to_string(samples[item]);
+            };
+            for (size_t item : sampled) {
+                if (sampleValid[item]) {
+                    sampleCounts[sampleKey(item)]++;
+                }
+            }
+            std::vector<size_t> hashed;
+            for (size_t item : sampled) {
+                if (sampleValid[item] && (sampleCounts[sampleKey(item)] > 1 || index.HasSize(items[item].fileSize))) {
+                    hashed.push_back(item);
+                }
+            }
+
+            // Whatever still collides is settled by its full digest
+            runAll(hashed, "Hashing duplicate candidates...", [&](size_t item, std::vector<uint8_t>& buffer, uint64_t& read) {
+                matches[item].digest = Digest(items[item], buffer, read);
+            });
+
+            std::unordered_map<std::string, size_t> firstCopy;
+            for (size_t item : hashed) {
+                DuplicateMatch& match = matches[item];
+                if (match.digest.empty()) {
+                    continue;
+                }
+                const uint64_t size = items[item].fileSize;
+                std::error_code error;
+                const std::string* existing = index.Find(size, match.digest);
+                if (existing && std::filesystem::exists(std::filesystem::u8path(*existing), error)) {
+                    match.existingPath = *existing;
+                } else {
+                    auto inserted = firstCopy.emplace(EntryKey(size, match.digest), item);
+                    if (!inserted.second) {
+                        match.original = inserted.first->second;
+                    }
+                }
+                if (match.IsDuplicate()) {
+                    stats.duplicates++;
+                    stats.bytesSaved += size;
+                }
+            }
+
+            stats.sampled = sampled.size();
+            stats.hashed = hashed.size();
+            stats.bytesRead = bytesRead.load();
+            return matches;
+        }
+
+        uint32_t DuplicateFinder::Sample(const RecoveryItem& item, std::vector<uint8_t>& buffer, uint64_t& bytesRead) {
+            const uint64_t size = item.fileSize;
+            if (size <= 3 * options.sampleLength) {
+                buffer.resize(static_cast<size_t>(size));
+                Read(item, 0, buffer.size(), buffer.data(), bytesRead);
+                return Crc32c(buffer.data(), buffer.size());
+            }
+            const size_t length = options.sampleLength;
+            const uint64_t starts[3] = {0, (size - length) / 2, size - length};
+            buffer.resize(length);
+            uint32_t crc = 0;
+            for (uint64_t start : starts) {
+                Read(item, start, length, buffer.data(), bytesRead);
+                crc = Crc32c(buffer.data(), length, crc);
+            }
+            return crc;
+        }
+
+        std::string DuplicateFinder::Digest(const RecoveryItem& item, std::vector<uint8_t>& buffer, uint64_t& bytesRead) {
+            FileHasher hasher(HashAlgorithm::SHA256);
+            buffer.resize(static_cast<size_t>(std::min<uint64_t>(item.fileSize, HASH_CHUNK)));
+            for (uint64_t offset = 0; offset < item.fileSize;) {
+                const size_t length = static_cast<size_t>(std::min<uint64_t>(HASH_CHUNK, item.fileSize - offset));
+                Read(item, offset, length, buffer.data(), bytesRead);
+                hasher.Update(buffer.data(), length);
+                offset += length;
+            }
+            return hasher.Final();
+        }
+
+        void DuplicateFinder::Read(const RecoveryItem& item, uint64_t offset, size_t length, uint8_t* out,
+                                   uint64_t& bytesRead) {
+            // Same layout rules as recovery: holes and bytes past the data read as zeros
+            std::memset(out, 0, length);
+            if (item.extents.empty()) {
+                if (offset < item.inlineData.size()) {
+                    size_t count = static_cast<size_t>(std::min<uint64_t>(length, item.inlineData.size() - offset));
+                    std::memcpy(out, item.inlineData.data() + offset, count);
+                }
+                return;
+            }
+            const uint64_t end = offset + length;
+            uint64_t position = 0;
+            for (const auto& extent : item.extents) {
+                if (position >= end) {
+                    break;
+                }
+                const uint64_t extentEnd = position + extent.length;
+                if (extentEnd > offset && extent.offset != SPARSE_EXTENT) {
+                    const uint64_t from = std::max(position, offset);
+                    const size_t count = static_cast<size_t>(std::min(extentEnd, end) - from);
+                    const uint64_t physical = extent.offset + (from - position);
+                    if (const uint8_t* view = source.View(physical, count)) {
+                        std::memcpy(out + (from - offset), view, count);
+                    } else if (source.ReadAt(physical, out + (from - offset), count) < count) {
+                        throw SectorReadError("short read", physical);
+                    }
+                    bytesRead += count;
+                }
+                position = extentEnd;
+            }
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
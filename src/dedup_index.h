@@ -0,0 +1,145 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Duplicate Detection
+ *
+ * Deep and raw scans report the same content many times (shadow copies,
+ * MFT records plus carving, repeated camera dumps). Before recovery the
+ * batch is narrowed in three steps: sizes shared by no other file are
+ * unique outright, CRC32C samples of the head, middle and tail split
+ * the rest, and only files that still collide are hashed in full with
+ * SHA-256. Files recovered earlier are remembered in a per-user index
+ * shared by every session, so a later scan does not write them again.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_DEDUP_INDEX_H
+#define STELLAR_DEDUP_INDEX_H
+
+#include "stellar_recovery.h"
+#include "sector_reader.h"
+#include "recovery_pipeline.h"
+#include "scan_scheduler.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        /**
+         * On-disk set of recovered files keyed by size and SHA-256. Records
+         * are appended and checksummed, so a torn tail is dropped on load.
+         * Not thread-safe.
+         */
+        class DedupIndex {
+        public:
+            /**
+             * Load path if it exists; a missing or foreign file starts empty.
+             * A torn tail is cut off, so users of one file must not load it
+             * while another is in Save().
+             */
+            explicit DedupIndex(const std::string& path);
+
+            const std::string& Path() const { return path; }
+            size_t Count() const { return entries.size(); }
+
+            bool HasSize(uint64_t size) const { return sizes.count(size) != 0; }
+
+            // Where a file with this content was recovered, or nullptr
+            const std::string* Find(uint64_t size, const std::string& digest) const;
+
+            // Remember a recovered file; kept in memory until Save()
+            void Add(uint64_t size, const std::string& digest, const std::string& path);
+
+            // Append the records added since loading. Returns false on failure.
+            bool Save();
+
+        private:
+            void Load();
+
+            std::string path;
+            std::unordered_map<std::string, std::string> entries;   // Size and digest -> recovered path
+            std::unordered_set<uint64_t> sizes;
+            std::vector<uint8_t> pending;
+        };
+
+        // Shared index inside the session directory
+        std::string DedupIndexPath(const std::string& directory);
+
+        /**
+         * How one item relates to the rest of the batch. An item is a
+         * duplicate of an earlier item of the batch (original) or of a file
+         * recovered in an earlier session (existingPath), never both.
+         */
+        struct DuplicateMatch {
+            static constexpr size_t NONE = SIZE_MAX;
+
+            size_t original;
+            std::string existingPath;
+            std::string digest;                 // SHA-256 hex; empty unless the file was hashed in full
+
+            DuplicateMatch() : original(NONE) {}
+
+            bool IsDuplicate() const { return original != NONE || !existingPath.empty(); }
+        };
+
+        struct DedupOptions {
+            size_t sampleLength;                // Bytes taken from each of head, middle and tail
+            size_t workers;                     // 0 = GetDefaultWorkerCount()
+
+            DedupOptions() :
+                sampleLength(4096),
+                workers(0) {}
+        };
+
+        struct DedupStats {
+            uint64_t files;
+            uint64_t sampled;                   // Files whose size was shared
+            uint64_t hashed;                    // Files whose sample was shared too
+            uint64_t duplicates;
+            uint64_t bytesRead;
+            uint64_t bytesSaved;                // Data of duplicates that will not be written
+
+            DedupStats() : files(0), sampled(0), hashed(0), duplicates(0), bytesRead(0), bytesSaved(0) {}
+        };
+
+        /**
+         * Finds duplicate items of a recovery batch
+         */
+        class DuplicateFinder {
+        public:
+            DuplicateFinder(SectorSource& source, const DedupIndex& index,
+                            const DedupOptions& options = DedupOptions());
+
+            /**
+             * One match per item, in order. The first copy of each content
+             * is kept. Items that cannot be read are treated as unique.
+             * progress is called from the calling thread.
+             */
+            std::vector<DuplicateMatch> Find(const std::vector<RecoveryItem>& items,
+                                             const ProgressCallback& progress = ProgressCallback());
+
+            const DedupStats& Stats() const { return stats; }
+
+        private:
+            uint32_t Sample(const RecoveryItem& item, std::vector<uint8_t>& buffer, uint64_t& bytesRead);
+            std::string Digest(const RecoveryItem& item, std::vector<uint8_t>& buffer, uint64_t& bytesRead);
+            void Read(const RecoveryItem& item, uint64_t offset, size_t length, uint8_t* out, uint64_t& bytesRead);
+
+            SectorSource& source;
+            const DedupIndex& index;
+            DedupOptions options;
+            WorkStealingPool pool;
+            DedupStats stats;
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_DEDUP_INDEX_H
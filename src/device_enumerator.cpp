@@ -0,0 +1,381 @@
+/**
+ * Stellar Data Recovery Pro Free - Device Enumeration
+ *
+ * Win32 volume enumeration and the Linux sysfs/udev equivalent.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "device_enumerator.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <cstdio>
+#else
+#include <unistd.h>
+#include <sys/statvfs.h>
+#include <sys/utsname.h>
+#ifdef __linux__
+#include <filesystem>
+#include <fstream>
+#include <map>
+#endif
+#endif
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+#ifdef __linux__
+            struct MountEntry {
+                std::string mountPoint;
+                std::string type;
+            };
+
+            std::string ReadAttribute(const std::string& path) {
+                std::ifstream file(path);
+                std::string value;
+                std::getline(file, value);
+                // Model and vendor strings are space padded
+                while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) {
+                    value.pop_back();
+                }
+                return value;
+            }
+
+            uint64_t ReadNumber(const std::string& path) {
+                std::string value = ReadAttribute(path);
+                return value.empty() ? 0 : std::strtoull(value.c_str(), nullptr, 10);
+            }
+
+            // /proc/mounts writes space, tab, newline and backslash as \ooo
+            std::string UnescapeMountField(const std::string& field) {
+                std::string result;
+                for (size_t i = 0; i < field.size(); i++) {
+                    if (field[i] == '\\' && i + 3 < field.size() &&
+                        std::isdigit(static_cast<unsigned char>(field[i + 1]))) {
+                        result += static_cast<char>(std::strtol(field.substr(i + 1, 3).c_str(), nullptr, 8));
+                        i += 3;
+                    } else {
+                        result += field[i];
+                    }
+                }
+                return result;
+            }
+
+            // Mounted block devices keyed by their canonical /dev node
+            std::map<std::string, MountEntry> ReadMounts() {
+                std::map<std::string, MountEntry> mounts;
+                std::ifstream file("/proc/self/mounts");
+                std::string device, mountPoint, type, rest;
+                while (file >> device >> mountPoint >> type) {
+                    std::getline(file, rest);
+                    if (device.compare(0, 5, "/dev/") != 0) {
+                        continue;
+                    }
+                    // /dev/mapper/* and /dev/disk/by-* are links to the node sysfs names
+                    std::error_code error;
+                    std::filesystem::path node = std::filesystem::canonical(device, error);
+                    mounts.emplace(error ? device : node.string(),
+                                   MountEntry{UnescapeMountField(mountPoint), type});
+                }
+                return mounts;
+            }
+
+            /**
+             * Properties udev's blkid probe recorded for a device, so file
+             * systems and labels of unmounted volumes are known without
+             * reading the (possibly failing) media here
+             */
+            std::map<std::string, std::string> ReadUdevProperties(const std::string& sysfs) {
+                std::map<std::string, std::string> properties;
+                std::ifstream file("/run/udev/data/b" + ReadAttribute(sysfs + "/dev"));
+                std::string line;
+                while (std::getline(file, line)) {
+                    size_t equals = line.find('=');
+                    if (line.compare(0, 2, "E:") == 0 && equals != std::string::npos) {
+                        properties[line.substr(2, equals - 2)] = line.substr(equals + 1);
+                    }
+                }
+                return properties;
+            }
+
+            bool StartsWith(const std::string& text, const char* prefix) {
+                return text.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+            }
+
+            DeviceType ClassifyDisk(const std::string& name, const std::string& sysfs) {
+                if (StartsWith(name, "sr")) {
+                    return DeviceType::CD_DVD;
+                }
+                if (StartsWith(name, "mmcblk")) {
+                    return DeviceType::SD_CARD;
+                }
+                if (StartsWith(name, "md")) {
+                    return DeviceType::RAID;
+                }
+                if (StartsWith(name, "nbd") || StartsWith(name, "rbd")) {
+                    return DeviceType::NETWORK;
+                }
+                if (StartsWith(name, "loop") || StartsWith(name, "dm-")) {
+                    return DeviceType::VIRTUAL;
+                }
+
+                // USB bridges report removable=0 for hard disks, so check the bus too
+                std::error_code error;
+                std::string device = std::filesystem::canonical(sysfs, error).string();
+                if ((!error && device.find("/usb") != std::string::npos) || ReadNumber(sysfs + "/removable") != 0) {
+                    return DeviceType::USB;
+                }
+                return ReadNumber(sysfs + "/queue/rotational") != 0 ? DeviceType::HDD : DeviceType::SSD;
+            }
+
+            DriveInformation DescribeBlockDevice(const std::string& name, const std::string& sysfs,
+                                                 const DriveInformation& disk,
+                                                 const std::map<std::string, MountEntry>& mounts) {
+                DriveInformation info;
+                info.driveLetter = "/dev/" + name;
+                info.deviceType = disk.deviceType;
+                info.isRemovable = disk.isRemovable;
+                info.manufacturer = disk.manufacturer;
+                info.model = disk.model;
+                // sysfs sizes are always in 512-byte units
+                info.totalCapacity = ReadNumber(sysfs + "/size") * 512;
+                info.isAccessible = info.totalCapacity > 0 && access(info.driveLetter.c_str(), R_OK) == 0;
+
+                std::map<std::string, std::string> udev = ReadUdevProperties(sysfs);
+                info.fileSystem = ParseFileSystemName(udev["ID_FS_TYPE"]);
+                info.volumeLabel = udev["ID_FS_LABEL"];
+                info.serialNumber = udev["ID_FS_UUID"];
+
+                auto mount = mounts.find(info.driveLetter);
+                if (mount != mounts.end()) {
+                    if (info.fileSystem == FileSystemType::UNKNOWN) {
+                        info.fileSystem = ParseFileSystemName(mount->second.type);
+                    }
+                    info.isSystemDrive = mount->second.mountPoint == "/";
+                    struct statvfs usage;
+                    if (statvfs(mount->second.mountPoint.c_str(), &usage) == 0) {
+                        info.freeSpace = static_cast<uint64_t>(usage.f_bavail) * usage.f_frsize;
+                        info.usedSpace = static_cast<uint64_t>(usage.f_blocks - usage.f_bfree) * usage.f_frsize;
+                    }
+                }
+                return info;
+            }
+
+            std::vector<DriveInformation> EnumerateBlockDevices() {
+                std::vector<DriveInformation> drives;
+                std::map<std::string, MountEntry> mounts = ReadMounts();
+
+                std::vector<std::string> disks;
+                std::error_code error;
+                for (const auto& entry : std::filesystem::directory_iterator("/sys/block", error)) {
+                    disks.push_back(entry.path().filename().string());
+                }
+                std::sort(disks.begin(), disks.end());
+
+                for (const std::string& name : disks) {
+                    std::string sysfs = "/sys/block/" + name;
+                    // RAM disks hold nothing to recover; unattached loop devices have no size
+                    if (StartsWith(name, "ram") || StartsWith(name, "zram") ||
+                        (StartsWith(name, "loop") && ReadNumber(sysfs + "/size") == 0)) {
+                        continue;
+                    }
+
+                    DriveInformation disk;
+                    disk.deviceType = ClassifyDisk(name, sysfs);
+                    disk.isRemovable = ReadNumber(sysfs + "/removable") != 0;
+                    disk.manufacturer = ReadAttribute(sysfs + "/device/vendor");
+                    disk.model = ReadAttribute(sysfs + "/device/model");
+
+                    // The whole disk comes first: partition recovery reads its tables
+                    drives.push_back(DescribeBlockDevice(name, sysfs, disk, mounts));
+
+                    std::vector<std::pair<uint64_t, std::string>> partitions;
+                    for (const auto& entry : std::filesystem::directory_iterator(sysfs, error)) {
+                        std::string partition = entry.path().string() + "/partition";
+                        if (std::filesystem::exists(partition, error)) {
+                            partitions.emplace_back(ReadNumber(partition), entry.path().filename().string());
+                        }
+                    }
+                    std::sort(partitions.begin(), partitions.end());
+                    for (const auto& partition : partitions) {
+                        drives.push_back(DescribeBlockDevice(partition.second, sysfs + "/" + partition.second,
+                                                             disk, mounts));
+                    }
+                }
+                return drives;
+            }
+#endif
+
+        } // namespace
+
+        std::vector<DriveInformation> EnumerateDrives() {
+            std::vector<DriveInformation> drives;
+#ifdef _WIN32
+            DWORD drivesMask = GetLogicalDrives();
+
+            for (char drive = 'A'; drive <= 'Z'; drive++) {
+                if (!(drivesMask & (1 << (drive - 'A')))) {
+                    continue;
+                }
+
+                DriveInformation info;
+                info.driveLetter = std::string(1, drive) + ":";
+                std::string rootPath = info.driveLetter + "\\";
+
+                switch (GetDriveTypeA(rootPath.c_str())) {
+                    case DRIVE_FIXED:
+                        info.deviceType = DeviceType::HDD;
+                        break;
+                    case DRIVE_REMOVABLE:
+                        info.deviceType = DeviceType::USB;
+                        info.isRemovable = true;
+                        break;
+                    case DRIVE_CDROM:
+                        info.deviceType = DeviceType::CD_DVD;
+                        info.isRemovable = true;
+                        break;
+                    case DRIVE_REMOTE:
+                        info.deviceType = DeviceType::NETWORK;
+                        break;
+                    default:
+                        continue; // Skip unknown drives
+                }
+
+                char volumeName[MAX_PATH];
+                char fileSystemName[MAX_PATH];
+                DWORD serialNumber, maxComponentLen, fileSystemFlags;
+                if (GetVolumeInformationA(rootPath.c_str(), volumeName, MAX_PATH,
+                                          &serialNumber, &maxComponentLen, &fileSystemFlags,
+                                          fileSystemName, MAX_PATH)) {
+                    char serial[16];
+                    std::snprintf(serial, sizeof(serial), "%04lX-%04lX",
+                                  static_cast<unsigned long>(serialNumber >> 16),
+                                  static_cast<unsigned long>(serialNumber & 0xFFFF));
+                    info.volumeLabel = volumeName;
+                    info.serialNumber = serial;
+                    info.fileSystem = ParseFileSystemName(fileSystemName);
+                    info.isAccessible = true;
+                }
+
+                ULARGE_INTEGER freeBytesAvailable, totalNumberOfBytes, totalFreeBytes;
+                if (GetDiskFreeSpaceExA(rootPath.c_str(), &freeBytesAvailable,
+                                        &totalNumberOfBytes, &totalFreeBytes)) {
+                    info.totalCapacity = totalNumberOfBytes.QuadPart;
+                    info.freeSpace = freeBytesAvailable.QuadPart;
+                    info.usedSpace = totalNumberOfBytes.QuadPart - totalFreeBytes.QuadPart;
+                }
+
+                char windowsDirectory[MAX_PATH];
+                if (GetSystemWindowsDirectoryA(windowsDirectory, MAX_PATH) >= 2) {
+                    info.isSystemDrive = std::toupper(static_cast<unsigned char>(windowsDirectory[0])) == drive;
+                }
+
+                drives.push_back(info);
+            }
+#elif defined(__linux__)
+            drives = EnumerateBlockDevices();
+#endif
+            return drives;
+        }
+
+        std::string GetDeviceSourcePath(const std::string& drive) {
+#ifdef _WIN32
+            if (drive.size() == 2 && drive[1] == ':') {
+                return "\\\\.\\" + drive;
+            }
+#endif
+            return drive;
+        }
+
+        FileSystemType ParseFileSystemName(const std::string& name) {
+            std::string lower(name);
+            std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+                return static_cast<char>(std::tolower(c));
+            });
+
+            if (lower == "ntfs" || lower == "ntfs3") return FileSystemType::NTFS;
+            // Windows says "FAT" for FAT12/16; Linux mounts every FAT as vfat
+            if (lower == "fat" || lower == "fat16" || lower == "msdos") return FileSystemType::FAT16;
+            if (lower == "fat32" || lower == "vfat") return FileSystemType::FAT32;
+            if (lower == "exfat") return FileSystemType::EXFAT;
+            if (lower == "refs") return FileSystemType::REFS;
+            if (lower == "apfs") return FileSystemType::APFS;
+            if (lower == "hfsplus" || lower == "hfs+") return FileSystemType::HFS_PLUS;
+            if (lower == "ext2") return FileSystemType::EXT2;
+            if (lower == "ext3") return FileSystemType::EXT3;
+            if (lower == "ext4") return FileSystemType::EXT4;
+            if (lower == "xfs") return FileSystemType::XFS;
+            if (lower == "btrfs") return FileSystemType::BTRFS;
+            if (lower == "udf") return FileSystemType::UDF;
+            if (lower == "iso9660" || lower == "cdfs") return FileSystemType::ISO9660;
+            return FileSystemType::UNKNOWN;
+        }
+
+        HostInformation GetHostInformation() {
+            HostInformation host;
+            host.processorCount = std::thread::hardware_concurrency();
+#ifdef _WIN32
+            OSVERSIONINFO osvi;
+            ZeroMemory(&osvi, sizeof(OSVERSIONINFO));
+            osvi.dwOSVersionInfoSize = sizeof(OSVERSIONINFO);
+            if (GetVersionEx(&osvi)) {
+                host.operatingSystem = "Windows " + std::to_string(osvi.dwMajorVersion) + "." +
+                                       std::to_string(osvi.dwMinorVersion);
+                host.meetsRequirements = osvi.dwMajorVersion >= 6; // Windows Vista or later
+            }
+
+            MEMORYSTATUSEX memInfo;
+            memInfo.dwLength = sizeof(MEMORYSTATUSEX);
+            if (GlobalMemoryStatusEx(&memInfo)) {
+                host.totalMemory = memInfo.ullTotalPhys;
+                host.availableMemory = memInfo.ullAvailPhys;
+            }
+
+            SYSTEM_INFO sysInfo;
+            GetSystemInfo(&sysInfo);
+            host.processorCount = sysInfo.dwNumberOfProcessors;
+#else
+            struct utsname name;
+            if (uname(&name) == 0) {
+                host.operatingSystem = std::string(name.sysname) + " " + name.release;
+            }
+            // O_DIRECT, BLKGETSIZE64 and copy_file_range fallbacks cover every Linux we meet
+            host.meetsRequirements = true;
+
+            long pages = sysconf(_SC_PHYS_PAGES);
+            long pageSize = sysconf(_SC_PAGE_SIZE);
+            if (pages > 0 && pageSize > 0) {
+                host.totalMemory = static_cast<uint64_t>(pages) * static_cast<uint64_t>(pageSize);
+            }
+#ifdef __linux__
+            // Free pages alone ignore reclaimable page cache
+            std::ifstream meminfo("/proc/meminfo");
+            std::string key;
+            uint64_t kibibytes;
+            std::string unit;
+            while (meminfo >> key >> kibibytes) {
+                std::getline(meminfo, unit);
+                if (key == "MemAvailable:") {
+                    host.availableMemory = kibibytes * 1024;
+                    break;
+                }
+            }
+#endif
+#endif
+            return host;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
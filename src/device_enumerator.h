@@ -0,0 +1,64 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Device Enumeration
+ *
+ * Host-specific discovery of the volumes and block devices a scan can be
+ * pointed at, plus the few host facts the front end reports. Windows
+ * lists lettered volumes; Linux lists /sys/block disks and their
+ * partitions. Everything past this layer opens sources by path.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_DEVICE_ENUMERATOR_H
+#define STELLAR_DEVICE_ENUMERATOR_H
+
+#include "stellar_recovery.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        /**
+         * Drives and devices attached to this host. driveLetter holds the
+         * name the user picks: "C:" on Windows, "/dev/sdb1" on Linux.
+         * Hosts without a device backend return an empty list, leaving
+         * disk images as the only sources.
+         */
+        std::vector<DriveInformation> EnumerateDrives();
+
+        /**
+         * Path FileSectorSource opens for a drive name: "C:" maps to the
+         * raw volume "\\.\C:", device nodes and image paths pass through
+         */
+        std::string GetDeviceSourcePath(const std::string& drive);
+
+        /**
+         * Map an OS file system name ("NTFS", "vfat", "ext4") onto FileSystemType
+         */
+        FileSystemType ParseFileSystemName(const std::string& name);
+
+        struct HostInformation {
+            std::string operatingSystem;    // "Windows 10.0", "Linux 6.1.0"
+            uint64_t totalMemory;
+            uint64_t availableMemory;
+            uint32_t processorCount;
+            bool meetsRequirements;         // Windows Vista or later; any Linux
+
+            HostInformation() :
+                totalMemory(0),
+                availableMemory(0),
+                processorCount(0),
+                meetsRequirements(false) {}
+        };
+
+        HostInformation GetHostInformation();
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_DEVICE_ENUMERATOR_H
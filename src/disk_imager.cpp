@@ -0,0 +1,450 @@
+/**
+ * Stellar Data Recovery Pro Free - Disk Imager
+ *
+ * Rescue map bookkeeping, the copy, trim, scrape and retry passes, and
+ * the fault-injecting test source.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "disk_imager.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <system_error>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            constexpr RegionStatus ALL_STATUSES[] = {
+                RegionStatus::NON_TRIED, RegionStatus::NON_TRIMMED, RegionStatus::NON_SCRAPED,
+                RegionStatus::BAD_SECTOR, RegionStatus::FINISHED
+            };
+
+            size_t StatusIndex(RegionStatus status) {
+                switch (status) {
+                    case RegionStatus::NON_TRIED: return 0;
+                    case RegionStatus::NON_TRIMMED: return 1;
+                    case RegionStatus::NON_SCRAPED: return 2;
+                    case RegionStatus::BAD_SECTOR: return 3;
+                    default: return 4;
+                }
+            }
+
+            bool ParseStatus(char c, RegionStatus& status) {
+                for (RegionStatus candidate : ALL_STATUSES) {
+                    if (static_cast<char>(candidate) == c) {
+                        status = candidate;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+        } // namespace
+
+        RescueMap::RescueMap(uint64_t size) : size(size) {
+            if (size > 0) {
+                regions[0] = Entry{size, RegionStatus::NON_TRIED};
+                totals[StatusIndex(RegionStatus::NON_TRIED)] = size;
+            }
+        }
+
+        bool RescueMap::Load(const std::string& path) {
+            std::ifstream in(path);
+            if (!in) {
+                return false;
+            }
+
+            // Comment lines, one "position phase [pass]" line, then "offset length status" lines
+            RescueMap loaded(0);
+            loaded.size = size;
+            bool statusLine = false;
+            uint64_t expected = 0;
+            std::string line;
+            while (std::getline(in, line)) {
+                if (line.empty() || line[0] == '#') {
+                    continue;
+                }
+                std::istringstream fields(line);
+                std::string first;
+                std::string second;
+                std::string third;
+                fields >> first >> second >> third;
+                try {
+                    if (!statusLine) {
+                        loaded.position = std::stoull(first, nullptr, 0);
+                        loaded.phase = second.empty() ? '?' : second[0];
+                        statusLine = true;
+                        continue;
+                    }
+                    uint64_t offset = std::stoull(first, nullptr, 0);
+                    uint64_t length = std::stoull(second, nullptr, 0);
+                    RegionStatus status;
+                    if (offset != expected || length == 0 || third.size() != 1 || !ParseStatus(third[0], status)) {
+                        return false;
+                    }
+                    loaded.regions[offset] = Entry{length, status};
+                    loaded.totals[StatusIndex(status)] += length;
+                    expected = offset + length;
+                } catch (const std::exception&) {
+                    return false;
+                }
+            }
+            if (!statusLine || expected != size) {
+                return false;
+            }
+            *this = loaded;
+            return true;
+        }
+
+        bool RescueMap::Save(const std::string& path) const {
+            const std::string temporary = path + ".tmp";
+            {
+                std::ofstream out(temporary, std::ios::trunc);
+                if (!out) {
+                    return false;
+                }
+                char line[96];
+                out << "# Rescue map written by Stellar Data Recovery (ddrescue format)\n";
+                out << "# current_pos  current_status  current_pass\n";
+                std::snprintf(line, sizeof(line), "0x%08" PRIX64 "     %c               1\n", position, phase);
+                out << line;
+                out << "#      pos        size  status\n";
+                for (const auto& [offset, entry] : regions) {
+                    std::snprintf(line, sizeof(line), "0x%08" PRIX64 "  0x%08" PRIX64 "  %c\n", offset, entry.length,
+                                  static_cast<char>(entry.status));
+                    out << line;
+                }
+                out.flush();
+                if (!out) {
+                    return false;
+                }
+            }
+            std::error_code error;
+            std::filesystem::rename(temporary, path, error);
+            return !error;
+        }
+
+        void RescueMap::Split(uint64_t offset) {
+            if (offset == 0 || offset >= size) {
+                return;
+            }
+            auto it = std::prev(regions.upper_bound(offset));
+            if (it->first == offset) {
+                return;
+            }
+            Entry right{it->first + it->second.length - offset, it->second.status};
+            it->second.length = offset - it->first;
+            regions.emplace(offset, right);
+        }
+
+        void RescueMap::Set(uint64_t offset, uint64_t length, RegionStatus status) {
+            uint64_t end = std::min(offset + length, size);
+            if (offset >= end) {
+                return;
+            }
+            Split(offset);
+            Split(end);
+            auto it = regions.find(offset);
+            while (it != regions.end() && it->first < end) {
+                totals[StatusIndex(it->second.status)] -= it->second.length;
+                it = regions.erase(it);
+            }
+            it = regions.emplace(offset, Entry{end - offset, status}).first;
+            totals[StatusIndex(status)] += end - offset;
+
+            // Keep neighbours with the same status as one region
+            auto next = std::next(it);
+            if (next != regions.end() && next->second.status == status) {
+                it->second.length += next->second.length;
+                regions.erase(next);
+            }
+            if (it != regions.begin()) {
+                auto previous = std::prev(it);
+                if (previous->second.status == status) {
+                    previous->second.length += it->second.length;
+                    regions.erase(it);
+                }
+            }
+        }
+
+        std::vector<RescueRegion> RescueMap::Regions(RegionStatus status) const {
+            std::vector<RescueRegion> result;
+            for (const auto& [offset, entry] : regions) {
+                if (entry.status == status) {
+                    result.push_back(RescueRegion{offset, entry.length, status});
+                }
+            }
+            return result;
+        }
+
+        uint64_t RescueMap::Unfinished(uint64_t offset, uint64_t length) const {
+            const uint64_t end = offset + length;
+            auto it = regions.upper_bound(offset);
+            if (it != regions.begin()) {
+                --it;
+            }
+            for (; it != regions.end() && it->first < end; ++it) {
+                if (it->second.status != RegionStatus::FINISHED && it->first + it->second.length > offset) {
+                    return std::max(it->first, offset);
+                }
+            }
+            return end;
+        }
+
+        uint64_t RescueMap::Bytes(RegionStatus status) const {
+            return totals[StatusIndex(status)];
+        }
+
+        std::string ImageMapPath(const std::string& imagePath) {
+            return imagePath + ".map";
+        }
+
+        DiskImager::DiskImager(SectorSource& source, const std::string& imagePath, const std::string& mapPath,
+                               const ImagingOptions& options)
+            : source(source),
+              imagePath(imagePath),
+              mapPath(mapPath),
+              options(options),
+              sectorSize(std::max<uint32_t>(source.SectorSize(), 512)),
+              map(source.Size()) {
+            // Copy blocks and skips are whole sectors
+            this->options.blockSize = std::max<size_t>(this->options.blockSize / sectorSize * sectorSize, sectorSize);
+            this->options.minSkip = std::max<uint64_t>(this->options.minSkip / sectorSize * sectorSize, sectorSize);
+            this->options.maxSkip = std::max(this->options.maxSkip / sectorSize * sectorSize, this->options.minSkip);
+
+            // A map without its image is worthless; start over
+            std::error_code error;
+            resumed = std::filesystem::exists(imagePath, error) && map.Load(mapPath);
+            if (!resumed) {
+                map = RescueMap(source.Size());
+            }
+        }
+
+        bool DiskImager::Run(const ProgressCallback& progress) {
+            started = std::chrono::steady_clock::now();
+            lastSave = started;
+            this->progress = &progress;
+
+            auto mode = std::ios::in | std::ios::out | std::ios::binary;
+            if (!resumed) {
+                mode |= std::ios::trunc;
+            }
+            image.open(imagePath, mode);
+            if (!image) {
+                throw SectorReadError("Cannot open image file " + imagePath);
+            }
+            std::error_code error;
+            std::filesystem::resize_file(imagePath, source.Size(), error);
+            if (error) {
+                throw SectorReadError("Cannot size image file " + imagePath + ": " + error.message());
+            }
+            buffer = AlignedBuffer(options.blockSize);
+
+            // Healthy areas first: forward with skips, back over the skips, then whatever is left
+            passName = "Copying";
+            CopyPass(true, false);
+            CopyPass(true, true);
+            CopyPass(false, false);
+            passName = "Trimming";
+            TrimPass();
+            passName = "Scraping";
+            ScrapePass(RegionStatus::NON_SCRAPED);
+            passName = "Retrying bad sectors";
+            for (int pass = 0; pass < options.retryPasses && map.Bytes(RegionStatus::BAD_SECTOR) != 0; pass++) {
+                ScrapePass(RegionStatus::BAD_SECTOR);
+            }
+
+            map.SetPosition(0, '+');
+            Checkpoint(true);
+            image.close();
+            this->progress = nullptr;
+            if (progress) {
+                progress(100, "Imaging complete");
+            }
+            return map.Bytes(RegionStatus::FINISHED) == map.Size();
+        }
+
+        void DiskImager::CopyPass(bool skipping, bool reverse) {
+            auto areas = map.Regions(RegionStatus::NON_TRIED);
+            if (reverse) {
+                std::reverse(areas.begin(), areas.end());
+            }
+            const char phase = static_cast<char>(RegionStatus::NON_TRIED);
+            for (const RescueRegion& area : areas) {
+                const uint64_t start = area.offset;
+                const uint64_t end = area.offset + area.length;
+                uint64_t skip = options.minSkip;
+                uint64_t position = reverse ? end : start;
+                while (reverse ? position > start : position < end) {
+                    // Stay on block boundaries so later reads are aligned
+                    uint64_t length;
+                    uint64_t offset;
+                    if (reverse) {
+                        uint64_t misalign = position % options.blockSize;
+                        length = std::min<uint64_t>(misalign ? misalign : options.blockSize, position - start);
+                        offset = position - length;
+                    } else {
+                        length = std::min<uint64_t>(options.blockSize - position % options.blockSize, end - position);
+                        offset = position;
+                    }
+                    map.SetPosition(offset, phase);
+
+                    bool good = Copy(offset, static_cast<size_t>(length));
+                    map.Set(offset, length, good ? RegionStatus::FINISHED : RegionStatus::NON_TRIMMED);
+                    position = reverse ? offset : offset + length;
+                    if (good) {
+                        skip = options.minSkip;
+                    } else if (skipping) {
+                        // Leave the area after a failure for a later pass
+                        uint64_t jump = reverse ? std::min(skip, position - start) : std::min(skip, end - position);
+                        position = reverse ? position - jump : position + jump;
+                        skip = std::min(skip * 2, options.maxSkip);
+                    }
+                    Checkpoint(false);
+                }
+            }
+        }
+
+        void DiskImager::TrimPass() {
+            const char phase = static_cast<char>(RegionStatus::NON_TRIMMED);
+            for (const RescueRegion& block : map.Regions(RegionStatus::NON_TRIMMED)) {
+                uint64_t first = block.offset;
+                uint64_t last = block.offset + block.length;
+
+                // Read sector by sector in from both edges until each side fails once
+                while (first < last) {
+                    uint64_t length = std::min<uint64_t>(sectorSize, last - first);
+                    map.SetPosition(first, phase);
+                    bool good = Copy(first, static_cast<size_t>(length));
+                    map.Set(first, length, good ? RegionStatus::FINISHED : RegionStatus::BAD_SECTOR);
+                    first += length;
+                    Checkpoint(false);
+                    if (!good) {
+                        break;
+                    }
+                }
+                while (first < last) {
+                    uint64_t length = (last - first) % sectorSize ? (last - first) % sectorSize : sectorSize;
+                    uint64_t offset = last - length;
+                    map.SetPosition(offset, phase);
+                    bool good = Copy(offset, static_cast<size_t>(length));
+                    map.Set(offset, length, good ? RegionStatus::FINISHED : RegionStatus::BAD_SECTOR);
+                    last = offset;
+                    Checkpoint(false);
+                    if (!good) {
+                        break;
+                    }
+                }
+                map.Set(first, last - first, RegionStatus::NON_SCRAPED);
+            }
+        }
+
+        void DiskImager::ScrapePass(RegionStatus status) {
+            const char phase = static_cast<char>(status);
+            for (const RescueRegion& area : map.Regions(status)) {
+                const uint64_t end = area.offset + area.length;
+                for (uint64_t offset = area.offset; offset < end;) {
+                    uint64_t length = std::min<uint64_t>(sectorSize - offset % sectorSize, end - offset);
+                    map.SetPosition(offset, phase);
+                    bool good = Copy(offset, static_cast<size_t>(length));
+                    map.Set(offset, length, good ? RegionStatus::FINISHED : RegionStatus::BAD_SECTOR);
+                    offset += length;
+                    Checkpoint(false);
+                }
+            }
+        }
+
+        bool DiskImager::Copy(uint64_t offset, size_t length) {
+            reads++;
+            size_t got;
+            try {
+                got = source.ReadAt(offset, buffer.Data(), length);
+            } catch (const SectorReadError&) {
+                readErrors++;
+                return false;
+            }
+            // Only the end of the source reads short
+            if (got < length && offset + got < source.Size()) {
+                readErrors++;
+                return false;
+            }
+            image.seekp(static_cast<std::streamoff>(offset));
+            image.write(reinterpret_cast<const char*>(buffer.Data()), static_cast<std::streamsize>(got));
+            if (!image) {
+                throw SectorReadError("Cannot write image file " + imagePath, offset);
+            }
+            return true;
+        }
+
+        void DiskImager::Checkpoint(bool force) {
+            auto now = std::chrono::steady_clock::now();
+            if (!force && now - lastSave < std::chrono::seconds(options.saveInterval)) {
+                if (*progress && reads % 256 == 0) {
+                    uint64_t size = std::max<uint64_t>(map.Size(), 1);
+                    uint64_t done = map.Bytes(RegionStatus::FINISHED) + map.Bytes(RegionStatus::BAD_SECTOR);
+                    (*progress)(static_cast<int>(done * 100 / size), passName);
+                }
+                return;
+            }
+            lastSave = now;
+
+            // The map must never claim data the image does not hold yet
+            image.flush();
+            if (!image || !map.Save(mapPath)) {
+                throw SectorReadError("Cannot save rescue map " + mapPath);
+            }
+        }
+
+        ImagingStats DiskImager::Stats() const {
+            ImagingStats stats;
+            stats.bytesRescued = map.Bytes(RegionStatus::FINISHED);
+            stats.bytesBad = map.Bytes(RegionStatus::BAD_SECTOR);
+            stats.bytesPending = map.Bytes(RegionStatus::NON_TRIED) + map.Bytes(RegionStatus::NON_TRIMMED) +
+                                 map.Bytes(RegionStatus::NON_SCRAPED);
+            stats.reads = reads;
+            stats.readErrors = readErrors;
+            stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            return stats;
+        }
+
+        void FaultInjectingSource::AddFault(uint64_t offset, uint64_t length, uint32_t failures) {
+            std::lock_guard<std::mutex> lock(mutex);
+            faults.push_back(Fault{offset, length, failures});
+        }
+
+        size_t FaultInjectingSource::ReadAt(uint64_t offset, void* buffer, size_t length) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (Fault& fault : faults) {
+                    bool touches = offset < fault.offset + fault.length && fault.offset < offset + length;
+                    if (!touches || fault.failures == 0) {
+                        continue;
+                    }
+                    if (fault.failures != ALWAYS) {
+                        fault.failures--;
+                    }
+                    failedReads++;
+                    MetricsRegistry::Global().Add(Counter::READ_ERRORS);
+                    throw SectorReadError("Injected read error on " + inner.Path(), std::max(offset, fault.offset));
+                }
+            }
+            return inner.ReadAt(offset, buffer, length);
+        }
+
+        uint64_t FaultInjectingSource::FailedReads() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return failedReads;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
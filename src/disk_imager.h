@@ -0,0 +1,212 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Disk Imager
+ *
+ * Copies a failing drive to an image file before it is scanned, in the
+ * manner of GNU ddrescue. The first passes read large blocks and jump
+ * ahead exponentially past read errors, so the healthy areas come off
+ * the drive before the damaged ones are touched. Later passes go back
+ * to what was skipped, trim the edges of failed blocks sector by
+ * sector, scrape what is left and finally retry bad sectors. Every
+ * region's state is kept in a ddrescue-compatible map file, so an
+ * interrupted run resumes where it stopped.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_DISK_IMAGER_H
+#define STELLAR_DISK_IMAGER_H
+
+#include "stellar_recovery.h"
+#include "sector_reader.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        // Region states; the characters are those of ddrescue map files
+        enum class RegionStatus : char {
+            NON_TRIED = '?',        // Not read yet
+            NON_TRIMMED = '*',      // Failed block; edges not read sector by sector yet
+            NON_SCRAPED = '/',      // Middle of a failed block; not read sector by sector yet
+            BAD_SECTOR = '-',       // Failed a sector-sized read
+            FINISHED = '+'          // In the image
+        };
+
+        struct RescueRegion {
+            uint64_t offset;
+            uint64_t length;
+            RegionStatus status;
+        };
+
+        /**
+         * Status of every byte of a source, as a list of adjacent regions
+         */
+        class RescueMap {
+        public:
+            // The whole source untried
+            explicit RescueMap(uint64_t size = 0);
+
+            /**
+             * Load a ddrescue map file. Returns false, leaving the map
+             * unchanged, when it is missing, malformed or for a source of
+             * another size.
+             */
+            bool Load(const std::string& path);
+
+            // Replace path through a temporary file; false on failure
+            bool Save(const std::string& path) const;
+
+            void Set(uint64_t offset, uint64_t length, RegionStatus status);
+
+            // Regions with status, by offset
+            std::vector<RescueRegion> Regions(RegionStatus status) const;
+
+            // First byte of [offset, offset + length) not FINISHED, or offset + length
+            uint64_t Unfinished(uint64_t offset, uint64_t length) const;
+
+            uint64_t Bytes(RegionStatus status) const;
+            uint64_t Size() const { return size; }
+            size_t RegionCount() const { return regions.size(); }
+
+            // Current position and phase, recorded for ddrescue-compatible tools
+            void SetPosition(uint64_t offset, char phase) { position = offset; this->phase = phase; }
+
+        private:
+            struct Entry {
+                uint64_t length;
+                RegionStatus status;
+            };
+
+            void Split(uint64_t offset);
+
+            uint64_t size;
+            std::map<uint64_t, Entry> regions;      // Keyed by offset
+            uint64_t totals[5] = {};                // Bytes per status
+            uint64_t position = 0;
+            char phase = '?';
+        };
+
+        struct ImagingOptions {
+            size_t blockSize;           // Read size of the copy passes
+            uint64_t minSkip;           // Jump after the first error of a run of errors
+            uint64_t maxSkip;           // Largest jump; each further error doubles it up to this
+            int retryPasses;            // Extra passes over bad sectors
+            uint32_t saveInterval;      // Seconds between map saves
+
+            ImagingOptions() :
+                blockSize(64 * 1024),
+                minSkip(64 * 1024),
+                maxSkip(1ull << 30),
+                retryPasses(1),
+                saveInterval(30) {}
+        };
+
+        struct ImagingStats {
+            uint64_t bytesRescued;
+            uint64_t bytesBad;
+            uint64_t bytesPending;      // Untried, untrimmed or unscraped
+            uint64_t reads;
+            uint64_t readErrors;
+            double elapsedSeconds;
+
+            ImagingStats() : bytesRescued(0), bytesBad(0), bytesPending(0), reads(0), readErrors(0), elapsedSeconds(0) {}
+        };
+
+        /**
+         * Images one source into a file next to its map. Reads are issued
+         * one at a time: a failing drive gains nothing from a deeper queue.
+         */
+        class DiskImager {
+        public:
+            // Resumes from mapPath when it describes this source
+            DiskImager(SectorSource& source, const std::string& imagePath, const std::string& mapPath,
+                       const ImagingOptions& options = ImagingOptions());
+
+            /**
+             * Run every remaining pass. Returns true when the whole source
+             * is in the image. Throws SectorReadError when the image or
+             * the map cannot be written. progress is called from the
+             * calling thread.
+             */
+            bool Run(const ProgressCallback& progress = ProgressCallback());
+
+            const RescueMap& Map() const { return map; }
+            bool Resumed() const { return resumed; }
+            ImagingStats Stats() const;
+
+        private:
+            void CopyPass(bool skipping, bool reverse);
+            void TrimPass();
+            void ScrapePass(RegionStatus status);
+            bool Copy(uint64_t offset, size_t length);
+            void Checkpoint(bool force);
+
+            SectorSource& source;
+            std::string imagePath;
+            std::string mapPath;
+            ImagingOptions options;
+            uint32_t sectorSize;
+            RescueMap map;
+            bool resumed = false;
+
+            std::fstream image;
+            AlignedBuffer buffer;
+            uint64_t reads = 0;
+            uint64_t readErrors = 0;
+            std::chrono::steady_clock::time_point started;
+            std::chrono::steady_clock::time_point lastSave;
+            const char* passName = "";
+            const ProgressCallback* progress = nullptr;
+        };
+
+        // Map file kept beside an image
+        std::string ImageMapPath(const std::string& imagePath);
+
+        /**
+         * Wraps a source and fails reads that touch chosen ranges, to
+         * exercise imaging and recovery without a failing drive.
+         */
+        class FaultInjectingSource : public SectorSource {
+        public:
+            static constexpr uint32_t ALWAYS = UINT32_MAX;
+
+            explicit FaultInjectingSource(SectorSource& inner) : inner(inner) {}
+
+            // Reads touching the range fail the next failures times (ALWAYS: every time)
+            void AddFault(uint64_t offset, uint64_t length, uint32_t failures = ALWAYS);
+
+            const std::string& Path() const override { return inner.Path(); }
+            uint64_t Size() const override { return inner.Size(); }
+            uint32_t SectorSize() const override { return inner.SectorSize(); }
+            size_t ReadAt(uint64_t offset, void* buffer, size_t length) override;
+            bool IncursSeekPenalty() const override { return inner.IncursSeekPenalty(); }
+
+            uint64_t FailedReads() const;
+
+        private:
+            struct Fault {
+                uint64_t offset;
+                uint64_t length;
+                uint32_t failures;
+            };
+
+            SectorSource& inner;
+            mutable std::mutex mutex;
+            std::vector<Fault> faults;
+            uint64_t failedReads = 0;
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_DISK_IMAGER_H
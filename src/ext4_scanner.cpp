@@ -0,0 +1,692 @@
+/**
+ * Stellar Data Recovery Pro Free - ext2/3/4 Scanner
+ *
+ * Inode table streaming, jbd2 journal scanning and extent decoding.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "ext4_scanner.h"
+#include "signature_automaton.h"
+#include <algorithm>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            constexpr uint64_t SUPERBLOCK_OFFSET = 1024;
+            constexpr uint16_t EXT_MAGIC = 0xEF53;
+            constexpr uint16_t EXTENT_MAGIC = 0xF30A;
+            constexpr uint32_t JBD2_MAGIC = 0xC03B3998u;
+
+            // Feature flags
+            constexpr uint32_t COMPAT_HAS_JOURNAL = 0x0004;
+            constexpr uint32_t INCOMPAT_EXTENTS = 0x0040;
+            constexpr uint32_t INCOMPAT_64BIT = 0x0080;
+            constexpr uint32_t INCOMPAT_FLEX_BG = 0x0200;
+            constexpr uint32_t RO_COMPAT_GDT_CSUM = 0x0010;
+            constexpr uint32_t RO_COMPAT_METADATA_CSUM = 0x0400;
+
+            // Group descriptor flags
+            constexpr uint16_t BG_INODE_UNINIT = 0x0001;
+            constexpr uint16_t BG_BLOCK_UNINIT = 0x0002;
+
+            // Inode fields
+            constexpr uint16_t MODE_TYPE_MASK = 0xF000;
+            constexpr uint16_t MODE_REGULAR = 0x8000;
+            constexpr uint32_t INODE_FLAG_EXTENTS = 0x00080000;
+            constexpr uint32_t INODE_FLAG_INLINE_DATA = 0x10000000;
+            constexpr size_t INODE_BLOCK_OFFSET = 0x28;
+            constexpr size_t INODE_BLOCK_SIZE = 60;
+
+            // jbd2 block types and descriptor tag flags
+            constexpr uint32_t JBD2_DESCRIPTOR_BLOCK = 1;
+            constexpr uint32_t JBD2_SUPERBLOCK_V1 = 3;
+            constexpr uint32_t JBD2_SUPERBLOCK_V2 = 4;
+            constexpr uint32_t JBD2_FEATURE_INCOMPAT_64BIT = 0x02;
+            constexpr uint32_t JBD2_FEATURE_INCOMPAT_CSUM_V2 = 0x08;
+            constexpr uint32_t JBD2_FEATURE_INCOMPAT_CSUM_V3 = 0x10;
+            constexpr uint32_t JBD2_FLAG_ESCAPE = 0x1;
+            constexpr uint32_t JBD2_FLAG_SAME_UUID = 0x2;
+            constexpr uint32_t JBD2_FLAG_LAST_TAG = 0x8;
+
+            constexpr size_t STREAM_CHUNK_SIZE = 8u << 20;
+            constexpr uint64_t MERGE_GAP_BYTES = 1u << 20;    // Read through gaps smaller than this
+            constexpr uint64_t MAX_BLOCK_POINTER_BLOCKS = 1u << 24;
+
+            bool HasMappedData(const uint8_t* inode) {
+                const uint8_t* root = inode + INODE_BLOCK_OFFSET;
+                if (ReadLE32(inode + 0x20) & INODE_FLAG_EXTENTS) {
+                    return ReadLE16(root) == EXTENT_MAGIC && ReadLE16(root + 2) > 0;
+                }
+                for (size_t i = 0; i < INODE_BLOCK_SIZE; i += 4) {
+                    if (ReadLE32(root + i) != 0) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            uint64_t InodeSize(const uint8_t* inode) {
+                return ReadLE32(inode + 0x04) | (static_cast<uint64_t>(ReadLE32(inode + 0x6C)) << 32);
+            }
+
+            // Newer transaction, allowing for tid wrap-around
+            bool SequenceAfter(uint32_t a, uint32_t b) {
+                return static_cast<int32_t>(a - b) > 0;
+            }
+
+            std::chrono::system_clock::time_point UnixTime(uint32_t seconds) {
+                return std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::seconds(seconds)));
+            }
+
+        } // namespace
+
+        Ext4Scanner::Ext4Scanner(SectorSource& source, uint64_t volumeOffset) :
+            FileSystemScanner(source, volumeOffset) {
+            AlignedBuffer buffer(IO_ALIGNMENT);
+            if (Read(0, buffer.Data(), buffer.Size()) < SUPERBLOCK_OFFSET + 1024 ||
+                !IsExtSuperblock(buffer.Data() + SUPERBLOCK_OFFSET)) {
+                throw FileSystemError("No ext2/3/4 superblock on " + source.Path());
+            }
+            const uint8_t* superblock = buffer.Data() + SUPERBLOCK_OFFSET;
+
+            blockSize = 1024u << ReadLE32(superblock + 0x18);
+            blocksPerGroup = ReadLE32(superblock + 0x20);
+            inodesPerGroup = ReadLE32(superblock + 0x28);
+            firstDataBlock = ReadLE32(superblock + 0x14);
+            inodeSize = ReadLE32(superblock + 0x4C) >= 1 ? ReadLE16(superblock + 0x58) : 128;
+            featureCompat = ReadLE32(superblock + 0x5C);
+            featureIncompat = ReadLE32(superblock + 0x60);
+            featureRoCompat = ReadLE32(superblock + 0x64);
+            journalInode = (featureCompat & COMPAT_HAS_JOURNAL) ? ReadLE32(superblock + 0xE0) : 0;
+            blockCount = ReadLE32(superblock + 0x04);
+            if (featureIncompat & INCOMPAT_64BIT) {
+                blockCount |= static_cast<uint64_t>(ReadLE32(superblock + 0x150)) << 32;
+                descriptorSize = std::max<uint32_t>(ReadLE16(superblock + 0xFE), 32);
+            }
+
+            LoadGroupDescriptors();
+        }
+
+        FileSystemType Ext4Scanner::Type() const {
+            if (featureIncompat & (INCOMPAT_EXTENTS | INCOMPAT_FLEX_BG | INCOMPAT_64BIT)) {
+                return FileSystemType::EXT4;
+            }
+            return journalInode ? FileSystemType::EXT3 : FileSystemType::EXT2;
+        }
+
+        FileSystemType Ext4Scanner::TypeFromSuperblock(const uint8_t* superblock) {
+            if (ReadLE32(superblock + 0x60) & (INCOMPAT_EXTENTS | INCOMPAT_FLEX_BG | INCOMPAT_64BIT)) {
+                return FileSystemType::EXT4;
+            }
+            return (ReadLE32(superblock + 0x5C) & COMPAT_HAS_JOURNAL) ? FileSystemType::EXT3 : FileSystemType::EXT2;
+        }
+
+        bool Ext4Scanner::IsExtSuperblock(const uint8_t* superblock) {
+            if (ReadLE16(superblock + 0x38) != EXT_MAGIC || ReadLE32(superblock + 0x18) > 6) {
+                return false;
+            }
+            uint32_t block = 1024u << ReadLE32(superblock + 0x18);
+            uint32_t inode = ReadLE32(superblock + 0x4C) >= 1 ? ReadLE16(superblock + 0x58) : 128;
+            return ReadLE32(superblock + 0x20) != 0 && ReadLE32(superblock + 0x28) != 0 &&
+                   inode >= 128 && inode <= block && (inode & (inode - 1)) == 0;
+        }
+
+        void Ext4Scanner::LoadGroupDescriptors() {
+            uint64_t count = (blockCount - firstDataBlock + blocksPerGroup - 1) / blocksPerGroup;
+            std::vector<uint8_t> table(static_cast<size_t>(count * descriptorSize));
+            uint64_t tableOffset = static_cast<uint64_t>(firstDataBlock + 1) * blockSize;
+            if (Read(tableOffset, table.data(), table.size()) < table.size()) {
+                throw FileSystemError("Truncated group descriptor table on " + source.Path());
+            }
+
+            const bool trustUnused = (featureRoCompat & (RO_COMPAT_GDT_CSUM | RO_COMPAT_METADATA_CSUM)) != 0;
+            const bool wide = descriptorSize >= 64;
+            for (uint64_t index = 0; index < count; index++) {
+                const uint8_t* descriptor = table.data() + index * descriptorSize;
+                Group group;
+                group.blockBitmap = ReadLE32(descriptor + 0x00);
+                group.inodeTable = ReadLE32(descriptor + 0x08);
+                uint32_t unused = ReadLE16(descriptor + 0x1C);
+                if (wide) {
+                    group.blockBitmap |= static_cast<uint64_t>(ReadLE32(descriptor + 0x20)) << 32;
+                    group.inodeTable |= static_cast<uint64_t>(ReadLE32(descriptor + 0x28)) << 32;
+                    unused |= static_cast<uint32_t>(ReadLE16(descriptor + 0x32)) << 16;
+                }
+                uint16_t flags = ReadLE16(descriptor + 0x12);
+                group.blockBitmapUninit = trustUnused && (flags & BG_BLOCK_UNINIT);
+
+                // Inodes past itable_unused were never handed out
+                group.usedInodes = inodesPerGroup;
+                if (trustUnused) {
+                    group.usedInodes = (flags & BG_INODE_UNINIT) ? 0 : inodesPerGroup - std::min(unused, inodesPerGroup);
+                }
+                if (group.inodeTable == 0 || group.inodeTable >= blockCount) {
+                    group.usedInodes = 0;
+                }
+                groups.push_back(group);
+                inodeTableIndex.emplace_back(group.inodeTable, static_cast<uint32_t>(index));
+            }
+            std::sort(inodeTableIndex.begin(), inodeTableIndex.end());
+        }
+
+        void Ext4Scanner::StreamBlocks(std::vector<BlockRange> ranges, bool keepOrder, const BlockVisitor& visit) {
+            if (!keepOrder) {
+                std::sort(ranges.begin(), ranges.end(),
+                          [](const BlockRange& a, const BlockRange& b) { return a.first < b.first; });
+            }
+
+            const uint64_t mergeGap = MERGE_GAP_BYTES / blockSize;
+            for (size_t i = 0; i < ranges.size();) {
+                // Coalesce ranges separated by small gaps into one sequential read
+                size_t last = i;
+                uint64_t end = ranges[i].first + ranges[i].count;
+                while (!keepOrder && last + 1 < ranges.size() && ranges[last + 1].first <= end + mergeGap) {
+                    last++;
+                    end = std::max(end, ranges[last].first + ranges[last].count);
+                }
+
+                ReaderOptions options;
+                options.chunkSize = STREAM_CHUNK_SIZE;
+                options.startOffset = volumeOffset + ranges[i].first * blockSize;
+                options.endOffset = volumeOffset + end * blockSize;
+                SectorReader reader(source, options);
+
+                size_t current = i;
+                SectorChunk chunk;
+                while (reader.Next(chunk)) {
+                    bytesRead += chunk.length;
+                    uint64_t block = (chunk.offset - volumeOffset) / blockSize;
+                    for (size_t offset = 0; offset + blockSize <= chunk.length; offset += blockSize, block++) {
+                        while (current < last && block >= ranges[current].first + ranges[current].count) {
+                            current++;
+                        }
+                        // Gap blocks were only read to keep the request sequential
+                        bool wanted = false;
+                        for (size_t r = current; r <= last && ranges[r].first <= block; r++) {
+                            wanted = wanted || block < ranges[r].first + ranges[r].count;
+                        }
+                        if (wanted) {
+                            visit(block, chunk.data + offset);
+                        }
+                    }
+                }
+                i = last + 1;
+            }
+        }
+
+        std::vector<RecoverableFile> Ext4Scanner::ScanDeleted(const ProgressCallback& progress) {
+            std::vector<DeletedInode> deleted;
+            ReadInodeTables(deleted, progress);
+            ScanJournal(deleted, progress);
+            std::vector<uint8_t> bitmap = ReadBlockBitmaps();
+
+            const CompiledSignatureSet& signatures = GetSignatureSet(TargetFileType::ALL_DATA);
+            std::vector<uint8_t> head(blockSize);
+            std::vector<RecoverableFile> files;
+
+            for (size_t index = 0; index < deleted.size(); index++) {
+                DeletedInode& entry = deleted[index];
+                // ext2 keeps the block map of deleted inodes; ext3/4 need a journal copy
+                const bool fromJournal = !HasMappedData(entry.inode.data());
+                const uint8_t* inode = fromJournal ? entry.recovered.data() : entry.inode.data();
+                if (fromJournal && entry.recovered.empty()) {
+                    continue;
+                }
+                uint64_t size = InodeSize(inode);
+                std::vector<Ext4Extent> mapped = MapInode(inode, size, fromJournal, entry.recoveredSequence);
+                if (size == 0 || mapped.empty()) {
+                    continue;
+                }
+
+                RecoverableFile file;
+                uint64_t covered = 0;
+                uint64_t freeBlocks = 0;
+                uint64_t usedBlocks = 0;
+                uint64_t next = 0;
+                for (const auto& extent : mapped) {
+                    if (extent.logical * blockSize >= size) {
+                        break;
+                    }
+                    if (extent.logical > next) {
+                        file.extents.push_back(FileExtent{SPARSE_EXTENT, (extent.logical - next) * blockSize});
+                    }
+                    uint64_t length = std::min<uint64_t>(static_cast<uint64_t>(extent.length) * blockSize,
+                                                         size - extent.logical * blockSize);
+                    uint64_t offset = extent.uninitialized ? SPARSE_EXTENT : volumeOffset + extent.physical * blockSize;
+                    FileExtent* last = file.extents.empty() ? nullptr : &file.extents.back();
+                    if (last && last->offset != SPARSE_EXTENT && offset == last->offset + last->length) {
+                        last->length += length;
+                    } else {
+                        file.extents.push_back(FileExtent{offset, length});
+                    }
+                    for (uint64_t block = extent.physical; block < extent.physical + extent.length; block++) {
+                        bool allocated = block / 8 < bitmap.size() && ((bitmap[block / 8] >> (block % 8)) & 1);
+                        (allocated ? usedBlocks : freeBlocks)++;
+                    }
+                    covered = extent.logical * blockSize + length;
+                    next = extent.logical + extent.length;
+                }
+
+                // Deleted inodes have no names; identify the content from its first block
+                std::string extension;
+                file.fileType = TargetFileType::ALL_DATA;
+                const FileExtent& first = file.extents.front();
+                if (first.offset != SPARSE_EXTENT) {
+                    size_t got = source.ReadAt(first.offset, head.data(), head.size());
+                    bytesRead += got;
+                    for (size_t i = 0; i < signatures.headerOffsetCount && extension.empty(); i++) {
+                        uint16_t found[8];
+                        size_t count = signatures.anchored(head.data(), got, signatures.headerOffsets[i], found, 8);
+                        for (size_t f = 0; f < count; f++) {
+                            const SignaturePattern& pattern = signatures.patterns[found[f]];
+                            const FileSignature& signature = FILE_SIGNATURES[pattern.signature];
+                            if (pattern.kind == PatternKind::HEADER && signature.headerOffset == signatures.headerOffsets[i]) {
+                                extension = signature.extension;
+                                file.fileType = signature.type;
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                file.fileName = "inode_" + std::to_string(entry.number) + extension;
+                file.originalPath = "\\lost+found\\" + file.fileName;
+                file.fileSize = size;
+                file.dateAccessed = UnixTime(ReadLE32(inode + 0x08));
+                file.dateModified = UnixTime(ReadLE32(inode + 0x10));
+                bool hasCreation = inodeSize > 128 && ReadLE16(inode + 0x80) >= 0x18;
+                file.dateCreated = UnixTime(ReadLE32(inode + (hasCreation ? 0x90 : 0x0C)));
+
+                double base = fromJournal ? 0.85 : 0.9;
+                double freeRatio = freeBlocks + usedBlocks ? static_cast<double>(freeBlocks) / (freeBlocks + usedBlocks) : 1.0;
+                file.recoveryConfidence = std::max(0.05, base * freeRatio * (covered < size ? 0.5 : 1.0));
+                files.push_back(std::move(file));
+
+                if (progress && index % 256 == 0) {
+                    progress(static_cast<int>(85 + 15 * index / deleted.size()), "Mapping deleted inodes...");
+                }
+            }
+
+            if (progress) {
+                progress(100, "Mapping deleted inodes...");
+            }
+            return files;
+        }
+
+        void Ext4Scanner::ReadInodeTables(std::vector<DeletedInode>& deleted, const ProgressCallback& progress) {
+            const uint32_t inodesPerBlock = blockSize / inodeSize;
+            std::vector<BlockRange> ranges;
+            uint64_t total = 0;
+            for (const auto& group : groups) {
+                if (group.usedInodes > 0) {
+                    uint64_t blocks = (group.usedInodes + inodesPerBlock - 1) / inodesPerBlock;
+                    ranges.push_back(BlockRange{group.inodeTable, blocks});
+                    total += blocks;
+                }
+            }
+
+            uint64_t visited = 0;
+            StreamBlocks(ranges, false, [&](uint64_t block, const uint8_t* data) {
+                uint64_t firstInode;
+                if (!IsInodeTableBlock(block, firstInode)) {
+                    return;
+                }
+                for (uint32_t i = 0; i < inodesPerBlock; i++) {
+                    const uint8_t* inode = data + i * inodeSize;
+                    uint16_t mode = ReadLE16(inode);
+                    // Deleted: no links left and a deletion time recorded
+                    if ((mode & MODE_TYPE_MASK) == MODE_REGULAR && ReadLE16(inode + 0x1A) == 0 &&
+                        ReadLE32(inode + 0x14) != 0) {
+                        DeletedInode entry;
+                        entry.number = firstInode + i;
+                        entry.inode.assign(inode, inode + inodeSize);
+                        deleted.push_back(std::move(entry));
+                    }
+                }
+                if (progress && ++visited % 1024 == 0) {
+                    progress(static_cast<int>(visited * 40 / std::max<uint64_t>(total, 1)), "Reading inode tables...");
+                }
+            });
+        }
+
+        void Ext4Scanner::ScanJournal(std::vector<DeletedInode>& deleted, const ProgressCallback& progress) {
+            std::vector<uint8_t> journal;
+            if (journalInode == 0 || deleted.empty() || !ReadInode(journalInode, journal)) {
+                return;
+            }
+            std::vector<Ext4Extent> layout = MapInode(journal.data(), InodeSize(journal.data()), false, 0);
+            if (layout.empty()) {
+                return;
+            }
+
+            std::vector<uint8_t> header(blockSize);
+            if (Read(layout.front().physical * blockSize, header.data(), header.size()) < header.size() ||
+                ReadBE32(header.data()) != JBD2_MAGIC ||
+                (ReadBE32(header.data() + 4) != JBD2_SUPERBLOCK_V1 && ReadBE32(header.data() + 4) != JBD2_SUPERBLOCK_V2)) {
+                return;
+            }
+            const uint32_t journalBlocksTotal = ReadBE32(header.data() + 0x10);
+            const uint32_t firstLogBlock = ReadBE32(header.data() + 0x14);
+            const uint32_t incompat = ReadBE32(header.data() + 4) == JBD2_SUPERBLOCK_V2 ? ReadBE32(header.data() + 0x28) : 0;
+            const bool csumV3 = (incompat & JBD2_FEATURE_INCOMPAT_CSUM_V3) != 0;
+            const size_t tagSize = csumV3 ? 16 : (incompat & JBD2_FEATURE_INCOMPAT_64BIT) ? 12 : 8;
+            const size_t tailSize = (incompat & (JBD2_FEATURE_INCOMPAT_CSUM_V2 | JBD2_FEATURE_INCOMPAT_CSUM_V3)) ? 4 : 0;
+
+            std::unordered_map<uint64_t, size_t> byInode;
+            for (size_t i = 0; i < deleted.size(); i++) {
+                byInode[deleted[i].number] = i;
+            }
+
+            // Journal block index -> logged file system block
+            struct Pending {
+                uint64_t target;
+                uint32_t sequence;
+                bool escaped;
+            };
+            std::unordered_map<uint32_t, Pending> pending;
+
+            auto absorb = [&](const Pending& logged, const uint8_t* data) {
+                std::vector<uint8_t> copy(data, data + blockSize);
+                if (logged.escaped) {
+                    copy[0] = 0xC0; copy[1] = 0x3B; copy[2] = 0x39; copy[3] = 0x98;
+                }
+
+                uint64_t firstInode;
+                if (IsInodeTableBlock(logged.target, firstInode)) {
+                    for (uint32_t i = 0; i < blockSize / inodeSize; i++) {
+                        auto match = byInode.find(firstInode + i);
+                        if (match == byInode.end()) {
+                            continue;
+                        }
+                        const uint8_t* inode = copy.data() + i * inodeSize;
+                        DeletedInode& entry = deleted[match->second];
+                        // A copy from before the delete still maps the data
+                        bool live = ReadLE16(inode + 0x1A) != 0 && ReadLE32(inode + 0x14) == 0;
+                        bool sameFile = ReadLE32(inode + 0x64) == ReadLE32(entry.inode.data() + 0x64);
+                        if (live && sameFile && HasMappedData(inode) &&
+                            (entry.recovered.empty() || SequenceAfter(logged.sequence, entry.recoveredSequence))) {
+                            entry.recovered.assign(inode, inode + inodeSize);
+                            entry.recoveredSequence = logged.sequence;
+                        }
+                    }
+                } else if (ReadLE16(copy.data()) == EXTENT_MAGIC) {
+                    journalBlocks[logged.target].push_back(JournalCopy{logged.sequence, std::move(copy)});
+                }
+            };
+
+            auto parseDescriptor = [&](uint32_t index, const uint8_t* data) {
+                uint32_t sequence = ReadBE32(data + 8);
+                size_t position = 12;
+                uint32_t target = index;
+                while (position + tagSize <= blockSize - tailSize) {
+                    const uint8_t* tag = data + position;
+                    uint64_t block = ReadBE32(tag);
+                    uint32_t flags = csumV3 ? ReadBE32(tag + 4) : static_cast<uint32_t>(tag[6] << 8 | tag[7]);
+                    if (tagSize >= 12) {
+                        block |= static_cast<uint64_t>(ReadBE32(tag + 8)) << 32;
+                    }
+                    position += tagSize + ((flags & JBD2_FLAG_SAME_UUID) ? 0 : 16);
+
+                    // The log is circular between s_first and the journal end
+                    if (++target >= journalBlocksTotal) {
+                        target = firstLogBlock;
+                    }
+                    pending[target] = Pending{block, sequence, (flags & JBD2_FLAG_ESCAPE) != 0};
+                    if (flags & JBD2_FLAG_LAST_TAG) {
+                        break;
+                    }
+                }
+            };
+
+            // Every descriptor in the journal area, not just the live log, can hold old copies
+            uint64_t logical = 0;
+            uint64_t streamed = 0;
+            for (const auto& extent : layout) {
+                logical = extent.logical;
+                StreamBlocks({BlockRange{extent.physical, extent.length}}, true, [&](uint64_t, const uint8_t* data) {
+                    uint32_t index = static_cast<uint32_t>(logical++);
+                    auto logged = pending.find(index);
+                    if (logged != pending.end()) {
+                        absorb(logged->second, data);
+                        pending.erase(logged);
+                    } else if (index > 0 && ReadBE32(data) == JBD2_MAGIC && ReadBE32(data + 4) == JBD2_DESCRIPTOR_BLOCK) {
+                        parseDescriptor(index, data);
+                    }
+                    if (progress && ++streamed % 4096 == 0) {
+                        progress(static_cast<int>(40 + 40 * streamed / std::max<uint32_t>(journalBlocksTotal, 1)),
+                                 "Scanning journal...");
+                    }
+                });
+            }
+
+            // Transactions that wrapped to the start of the log
+            for (const auto& entry : pending) {
+                for (const auto& extent : layout) {
+                    if (entry.first >= extent.logical && entry.first < extent.logical + extent.length) {
+                        uint64_t physical = extent.physical + (entry.first - extent.logical);
+                        if (Read(physical * blockSize, header.data(), blockSize) == blockSize) {
+                            absorb(entry.second, header.data());
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+
+        std::vector<uint8_t> Ext4Scanner::ReadBlockBitmaps() {
+            std::vector<uint8_t> bitmap(static_cast<size_t>((blockCount + 7) / 8), 0);
+            std::unordered_map<uint64_t, uint32_t> owner;
+            std::vector<BlockRange> ranges;
+            for (uint32_t index = 0; index < groups.size(); index++) {
+                const Group& group = groups[index];
+                if (!group.blockBitmapUninit && group.blockBitmap != 0 && group.blockBitmap < blockCount) {
+                    owner[group.blockBitmap] = index;
+                    ranges.push_back(BlockRange{group.blockBitmap, 1});
+                }
+            }
+
+            StreamBlocks(ranges, false, [&](uint64_t block, const uint8_t* data) {
+                auto group = owner.find(block);
+                if (group == owner.end()) {
+                    return;
+                }
+                // Bit 0 of group g is block firstDataBlock + g * blocksPerGroup
+                uint64_t firstBlock = firstDataBlock + static_cast<uint64_t>(group->second) * blocksPerGroup;
+                for (uint64_t bit = 0; bit < blocksPerGroup && bit < blockSize * 8ull; bit++) {
+                    uint64_t target = firstBlock + bit;
+                    if (target < blockCount && ((data[bit / 8] >> (bit % 8)) & 1)) {
+                        bitmap[target / 8] |= static_cast<uint8_t>(1u << (target % 8));
+                    }
+                }
+            });
+            return bitmap;
+        }
+
+        std::vector<Ext4Extent> Ext4Scanner::MapInode(const uint8_t* inode, uint64_t size, bool fromJournal,
+                                                      uint32_t maxSequence) {
+            std::vector<Ext4Extent> extents;
+            uint32_t flags = ReadLE32(inode + 0x20);
+            if (flags & INODE_FLAG_INLINE_DATA) {
+                return extents;
+            }
+
+            bool valid;
+            if (flags & INODE_FLAG_EXTENTS) {
+                valid = DecodeExtentTree(inode + INODE_BLOCK_OFFSET, INODE_BLOCK_SIZE, blockSize,
+                                         [&](uint64_t block) { return LookupBlock(block, fromJournal, maxSequence); },
+                                         extents);
+            } else {
+                valid = MapBlockPointers(inode, (size + blockSize - 1) / blockSize, extents);
+            }
+
+            // Blocks outside the volume mean the mapping is garbage
+            for (const auto& extent : extents) {
+                valid = valid && extent.physical + extent.length <= blockCount;
+            }
+            if (!valid) {
+                return {};
+            }
+            std::sort(extents.begin(), extents.end(),
+                      [](const Ext4Extent& a, const Ext4Extent& b) { return a.logical < b.logical; });
+            return extents;
+        }
+
+        bool Ext4Scanner::DecodeExtentTree(const uint8_t* node, size_t nodeSize, size_t blockSize,
+                                           const BlockLookup& lookup, std::vector<Ext4Extent>& extents,
+                                           int depthLimit) {
+            if (nodeSize < 12 || ReadLE16(node) != EXTENT_MAGIC) {
+                return false;
+            }
+            size_t entries = ReadLE16(node + 2);
+            int depth = ReadLE16(node + 6);
+            if (entries > (nodeSize - 12) / 12 || depth > depthLimit) {
+                return false;
+            }
+
+            for (size_t i = 0; i < entries; i++) {
+                const uint8_t* entry = node + 12 + i * 12;
+                if (depth == 0) {
+                    uint32_t length = ReadLE16(entry + 4);
+                    // Lengths above 32768 mark uninitialized (preallocated) extents
+                    bool uninitialized = length > 32768;
+                    uint64_t start = ReadLE32(entry + 8) | (static_cast<uint64_t>(ReadLE16(entry + 6)) << 32);
+                    extents.push_back(Ext4Extent{ReadLE32(entry), start, uninitialized ? length - 32768 : length,
+                                                 uninitialized});
+                } else {
+                    uint64_t child = ReadLE32(entry + 4) | (static_cast<uint64_t>(ReadLE16(entry + 8)) << 32);
+                    const uint8_t* data = lookup(child);
+                    if (!data || ReadLE16(data + 6) != static_cast<uint16_t>(depth - 1) ||
+                        !DecodeExtentTree(data, blockSize, blockSize, lookup, extents, depth - 1)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool Ext4Scanner::MapBlockPointers(const uint8_t* inode, uint64_t blocks, std::vector<Ext4Extent>& extents) {
+            const uint32_t perBlock = blockSize / 4;
+            uint64_t logical = 0;
+            blocks = std::min(blocks, MAX_BLOCK_POINTER_BLOCKS);
+
+            auto addBlock = [&](uint64_t physical) {
+                if (physical == 0) {
+                    logical++;          // Hole
+                    return;
+                }
+                Ext4Extent* last = extents.empty() ? nullptr : &extents.back();
+                if (last && last->logical + last->length == logical && last->physical + last->length == physical) {
+                    last->length++;
+                } else {
+                    extents.push_back(Ext4Extent{logical, physical, 1, false});
+                }
+                logical++;
+            };
+
+            // Walk an indirect block of the given level (1 = single indirect)
+            std::function<bool(uint64_t, int)> walk = [&](uint64_t block, int level) {
+                if (block == 0) {
+                    uint64_t span = 1;
+                    for (int l = 0; l < level; l++) {
+                        span *= perBlock;
+                    }
+                    logical += span;
+                    return true;
+                }
+                if (block >= blockCount) {
+                    return false;
+                }
+                std::vector<uint8_t> data(blockSize);
+                if (Read(block * blockSize, data.data(), blockSize) < blockSize) {
+                    return false;
+                }
+                for (uint32_t i = 0; i < perBlock && logical < blocks; i++) {
+                    uint64_t pointer = ReadLE32(data.data() + i * 4);
+                    if (level == 1) {
+                        addBlock(pointer);
+                    } else if (!walk(pointer, level - 1)) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            const uint8_t* pointers = inode + INODE_BLOCK_OFFSET;
+            for (int i = 0; i < 12 && logical < blocks; i++) {
+                addBlock(ReadLE32(pointers + i * 4));
+            }
+            for (int level = 1; level <= 3 && logical < blocks; level++) {
+                if (!walk(ReadLE32(pointers + (11 + level) * 4), level)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        const uint8_t* Ext4Scanner::LookupBlock(uint64_t block, bool fromJournal, uint32_t maxSequence) {
+            if (fromJournal) {
+                // Newest logged copy no later than the inode copy being mapped
+                auto copies = journalBlocks.find(block);
+                const JournalCopy* best = nullptr;
+                if (copies != journalBlocks.end()) {
+                    for (const auto& copy : copies->second) {
+                        if (!SequenceAfter(copy.sequence, maxSequence) &&
+                            (!best || SequenceAfter(copy.sequence, best->sequence))) {
+                            best = &copy;
+                        }
+                    }
+                }
+                if (best) {
+                    return best->data.data();
+                }
+            }
+
+            auto cached = blockCache.find(block);
+            if (cached == blockCache.end()) {
+                std::vector<uint8_t> data(blockSize);
+                if (block >= blockCount || Read(block * blockSize, data.data(), blockSize) < blockSize) {
+                    return nullptr;
+                }
+                cached = blockCache.emplace(block, std::move(data)).first;
+            }
+            return cached->second.data();
+        }
+
+        bool Ext4Scanner::ReadInode(uint64_t number, std::vector<uint8_t>& inode) {
+            if (number == 0) {
+                return false;
+            }
+            uint64_t group = (number - 1) / inodesPerGroup;
+            uint64_t index = (number - 1) % inodesPerGroup;
+            if (group >= groups.size()) {
+                return false;
+            }
+            inode.resize(inodeSize);
+            uint64_t offset = groups[group].inodeTable * blockSize + index * inodeSize;
+            return Read(offset, inode.data(), inodeSize) == inodeSize;
+        }
+
+        bool Ext4Scanner::IsInodeTableBlock(uint64_t block, uint64_t& firstInode) const {
+            auto next = std::upper_bound(inodeTableIndex.begin(), inodeTableIndex.end(),
+                                         std::make_pair(block, UINT32_MAX));
+            if (next == inodeTableIndex.begin()) {
+                return false;
+            }
+            const auto& table = *(next - 1);
+            uint64_t tableBlocks = (static_cast<uint64_t>(inodesPerGroup) * inodeSize + blockSize - 1) / blockSize;
+            if (block >= table.first + tableBlocks) {
+                return false;
+            }
+            firstInode = static_cast<uint64_t>(table.second) * inodesPerGroup +
+                         (block - table.first) * (blockSize / inodeSize) + 1;
+            return true;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
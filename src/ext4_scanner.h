@@ -0,0 +1,140 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - ext2/3/4 Scanner
+ *
+ * Quick-scan backend for the ext family. Inode tables are bulk-read per
+ * block group, coalescing the adjacent tables that flex_bg lays out
+ * together. Deleted ext4 inodes have their extent roots cleared, so the
+ * jbd2 journal is scanned for older copies of inode table and extent
+ * blocks that still describe the file's data.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_EXT4_SCANNER_H
+#define STELLAR_EXT4_SCANNER_H
+
+#include "filesystem_scanner.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        // Mapping of logical file blocks to physical blocks
+        struct Ext4Extent {
+            uint64_t logical;
+            uint64_t physical;
+            uint32_t length;
+            bool uninitialized;     // Allocated but reads back as zeros
+        };
+
+        /**
+         * ext2/3/4 backend. The constructor validates the superblock and
+         * loads the group descriptors.
+         */
+        class Ext4Scanner : public FileSystemScanner {
+        public:
+            Ext4Scanner(SectorSource& source, uint64_t volumeOffset = 0);
+
+            FileSystemType Type() const override;
+            std::vector<RecoverableFile> ScanDeleted(const ProgressCallback& progress = ProgressCallback()) override;
+
+            uint32_t BlockSize() const { return blockSize; }
+            uint32_t GroupCount() const { return static_cast<uint32_t>(groups.size()); }
+
+            // Checks the magic and geometry of a superblock (volume offset 1024)
+            static bool IsExtSuperblock(const uint8_t* superblock);
+
+            // ext2, ext3 or ext4 from the superblock feature flags
+            static FileSystemType TypeFromSuperblock(const uint8_t* superblock);
+
+            /**
+             * Returns the contents of a file system block, or nullptr when it
+             * cannot be read. Used to follow extent index nodes.
+             */
+            using BlockLookup = std::function<const uint8_t*(uint64_t block)>;
+
+            /**
+             * Decode an extent tree rooted at node (i_block or a tree block).
+             * Returns false if a node is malformed.
+             */
+            static bool DecodeExtentTree(const uint8_t* node, size_t nodeSize, size_t blockSize,
+                                         const BlockLookup& lookup, std::vector<Ext4Extent>& extents,
+                                         int depthLimit = 5);
+
+        private:
+            struct Group {
+                uint64_t blockBitmap;
+                uint64_t inodeTable;
+                uint32_t usedInodes;        // Inodes worth reading from the table start
+                bool blockBitmapUninit;
+            };
+
+            // Copy of a block found in the journal
+            struct JournalCopy {
+                uint32_t sequence;          // Transaction that logged it
+                std::vector<uint8_t> data;
+            };
+
+            // A deleted inode and the best description of its data
+            struct DeletedInode {
+                uint64_t number;
+                std::vector<uint8_t> inode;       // As found in the inode table
+                std::vector<uint8_t> recovered;   // Newest journal copy that still maps data
+                uint32_t recoveredSequence = 0;
+            };
+
+            // Blocks to read; adjacent ranges are merged into one sequential read
+            struct BlockRange {
+                uint64_t first;
+                uint64_t count;
+            };
+            using BlockVisitor = std::function<void(uint64_t block, const uint8_t* data)>;
+
+            void LoadGroupDescriptors();
+            void StreamBlocks(std::vector<BlockRange> ranges, bool keepOrder, const BlockVisitor& visit);
+            void ReadInodeTables(std::vector<DeletedInode>& deleted, const ProgressCallback& progress);
+            void ScanJournal(std::vector<DeletedInode>& deleted, const ProgressCallback& progress);
+            std::vector<uint8_t> ReadBlockBitmaps();
+
+            /**
+             * Physical extents of an inode. Journal copies resolve extent
+             * index blocks from the journal as of maxSequence.
+             */
+            std::vector<Ext4Extent> MapInode(const uint8_t* inode, uint64_t size, bool fromJournal,
+                                             uint32_t maxSequence);
+            bool MapBlockPointers(const uint8_t* inode, uint64_t blocks, std::vector<Ext4Extent>& extents);
+            const uint8_t* LookupBlock(uint64_t block, bool fromJournal, uint32_t maxSequence);
+            bool ReadInode(uint64_t number, std::vector<uint8_t>& inode);
+            bool IsInodeTableBlock(uint64_t block, uint64_t& firstInode) const;
+
+            uint32_t blockSize = 4096;
+            uint32_t inodeSize = 256;
+            uint32_t inodesPerGroup = 0;
+            uint32_t blocksPerGroup = 0;
+            uint32_t firstDataBlock = 0;
+            uint64_t blockCount = 0;
+            uint32_t journalInode = 0;
+            uint32_t featureCompat = 0;
+            uint32_t featureIncompat = 0;
+            uint32_t featureRoCompat = 0;
+            uint32_t descriptorSize = 32;
+            std::vector<Group> groups;
+            std::vector<std::pair<uint64_t, uint32_t>> inodeTableIndex;  // (first block, group), sorted
+
+            // Journal copies of extent tree blocks, by file system block
+            std::unordered_map<uint64_t, std::vector<JournalCopy>> journalBlocks;
+            std::unordered_map<uint64_t, std::vector<uint8_t>> blockCache;
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_EXT4_SCANNER_H
@@ -0,0 +1,190 @@
+/**
+ * Stellar Data Recovery Pro Free - Extent Copier
+ *
+ * FICLONERANGE and copy_file_range on Linux; buffered-only elsewhere.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "extent_copier.h"
+#include "image_source.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+#endif
+
+namespace Stellar {
+    namespace Recovery {
+
+#ifdef __linux__
+
+        DirectOutput::~DirectOutput() {
+            if (descriptor >= 0) {
+                ::close(descriptor);
+            }
+        }
+
+        bool DirectOutput::Open(const std::string& path) {
+            descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            return descriptor >= 0;
+        }
+
+        bool DirectOutput::WriteAt(uint64_t offset, const uint8_t* data, size_t length) {
+            while (length > 0) {
+                ssize_t written = ::pwrite(descriptor, data, length, static_cast<off_t>(offset));
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (written <= 0) {
+                    return false;
+                }
+                data += written;
+                offset += static_cast<uint64_t>(written);
+                length -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        bool DirectOutput::ReadAt(uint64_t offset, uint8_t* data, size_t length) const {
+            while (length > 0) {
+                ssize_t got = ::pread(descriptor, data, length, static_cast<off_t>(offset));
+                if (got < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (got <= 0) {
+                    return false;
+                }
+                data += got;
+                offset += static_cast<uint64_t>(got);
+                length -= static_cast<size_t>(got);
+            }
+            return true;
+        }
+
+        bool DirectOutput::Close(uint64_t size) {
+            bool ok = ::ftruncate(descriptor, static_cast<off_t>(size)) == 0;
+            ok = ::close(descriptor) == 0 && ok;
+            descriptor = -1;
+            return ok;
+        }
+
+        ExtentCopier::ExtentCopier(const std::string& imagePath) {
+            // Devices and volumes cannot be a copy_file_range source
+            if (IsImageFile(imagePath)) {
+                descriptor = ::open(imagePath.c_str(), O_RDONLY | O_CLOEXEC);
+            }
+        }
+
+        ExtentCopier::~ExtentCopier() {
+            if (descriptor >= 0) {
+                ::close(descriptor);
+            }
+        }
+
+        uint64_t ExtentCopier::Copy(DirectOutput& out, uint64_t outOffset, uint64_t sourceOffset, uint64_t length,
+                                    CopyMethod& method) {
+            method = CopyMethod::BUFFERED;
+            if (descriptor < 0 || !out.IsOpen() || length == 0) {
+                return 0;
+            }
+
+            // Reflinks share whole blocks, so both offsets and the length must be block aligned
+            struct stat info;
+            if (reflinks && ::fstat(out.descriptor, &info) == 0 && info.st_blksize > 0) {
+                const uint64_t block = static_cast<uint64_t>(info.st_blksize);
+                if (sourceOffset % block == 0 && outOffset % block == 0 && length % block == 0) {
+                    file_clone_range range = {};
+                    range.src_fd = descriptor;
+                    range.src_offset = sourceOffset;
+                    range.src_length = length;
+                    range.dest_offset = outOffset;
+                    if (::ioctl(out.descriptor, FICLONERANGE, &range) == 0) {
+                        method = CopyMethod::REFLINK;
+                        return length;
+                    }
+                    if (errno == EOPNOTSUPP || errno == ENOTTY || errno == EXDEV || errno == EPERM) {
+                        reflinks = false;
+                    }
+                }
+            }
+
+            uint64_t moved = 0;
+            while (kernelCopies && moved < length) {
+                loff_t in = static_cast<loff_t>(sourceOffset + moved);
+                loff_t to = static_cast<loff_t>(outOffset + moved);
+                ssize_t copied = ::copy_file_range(descriptor, &in, out.descriptor, &to,
+                                                   static_cast<size_t>(length - moved), 0);
+                if (copied > 0) {
+                    moved += static_cast<uint64_t>(copied);
+                    continue;
+                }
+                if (copied < 0 && errno == EINTR) {
+                    continue;
+                }
+                // Older kernels refuse cross-file-system copies; anything else is left to the caller
+                if (copied < 0 && (errno == ENOSYS || errno == EXDEV || errno == EOPNOTSUPP || errno == EINVAL)) {
+                    kernelCopies = false;
+                }
+                break;
+            }
+            if (moved > 0) {
+                method = CopyMethod::KERNEL_COPY;
+            }
+            return moved;
+        }
+
+#else
+
+        DirectOutput::~DirectOutput() = default;
+
+        bool DirectOutput::Open(const std::string& path) {
+            (void)path;
+            return false;
+        }
+
+        bool DirectOutput::WriteAt(uint64_t offset, const uint8_t* data, size_t length) {
+            (void)offset;
+            (void)data;
+            (void)length;
+            return false;
+        }
+
+        bool DirectOutput::ReadAt(uint64_t offset, uint8_t* data, size_t length) const {
+            (void)offset;
+            (void)data;
+            (void)length;
+            return false;
+        }
+
+        bool DirectOutput::Close(uint64_t size) {
+            (void)size;
+            return false;
+        }
+
+        ExtentCopier::ExtentCopier(const std::string& imagePath) {
+            (void)imagePath;
+        }
+
+        ExtentCopier::~ExtentCopier() = default;
+
+        uint64_t ExtentCopier::Copy(DirectOutput& out, uint64_t outOffset, uint64_t sourceOffset, uint64_t length,
+                                    CopyMethod& method) {
+            (void)out;
+            (void)outOffset;
+            (void)sourceOffset;
+            (void)length;
+            method = CopyMethod::BUFFERED;
+            return 0;
+        }
+
+#endif
+
+    } // namespace Recovery
+} // namespace Stellar
@@ -0,0 +1,93 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Extent Copier
+ *
+ * Moves file data from a disk image to an output file inside the kernel.
+ * Ranges are first tried as a reflink (shared blocks on XFS and Btrfs),
+ * then with copy_file_range. Callers fall back to their buffered path for
+ * whatever was not moved. Only available on Linux with an image file
+ * as the source.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_EXTENT_COPIER_H
+#define STELLAR_EXTENT_COPIER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Stellar {
+    namespace Recovery {
+
+        enum class CopyMethod {
+            BUFFERED,       // Read into memory and written back
+            KERNEL_COPY,    // copy_file_range
+            REFLINK         // Blocks shared with the image
+        };
+
+        /**
+         * Output file written by offset, either through an ExtentCopier or
+         * from memory
+         */
+        class DirectOutput {
+        public:
+            DirectOutput() = default;
+            ~DirectOutput();
+
+            DirectOutput(const DirectOutput&) = delete;
+            DirectOutput& operator=(const DirectOutput&) = delete;
+
+            // Create or truncate path; false when it cannot be opened
+            bool Open(const std::string& path);
+
+            bool WriteAt(uint64_t offset, const uint8_t* data, size_t length);
+
+            // Read back written bytes; false on a short read
+            bool ReadAt(uint64_t offset, uint8_t* data, size_t length) const;
+
+            // Set the final size (unwritten ranges read as zeros) and close
+            bool Close(uint64_t size);
+
+            bool IsOpen() const { return descriptor >= 0; }
+
+        private:
+            friend class ExtentCopier;
+
+            int descriptor = -1;
+        };
+
+        class ExtentCopier {
+        public:
+            // Never throws; check Available()
+            explicit ExtentCopier(const std::string& imagePath);
+            ~ExtentCopier();
+
+            ExtentCopier(const ExtentCopier&) = delete;
+            ExtentCopier& operator=(const ExtentCopier&) = delete;
+
+            bool Available() const { return descriptor >= 0; }
+
+            /**
+             * Move image bytes [sourceOffset, sourceOffset + length) to out
+             * at outOffset. Returns the bytes moved and the method used;
+             * less than length when the kernel refused the rest. Safe to
+             * call from several threads.
+             */
+            uint64_t Copy(DirectOutput& out, uint64_t outOffset, uint64_t sourceOffset, uint64_t length,
+                          CopyMethod& method);
+
+        private:
+            int descriptor = -1;
+            std::atomic<bool> reflinks{true};       // Cleared once the file system refuses them
+            std::atomic<bool> kernelCopies{true};
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_EXTENT_COPIER_H
@@ -0,0 +1,642 @@
+/**
+ * Stellar Data Recovery Pro Free - FAT and exFAT Scanner
+ *
+ * FAT caching, directory walking and chain reconstruction.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "fat_scanner.h"
+#include <algorithm>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            constexpr size_t DIRECTORY_ENTRY_SIZE = 32;
+            constexpr size_t MAX_DIRECTORY_BYTES = 64u << 20;    // Guards against looping chains
+            constexpr size_t FAT_READ_CHUNK_SIZE = 8u << 20;
+
+            // FAT directory entry
+            constexpr uint8_t FAT_DELETED = 0xE5;
+            constexpr uint8_t FAT_KANJI_E5 = 0x05;
+            constexpr uint8_t FAT_ATTR_VOLUME_ID = 0x08;
+            constexpr uint8_t FAT_ATTR_DIRECTORY = 0x10;
+            constexpr uint8_t FAT_ATTR_LONG_NAME = 0x0F;
+
+            // exFAT entry types (in-use bit 0x80 cleared when deleted)
+            constexpr uint8_t EXFAT_IN_USE = 0x80;
+            constexpr uint8_t EXFAT_ALLOCATION_BITMAP = 0x81;
+            constexpr uint8_t EXFAT_FILE = 0x05;
+            constexpr uint8_t EXFAT_STREAM_EXTENSION = 0x40;
+            constexpr uint8_t EXFAT_FILE_NAME = 0x41;
+            constexpr uint8_t EXFAT_NO_FAT_CHAIN = 0x02;
+            constexpr uint16_t EXFAT_ATTR_DIRECTORY = 0x10;
+
+            uint8_t LongNameChecksum(const uint8_t* shortName) {
+                uint8_t sum = 0;
+                for (size_t i = 0; i < 11; i++) {
+                    sum = static_cast<uint8_t>(((sum & 1) << 7) + (sum >> 1) + shortName[i]);
+                }
+                return sum;
+            }
+
+            // "NAME    EXT" to "NAME.EXT"
+            std::string ShortName(const uint8_t* entry) {
+                std::string base(reinterpret_cast<const char*>(entry), 8);
+                std::string extension(reinterpret_cast<const char*>(entry + 8), 3);
+                base.erase(base.find_last_not_of(' ') + 1);
+                extension.erase(extension.find_last_not_of(' ') + 1);
+                return extension.empty() ? base : base + "." + extension;
+            }
+
+            // Long name from LFN entries collected in on-disk order (last part first)
+            std::string LongName(const std::vector<const uint8_t*>& parts) {
+                std::vector<uint8_t> units;
+                for (auto it = parts.rbegin(); it != parts.rend(); ++it) {
+                    const uint8_t* entry = *it;
+                    units.insert(units.end(), entry + 1, entry + 11);
+                    units.insert(units.end(), entry + 14, entry + 26);
+                    units.insert(units.end(), entry + 28, entry + 32);
+                }
+                size_t count = 0;
+                while (count * 2 + 1 < units.size() && ReadLE16(units.data() + count * 2) != 0 &&
+                       ReadLE16(units.data() + count * 2) != 0xFFFF) {
+                    count++;
+                }
+                return Utf16ToUtf8(units.data(), count);
+            }
+
+            int64_t DaysFromCivil(int64_t year, unsigned month, unsigned day) {
+                year -= month <= 2;
+                const int64_t era = (year >= 0 ? year : year - 399) / 400;
+                const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+                const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+                const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+                return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+            }
+
+            // DOS date in the high word, time in the low word; volumes store local time
+            std::chrono::system_clock::time_point DosTimeToTimePoint(uint32_t stamp) {
+                unsigned day = (stamp >> 16) & 0x1F;
+                unsigned month = (stamp >> 21) & 0x0F;
+                unsigned year = 1980 + ((stamp >> 25) & 0x7F);
+                if (day == 0 || month == 0 || month > 12) {
+                    return std::chrono::system_clock::time_point();
+                }
+                int64_t seconds = DaysFromCivil(year, month, day) * 86400 +
+                                  ((stamp >> 11) & 0x1F) * 3600 + ((stamp >> 5) & 0x3F) * 60 + (stamp & 0x1F) * 2;
+                return std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::seconds(seconds)));
+            }
+
+        } // namespace
+
+        // FatTable --------------------------------------------------------
+
+        void FatTable::Reset(FatVariant variant, uint32_t clusterCount) {
+            this->variant = variant;
+            unitSize = variant == FatVariant::FAT12 ? 3 : variant == FatVariant::FAT16 ? 2 : 4;
+            decoded = 0;
+            carry.clear();
+            entries.assign(static_cast<size_t>(clusterCount) + 2, FREE);
+            allocated.assign((entries.size() + 63) / 64, 0);
+        }
+
+        void FatTable::Append(const uint8_t* data, size_t length) {
+            if (!carry.empty()) {
+                size_t take = std::min(unitSize - carry.size(), length);
+                carry.insert(carry.end(), data, data + take);
+                data += take;
+                length -= take;
+                if (carry.size() < unitSize) {
+                    return;
+                }
+                Decode(carry.data());
+                carry.clear();
+            }
+            while (length >= unitSize && decoded < entries.size()) {
+                Decode(data);
+                data += unitSize;
+                length -= unitSize;
+            }
+            if (decoded < entries.size()) {
+                carry.assign(data, data + length);
+            }
+        }
+
+        void FatTable::Decode(const uint8_t* unit) {
+            uint32_t values[2];
+            size_t count = 1;
+            uint32_t endOfChain;
+            uint32_t bad;
+            switch (variant) {
+                case FatVariant::FAT12:
+                    values[0] = unit[0] | ((unit[1] & 0x0F) << 8);
+                    values[1] = (unit[1] >> 4) | (unit[2] << 4);
+                    count = 2;
+                    endOfChain = 0xFF8;
+                    bad = 0xFF7;
+                    break;
+                case FatVariant::FAT16:
+                    values[0] = ReadLE16(unit);
+                    endOfChain = 0xFFF8;
+                    bad = 0xFFF7;
+                    break;
+                case FatVariant::FAT32:
+                    values[0] = ReadLE32(unit) & 0x0FFFFFFF;
+                    endOfChain = 0x0FFFFFF8;
+                    bad = 0x0FFFFFF7;
+                    break;
+                case FatVariant::EXFAT:
+                default:
+                    values[0] = ReadLE32(unit);
+                    endOfChain = 0xFFFFFFF8u;
+                    bad = 0xFFFFFFF7u;
+                    break;
+            }
+
+            for (size_t i = 0; i < count && decoded < entries.size(); i++, decoded++) {
+                uint32_t value = values[i];
+                value = value >= endOfChain ? END_OF_CHAIN : value == bad ? BAD : value;
+                entries[decoded] = value;
+                if (value != FREE && decoded >= 2) {
+                    allocated[decoded / 64] |= 1ull << (decoded % 64);
+                }
+            }
+        }
+
+        void FatTable::SetAllocationBitmap(const uint8_t* bitmap, size_t length) {
+            std::fill(allocated.begin(), allocated.end(), 0);
+            // Bit 0 of the bitmap is cluster 2
+            for (size_t cluster = 2; cluster < entries.size() && (cluster - 2) / 8 < length; cluster++) {
+                if ((bitmap[(cluster - 2) / 8] >> ((cluster - 2) % 8)) & 1) {
+                    allocated[cluster / 64] |= 1ull << (cluster % 64);
+                }
+            }
+        }
+
+        std::vector<uint32_t> FatTable::Chain(uint32_t first, size_t limit) const {
+            std::vector<uint32_t> chain;
+            uint32_t cluster = first;
+            while (IsValidCluster(cluster) && chain.size() < limit) {
+                chain.push_back(cluster);
+                uint32_t next = entries[cluster];
+                if (next == END_OF_CHAIN) {
+                    return chain;
+                }
+                if (chain.size() > entries.size()) {
+                    break;
+                }
+                cluster = next;
+            }
+            if (chain.size() == limit) {
+                return chain;
+            }
+            return {};
+        }
+
+        // FatScanner ------------------------------------------------------
+
+        FatScanner::FatScanner(SectorSource& source, uint64_t volumeOffset) :
+            FileSystemScanner(source, volumeOffset) {
+            AlignedBuffer boot(IO_ALIGNMENT);
+            if (Read(0, boot.Data(), boot.Size()) < 512 || !DetectVariant(boot.Data(), variant)) {
+                throw FileSystemError("No FAT or exFAT boot sector on " + source.Path());
+            }
+            const uint8_t* sector = boot.Data();
+
+            if (variant == FatVariant::EXFAT) {
+                sectorSize = 1u << sector[0x6C];
+                clusterSize = sectorSize << sector[0x6D];
+                fatOffset = static_cast<uint64_t>(ReadLE32(sector + 0x50)) * sectorSize;
+                fatLength = static_cast<uint64_t>(ReadLE32(sector + 0x54)) * sectorSize;
+                dataOffset = static_cast<uint64_t>(ReadLE32(sector + 0x58)) * sectorSize;
+                clusterCount = ReadLE32(sector + 0x5C);
+                rootCluster = ReadLE32(sector + 0x60);
+            } else {
+                sectorSize = ReadLE16(sector + 0x0B);
+                clusterSize = sectorSize * sector[0x0D];
+                uint32_t reserved = ReadLE16(sector + 0x0E);
+                uint32_t fats = sector[0x10];
+                uint32_t rootEntries = ReadLE16(sector + 0x11);
+                uint32_t fatSectors = ReadLE16(sector + 0x16) ? ReadLE16(sector + 0x16) : ReadLE32(sector + 0x24);
+                uint32_t totalSectors = ReadLE16(sector + 0x13) ? ReadLE16(sector + 0x13) : ReadLE32(sector + 0x20);
+                uint32_t rootSectors = (rootEntries * DIRECTORY_ENTRY_SIZE + sectorSize - 1) / sectorSize;
+                uint64_t metaSectors = reserved + static_cast<uint64_t>(fats) * fatSectors + rootSectors;
+
+                fatOffset = static_cast<uint64_t>(reserved) * sectorSize;
+                fatLength = static_cast<uint64_t>(fatSectors) * sectorSize;
+                rootOffset = fatOffset + fats * fatLength;
+                rootLength = static_cast<uint64_t>(rootSectors) * sectorSize;
+                dataOffset = metaSectors * sectorSize;
+                clusterCount = static_cast<uint32_t>((totalSectors - metaSectors) / sector[0x0D]);
+                rootCluster = variant == FatVariant::FAT32 ? ReadLE32(sector + 0x2C) : 0;
+            }
+
+            // Bytes needed for clusterCount + 2 entries
+            uint64_t needed = variant == FatVariant::FAT12 ? (static_cast<uint64_t>(clusterCount) + 3) / 2 * 3
+                            : variant == FatVariant::FAT16 ? (static_cast<uint64_t>(clusterCount) + 2) * 2
+                                                            : (static_cast<uint64_t>(clusterCount) + 2) * 4;
+            if (clusterCount == 0 || fatLength < needed) {
+                throw FileSystemError("Inconsistent FAT geometry on " + source.Path());
+            }
+            fatLength = needed;
+        }
+
+        FileSystemType FatScanner::Type() const {
+            switch (variant) {
+                case FatVariant::EXFAT: return FileSystemType::EXFAT;
+                case FatVariant::FAT32: return FileSystemType::FAT32;
+                default: return FileSystemType::FAT16;
+            }
+        }
+
+        bool FatScanner::DetectVariant(const uint8_t* sector, FatVariant& variant) {
+            if (sector[510] != 0x55 || sector[511] != 0xAA) {
+                return false;
+            }
+            if (std::memcmp(sector + 3, "EXFAT   ", 8) == 0) {
+                uint8_t sectorShift = sector[0x6C];
+                uint8_t clusterShift = sector[0x6D];
+                if (sectorShift < 9 || sectorShift > 12 || sectorShift + clusterShift > 25) {
+                    return false;
+                }
+                variant = FatVariant::EXFAT;
+                return true;
+            }
+            if ((sector[0] != 0xEB && sector[0] != 0xE9) || std::memcmp(sector + 3, "NTFS    ", 8) == 0) {
+                return false;
+            }
+
+            uint32_t bytesPerSector = ReadLE16(sector + 0x0B);
+            uint32_t sectorsPerCluster = sector[0x0D];
+            uint32_t reserved = ReadLE16(sector + 0x0E);
+            uint32_t fats = sector[0x10];
+            uint32_t rootEntries = ReadLE16(sector + 0x11);
+            uint32_t fatSectors = ReadLE16(sector + 0x16) ? ReadLE16(sector + 0x16) : ReadLE32(sector + 0x24);
+            uint32_t totalSectors = ReadLE16(sector + 0x13) ? ReadLE16(sector + 0x13) : ReadLE32(sector + 0x20);
+            bool geometryOk = bytesPerSector >= 512 && bytesPerSector <= 4096 &&
+                              (bytesPerSector & (bytesPerSector - 1)) == 0 &&
+                              sectorsPerCluster != 0 && (sectorsPerCluster & (sectorsPerCluster - 1)) == 0 &&
+                              reserved != 0 && fats >= 1 && fats <= 2 && fatSectors != 0 && sector[0x15] >= 0xF0;
+            if (!geometryOk) {
+                return false;
+            }
+
+            uint32_t rootSectors = (rootEntries * DIRECTORY_ENTRY_SIZE + bytesPerSector - 1) / bytesPerSector;
+            uint64_t metaSectors = reserved + static_cast<uint64_t>(fats) * fatSectors + rootSectors;
+            if (totalSectors <= metaSectors) {
+                return false;
+            }
+            // The variant is defined by the cluster count alone
+            uint64_t clusters = (totalSectors - metaSectors) / sectorsPerCluster;
+            variant = clusters < 4085 ? FatVariant::FAT12 : clusters < 65525 ? FatVariant::FAT16 : FatVariant::FAT32;
+            return variant != FatVariant::FAT32 || rootEntries == 0;
+        }
+
+        std::vector<RecoverableFile> FatScanner::ScanDeleted(const ProgressCallback& progress) {
+            LoadFat(progress);
+
+            // Directories are read in ascending cluster order to keep the head moving forward
+            auto laterCluster = [](const PendingDirectory& a, const PendingDirectory& b) {
+                return a.firstCluster > b.firstCluster;
+            };
+            std::vector<PendingDirectory> pending;
+            pending.push_back(PendingDirectory{rootCluster, 0, false, false, ""});
+            std::vector<bool> visited(table.EntryCount(), false);
+            std::vector<DeletedEntry> deleted;
+            size_t processed = 0;
+
+            while (!pending.empty()) {
+                std::pop_heap(pending.begin(), pending.end(), laterCluster);
+                PendingDirectory directory = std::move(pending.back());
+                pending.pop_back();
+
+                std::vector<uint8_t> data = ReadDirectory(directory, visited);
+                size_t before = pending.size();
+                if (variant == FatVariant::EXFAT) {
+                    ParseExFatDirectory(data, directory, pending, deleted);
+                } else {
+                    ParseFatDirectory(data, directory, pending, deleted);
+                }
+                for (size_t i = before; i < pending.size(); i++) {
+                    std::push_heap(pending.begin(), pending.begin() + i + 1, laterCluster);
+                }
+
+                processed++;
+                if (progress) {
+                    progress(static_cast<int>(20 + 80 * processed / (processed + pending.size())),
+                             "Reading directories...");
+                }
+            }
+
+            std::vector<RecoverableFile> files;
+            files.reserve(deleted.size());
+            for (const auto& entry : deleted) {
+                double confidence = 0.0;
+                std::vector<uint32_t> clusters = RebuildChain(entry, confidence);
+                if (clusters.empty()) {
+                    continue;
+                }
+
+                RecoverableFile file;
+                file.fileName = entry.name;
+                file.originalPath = entry.path + "\\" + entry.name;
+                file.fileType = ClassifyFileName(entry.name);
+                file.fileSize = entry.size;
+                file.dateCreated = DosTimeToTimePoint(entry.created);
+                file.dateModified = DosTimeToTimePoint(entry.modified);
+                file.dateAccessed = DosTimeToTimePoint(entry.accessed);
+                file.recoveryConfidence = confidence;
+
+                uint64_t remaining = entry.size;
+                for (uint32_t cluster : clusters) {
+                    uint64_t length = std::min<uint64_t>(clusterSize, remaining);
+                    uint64_t offset = ClusterOffset(cluster);
+                    remaining -= length;
+                    if (!file.extents.empty() && file.extents.back().offset + file.extents.back().length == offset) {
+                        file.extents.back().length += length;
+                    } else {
+                        file.extents.push_back(FileExtent{offset, length});
+                    }
+                }
+                files.push_back(std::move(file));
+            }
+
+            if (progress) {
+                progress(100, "Reading directories...");
+            }
+            return files;
+        }
+
+        void FatScanner::LoadFat(const ProgressCallback& progress) {
+            table.Reset(variant, clusterCount);
+
+            ReaderOptions options;
+            options.chunkSize = FAT_READ_CHUNK_SIZE;
+            options.startOffset = volumeOffset + fatOffset;
+            options.endOffset = options.startOffset + fatLength;
+            SectorReader reader(source, options);
+
+            SectorChunk chunk;
+            while (reader.Next(chunk)) {
+                bytesRead += chunk.length;
+                table.Append(chunk.data, chunk.length);
+                if (progress) {
+                    progress(static_cast<int>(reader.BytesConsumed() * 20 / fatLength), "Loading FAT...");
+                }
+            }
+        }
+
+        void FatScanner::LoadAllocationBitmap(uint32_t firstCluster, uint64_t length) {
+            size_t clusters = static_cast<size_t>((length + clusterSize - 1) / clusterSize);
+            std::vector<uint32_t> chain = table.Chain(firstCluster, clusters);
+            if (chain.empty()) {
+                for (size_t i = 0; i < clusters && table.IsValidCluster(firstCluster + static_cast<uint32_t>(i)); i++) {
+                    chain.push_back(firstCluster + static_cast<uint32_t>(i));
+                }
+            }
+            std::vector<uint8_t> bitmap = ReadClusters(chain);
+            table.SetAllocationBitmap(bitmap.data(), std::min<size_t>(bitmap.size(), static_cast<size_t>(length)));
+        }
+
+        std::vector<uint8_t> FatScanner::ReadDirectory(const PendingDirectory& directory, std::vector<bool>& visited) {
+            if (directory.firstCluster == 0) {
+                std::vector<uint8_t> data(static_cast<size_t>(rootLength));
+                data.resize(Read(rootOffset, data.data(), data.size()));
+                return data;
+            }
+
+            const size_t limit = MAX_DIRECTORY_BYTES / clusterSize;
+            std::vector<uint32_t> clusters;
+            if (directory.contiguous && directory.size > 0) {
+                size_t count = static_cast<size_t>(std::min<uint64_t>((directory.size + clusterSize - 1) / clusterSize, limit));
+                for (size_t i = 0; i < count && table.IsValidCluster(directory.firstCluster + static_cast<uint32_t>(i)); i++) {
+                    clusters.push_back(directory.firstCluster + static_cast<uint32_t>(i));
+                }
+            } else if (!directory.deleted || variant == FatVariant::EXFAT) {
+                // exFAT leaves the FAT chain of deleted entries in place
+                clusters = table.Chain(directory.firstCluster, limit);
+            }
+            if (clusters.empty() && table.IsValidCluster(directory.firstCluster)) {
+                // FAT zeroes deleted chains; the first cluster is all we know
+                clusters.push_back(directory.firstCluster);
+            }
+
+            // Directory loops and clusters shared with another directory
+            clusters.erase(std::remove_if(clusters.begin(), clusters.end(),
+                                          [&visited](uint32_t cluster) { return visited[cluster]; }),
+                           clusters.end());
+            for (uint32_t cluster : clusters) {
+                visited[cluster] = true;
+            }
+            return ReadClusters(clusters);
+        }
+
+        std::vector<uint8_t> FatScanner::ReadClusters(const std::vector<uint32_t>& clusters) {
+            std::vector<uint8_t> data(clusters.size() * clusterSize);
+            // One read per physically contiguous run
+            for (size_t i = 0; i < clusters.size();) {
+                size_t run = 1;
+                while (i + run < clusters.size() && clusters[i + run] == clusters[i] + run) {
+                    run++;
+                }
+                Read(dataOffset + static_cast<uint64_t>(clusters[i] - 2) * clusterSize,
+                     data.data() + i * clusterSize, run * clusterSize);
+                i += run;
+            }
+            return data;
+        }
+
+        void FatScanner::ParseFatDirectory(const std::vector<uint8_t>& data, const PendingDirectory& directory,
+                                           std::vector<PendingDirectory>& pending, std::vector<DeletedEntry>& deleted) {
+            // An overwritten deleted directory no longer starts with "."
+            if (directory.deleted && (data.size() < DIRECTORY_ENTRY_SIZE || std::memcmp(data.data(), ".          ", 11) != 0)) {
+                return;
+            }
+
+            std::vector<const uint8_t*> longName;
+            for (size_t offset = 0; offset + DIRECTORY_ENTRY_SIZE <= data.size(); offset += DIRECTORY_ENTRY_SIZE) {
+                const uint8_t* entry = data.data() + offset;
+                if (entry[0] == 0x00) {
+                    break;
+                }
+                uint8_t attributes = entry[11];
+                if (attributes == FAT_ATTR_LONG_NAME) {
+                    // Live sequences restart at the entry flagged as last
+                    if (entry[0] != FAT_DELETED && (entry[0] & 0x40)) {
+                        longName.clear();
+                    }
+                    longName.push_back(entry);
+                    continue;
+                }
+                if (attributes & FAT_ATTR_VOLUME_ID || entry[0] == '.') {
+                    longName.clear();
+                    continue;
+                }
+
+                bool entryDeleted = entry[0] == FAT_DELETED;
+                uint8_t shortName[11];
+                std::memcpy(shortName, entry, sizeof(shortName));
+                if (shortName[0] == FAT_KANJI_E5) {
+                    shortName[0] = FAT_DELETED;
+                }
+
+                // A deleted entry lost its first character; the LFN checksum recovers it
+                std::string name;
+                if (!longName.empty()) {
+                    uint8_t expected = longName.front()[13];
+                    bool matched = !entryDeleted && LongNameChecksum(shortName) == expected;
+                    for (int candidate = 0x20; entryDeleted && !matched && candidate < 0x100; candidate++) {
+                        shortName[0] = static_cast<uint8_t>(candidate);
+                        matched = LongNameChecksum(shortName) == expected;
+                    }
+                    if (matched) {
+                        name = LongName(longName);
+                    }
+                }
+                if (name.empty()) {
+                    if (entryDeleted) {
+                        shortName[0] = '_';
+                    }
+                    name = ShortName(shortName);
+                }
+                longName.clear();
+
+                uint32_t cluster = ReadLE16(entry + 26);
+                if (variant == FatVariant::FAT32) {
+                    cluster |= static_cast<uint32_t>(ReadLE16(entry + 20)) << 16;
+                }
+                uint32_t size = ReadLE32(entry + 28);
+                bool gone = entryDeleted || directory.deleted;
+
+                if (attributes & FAT_ATTR_DIRECTORY) {
+                    if (table.IsValidCluster(cluster)) {
+                        pending.push_back(PendingDirectory{cluster, 0, gone, false, directory.path + "\\" + name});
+                    }
+                } else if (gone && size > 0 && table.IsValidCluster(cluster)) {
+                    uint32_t created = (static_cast<uint32_t>(ReadLE16(entry + 16)) << 16) | ReadLE16(entry + 14);
+                    uint32_t modified = (static_cast<uint32_t>(ReadLE16(entry + 24)) << 16) | ReadLE16(entry + 22);
+                    uint32_t accessed = static_cast<uint32_t>(ReadLE16(entry + 18)) << 16;
+                    deleted.push_back(DeletedEntry{name, directory.path, cluster, size, false,
+                                                   created, modified, accessed});
+                }
+            }
+        }
+
+        void FatScanner::ParseExFatDirectory(const std::vector<uint8_t>& data, const PendingDirectory& directory,
+                                             std::vector<PendingDirectory>& pending, std::vector<DeletedEntry>& deleted) {
+            const size_t count = data.size() / DIRECTORY_ENTRY_SIZE;
+            for (size_t index = 0; index < count; index++) {
+                const uint8_t* entry = data.data() + index * DIRECTORY_ENTRY_SIZE;
+                uint8_t type = entry[0];
+                if (type == 0x00) {
+                    break;
+                }
+                if (type == EXFAT_ALLOCATION_BITMAP && directory.firstCluster == rootCluster) {
+                    LoadAllocationBitmap(ReadLE32(entry + 20), ReadLE64(entry + 24));
+                    continue;
+                }
+                if ((type & ~EXFAT_IN_USE) != EXFAT_FILE) {
+                    continue;
+                }
+
+                // File entry, stream extension, then 15-character name entries
+                size_t secondary = entry[1];
+                if (secondary < 2 || index + secondary >= count) {
+                    continue;
+                }
+                const uint8_t* stream = entry + DIRECTORY_ENTRY_SIZE;
+                bool inUse = (type & EXFAT_IN_USE) != 0;
+                if ((stream[0] & ~EXFAT_IN_USE) != EXFAT_STREAM_EXTENSION || ((stream[0] & EXFAT_IN_USE) != 0) != inUse) {
+                    continue;
+                }
+
+                size_t nameLength = stream[3];
+                std::vector<uint8_t> units;
+                for (size_t part = 2; part <= secondary && units.size() < nameLength * 2; part++) {
+                    const uint8_t* nameEntry = entry + part * DIRECTORY_ENTRY_SIZE;
+                    if ((nameEntry[0] & ~EXFAT_IN_USE) != EXFAT_FILE_NAME) {
+                        break;
+                    }
+                    units.insert(units.end(), nameEntry + 2, nameEntry + 32);
+                }
+                std::string name = Utf16ToUtf8(units.data(), std::min(nameLength, units.size() / 2));
+                index += secondary;
+                if (name.empty()) {
+                    continue;
+                }
+
+                uint16_t attributes = ReadLE16(entry + 4);
+                bool contiguous = (stream[1] & EXFAT_NO_FAT_CHAIN) != 0;
+                uint32_t cluster = ReadLE32(stream + 20);
+                uint64_t size = ReadLE64(stream + 24);
+                bool gone = !inUse || directory.deleted;
+
+                if (attributes & EXFAT_ATTR_DIRECTORY) {
+                    if (table.IsValidCluster(cluster)) {
+                        pending.push_back(PendingDirectory{cluster, size, gone, contiguous, directory.path + "\\" + name});
+                    }
+                } else if (gone && size > 0 && table.IsValidCluster(cluster)) {
+                    deleted.push_back(DeletedEntry{name, directory.path, cluster, size, contiguous,
+                                                   ReadLE32(entry + 8), ReadLE32(entry + 12), ReadLE32(entry + 16)});
+                }
+            }
+        }
+
+        std::vector<uint32_t> FatScanner::RebuildChain(const DeletedEntry& entry, double& confidence) const {
+            const size_t needed = static_cast<size_t>((entry.size + clusterSize - 1) / clusterSize);
+            const uint32_t first = entry.firstCluster;
+            if (!table.IsValidCluster(first) || needed == 0) {
+                return {};
+            }
+
+            std::vector<uint32_t> clusters;
+            double base;
+            if (entry.contiguous) {
+                for (size_t i = 0; i < needed && table.IsValidCluster(first + static_cast<uint32_t>(i)); i++) {
+                    clusters.push_back(first + static_cast<uint32_t>(i));
+                }
+                base = 0.9;
+            } else if (variant == FatVariant::EXFAT && !(clusters = table.Chain(first, needed)).empty()) {
+                base = 0.85;
+            } else if (table.IsAllocated(first)) {
+                // The start was reused; the tail may still be intact
+                for (size_t i = 0; i < needed && table.IsValidCluster(first + static_cast<uint32_t>(i)); i++) {
+                    clusters.push_back(first + static_cast<uint32_t>(i));
+                }
+                base = 0.2;
+            } else {
+                // Zeroed chain: assume the file took the next free clusters
+                bool skipped = false;
+                for (uint32_t cluster = first; clusters.size() < needed && table.IsValidCluster(cluster); cluster++) {
+                    if (table.IsAllocated(cluster)) {
+                        skipped = true;
+                        continue;
+                    }
+                    clusters.push_back(cluster);
+                }
+                base = skipped ? 0.5 : 0.8;
+            }
+            if (clusters.size() < needed) {
+                return {};
+            }
+
+            size_t unallocated = 0;
+            for (uint32_t cluster : clusters) {
+                unallocated += table.IsAllocated(cluster) ? 0 : 1;
+            }
+            confidence = std::max(0.05, base * static_cast<double>(unallocated) / static_cast<double>(clusters.size()));
+            return clusters;
+        }
+
+        uint64_t FatScanner::ClusterOffset(uint32_t cluster) const {
+            return volumeOffset + dataOffset + static_cast<uint64_t>(cluster - 2) * clusterSize;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
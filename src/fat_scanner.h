@@ -0,0 +1,152 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - FAT and exFAT Scanner
+ *
+ * Quick-scan backend for FAT12/16/32 and exFAT volumes. The FAT is read
+ * once into memory; directories are then walked in ascending cluster
+ * order looking for deleted entries (0xE5 names, exFAT entry sets with
+ * the in-use bit cleared). Cluster chains of deleted files are rebuilt
+ * from the cached FAT when it still holds them, otherwise from
+ * contiguous-allocation heuristics.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_FAT_SCANNER_H
+#define STELLAR_FAT_SCANNER_H
+
+#include "filesystem_scanner.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        enum class FatVariant {
+            FAT12,
+            FAT16,
+            FAT32,
+            EXFAT
+        };
+
+        /**
+         * In-memory copy of a FAT with end-of-chain and bad markers
+         * normalised across variants, plus the cluster allocation bitmap
+         */
+        class FatTable {
+        public:
+            static constexpr uint32_t FREE = 0;
+            static constexpr uint32_t BAD = 0xFFFFFFF7u;
+            static constexpr uint32_t END_OF_CHAIN = 0xFFFFFFFFu;
+
+            FatTable() = default;
+
+            // Start a new table; clusterCount excludes the two reserved entries
+            void Reset(FatVariant variant, uint32_t clusterCount);
+
+            // Decode the next raw FAT bytes, in on-disk order
+            void Append(const uint8_t* data, size_t length);
+
+            uint32_t Next(uint32_t cluster) const {
+                return cluster < entries.size() ? entries[cluster] : END_OF_CHAIN;
+            }
+
+            bool IsAllocated(uint32_t cluster) const {
+                return cluster < entries.size() && ((allocated[cluster / 64] >> (cluster % 64)) & 1) != 0;
+            }
+
+            // Replace FAT-derived allocation with an exFAT allocation bitmap
+            void SetAllocationBitmap(const uint8_t* bitmap, size_t length);
+
+            bool IsValidCluster(uint32_t cluster) const {
+                return cluster >= 2 && cluster < entries.size();
+            }
+
+            // Live chain from first, or empty if it is broken or loops
+            std::vector<uint32_t> Chain(uint32_t first, size_t limit) const;
+
+            size_t EntryCount() const { return entries.size(); }
+
+        private:
+            void Decode(const uint8_t* unit);
+
+            FatVariant variant = FatVariant::FAT32;
+            size_t unitSize = 4;               // Bytes decoded at once (FAT12: 3 bytes, 2 entries)
+            size_t decoded = 0;                // Entries decoded so far
+            std::vector<uint8_t> carry;        // Partial unit from the previous Append
+            std::vector<uint32_t> entries;     // Indexed by cluster number
+            std::vector<uint64_t> allocated;   // One bit per cluster
+        };
+
+        /**
+         * FAT12/16/32 and exFAT backend. The constructor validates the boot
+         * sector and derives the volume layout.
+         */
+        class FatScanner : public FileSystemScanner {
+        public:
+            FatScanner(SectorSource& source, uint64_t volumeOffset = 0);
+
+            FileSystemType Type() const override;
+            std::vector<RecoverableFile> ScanDeleted(const ProgressCallback& progress = ProgressCallback()) override;
+
+            FatVariant Variant() const { return variant; }
+            uint32_t ClusterSize() const { return clusterSize; }
+            uint32_t ClusterCount() const { return clusterCount; }
+
+            // Identify a FAT or exFAT boot sector; false for anything else
+            static bool DetectVariant(const uint8_t* sector, FatVariant& variant);
+
+        private:
+            // A deleted entry waiting for its chain to be rebuilt
+            struct DeletedEntry {
+                std::string name;
+                std::string path;
+                uint32_t firstCluster;
+                uint64_t size;
+                bool contiguous;        // exFAT NoFatChain flag
+                uint32_t created;       // DOS date/time (date in the high word)
+                uint32_t modified;
+                uint32_t accessed;
+            };
+
+            // A directory waiting to be read
+            struct PendingDirectory {
+                uint32_t firstCluster;  // 0 = FAT12/16 fixed root
+                uint64_t size;          // exFAT data length; 0 = follow the chain
+                bool deleted;
+                bool contiguous;
+                std::string path;
+            };
+
+            void LoadFat(const ProgressCallback& progress);
+            void LoadAllocationBitmap(uint32_t firstCluster, uint64_t length);
+            std::vector<uint8_t> ReadDirectory(const PendingDirectory& directory, std::vector<bool>& visited);
+            std::vector<uint8_t> ReadClusters(const std::vector<uint32_t>& clusters);
+            void ParseFatDirectory(const std::vector<uint8_t>& data, const PendingDirectory& directory,
+                                   std::vector<PendingDirectory>& pending, std::vector<DeletedEntry>& deleted);
+            void ParseExFatDirectory(const std::vector<uint8_t>& data, const PendingDirectory& directory,
+                                     std::vector<PendingDirectory>& pending, std::vector<DeletedEntry>& deleted);
+            std::vector<uint32_t> RebuildChain(const DeletedEntry& entry, double& confidence) const;
+            uint64_t ClusterOffset(uint32_t cluster) const;
+
+            FatVariant variant = FatVariant::FAT32;
+            uint32_t sectorSize = 512;
+            uint32_t clusterSize = 4096;
+            uint32_t clusterCount = 0;
+            uint64_t fatOffset = 0;          // Bytes from volume start
+            uint64_t fatLength = 0;
+            uint64_t rootOffset = 0;         // FAT12/16 fixed root directory
+            uint64_t rootLength = 0;
+            uint64_t dataOffset = 0;         // Cluster 2
+            uint32_t rootCluster = 0;        // FAT32 and exFAT
+            FatTable table;
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_FAT_SCANNER_H
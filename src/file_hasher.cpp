@@ -0,0 +1,357 @@
+/**
+ * Stellar Data Recovery Pro Free - File Hasher
+ *
+ * Slicing-by-8 and SSE4.2 CRC32C; portable and SHA-NI SHA-256.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "file_hasher.h"
+#include "cpu_features.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef STELLAR_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define STELLAR_X64 1
+#endif
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            constexpr uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;     // Reflected
+
+            const uint32_t SHA256_INITIAL[8] = {
+                0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+            };
+
+            alignas(16) const uint32_t SHA256_ROUND[64] = {
+                0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+                0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+                0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+                0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+                0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+                0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+                0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+                0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+            };
+
+            // table[k][b]: CRC of byte b followed by k zero bytes
+            struct Crc32cTables {
+                uint32_t table[8][256];
+
+                Crc32cTables() {
+                    for (uint32_t b = 0; b < 256; b++) {
+                        uint32_t crc = b;
+                        for (int bit = 0; bit < 8; bit++) {
+                            crc = (crc >> 1) ^ (CRC32C_POLYNOMIAL & (0u - (crc & 1)));
+                        }
+                        table[0][b] = crc;
+                    }
+                    for (uint32_t b = 0; b < 256; b++) {
+                        for (int k = 1; k < 8; k++) {
+                            table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xFF];
+                        }
+                    }
+                }
+            };
+
+            uint32_t Crc32cPortable(uint32_t crc, const uint8_t* data, size_t length) {
+                static const Crc32cTables tables;
+                const auto& t = tables.table;
+                while (length >= 8) {
+                    uint32_t low, high;
+                    std::memcpy(&low, data, 4);
+                    std::memcpy(&high, data + 4, 4);
+                    low ^= crc;
+                    crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+                          t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+                    data += 8;
+                    length -= 8;
+                }
+                while (length-- > 0) {
+                    crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+                }
+                return crc;
+            }
+
+#ifdef STELLAR_X64
+            STELLAR_TARGET("sse4.2")
+            uint32_t Crc32cSse42(uint32_t crc, const uint8_t* data, size_t length) {
+                uint64_t wide = crc;
+                while (length >= 8) {
+                    uint64_t word;
+                    std::memcpy(&word, data, 8);
+                    wide = _mm_crc32_u64(wide, word);
+                    data += 8;
+                    length -= 8;
+                }
+                crc = static_cast<uint32_t>(wide);
+                while (length-- > 0) {
+                    crc = _mm_crc32_u8(crc, *data++);
+                }
+                return crc;
+            }
+#endif
+
+            inline uint32_t RotateRight(uint32_t value, int count) {
+                return (value >> count) | (value << (32 - count));
+            }
+
+            void Sha256Portable(uint32_t state[8], const uint8_t* data, size_t blocks) {
+                for (; blocks > 0; blocks--, data += 64) {
+                    uint32_t w[64];
+                    for (int i = 0; i < 16; i++) {
+                        w[i] = (static_cast<uint32_t>(data[4 * i]) << 24) | (static_cast<uint32_t>(data[4 * i + 1]) << 16) |
+                               (static_cast<uint32_t>(data[4 * i + 2]) << 8) | data[4 * i + 3];
+                    }
+                    for (int i = 16; i < 64; i++) {
+                        uint32_t s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                        uint32_t s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+                    }
+
+                    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+                    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+                    for (int i = 0; i < 64; i++) {
+                        uint32_t s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+                        uint32_t choose = (e & f) ^ (~e & g);
+                        uint32_t t1 = h + s1 + choose + SHA256_ROUND[i] + w[i];
+                        uint32_t s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+                        uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+                        uint32_t t2 = s0 + majority;
+                        h = g;
+                        g = f;
+                        f = e;
+                        e = d + t1;
+                        d = c;
+                        c = b;
+                        b = a;
+                        a = t1 + t2;
+                    }
+                    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+                    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+                }
+            }
+
+#ifdef STELLAR_X86
+            /**
+             * SHA-NI: two rounds per SHA256RNDS2, with the message schedule
+             * kept in four registers and advanced by SHA256MSG1/MSG2
+             */
+            STELLAR_TARGET("sha,sse4.1,ssse3")
+            void Sha256ShaNi(uint32_t state[8], const uint8_t* data, size_t blocks) {
+                const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+                // State is kept as ABEF and CDGH
+                __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+                __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+                t = _mm_shuffle_epi32(t, 0xB1);
+                state1 = _mm_shuffle_epi32(state1, 0x1B);
+                __m128i state0 = _mm_alignr_epi8(t, state1, 8);
+                state1 = _mm_blend_epi16(state1, t, 0xF0);
+
+                for (; blocks > 0; blocks--, data += 64) {
+                    const __m128i savedAbef = state0;
+                    const __m128i savedCdgh = state1;
+                    __m128i message[4];
+                    for (int j = 0; j < 16; j++) {
+                        __m128i& current = message[j & 3];
+                        if (j < 4) {
+                            current = _mm_shuffle_epi8(
+                                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * j)), byteSwap);
+                        }
+                        __m128i rounds = _mm_add_epi32(
+                            current, _mm_load_si128(reinterpret_cast<const __m128i*>(&SHA256_ROUND[4 * j])));
+                        state1 = _mm_sha256rnds2_epu32(state1, state0, rounds);
+                        if (j >= 3 && j < 15) {
+                            __m128i& next = message[(j + 1) & 3];
+                            next = _mm_add_epi32(next, _mm_alignr_epi8(current, message[(j + 3) & 3], 4));
+                            next = _mm_sha256msg2_epu32(next, current);
+                        }
+                        rounds = _mm_shuffle_epi32(rounds, 0x0E);
+                        state0 = _mm_sha256rnds2_epu32(state0, state1, rounds);
+                        if (j >= 1 && j < 13) {
+                            __m128i& previous = message[(j + 3) & 3];
+                            previous = _mm_sha256msg1_epu32(previous, current);
+                        }
+                    }
+                    state0 = _mm_add_epi32(state0, savedAbef);
+                    state1 = _mm_add_epi32(state1, savedCdgh);
+                }
+
+                t = _mm_shuffle_epi32(state0, 0x1B);
+                state1 = _mm_shuffle_epi32(state1, 0xB1);
+                state0 = _mm_blend_epi16(t, state1, 0xF0);
+                state1 = _mm_alignr_epi8(state1, t, 8);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+            }
+#endif
+
+            void Sha256Blocks(HashKernel kernel, uint32_t state[8], const uint8_t* data, size_t blocks) {
+#ifdef STELLAR_X86
+                if (kernel == HashKernel::SHA_NI) {
+                    Sha256ShaNi(state, data, blocks);
+                    return;
+                }
+#endif
+                Sha256Portable(state, data, blocks);
+            }
+
+            std::string ToHex(const uint8_t* bytes, size_t count) {
+                static const char digits[] = "0123456789abcdef";
+                std::string hex(count * 2, '0');
+                for (size_t i = 0; i < count; i++) {
+                    hex[2 * i] = digits[bytes[i] >> 4];
+                    hex[2 * i + 1] = digits[bytes[i] & 0x0F];
+                }
+                return hex;
+            }
+
+        } // namespace
+
+        FileHasher::FileHasher(HashAlgorithm algorithm) :
+            algorithm(algorithm),
+            kernel(SelectKernel(algorithm)),
+            length(0),
+            crc(0xFFFFFFFFu),
+            pendingLength(0) {
+            std::memcpy(state, SHA256_INITIAL, sizeof(state));
+        }
+
+        HashKernel FileHasher::SelectKernel(HashAlgorithm algorithm) {
+            const CpuFeatures& cpu = GetCpuFeatures();
+            switch (algorithm) {
+                case HashAlgorithm::CRC32C:
+#ifdef STELLAR_X64
+                    if (cpu.sse42) {
+                        return HashKernel::SSE42;
+                    }
+#endif
+                    break;
+                case HashAlgorithm::SHA256:
+#ifdef STELLAR_X86
+                    if (cpu.shaNi && cpu.sse42) {
+                        return HashKernel::SHA_NI;
+                    }
+#endif
+                    break;
+                case HashAlgorithm::NONE:
+                    break;
+            }
+            (void)cpu;
+            return HashKernel::PORTABLE;
+        }
+
+        void FileHasher::Update(const uint8_t* data, size_t count) {
+            length += count;
+            switch (algorithm) {
+                case HashAlgorithm::CRC32C:
+#ifdef STELLAR_X64
+                    if (kernel == HashKernel::SSE42) {
+                        crc = Crc32cSse42(crc, data, count);
+                        return;
+                    }
+#endif
+                    crc = Crc32cPortable(crc, data, count);
+                    return;
+                case HashAlgorithm::SHA256:
+                    break;
+                case HashAlgorithm::NONE:
+                    return;
+            }
+
+            if (pendingLength > 0) {
+                size_t take = std::min(count, sizeof(pending) - pendingLength);
+                std::memcpy(pending + pendingLength, data, take);
+                pendingLength += take;
+                data += take;
+                count -= take;
+                if (pendingLength < sizeof(pending)) {
+                    return;
+                }
+                Sha256Blocks(kernel, state, pending, 1);
+                pendingLength = 0;
+            }
+            if (count >= 64) {
+                Sha256Blocks(kernel, state, data, count / 64);
+                data += count & ~static_cast<size_t>(63);
+                count &= 63;
+            }
+            std::memcpy(pending, data, count);
+            pendingLength = count;
+        }
+
+        std::string FileHasher::Final() {
+            if (algorithm == HashAlgorithm::CRC32C) {
+                uint32_t value = ~crc;
+                const uint8_t bytes[4] = {
+                    static_cast<uint8_t>(value >> 24), static_cast<uint8_t>(value >> 16),
+                    static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)
+                };
+                return ToHex(bytes, sizeof(bytes));
+            }
+            if (algorithm != HashAlgorithm::SHA256) {
+                return std::string();
+            }
+
+            // Padding: 0x80, zeros, then the bit length big-endian
+            const uint64_t bits = length * 8;
+            uint8_t tail[128] = {};
+            std::memcpy(tail, pending, pendingLength);
+            tail[pendingLength] = 0x80;
+            const size_t tailLength = pendingLength + 9 <= 64 ? 64 : 128;
+            for (int i = 0; i < 8; i++) {
+                tail[tailLength - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+            }
+            Sha256Blocks(kernel, state, tail, tailLength / 64);
+            pendingLength = 0;
+
+            uint8_t digest[32];
+            for (int i = 0; i < 8; i++) {
+                digest[4 * i] = static_cast<uint8_t>(state[i] >> 24);
+                digest[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+                digest[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+                digest[4 * i + 3] = static_cast<uint8_t>(state[i]);
+            }
+            return ToHex(digest, sizeof(digest));
+        }
+
+        uint32_t Crc32c(const uint8_t* data, size_t length, uint32_t previous) {
+#ifdef STELLAR_X64
+            static const bool hardware = FileHasher::SelectKernel(HashAlgorithm::CRC32C) == HashKernel::SSE42;
+            if (hardware) {
+                return ~Crc32cSse42(~previous, data, length);
+            }
+#endif
+            return ~Crc32cPortable(~previous, data, length);
+        }
+
+        const char* HashAlgorithmName(HashAlgorithm algorithm) {
+            switch (algorithm) {
+                case HashAlgorithm::CRC32C: return "CRC32C";
+                case HashAlgorithm::SHA256: return "SHA-256";
+                case HashAlgorithm::NONE: break;
+            }
+            return "none";
+        }
+
+        const char* HashKernelName(HashKernel kernel) {
+            switch (kernel) {
+                case HashKernel::SSE42: return "SSE4.2";
+                case HashKernel::SHA_NI: return "SHA-NI";
+                case HashKernel::PORTABLE: break;
+            }
+            return "portable";
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
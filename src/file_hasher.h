@@ -0,0 +1,75 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - File Hasher
+ *
+ * Streaming checksums of recovered files. CRC32C uses the SSE4.2 CRC32
+ * instruction and SHA-256 the SHA extensions when the CPU has them;
+ * both fall back to portable table/round code. The kernel is chosen
+ * once at runtime, so results never depend on which one ran.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_FILE_HASHER_H
+#define STELLAR_FILE_HASHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Stellar {
+    namespace Recovery {
+
+        enum class HashAlgorithm {
+            NONE,
+            CRC32C,         // Castagnoli CRC, for quick integrity checks
+            SHA256          // For chain-of-custody records
+        };
+
+        enum class HashKernel {
+            PORTABLE,
+            SSE42,          // CRC32 instruction
+            SHA_NI          // SHA256RNDS2 and friends
+        };
+
+        /**
+         * Incremental hash of one file. Feed the bytes in file order and
+         * call Final() once.
+         */
+        class FileHasher {
+        public:
+            explicit FileHasher(HashAlgorithm algorithm);
+
+            void Update(const uint8_t* data, size_t length);
+
+            // Lowercase hex digest; empty for NONE
+            std::string Final();
+
+            HashAlgorithm Algorithm() const { return algorithm; }
+            uint64_t Length() const { return length; }
+
+            // Kernel used for algorithm on this CPU
+            static HashKernel SelectKernel(HashAlgorithm algorithm);
+
+        private:
+            HashAlgorithm algorithm;
+            HashKernel kernel;
+            uint64_t length;
+            uint32_t crc;
+            uint32_t state[8];
+            uint8_t pending[64];        // Partial SHA-256 block
+            size_t pendingLength;
+        };
+
+        // One-shot CRC32C; pass the previous result to continue a stream
+        uint32_t Crc32c(const uint8_t* data, size_t length, uint32_t previous = 0);
+
+        const char* HashAlgorithmName(HashAlgorithm algorithm);
+        const char* HashKernelName(HashKernel kernel);
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_FILE_HASHER_H
@@ -0,0 +1,88 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - File Signature Table
+ *
+ * Header and footer signatures for every TargetFileType. The table is
+ * constexpr so the matching automata are built from it at compile time.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_FILE_SIGNATURES_H
+#define STELLAR_FILE_SIGNATURES_H
+
+#include "stellar_recovery.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace Stellar {
+    namespace Recovery {
+
+        constexpr uint64_t KiB = 1024ull;
+        constexpr uint64_t MiB = 1024ull * KiB;
+        constexpr uint64_t GiB = 1024ull * MiB;
+
+        // Signature of a carvable format
+        struct FileSignature {
+            const char* name;         // Format name shown in results
+            const char* extension;    // Extension given to carved files
+            TargetFileType type;
+            const char* header;       // Magic bytes (may contain NULs)
+            uint8_t headerLength;
+            uint8_t headerOffset;     // Position of the magic inside the file
+            uint64_t maxSize;         // Carve limit when the end is unknown
+            const char* footer;       // End-of-file marker, nullptr if none
+            uint8_t footerLength;
+            uint8_t footerTrailer;    // Fixed bytes that follow the footer
+        };
+
+        inline constexpr FileSignature FILE_SIGNATURES[] = {
+            // Photos
+            {"JPEG", ".jpg", TargetFileType::PHOTO, "\xFF\xD8\xFF", 3, 0, 64 * MiB, "\xFF\xD9", 2, 0},
+            {"PNG", ".png", TargetFileType::PHOTO, "\x89PNG\r\n\x1A\n", 8, 0, 64 * MiB, "IEND\xAE\x42\x60\x82", 8, 0},
+            {"GIF", ".gif", TargetFileType::PHOTO, "GIF8", 4, 0, 32 * MiB, "\x00\x3B", 2, 0},
+            {"BMP", ".bmp", TargetFileType::PHOTO, "BM", 2, 0, 64 * MiB, nullptr, 0, 0},
+            {"TIFF", ".tif", TargetFileType::PHOTO, "II*\x00", 4, 0, 256 * MiB, nullptr, 0, 0},
+            {"TIFF", ".tif", TargetFileType::PHOTO, "MM\x00*", 4, 0, 256 * MiB, nullptr, 0, 0},
+            // Videos
+            {"MP4", ".mp4", TargetFileType::VIDEO, "ftyp", 4, 4, 4 * GiB, nullptr, 0, 0},
+            {"AVI", ".avi", TargetFileType::VIDEO, "AVI LIST", 8, 8, 4 * GiB, nullptr, 0, 0},
+            {"WMV", ".wmv", TargetFileType::VIDEO, "\x30\x26\xB2\x75\x8E\x66\xCF\x11", 8, 0, 4 * GiB, nullptr, 0, 0},
+            {"FLV", ".flv", TargetFileType::VIDEO, "FLV\x01", 4, 0, 4 * GiB, nullptr, 0, 0},
+            {"MKV", ".mkv", TargetFileType::VIDEO, "\x1A\x45\xDF\xA3", 4, 0, 4 * GiB, nullptr, 0, 0},
+            // Audio
+            {"MP3", ".mp3", TargetFileType::AUDIO, "ID3", 3, 0, 256 * MiB, nullptr, 0, 0},
+            {"WAV", ".wav", TargetFileType::AUDIO, "WAVEfmt ", 8, 8, 1 * GiB, nullptr, 0, 0},
+            {"FLAC", ".flac", TargetFileType::AUDIO, "fLaC", 4, 0, 1 * GiB, nullptr, 0, 0},
+            {"OGG", ".ogg", TargetFileType::AUDIO, "OggS", 4, 0, 256 * MiB, nullptr, 0, 0},
+            // Documents
+            {"PDF", ".pdf", TargetFileType::DOCUMENT, "%PDF-", 5, 0, 512 * MiB, "%%EOF", 5, 0},
+            {"DOCX", ".docx", TargetFileType::DOCUMENT, "[Content_Types].xml", 19, 30, 512 * MiB, "PK\x05\x06", 4, 18},
+            {"OLE2", ".doc", TargetFileType::DOCUMENT, "\xD0\xCF\x11\xE0\xA1\xB1\x1A\xE1", 8, 0, 512 * MiB, nullptr, 0, 0},
+            {"RTF", ".rtf", TargetFileType::DOCUMENT, "{\\rtf", 5, 0, 256 * MiB, nullptr, 0, 0},
+            // Emails
+            {"PST", ".pst", TargetFileType::EMAIL, "!BDN", 4, 0, 50 * GiB, nullptr, 0, 0},
+            {"MBOX", ".mbox", TargetFileType::EMAIL, "From ", 5, 0, 4 * GiB, nullptr, 0, 0},
+            {"EML", ".eml", TargetFileType::EMAIL, "Return-Path: ", 13, 0, 64 * MiB, nullptr, 0, 0},
+            // Archives
+            {"ZIP", ".zip", TargetFileType::ARCHIVE, "PK\x03\x04", 4, 0, 4 * GiB, "PK\x05\x06", 4, 18},
+            {"RAR", ".rar", TargetFileType::ARCHIVE, "Rar!\x1A\x07", 6, 0, 4 * GiB, nullptr, 0, 0},
+            {"7Z", ".7z", TargetFileType::ARCHIVE, "7z\xBC\xAF\x27\x1C", 6, 0, 4 * GiB, nullptr, 0, 0},
+            {"GZIP", ".gz", TargetFileType::ARCHIVE, "\x1F\x8B\x08", 3, 0, 4 * GiB, nullptr, 0, 0},
+            // Executables
+            {"EXE", ".exe", TargetFileType::EXECUTABLE, "MZ", 2, 0, 512 * MiB, nullptr, 0, 0},
+            {"ELF", ".elf", TargetFileType::EXECUTABLE, "\x7F" "ELF", 4, 0, 512 * MiB, nullptr, 0, 0},
+            // Databases
+            {"SQLite", ".db", TargetFileType::DATABASE, "SQLite format 3\x00", 16, 0, 16 * GiB, nullptr, 0, 0},
+            {"MDB", ".mdb", TargetFileType::DATABASE, "Standard Jet DB", 15, 4, 2 * GiB, nullptr, 0, 0},
+            {"ACCDB", ".accdb", TargetFileType::DATABASE, "Standard ACE DB", 15, 4, 2 * GiB, nullptr, 0, 0},
+        };
+
+        constexpr size_t FILE_SIGNATURE_COUNT = sizeof(FILE_SIGNATURES) / sizeof(FILE_SIGNATURES[0]);
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_FILE_SIGNATURES_H
@@ -0,0 +1,155 @@
+/**
+ * Stellar Data Recovery Pro Free - File System Scanners
+ *
+ * Volume detection and backend selection.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "filesystem_scanner.h"
+#include "file_signatures.h"
+#include "ntfs_scanner.h"
+#include "fat_scanner.h"
+#include "ext4_scanner.h"
+#include <algorithm>
+#include <cctype>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            struct ExtensionAlias {
+                const char* extension;
+                TargetFileType type;
+            };
+
+            // Common extensions with no carving signature of their own
+            constexpr ExtensionAlias EXTENSION_ALIASES[] = {
+                {".jpeg", TargetFileType::PHOTO},
+                {".tiff", TargetFileType::PHOTO},
+                {".heic", TargetFileType::PHOTO},
+                {".webp", TargetFileType::PHOTO},
+                {".cr2", TargetFileType::PHOTO},
+                {".nef", TargetFileType::PHOTO},
+                {".mov", TargetFileType::VIDEO},
+                {".m4v", TargetFileType::VIDEO},
+                {".3gp", TargetFileType::VIDEO},
+                {".mpg", TargetFileType::VIDEO},
+                {".m4a", TargetFileType::AUDIO},
+                {".aac", TargetFileType::AUDIO},
+                {".wma", TargetFileType::AUDIO},
+                {".txt", TargetFileType::DOCUMENT},
+                {".xls", TargetFileType::DOCUMENT},
+                {".xlsx", TargetFileType::DOCUMENT},
+                {".ppt", TargetFileType::DOCUMENT},
+                {".pptx", TargetFileType::DOCUMENT},
+                {".odt", TargetFileType::DOCUMENT},
+                {".msg", TargetFileType::EMAIL},
+                {".ost", TargetFileType::EMAIL},
+                {".tar", TargetFileType::ARCHIVE},
+                {".bz2", TargetFileType::ARCHIVE},
+                {".xz", TargetFileType::ARCHIVE},
+                {".dll", TargetFileType::EXECUTABLE},
+                {".so", TargetFileType::EXECUTABLE},
+                {".sqlite", TargetFileType::DATABASE},
+            };
+
+        } // namespace
+
+        FileSystemType DetectFileSystem(SectorSource& source, uint64_t volumeOffset) {
+            AlignedBuffer boot(IO_ALIGNMENT);
+            if (source.ReadAt(volumeOffset, boot.Data(), boot.Size()) < 512) {
+                return FileSystemType::UNKNOWN;
+            }
+            if (NtfsScanner::IsNtfsBootSector(boot.Data())) {
+                return FileSystemType::NTFS;
+            }
+            if (Ext4Scanner::IsExtSuperblock(boot.Data() + 1024)) {
+                return Ext4Scanner::TypeFromSuperblock(boot.Data() + 1024);
+            }
+            FatVariant variant;
+            if (FatScanner::DetectVariant(boot.Data(), variant)) {
+                switch (variant) {
+                    case FatVariant::EXFAT: return FileSystemType::EXFAT;
+                    case FatVariant::FAT32: return FileSystemType::FAT32;
+                    default: return FileSystemType::FAT16;
+                }
+            }
+            return FileSystemType::UNKNOWN;
+        }
+
+        std::unique_ptr<FileSystemScanner> CreateFileSystemScanner(SectorSource& source, uint64_t volumeOffset) {
+            switch (DetectFileSystem(source, volumeOffset)) {
+                case FileSystemType::NTFS:
+                    return std::make_unique<NtfsScanner>(source, volumeOffset);
+                case FileSystemType::FAT16:
+                case FileSystemType::FAT32:
+                case FileSystemType::EXFAT:
+                    return std::make_unique<FatScanner>(source, volumeOffset);
+                case FileSystemType::EXT2:
+                case FileSystemType::EXT3:
+                case FileSystemType::EXT4:
+                    return std::make_unique<Ext4Scanner>(source, volumeOffset);
+                default:
+                    return nullptr;
+            }
+        }
+
+        std::string Utf16ToUtf8(const uint8_t* data, size_t units) {
+            std::string out;
+            out.reserve(units);
+            for (size_t i = 0; i < units; i++) {
+                uint32_t code = ReadLE16(data + i * 2);
+                if (code >= 0xD800 && code < 0xDC00 && i + 1 < units) {
+                    uint32_t low = ReadLE16(data + (i + 1) * 2);
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        i++;
+                    }
+                }
+                if (code < 0x80) {
+                    out += static_cast<char>(code);
+                } else if (code < 0x800) {
+                    out += static_cast<char>(0xC0 | (code >> 6));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                } else if (code < 0x10000) {
+                    out += static_cast<char>(0xE0 | (code >> 12));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                } else {
+                    out += static_cast<char>(0xF0 | (code >> 18));
+                    out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+            }
+            return out;
+        }
+
+        TargetFileType ClassifyFileName(const std::string& fileName) {
+            size_t dot = fileName.rfind('.');
+            if (dot == std::string::npos) {
+                return TargetFileType::ALL_DATA;
+            }
+            std::string extension = fileName.substr(dot);
+            std::transform(extension.begin(), extension.end(), extension.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+            for (const auto& signature : FILE_SIGNATURES) {
+                if (extension == signature.extension) {
+                    return signature.type;
+                }
+            }
+            for (const auto& alias : EXTENSION_ALIASES) {
+                if (extension == alias.extension) {
+                    return alias.type;
+                }
+            }
+            return TargetFileType::ALL_DATA;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
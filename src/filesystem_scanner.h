@@ -0,0 +1,102 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - File System Scanners
+ *
+ * Common interface of the metadata-driven backends used by quick scans.
+ * A backend reads only file system structures (MFT, directories, inode
+ * tables) and reports deleted files together with their data extents.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_FILESYSTEM_SCANNER_H
+#define STELLAR_FILESYSTEM_SCANNER_H
+
+#include "stellar_recovery.h"
+#include "sector_reader.h"
+#include "byte_order.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        /**
+         * Raised when a volume's metadata is not a valid instance of the
+         * file system a backend expects
+         */
+        class FileSystemError : public std::runtime_error {
+        public:
+            explicit FileSystemError(const std::string& message) : std::runtime_error(message) {}
+        };
+
+        /**
+         * Base class of the file system backends. Offsets passed to Read()
+         * are relative to the start of the volume.
+         */
+        class FileSystemScanner {
+        public:
+            FileSystemScanner(SectorSource& source, uint64_t volumeOffset) :
+                source(source), volumeOffset(volumeOffset) {}
+            virtual ~FileSystemScanner() = default;
+
+            FileSystemScanner(const FileSystemScanner&) = delete;
+            FileSystemScanner& operator=(const FileSystemScanner&) = delete;
+
+            virtual FileSystemType Type() const = 0;
+
+            /**
+             * Enumerate deleted files. Extents are absolute source offsets.
+             * Throws SectorReadError on I/O failure and FileSystemError on
+             * metadata too damaged to walk.
+             */
+            virtual std::vector<RecoverableFile> ScanDeleted(const ProgressCallback& progress = ProgressCallback()) = 0;
+
+            // Metadata bytes read so far
+            uint64_t BytesRead() const { return bytesRead; }
+
+        protected:
+            size_t Read(uint64_t offset, void* buffer, size_t length) {
+                size_t got = source.ReadAt(volumeOffset + offset, buffer, length);
+                bytesRead += got;
+                return got;
+            }
+
+            SectorSource& source;
+            uint64_t volumeOffset;
+            uint64_t bytesRead = 0;
+        };
+
+        /**
+         * Identify the file system of the volume starting at volumeOffset
+         */
+        FileSystemType DetectFileSystem(SectorSource& source, uint64_t volumeOffset = 0);
+
+        /**
+         * Backend for the volume at volumeOffset, or nullptr when the file
+         * system is not supported
+         */
+        std::unique_ptr<FileSystemScanner> CreateFileSystemScanner(SectorSource& source, uint64_t volumeOffset = 0);
+
+        /**
+         * Convert little-endian UTF-16 (as stored by NTFS, FAT and exFAT)
+         * to UTF-8; unpaired surrogates are passed through
+         */
+        std::string Utf16ToUtf8(const uint8_t* data, size_t units);
+
+        /**
+         * File type implied by a file name's extension (ALL_DATA if unknown)
+         */
+        TargetFileType ClassifyFileName(const std::string& fileName);
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_FILESYSTEM_SCANNER_H
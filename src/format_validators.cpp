@@ -0,0 +1,950 @@
+/**
+ * Stellar Data Recovery Pro Free - Format Validators
+ *
+ * JPEG entropy decoding, MP4 box trees and ZIP record chains.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "format_validators.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        ValidationState FormatValidator::Feed(const uint8_t* data, size_t length) {
+            while (length > 0 && state == ValidationState::NEED_MORE) {
+                size_t used;
+                if (skip > 0) {
+                    used = static_cast<size_t>(std::min<uint64_t>(skip, length));
+                    skip -= used;
+                } else {
+                    used = Parse(data, length);
+                    if (used == 0 && skip == 0 && state == ValidationState::NEED_MORE) {
+                        Fail(consumed);
+                    }
+                }
+                consumed += used;
+                data += used;
+                length -= used;
+            }
+            return state;
+        }
+
+        ValidationState FormatValidator::Finish() {
+            if (state == ValidationState::NEED_MORE && skip == 0 && CanEnd()) {
+                Complete(consumed);
+            }
+            return state;
+        }
+
+        void FormatValidator::Skip(uint64_t bytes) {
+            bytes = std::min(bytes, skip);
+            skip -= bytes;
+            consumed += bytes;
+        }
+
+        void FormatValidator::Complete(uint64_t length) {
+            state = ValidationState::COMPLETE;
+            end = length;
+        }
+
+        void FormatValidator::Fail(uint64_t offset) {
+            state = ValidationState::INVALID;
+            end = offset;
+        }
+
+        namespace {
+
+            template <typename Derived>
+            class CloneableValidator : public FormatValidator {
+            public:
+                std::unique_ptr<FormatValidator> Clone() const override {
+                    return std::make_unique<Derived>(static_cast<const Derived&>(*this));
+                }
+            };
+
+            uint16_t ReadBE16(const uint8_t* p) { return static_cast<uint16_t>((p[0] << 8) | p[1]); }
+            uint32_t ReadBE32(const uint8_t* p) { return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3]; }
+            uint64_t ReadBE64(const uint8_t* p) { return (uint64_t(ReadBE32(p)) << 32) | ReadBE32(p + 4); }
+            uint16_t ReadLE16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+            uint32_t ReadLE32(const uint8_t* p) { return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24); }
+            uint64_t ReadLE64(const uint8_t* p) { return uint64_t(ReadLE32(p)) | (uint64_t(ReadLE32(p + 4)) << 32); }
+
+            // JPEG ----------------------------------------------------------
+
+            /**
+             * Walks the marker segments and, for baseline Huffman frames,
+             * decodes every block of every scan. Restart intervals, MCU
+             * counts and the 1-bit padding before each marker must agree.
+             * Progressive and arithmetic frames get marker checks only.
+             */
+            class JpegValidator : public CloneableValidator<JpegValidator> {
+            protected:
+                size_t Parse(const uint8_t* data, size_t length) override {
+                    for (size_t i = 0; i < length; i++) {
+                        const uint8_t byte = data[i];
+                        const uint64_t at = consumed + i;
+                        bool ok = true;
+                        switch (phase) {
+                            case Phase::START:
+                                ok = byte == 0xFF;
+                                phase = Phase::START_CODE;
+                                break;
+                            case Phase::START_CODE:
+                                ok = byte == 0xD8;
+                                phase = Phase::MARKER;
+                                break;
+                            case Phase::MARKER:
+                                ok = byte == 0xFF;
+                                phase = Phase::CODE;
+                                break;
+                            case Phase::CODE:
+                                if (byte != 0xFF) {
+                                    ok = BeginMarker(byte, at);
+                                }
+                                break;
+                            case Phase::LENGTH_HIGH:
+                                remaining = static_cast<uint16_t>(byte << 8);
+                                phase = Phase::LENGTH_LOW;
+                                break;
+                            case Phase::LENGTH_LOW:
+                                remaining = static_cast<uint16_t>(remaining | byte);
+                                if (remaining < 2) {
+                                    ok = false;
+                                    break;
+                                }
+                                remaining = static_cast<uint16_t>(remaining - 2);
+                                if (!KeepsSegment(marker)) {
+                                    skip = remaining;
+                                    phase = Phase::MARKER;
+                                    return i + 1;
+                                }
+                                segment.clear();
+                                phase = Phase::SEGMENT;
+                                if (remaining == 0) {
+                                    ok = EndSegment();
+                                }
+                                break;
+                            case Phase::SEGMENT: {
+                                size_t count = std::min<size_t>(remaining, length - i);
+                                segment.insert(segment.end(), data + i, data + i + count);
+                                remaining = static_cast<uint16_t>(remaining - count);
+                                i += count - 1;
+                                if (remaining == 0) {
+                                    ok = EndSegment();
+                                }
+                                break;
+                            }
+                            case Phase::ENTROPY:
+                                ok = EntropyByte(byte, at);
+                                break;
+                        }
+                        if (!ok) {
+                            Fail(at);
+                            return i;
+                        }
+                        if (State() != ValidationState::NEED_MORE) {
+                            return i + 1;
+                        }
+                    }
+                    return length;
+                }
+
+            private:
+                enum class Phase : uint8_t { START, START_CODE, MARKER, CODE, LENGTH_HIGH, LENGTH_LOW, SEGMENT, ENTROPY };
+
+                struct HuffmanTable {
+                    int32_t maxCode[17];
+                    uint16_t minCode[17];
+                    uint16_t valuePointer[17];
+                    uint8_t values[256];
+                    bool defined = false;
+                };
+
+                struct Component {
+                    uint8_t id;
+                    uint8_t h;
+                    uint8_t v;
+                };
+
+                static bool KeepsSegment(uint8_t code) {
+                    return IsFrame(code) || code == 0xC4 || code == 0xDA || code == 0xDD;
+                }
+
+                static bool IsFrame(uint8_t code) {
+                    return code >= 0xC0 && code <= 0xCF && code != 0xC4 && code != 0xC8 && code != 0xCC;
+                }
+
+                bool BeginMarker(uint8_t code, uint64_t at) {
+                    marker = code;
+                    if (code == 0xD9) {
+                        if (!scanSeen) {
+                            return false;
+                        }
+                        Complete(at + 1);
+                        return true;
+                    }
+                    if (code == 0x01) {
+                        phase = Phase::MARKER;
+                        return true;
+                    }
+                    if (code == 0x00 || code == 0xD8 || (code >= 0xD0 && code <= 0xD7)) {
+                        return false;
+                    }
+                    phase = Phase::LENGTH_HIGH;
+                    return true;
+                }
+
+                bool EndSegment() {
+                    phase = Phase::MARKER;
+                    const uint8_t* p = segment.data();
+                    const size_t size = segment.size();
+                    if (IsFrame(marker)) {
+                        if (frameSeen || size < 6) {
+                            return false;
+                        }
+                        height = ReadBE16(p + 1);
+                        width = ReadBE16(p + 3);
+                        componentCount = p[5];
+                        if (width == 0 || componentCount == 0 || componentCount > 4 || size != 6 + 3u * componentCount) {
+                            return false;
+                        }
+                        hMax = vMax = 1;
+                        for (uint8_t c = 0; c < componentCount; c++) {
+                            components[c] = Component{p[6 + 3 * c], static_cast<uint8_t>(p[7 + 3 * c] >> 4),
+                                                      static_cast<uint8_t>(p[7 + 3 * c] & 15)};
+                            if (components[c].h < 1 || components[c].h > 4 || components[c].v < 1 || components[c].v > 4) {
+                                return false;
+                            }
+                            hMax = std::max(hMax, components[c].h);
+                            vMax = std::max(vMax, components[c].v);
+                        }
+                        frameSeen = true;
+                        decode = marker == 0xC0 || marker == 0xC1;
+                        return true;
+                    }
+                    if (marker == 0xC4) {
+                        for (size_t pos = 0; pos < size;) {
+                            if (size - pos < 17 || (p[pos] >> 4) > 1 || (p[pos] & 15) > 3) {
+                                return false;
+                            }
+                            size_t count = 0;
+                            for (int i = 0; i < 16; i++) {
+                                count += p[pos + 1 + i];
+                            }
+                            if (count > 256 || size - pos - 17 < count) {
+                                return false;
+                            }
+                            HuffmanTable& table = (p[pos] >> 4) ? ac[p[pos] & 15] : dc[p[pos] & 15];
+                            if (!BuildTable(table, p + pos + 1, p + pos + 17, count)) {
+                                return false;
+                            }
+                            pos += 17 + count;
+                        }
+                        return true;
+                    }
+                    if (marker == 0xDD) {
+                        if (size != 2) {
+                            return false;
+                        }
+                        restartInterval = ReadBE16(p);
+                        return true;
+                    }
+                    return BeginScan(p, size);
+                }
+
+                static bool BuildTable(HuffmanTable& table, const uint8_t* counts, const uint8_t* values, size_t count) {
+                    int32_t code = 0;
+                    size_t index = 0;
+                    for (int length = 1; length <= 16; length++) {
+                        table.valuePointer[length] = static_cast<uint16_t>(index);
+                        table.minCode[length] = static_cast<uint16_t>(code);
+                        code += counts[length - 1];
+                        index += counts[length - 1];
+                        // No code may be all ones
+                        if (counts[length - 1] && code >= (1 << length)) {
+                            return false;
+                        }
+                        table.maxCode[length] = counts[length - 1] ? code - 1 : -1;
+                        code <<= 1;
+                    }
+                    std::memcpy(table.values, values, count);
+                    table.defined = true;
+                    return true;
+                }
+
+                bool BeginScan(const uint8_t* p, size_t size) {
+                    if (!frameSeen || size < 1) {
+                        return false;
+                    }
+                    const uint8_t count = p[0];
+                    if (count < 1 || count > 4 || size != 4 + 2u * count) {
+                        return false;
+                    }
+                    scanSeen = true;
+                    phase = Phase::ENTROPY;
+                    pendingFF = false;
+                    nextRestart = 0;
+                    restarts = 0;
+                    mcus = 0;
+                    block = 0;
+                    coefficient = 0;
+                    bits = 0;
+                    bitCount = 0;
+                    blocksPerMcu = 0;
+                    if (!decode) {
+                        return true;
+                    }
+                    // Baseline scans cover all 64 coefficients in one pass
+                    if (p[1 + 2 * count] != 0 || p[2 + 2 * count] != 63 || p[3 + 2 * count] != 0) {
+                        return false;
+                    }
+                    const Component* single = nullptr;
+                    for (uint8_t i = 0; i < count; i++) {
+                        const Component* component = nullptr;
+                        for (uint8_t c = 0; c < componentCount; c++) {
+                            if (components[c].id == p[1 + 2 * i]) {
+                                component = &components[c];
+                            }
+                        }
+                        const uint8_t dcTable = p[2 + 2 * i] >> 4;
+                        const uint8_t acTable = p[2 + 2 * i] & 15;
+                        if (!component || dcTable > 3 || acTable > 3 || !dc[dcTable].defined || !ac[acTable].defined) {
+                            return false;
+                        }
+                        const size_t copies = count == 1 ? 1 : static_cast<size_t>(component->h) * component->v;
+                        if (blocksPerMcu + copies > sizeof(blockTables)) {
+                            return false;
+                        }
+                        for (size_t j = 0; j < copies; j++) {
+                            blockTables[blocksPerMcu++] = static_cast<uint8_t>((dcTable << 4) | acTable);
+                        }
+                        single = component;
+                    }
+                    if (height == 0) {
+                        totalMcus = 0;      // Height follows in a DNL segment
+                    } else if (count == 1) {
+                        uint64_t columns = (static_cast<uint64_t>(width) * single->h + hMax - 1) / hMax;
+                        uint64_t rows = (static_cast<uint64_t>(height) * single->v + vMax - 1) / vMax;
+                        totalMcus = ((columns + 7) / 8) * ((rows + 7) / 8);
+                    } else {
+                        totalMcus = ((width + 8u * hMax - 1) / (8u * hMax)) * ((height + 8u * vMax - 1) / (8u * vMax));
+                    }
+                    return true;
+                }
+
+                // MCUs that must be decoded before the next marker
+                uint64_t Target() const {
+                    uint64_t total = totalMcus ? totalMcus : UINT64_MAX;
+                    if (restartInterval == 0) {
+                        return total;
+                    }
+                    return std::min<uint64_t>(total, (restarts + 1) * static_cast<uint64_t>(restartInterval));
+                }
+
+                bool EntropyByte(uint8_t byte, uint64_t at) {
+                    if (pendingFF) {
+                        pendingFF = false;
+                        if (byte == 0x00) {
+                            return PushByte(0xFF);
+                        }
+                        if (byte == 0xFF) {
+                            pendingFF = true;
+                            return true;
+                        }
+                        if (byte >= 0xD0 && byte <= 0xD7) {
+                            return Restart(byte);
+                        }
+                        // Any other marker ends the scan
+                        if (!EndScan()) {
+                            return false;
+                        }
+                        phase = Phase::CODE;
+                        return BeginMarker(byte, at);
+                    }
+                    if (byte == 0xFF) {
+                        pendingFF = true;
+                        return true;
+                    }
+                    return PushByte(byte);
+                }
+
+                bool PushByte(uint8_t byte) {
+                    if (!decode) {
+                        return true;
+                    }
+                    bits = (bits << 8) | byte;
+                    bitCount += 8;
+                    const uint64_t target = Target();
+                    if (mcus == target) {
+                        // Only padding may follow the last MCU before a marker
+                        return bitCount < 8;
+                    }
+                    // A code and its extra bits never exceed 27 bits
+                    while (bitCount >= 27 && mcus < target) {
+                        if (!Step()) {
+                            return false;
+                        }
+                    }
+                    return mcus < target || bitCount < 8;
+                }
+
+                uint32_t Peek16() const {
+                    if (bitCount >= 16) {
+                        return static_cast<uint32_t>(bits >> (bitCount - 16)) & 0xFFFF;
+                    }
+                    const uint32_t fill = 16 - bitCount;
+                    return static_cast<uint32_t>(((bits << fill) | ((1u << fill) - 1)) & 0xFFFF);
+                }
+
+                // Decode one DC or AC element of the current block
+                bool Step() {
+                    const uint8_t tables = blockTables[block];
+                    const HuffmanTable& table = coefficient == 0 ? dc[tables >> 4] : ac[tables & 15];
+                    const uint32_t peek = Peek16();
+                    uint32_t length = 0;
+                    uint8_t symbol = 0;
+                    for (uint32_t l = 1; l <= 16; l++) {
+                        int32_t code = static_cast<int32_t>(peek >> (16 - l));
+                        if (code <= table.maxCode[l]) {
+                            symbol = table.values[table.valuePointer[l] + code - table.minCode[l]];
+                            length = l;
+                            break;
+                        }
+                    }
+                    if (length == 0) {
+                        return false;
+                    }
+                    uint32_t extra;
+                    if (coefficient == 0) {
+                        extra = symbol;
+                        if (extra > 11) {
+                            return false;
+                        }
+                        coefficient = 1;
+                    } else {
+                        const uint32_t run = symbol >> 4;
+                        extra = symbol & 15;
+                        if (extra == 0) {
+                            if (run == 15) {
+                                coefficient = static_cast<uint8_t>(coefficient + 16);
+                                if (coefficient > 64) {
+                                    return false;
+                                }
+                            } else if (run == 0) {
+                                coefficient = 64;
+                            } else {
+                                return false;
+                            }
+                        } else {
+                            if (extra > 10 || coefficient + run > 63) {
+                                return false;
+                            }
+                            coefficient = static_cast<uint8_t>(coefficient + run + 1);
+                        }
+                    }
+                    if (length + extra > bitCount) {
+                        return false;
+                    }
+                    bitCount -= length + extra;
+                    bits &= (uint64_t(1) << bitCount) - 1;
+                    if (coefficient >= 64) {
+                        coefficient = 0;
+                        if (++block == blocksPerMcu) {
+                            block = 0;
+                            mcus++;
+                        }
+                    }
+                    return true;
+                }
+
+                // Decode the bits left before a marker up to target MCUs
+                bool Drain(uint64_t target) {
+                    if (!decode) {
+                        return true;
+                    }
+                    while (mcus < target) {
+                        if (!Step()) {
+                            return false;
+                        }
+                    }
+                    const uint64_t mask = (uint64_t(1) << bitCount) - 1;
+                    if (bitCount >= 8 || (bits & mask) != mask) {
+                        return false;
+                    }
+                    bits = 0;
+                    bitCount = 0;
+                    return true;
+                }
+
+                bool Restart(uint8_t code) {
+                    if (restartInterval == 0 || (code & 7) != nextRestart) {
+                        return false;
+                    }
+                    nextRestart = (nextRestart + 1) & 7;
+                    if (decode) {
+                        const uint64_t target = Target();
+                        if (target == totalMcus || !Drain(target)) {
+                            return false;
+                        }
+                    }
+                    restarts++;
+                    return true;
+                }
+
+                bool EndScan() {
+                    if (!decode) {
+                        return true;
+                    }
+                    if (totalMcus == 0) {
+                        // Unknown size: stop at the next MCU boundary
+                        uint64_t target = block == 0 && coefficient == 0 ? mcus : mcus + 1;
+                        return Drain(target);
+                    }
+                    return Target() == totalMcus && Drain(totalMcus);
+                }
+
+                Phase phase = Phase::START;
+                uint8_t marker = 0;
+                uint16_t remaining = 0;
+                std::vector<uint8_t> segment;
+
+                bool frameSeen = false;
+                bool scanSeen = false;
+                bool decode = false;
+                uint16_t width = 0;
+                uint16_t height = 0;
+                uint8_t componentCount = 0;
+                uint8_t hMax = 1;
+                uint8_t vMax = 1;
+                Component components[4] = {};
+                HuffmanTable dc[4] = {};
+                HuffmanTable ac[4] = {};
+                uint16_t restartInterval = 0;
+
+                uint8_t blockTables[10] = {};   // DC table << 4 | AC table, per block of an MCU
+                uint8_t blocksPerMcu = 0;
+                uint64_t totalMcus = 0;
+                uint64_t mcus = 0;
+                uint64_t restarts = 0;
+                uint8_t nextRestart = 0;
+                uint8_t block = 0;
+                uint8_t coefficient = 0;
+                bool pendingFF = false;
+                uint64_t bits = 0;
+                uint32_t bitCount = 0;
+            };
+
+            // MP4 -----------------------------------------------------------
+
+            bool IsBoxType(const uint8_t* type) {
+                for (int i = 0; i < 4; i++) {
+                    if ((type[i] < 0x20 || type[i] > 0x7E) && type[i] != 0xA9) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            bool IsType(const uint8_t* type, const char* name) {
+                return std::memcmp(type, name, 4) == 0;
+            }
+
+            bool IsTopLevelBox(const uint8_t* type) {
+                static const char* const known[] = {
+                    "ftyp", "moov", "mdat", "free", "skip", "wide", "uuid", "moof", "mfra",
+                    "meta", "pdin", "styp", "sidx", "ssix", "prft", "emsg", "pnot", "PICT"
+                };
+                for (const char* name : known) {
+                    if (IsType(type, name)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool IsContainerBox(const uint8_t* type) {
+                static const char* const containers[] = {
+                    "moov", "trak", "mdia", "minf", "stbl", "dinf", "edts", "mvex", "moof", "traf", "mfra", "tref"
+                };
+                for (const char* name : containers) {
+                    if (IsType(type, name)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            // Children of a container must tile it exactly
+            bool CheckBoxes(const uint8_t* data, uint64_t size, int depth) {
+                uint64_t position = 0;
+                while (position < size) {
+                    const uint64_t left = size - position;
+                    if (left < 8 || !IsBoxType(data + position + 4)) {
+                        return false;
+                    }
+                    uint64_t boxSize = ReadBE32(data + position);
+                    uint64_t header = 8;
+                    if (boxSize == 1) {
+                        if (left < 16) {
+                            return false;
+                        }
+                        boxSize = ReadBE64(data + position + 8);
+                        header = 16;
+                    } else if (boxSize == 0) {
+                        boxSize = left;
+                    }
+                    if (boxSize < header || boxSize > left) {
+                        return false;
+                    }
+                    if (depth < 16 && IsContainerBox(data + position + 4) &&
+                        !CheckBoxes(data + position + header, boxSize - header, depth + 1)) {
+                        return false;
+                    }
+                    position += boxSize;
+                }
+                return true;
+            }
+
+            /**
+             * Top-level boxes must chain from ftyp and the movie header's
+             * box tree must be consistent. Media data is skipped. The file
+             * ends at the first top-level header that is not a box once
+             * both the movie header and media data have been seen.
+             */
+            class Mp4Validator : public CloneableValidator<Mp4Validator> {
+            protected:
+                size_t Parse(const uint8_t* data, size_t length) override {
+                    if (bodyNeeded > 0) {
+                        size_t count = static_cast<size_t>(std::min<uint64_t>(length, bodyNeeded - body.size()));
+                        body.insert(body.end(), data, data + count);
+                        if (body.size() == bodyNeeded) {
+                            bool consistent = CheckBoxes(body.data(), body.size(), 1);
+                            bodyNeeded = 0;
+                            std::vector<uint8_t>().swap(body);
+                            if (!consistent) {
+                                Fail(boxStart);
+                            }
+                        }
+                        return count;
+                    }
+
+                    if (headerBytes == 0) {
+                        boxStart = consumed;
+                    }
+                    size_t used = 0;
+                    while (used < length && headerBytes < headerNeeded) {
+                        header[headerBytes++] = data[used++];
+                    }
+                    if (headerBytes < headerNeeded) {
+                        return used;
+                    }
+
+                    uint64_t size = ReadBE32(header);
+                    if (headerNeeded == 8) {
+                        const bool first = boxStart == 0;
+                        if (!IsBoxType(header + 4) || (first ? !IsType(header + 4, "ftyp") : !IsTopLevelBox(header + 4))) {
+                            if (movieSeen && dataSeen) {
+                                Complete(boxStart);
+                            } else {
+                                Fail(boxStart);
+                            }
+                            return used;
+                        }
+                        if (size == 1) {
+                            headerNeeded = 16;
+                            return used;
+                        }
+                    } else {
+                        size = ReadBE64(header + 8);
+                    }
+                    // A size of zero runs to the end of the volume and gives no length
+                    if (size < headerNeeded) {
+                        Fail(boxStart);
+                        return used;
+                    }
+
+                    const uint64_t payload = size - headerNeeded;
+                    headerBytes = 0;
+                    headerNeeded = 8;
+                    if (IsType(header + 4, "moov") || IsType(header + 4, "moof")) {
+                        movieSeen = true;
+                        if (payload == 0 || payload > MAX_MOVIE_HEADER) {
+                            Fail(boxStart);
+                            return used;
+                        }
+                        bodyNeeded = payload;
+                        body.reserve(static_cast<size_t>(payload));
+                    } else {
+                        dataSeen = dataSeen || IsType(header + 4, "mdat");
+                        skip = payload;
+                    }
+                    return used;
+                }
+
+                bool CanEnd() const override {
+                    return headerBytes == 0 && bodyNeeded == 0 && movieSeen && dataSeen;
+                }
+
+            private:
+                static constexpr uint64_t MAX_MOVIE_HEADER = 64 * MiB;
+
+                uint8_t header[16] = {};
+                uint8_t headerBytes = 0;
+                uint8_t headerNeeded = 8;
+                uint64_t boxStart = 0;
+                uint64_t bodyNeeded = 0;
+                std::vector<uint8_t> body;
+                bool movieSeen = false;
+                bool dataSeen = false;
+            };
+
+            // ZIP -----------------------------------------------------------
+
+            /**
+             * Local entries must chain by their sizes (or by data descriptors
+             * for streamed entries), and the central directory must point
+             * back at those entries and be described by the end record.
+             */
+            class ZipValidator : public CloneableValidator<ZipValidator> {
+            protected:
+                size_t Parse(const uint8_t* data, size_t length) override {
+                    if (phase == Phase::DONE) {
+                        Complete(consumed);
+                        return 0;
+                    }
+                    if (phase == Phase::SEARCH) {
+                        return Search(data, length);
+                    }
+                    if (buffer.empty()) {
+                        recordStart = consumed;
+                    }
+                    size_t count = std::min(length, needed - buffer.size());
+                    buffer.insert(buffer.end(), data, data + count);
+                    if (buffer.size() == needed && !Process()) {
+                        Fail(recordStart);
+                    }
+                    return count;
+                }
+
+                bool CanEnd() const override {
+                    return phase == Phase::DONE;
+                }
+
+            private:
+                enum class Phase : uint8_t {
+                    SIGNATURE, LOCAL, LOCAL_NAMES, SEARCH, DESCRIPTOR, CENTRAL, END, ZIP64_END, SIGNATURE_SIZE, DONE
+                };
+
+                void Expect(Phase next, size_t bytes) {
+                    phase = next;
+                    needed = bytes;
+                    buffer.clear();
+                }
+
+                bool Process() {
+                    const uint8_t* p = buffer.data();
+                    switch (phase) {
+                        case Phase::SIGNATURE: {
+                            const uint32_t signature = ReadLE32(p);
+                            if (signature == 0x04034B50 && !centralSeen) {
+                                entryStart = recordStart;
+                                Expect(Phase::LOCAL, 26);
+                            } else if (signature == 0x02014B50) {
+                                if (!centralSeen) {
+                                    centralSeen = true;
+                                    centralStart = recordStart;
+                                }
+                                Expect(Phase::CENTRAL, 42);
+                            } else if (signature == 0x06064B50) {
+                                centralEnd = centralEnd ? centralEnd : recordStart;
+                                Expect(Phase::ZIP64_END, 8);
+                            } else if (signature == 0x07064B50) {
+                                Expect(Phase::SIGNATURE, 4);
+                                skip = 16;
+                            } else if (signature == 0x05054B50 && centralSeen) {
+                                Expect(Phase::SIGNATURE_SIZE, 2);
+                            } else if (signature == 0x06054B50) {
+                                centralStart = centralSeen ? centralStart : recordStart;
+                                centralEnd = centralEnd ? centralEnd : recordStart;
+                                Expect(Phase::END, 18);
+                            } else {
+                                return false;
+                            }
+                            return true;
+                        }
+                        case Phase::LOCAL: {
+                            const uint16_t flags = ReadLE16(p + 2);
+                            const uint16_t method = ReadLE16(p + 4);
+                            const uint16_t nameLength = ReadLE16(p + 22);
+                            if (nameLength == 0 || method > 99 || (p[0] > 100)) {
+                                return false;
+                            }
+                            localOffsets.push_back(entryStart);
+                            streamed = (flags & 8) != 0;
+                            compressedSize = ReadLE32(p + 14);
+                            localNameLength = nameLength;
+                            Expect(Phase::LOCAL_NAMES, nameLength + static_cast<size_t>(ReadLE16(p + 24)));
+                            return true;
+                        }
+                        case Phase::LOCAL_NAMES: {
+                            if (compressedSize == 0xFFFFFFFF && !ReadZip64Size(p + localNameLength, buffer.size() - localNameLength)) {
+                                return false;
+                            }
+                            if (streamed && compressedSize == 0) {
+                                // Size follows the data in a descriptor; find it
+                                phase = Phase::SEARCH;
+                                buffer.clear();
+                                dataStart = recordStart + needed;
+                                matched = 0;
+                                return true;
+                            }
+                            if (streamed) {
+                                Expect(Phase::DESCRIPTOR, 16);
+                            } else {
+                                Expect(Phase::SIGNATURE, 4);
+                            }
+                            skip = compressedSize;
+                            return true;
+                        }
+                        case Phase::DESCRIPTOR: {
+                            // Descriptor is crc, sizes, optionally preceded by its signature
+                            if (ReadLE32(p) == 0x08074B50) {
+                                Expect(Phase::SIGNATURE, 4);
+                            } else {
+                                // No signature: 12 bytes were the descriptor, the last 4 the next signature
+                                buffer.erase(buffer.begin(), buffer.begin() + 12);
+                                phase = Phase::SIGNATURE;
+                                needed = 4;
+                                recordStart += 12;
+                                return Process();
+                            }
+                            return true;
+                        }
+                        case Phase::CENTRAL: {
+                            const uint32_t offset = ReadLE32(p + 38);
+                            if (offset != 0xFFFFFFFF && !std::binary_search(localOffsets.begin(), localOffsets.end(), offset)) {
+                                return false;
+                            }
+                            centralEntries++;
+                            const size_t names = static_cast<size_t>(ReadLE16(p + 24)) + ReadLE16(p + 26) + ReadLE16(p + 28);
+                            Expect(Phase::SIGNATURE, 4);
+                            skip = names;
+                            return true;
+                        }
+                        case Phase::ZIP64_END: {
+                            const uint64_t size = ReadLE64(p);
+                            Expect(Phase::SIGNATURE, 4);
+                            skip = size;
+                            return true;
+                        }
+                        case Phase::SIGNATURE_SIZE: {
+                            const uint16_t size = ReadLE16(p);
+                            Expect(Phase::SIGNATURE, 4);
+                            skip = size;
+                            return true;
+                        }
+                        case Phase::END: {
+                            const uint16_t entries = ReadLE16(p + 6);
+                            const uint32_t size = ReadLE32(p + 8);
+                            const uint32_t offset = ReadLE32(p + 12);
+                            const uint16_t commentLength = ReadLE16(p + 16);
+                            if ((entries != 0xFFFF && entries != (centralEntries & 0xFFFF)) ||
+                                (offset != 0xFFFFFFFF && offset != centralStart) ||
+                                (size != 0xFFFFFFFF && size != centralEnd - centralStart)) {
+                                return false;
+                            }
+                            phase = Phase::DONE;
+                            buffer.clear();
+                            if (commentLength == 0) {
+                                Complete(recordStart + 18);
+                            }
+                            skip = commentLength;
+                            return true;
+                        }
+                        default:
+                            return false;
+                    }
+                }
+
+                // Compressed size from a ZIP64 extra field (after the uncompressed size)
+                bool ReadZip64Size(const uint8_t* extra, size_t length) {
+                    for (size_t pos = 0; pos + 4 <= length;) {
+                        const uint16_t id = ReadLE16(extra + pos);
+                        const uint16_t size = ReadLE16(extra + pos + 2);
+                        if (id == 0x0001 && size >= 16 && pos + 4 + 16 <= length) {
+                            compressedSize = ReadLE64(extra + pos + 12);
+                            return true;
+                        }
+                        pos += 4 + static_cast<size_t>(size);
+                    }
+                    return false;
+                }
+
+                // Scan streamed data for its descriptor; the stored size must match
+                size_t Search(const uint8_t* data, size_t length) {
+                    static const uint8_t signature[4] = {0x50, 0x4B, 0x07, 0x08};
+                    for (size_t i = 0; i < length; i++) {
+                        if (matched >= 4) {
+                            descriptor[matched - 4] = data[i];
+                            if (++matched == 16) {
+                                const uint64_t descriptorStart = consumed + i + 1 - 16;
+                                if (ReadLE32(descriptor + 4) != ((descriptorStart - dataStart) & 0xFFFFFFFF)) {
+                                    // The signature bytes were compressed data; keep looking
+                                    matched = 0;
+                                    continue;
+                                }
+                                Expect(Phase::SIGNATURE, 4);
+                                return i + 1;
+                            }
+                            continue;
+                        }
+                        if (data[i] == signature[matched]) {
+                            matched++;
+                        } else {
+                            matched = data[i] == signature[0] ? 1 : 0;
+                        }
+                    }
+                    return length;
+                }
+
+                Phase phase = Phase::SIGNATURE;
+                size_t needed = 4;
+                std::vector<uint8_t> buffer;
+                uint64_t recordStart = 0;
+                uint64_t entryStart = 0;
+                uint64_t compressedSize = 0;
+                uint16_t localNameLength = 0;
+                bool streamed = false;
+                uint64_t dataStart = 0;
+                size_t matched = 0;
+                uint8_t descriptor[12] = {};
+                std::vector<uint64_t> localOffsets;    // Ascending by construction
+                bool centralSeen = false;
+                uint64_t centralStart = 0;
+                uint64_t centralEnd = 0;
+                uint64_t centralEntries = 0;
+            };
+
+        } // namespace
+
+        std::unique_ptr<FormatValidator> CreateFormatValidator(const FileSignature& signature) {
+            if (std::strcmp(signature.name, "JPEG") == 0) {
+                return std::make_unique<JpegValidator>();
+            }
+            if (std::strcmp(signature.name, "MP4") == 0) {
+                return std::make_unique<Mp4Validator>();
+            }
+            if (std::strcmp(signature.name, "ZIP") == 0 || std::strcmp(signature.name, "DOCX") == 0) {
+                return std::make_unique<ZipValidator>();
+            }
+            return nullptr;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
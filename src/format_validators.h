@@ -0,0 +1,93 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Format Validators
+ *
+ * Incremental structure checks for carved files. A validator is fed the
+ * bytes of a file in order and reports the first byte that cannot belong
+ * to it, or the exact end of the file once its structure is complete.
+ * Validators are cheap to copy, so a carver can keep the state at a
+ * fragment boundary and try several continuations from it.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_FORMAT_VALIDATORS_H
+#define STELLAR_FORMAT_VALIDATORS_H
+
+#include "file_signatures.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Stellar {
+    namespace Recovery {
+
+        enum class ValidationState {
+            NEED_MORE,      // Valid so far
+            COMPLETE,       // End of file reached; Length() is its size
+            INVALID         // Length() is the offset of the first bad byte
+        };
+
+        /**
+         * Streaming structure check for one file
+         */
+        class FormatValidator {
+        public:
+            virtual ~FormatValidator() = default;
+
+            virtual std::unique_ptr<FormatValidator> Clone() const = 0;
+
+            /**
+             * Consume the next bytes of the file. Bytes after the state
+             * leaves NEED_MORE are ignored.
+             */
+            ValidationState Feed(const uint8_t* data, size_t length);
+
+            // No bytes will follow; formats without an end marker may complete here
+            ValidationState Finish();
+
+            ValidationState State() const { return state; }
+
+            // Bytes accepted so far, or the final length once decided
+            uint64_t Length() const { return state == ValidationState::NEED_MORE ? consumed : end; }
+
+            // Upcoming bytes that carry no structure (media data, compressed members)
+            uint64_t Skippable() const { return skip; }
+
+            // Step over up to Skippable() bytes without reading them
+            void Skip(uint64_t bytes);
+
+        protected:
+            /**
+             * Parse bytes starting at file offset consumed. Returns the bytes
+             * used, which must be at least one unless skip was set or the
+             * state was decided.
+             */
+            virtual size_t Parse(const uint8_t* data, size_t length) = 0;
+
+            // True when the file may end at the current offset
+            virtual bool CanEnd() const { return false; }
+
+            void Complete(uint64_t length);
+            void Fail(uint64_t offset);
+
+            uint64_t consumed = 0;
+            uint64_t skip = 0;
+
+        private:
+            ValidationState state = ValidationState::NEED_MORE;
+            uint64_t end = 0;
+        };
+
+        /**
+         * Validator for a signature's format, or nullptr when the format has none
+         * (JPEG, MP4 and ZIP-based formats are checked)
+         */
+        std::unique_ptr<FormatValidator> CreateFormatValidator(const FileSignature& signature);
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_FORMAT_VALIDATORS_H
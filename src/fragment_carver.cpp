@@ -0,0 +1,286 @@
+/**
+ * Stellar Data Recovery Pro Free - Fragment Carver
+ *
+ * Header-to-break validation, gap search and continuation.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "fragment_carver.h"
+#include "format_validators.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            constexpr size_t STREAM_CHUNK = 1 * MiB;
+
+            constexpr double CONTIGUOUS_CONFIDENCE = 0.98;
+            constexpr double BIFRAGMENT_CONFIDENCE = 0.90;
+            constexpr double UNVALIDATED_CONFIDENCE = 0.50;
+
+            // Broken files score by how much of the expected size still validated
+            double TruncatedConfidence(uint64_t validated, uint64_t expected) {
+                double fraction = expected > 0 ? std::min(1.0, static_cast<double>(validated) / expected) : 0.0;
+                return 0.10 + 0.40 * fraction;
+            }
+
+        } // namespace
+
+        // Validator state at a block boundary
+        struct FragmentCarver::Snapshot {
+            uint64_t offset;
+            std::unique_ptr<FormatValidator> state;
+        };
+
+        FragmentCarver::FragmentCarver(SectorSource& source, const FragmentCarverOptions& options) :
+            source(source), options(options), pool(options.workers) {
+            this->options.blockSize = std::max<uint32_t>(this->options.blockSize, 1);
+            this->options.probeLength = std::max<size_t>(this->options.probeLength, 1);
+        }
+
+        std::vector<CarvedFile> FragmentCarver::Carve(const std::vector<CarveTarget>& targets,
+                                                      const ProgressCallback& progress) {
+            std::vector<CarvedFile> files(targets.size());
+            std::vector<std::vector<Snapshot>> snapshots(targets.size());
+            std::atomic<size_t> done(0);
+
+            // Validate every file from its header; all but the broken ones finish here
+            for (size_t i = 0; i < targets.size(); i++) {
+                pool.Submit(i, [&, i](size_t) {
+                    try {
+                        files[i] = CarveOne(targets[i], snapshots[i]);
+                    } catch (const SectorReadError&) {
+                        files[i] = CarvedFile();
+                        files[i].size = targets[i].expectedSize;
+                        files[i].confidence = UNVALIDATED_CONFIDENCE;
+                        snapshots[i].clear();
+                    }
+                    done++;
+                });
+            }
+            while (!pool.WaitIdleFor(std::chrono::milliseconds(100))) {
+                if (progress && !targets.empty()) {
+                    progress(static_cast<int>(done.load() * 100 / targets.size()), "Validating carved files...");
+                }
+            }
+
+            // Broken files search their gap one at a time, candidates in parallel
+            for (size_t i = 0; i < targets.size(); i++) {
+                if (snapshots[i].empty()) {
+                    continue;
+                }
+                try {
+                    SearchGap(targets[i], snapshots[i], files[i]);
+                } catch (const SectorReadError&) {
+                    // Keep the truncated result
+                }
+                snapshots[i].clear();
+                if (progress) {
+                    progress(static_cast<int>((i + 1) * 100 / targets.size()), "Reassembling fragments...");
+                }
+            }
+            return files;
+        }
+
+        CarvedFile FragmentCarver::CarveOne(const CarveTarget& target, std::vector<Snapshot>& snapshots) {
+            CarvedFile file;
+            file.size = target.expectedSize;
+            std::unique_ptr<FormatValidator> validator = CreateFormatValidator(*target.signature);
+            if (!validator) {
+                file.confidence = UNVALIDATED_CONFIDENCE;
+                return file;
+            }
+
+            const uint64_t limit = std::min(source.Size(), target.offset + target.signature->maxSize);
+            Stream(*validator, target.offset, limit, target.offset, &snapshots);
+
+            const uint64_t validated = validator->Length();
+            if (validator->State() == ValidationState::COMPLETE) {
+                file.layout = CarveLayout::CONTIGUOUS;
+                file.size = validated;
+                file.confidence = CONTIGUOUS_CONFIDENCE;
+                snapshots.clear();
+                return file;
+            }
+
+            // Without a continuation the old footer-based size is still the best guess
+            file.layout = CarveLayout::TRUNCATED;
+            file.size = std::min(std::max(validated, target.expectedSize), target.signature->maxSize);
+            file.confidence = TruncatedConfidence(validated, target.expectedSize);
+            if (validator->State() == ValidationState::NEED_MORE) {
+                snapshots.clear();      // Ran into the end of the source, not a break
+            }
+            return file;
+        }
+
+        void FragmentCarver::SearchGap(const CarveTarget& target, std::vector<Snapshot>& snapshots, CarvedFile& file) {
+            const uint64_t block = options.blockSize;
+            const uint64_t origin = target.offset;
+
+            // The first fragment needs at least one block; long skips cannot be probed
+            snapshots.erase(std::remove_if(snapshots.begin(), snapshots.end(), [&](const Snapshot& snapshot) {
+                return snapshot.offset == origin || snapshot.state->Skippable() > options.maxGap;
+            }), snapshots.end());
+            if (snapshots.empty()) {
+                return;
+            }
+
+            // Nearest gaps first; for each gap the latest boundary first
+            struct Candidate {
+                size_t snapshot;
+                uint64_t start;
+            };
+            std::vector<Candidate> candidates;
+            uint64_t low = UINT64_MAX;
+            uint64_t high = 0;
+            for (uint64_t gap = block; gap <= options.maxGap; gap += block) {
+                for (size_t s = snapshots.size(); s-- > 0;) {
+                    uint64_t start = snapshots[s].offset + gap;
+                    if (start < source.Size()) {
+                        candidates.push_back(Candidate{s, start});
+                    }
+                }
+            }
+            for (const auto& snapshot : snapshots) {
+                low = std::min(low, snapshot.offset + block);
+                high = std::max(high, snapshot.offset + options.maxGap + snapshot.state->Skippable() + options.probeLength);
+            }
+            high = std::min(high, source.Size());
+            if (candidates.empty() || low >= high) {
+                return;
+            }
+
+            // The whole window is read once and shared by every candidate
+            std::vector<uint8_t> buffer;
+            const size_t windowLength = static_cast<size_t>(high - low);
+            const uint8_t* window = source.View(low, windowLength);
+            if (!window) {
+                buffer.resize(windowLength);
+                buffer.resize(source.ReadAt(low, buffer.data(), windowLength));
+                window = buffer.data();
+                high = low + buffer.size();
+            }
+
+            auto evaluate = [&](const Candidate& candidate) {
+                const Snapshot& snapshot = snapshots[candidate.snapshot];
+                std::unique_ptr<FormatValidator> trial = snapshot.state->Clone();
+                const uint64_t skipped = trial->Skippable();
+                trial->Skip(skipped);
+                const uint64_t dataStart = candidate.start + skipped;
+                if (dataStart >= high) {
+                    return false;
+                }
+                const size_t length = static_cast<size_t>(std::min<uint64_t>(options.probeLength, high - dataStart));
+                trial->Feed(window + (dataStart - low), length);
+                if (trial->State() == ValidationState::NEED_MORE && length < options.probeLength) {
+                    trial->Finish();
+                }
+                // The candidate's own bytes must have been parsed, not just skipped
+                const bool progressed = trial->Length() > snapshot.offset - origin + skipped;
+                return progressed && (trial->State() == ValidationState::COMPLETE ||
+                                      (trial->State() == ValidationState::NEED_MORE && length == options.probeLength));
+            };
+
+            // Workers take candidates in order and stop once a nearer one has passed
+            std::atomic<size_t> next(0);
+            std::atomic<size_t> best(candidates.size());
+            for (size_t worker = 0; worker < pool.WorkerCount(); worker++) {
+                pool.Submit(worker, [&](size_t) {
+                    for (size_t i = next++; i < candidates.size() && i < best.load(); i = next++) {
+                        if (evaluate(candidates[i])) {
+                            size_t current = best.load();
+                            while (i < current && !best.compare_exchange_weak(current, i)) {
+                            }
+                        }
+                    }
+                });
+            }
+            pool.WaitIdle();
+            if (best.load() == candidates.size()) {
+                return;
+            }
+
+            // Follow the winning continuation to the end of the file
+            const Candidate& winner = candidates[best.load()];
+            const Snapshot& snapshot = snapshots[winner.snapshot];
+            const uint64_t firstLength = snapshot.offset - origin;
+            std::unique_ptr<FormatValidator> validator = snapshot.state->Clone();
+            const uint64_t limit = std::min(source.Size(), winner.start + (target.signature->maxSize - firstLength));
+            Stream(*validator, winner.start, limit, winner.start, nullptr);
+
+            const uint64_t validated = validator->Length();
+            if (validated <= firstLength) {
+                return;
+            }
+            file.size = validated;
+            file.extents = {FileExtent{origin, firstLength}, FileExtent{winner.start, validated - firstLength}};
+            if (validator->State() == ValidationState::COMPLETE) {
+                file.layout = CarveLayout::BIFRAGMENT;
+                // A boundary inside skipped payload (deflate data, media) rejoins as well as
+                // any other boundary over that payload, so the break was only guessed
+                const bool pinned = snapshot.state->Skippable() == 0;
+                file.confidence = pinned ? BIFRAGMENT_CONFIDENCE : TruncatedConfidence(validated, target.expectedSize);
+            } else {
+                file.confidence = TruncatedConfidence(validated, target.expectedSize);
+            }
+        }
+
+        void FragmentCarver::Stream(FormatValidator& validator, uint64_t from, uint64_t to, uint64_t origin,
+                                    std::vector<Snapshot>* snapshots) {
+            const uint64_t block = options.blockSize;
+            std::vector<uint8_t> buffer;
+            uint64_t position = from;
+            while (position < to && validator.State() == ValidationState::NEED_MORE) {
+                // Unstructured payload is stepped over without reading it
+                if (validator.Skippable() >= block) {
+                    uint64_t step = std::min(validator.Skippable(), to - position);
+                    validator.Skip(step);
+                    position += step;
+                    continue;
+                }
+
+                size_t length = static_cast<size_t>(std::min<uint64_t>(STREAM_CHUNK, to - position));
+                const uint8_t* data = source.View(position, length);
+                if (!data) {
+                    buffer.resize(length);
+                    length = source.ReadAt(position, buffer.data(), length);
+                    data = buffer.data();
+                    if (length == 0) {
+                        break;
+                    }
+                }
+
+                if (!snapshots) {
+                    validator.Feed(data, length);
+                    position += length;
+                    continue;
+                }
+                // Keep the state at the last few block boundaries
+                for (size_t done = 0; done < length && validator.State() == ValidationState::NEED_MORE;) {
+                    const uint64_t relative = position + done - origin;
+                    if (relative % block == 0) {
+                        if (snapshots->size() > options.backtrackBlocks) {
+                            snapshots->erase(snapshots->begin());
+                        }
+                        snapshots->push_back(Snapshot{position + done, validator.Clone()});
+                    }
+                    size_t piece = static_cast<size_t>(std::min<uint64_t>(block - relative % block, length - done));
+                    validator.Feed(data + done, piece);
+                    done += piece;
+                }
+                position += length;
+            }
+            if (validator.State() == ValidationState::NEED_MORE) {
+                validator.Finish();
+            }
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
@@ -0,0 +1,104 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Fragment Carver
+ *
+ * Bifragment gap carving for carved files whose format can be validated.
+ * Each file is validated from its header; where validation breaks, the
+ * state at the last few block boundaries is kept and every block start
+ * within the gap window is tried as the start of the second fragment.
+ * Candidates are evaluated on the scan thread pool and the nearest one
+ * whose data keeps validating wins. The outcome also sets the file's
+ * confidence; a join across a break inside skipped payload, which no
+ * validator can place, scores as truncated.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_FRAGMENT_CARVER_H
+#define STELLAR_FRAGMENT_CARVER_H
+
+#include "stellar_recovery.h"
+#include "sector_reader.h"
+#include "file_signatures.h"
+#include "scan_scheduler.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        class FormatValidator;
+
+        // A carved header to follow
+        struct CarveTarget {
+            uint64_t offset;                    // File start on the source
+            uint64_t expectedSize;              // Size implied by footers or the next header
+            const FileSignature* signature;
+        };
+
+        enum class CarveLayout {
+            UNVALIDATED,    // No validator for the format; expectedSize is kept
+            CONTIGUOUS,     // Validated to its end in one run
+            BIFRAGMENT,     // Validated to its end across two runs
+            TRUNCATED       // Validation broke and no continuation was found
+        };
+
+        struct CarvedFile {
+            CarveLayout layout;
+            uint64_t size;
+            double confidence;
+            std::vector<FileExtent> extents;    // Set for BIFRAGMENT only; otherwise one run from the header
+
+            CarvedFile() : layout(CarveLayout::UNVALIDATED), size(0), confidence(0) {}
+        };
+
+        struct FragmentCarverOptions {
+            uint32_t blockSize;         // Fragments start and end on these boundaries (sector or cluster)
+            uint64_t maxGap;            // Furthest the second fragment may start past the first
+            uint32_t backtrackBlocks;   // Boundaries before the detected break tried as the first fragment's end
+            size_t probeLength;         // Bytes of a second fragment that must validate to accept it
+            size_t workers;             // 0 = GetDefaultWorkerCount()
+
+            FragmentCarverOptions() :
+                blockSize(512),
+                maxGap(4 * MiB),
+                backtrackBlocks(4),
+                probeLength(32 * KiB),
+                workers(0) {}
+        };
+
+        /**
+         * Validates and reassembles carved files from one source
+         */
+        class FragmentCarver {
+        public:
+            FragmentCarver(SectorSource& source, const FragmentCarverOptions& options = FragmentCarverOptions());
+
+            /**
+             * One result per target, in order. Read errors leave a target
+             * unvalidated rather than failing the batch. progress is called
+             * from the calling thread.
+             */
+            std::vector<CarvedFile> Carve(const std::vector<CarveTarget>& targets,
+                                          const ProgressCallback& progress = ProgressCallback());
+
+        private:
+            struct Snapshot;
+
+            CarvedFile CarveOne(const CarveTarget& target, std::vector<Snapshot>& snapshots);
+            void SearchGap(const CarveTarget& target, std::vector<Snapshot>& snapshots, CarvedFile& file);
+            void Stream(FormatValidator& validator, uint64_t from, uint64_t to, uint64_t origin,
+                        std::vector<Snapshot>* snapshots);
+
+            SectorSource& source;
+            FragmentCarverOptions options;
+            WorkStealingPool pool;
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_FRAGMENT_CARVER_H
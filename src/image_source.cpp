@@ -0,0 +1,211 @@
+/**
+ * Stellar Data Recovery Pro Free - Memory-Mapped Image Source
+ *
+ * mmap / MapViewOfFile backed image access and source selection.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "image_source.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <filesystem>
+#include <limits>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            // Prefaulting a mapping larger than RAM only evicts its own pages
+            bool ShouldPopulate(uint64_t size, const MappedSourceOptions& options) {
+                if (!options.populate) {
+                    return false;
+                }
+#ifdef _WIN32
+                MEMORYSTATUSEX status;
+                status.dwLength = sizeof(status);
+                if (!GlobalMemoryStatusEx(&status)) {
+                    return false;
+                }
+                double physical = static_cast<double>(status.ullTotalPhys);
+#else
+                long pages = sysconf(_SC_PHYS_PAGES);
+                long pageSize = sysconf(_SC_PAGESIZE);
+                if (pages <= 0 || pageSize <= 0) {
+                    return false;
+                }
+                double physical = static_cast<double>(pages) * static_cast<double>(pageSize);
+#endif
+                return static_cast<double>(size) <= physical * options.populateLimit;
+            }
+
+        } // namespace
+
+#ifdef _WIN32
+
+        MappedImageSource::MappedImageSource(const std::string& path, const MappedSourceOptions& options) :
+            path(path) {
+            HANDLE h = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                   OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (h == INVALID_HANDLE_VALUE) {
+                throw SectorReadError("Cannot open " + path + " (error " +
+                                      std::to_string(GetLastError()) + ")");
+            }
+            file = h;
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(h, &fileSize) || fileSize.QuadPart <= 0 ||
+                static_cast<uint64_t>(fileSize.QuadPart) > std::numeric_limits<size_t>::max()) {
+                CloseHandle(h);
+                throw SectorReadError("Cannot map " + path + ": empty or larger than the address space");
+            }
+            size = static_cast<uint64_t>(fileSize.QuadPart);
+
+            mapping = CreateFileMappingA(h, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                base = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            }
+            if (!base) {
+                DWORD error = GetLastError();
+                if (mapping) {
+                    CloseHandle(mapping);
+                }
+                CloseHandle(h);
+                throw SectorReadError("Cannot map " + path + " (error " + std::to_string(error) + ")");
+            }
+
+            // PrefetchVirtualMemory is Windows 8+; large pages are not available for file views
+            if (ShouldPopulate(size, options)) {
+                struct MemoryRange {
+                    PVOID address;
+                    SIZE_T bytes;
+                };
+                using PrefetchFunction = BOOL (WINAPI*)(HANDLE, ULONG_PTR, MemoryRange*, ULONG);
+                auto prefetch = reinterpret_cast<PrefetchFunction>(
+                    GetProcAddress(GetModuleHandleA("kernel32.dll"), "PrefetchVirtualMemory"));
+                if (prefetch) {
+                    MemoryRange range = {const_cast<uint8_t*>(base), static_cast<SIZE_T>(size)};
+                    prefetch(GetCurrentProcess(), 1, &range, 0);
+                }
+            }
+        }
+
+        MappedImageSource::~MappedImageSource() {
+            if (base) {
+                UnmapViewOfFile(base);
+            }
+            if (mapping) {
+                CloseHandle(static_cast<HANDLE>(mapping));
+            }
+            if (file) {
+                CloseHandle(static_cast<HANDLE>(file));
+            }
+        }
+
+#else
+
+        MappedImageSource::MappedImageSource(const std::string& path, const MappedSourceOptions& options) :
+            path(path) {
+            fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                throw SectorReadError("Cannot open " + path + ": " + std::strerror(errno));
+            }
+
+            struct stat info;
+            if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0 ||
+                static_cast<uint64_t>(info.st_size) > std::numeric_limits<size_t>::max()) {
+                ::close(fd);
+                throw SectorReadError("Cannot map " + path + ": not a non-empty regular file");
+            }
+            size = static_cast<uint64_t>(info.st_size);
+            // Pages missing from the cache still come off the backing disk
+            seekPenalty = DescriptorIncursSeekPenalty(fd);
+
+            int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+            if (ShouldPopulate(size, options)) {
+                flags |= MAP_POPULATE;
+            }
+#endif
+            void* address = mmap(nullptr, static_cast<size_t>(size), PROT_READ, flags, fd, 0);
+            if (address == MAP_FAILED) {
+                int error = errno;
+                ::close(fd);
+                throw SectorReadError("Cannot map " + path + ": " + std::strerror(error));
+            }
+            base = static_cast<const uint8_t*>(address);
+
+            // Hints only; file-backed huge pages need CONFIG_READ_ONLY_THP_FOR_FS
+            madvise(address, static_cast<size_t>(size), MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+            if (options.hugePages) {
+                madvise(address, static_cast<size_t>(size), MADV_HUGEPAGE);
+            }
+#endif
+        }
+
+        MappedImageSource::~MappedImageSource() {
+            if (base) {
+                munmap(const_cast<uint8_t*>(base), static_cast<size_t>(size));
+            }
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+
+#endif
+
+        size_t MappedImageSource::ReadAt(uint64_t offset, void* buffer, size_t length) {
+            if (offset >= size) {
+                return 0;
+            }
+            size_t count = static_cast<size_t>(std::min<uint64_t>(length, size - offset));
+            std::memcpy(buffer, base + offset, count);
+            MetricsRegistry::Global().Add(Counter::BYTES_READ, count);
+            return count;
+        }
+
+        const uint8_t* MappedImageSource::View(uint64_t offset, size_t length) {
+            if (offset > size || length > size - offset) {
+                return nullptr;
+            }
+            return base + offset;
+        }
+
+        bool IsImageFile(const std::string& path) {
+            std::error_code error;
+            return std::filesystem::is_regular_file(std::filesystem::u8path(path), error);
+        }
+
+        std::unique_ptr<SectorSource> OpenSectorSource(const std::string& path, const SourceOptions& options,
+                                                       const MappedSourceOptions& mapped) {
+            if (IsImageFile(path)) {
+                try {
+                    return std::make_unique<MappedImageSource>(path, mapped);
+                } catch (const SectorReadError&) {
+                    // 32-bit address space or a file system without mmap support
+                }
+            }
+            return std::make_unique<FileSectorSource>(path, options);
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
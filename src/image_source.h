@@ -0,0 +1,91 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Memory-Mapped Image Source
+ *
+ * Forensic images (.dd, .img, .raw) are mapped read-only so the carver
+ * and file system parsers work directly on the page cache instead of
+ * copying every chunk into user buffers.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_IMAGE_SOURCE_H
+#define STELLAR_IMAGE_SOURCE_H
+
+#include "sector_reader.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Stellar {
+    namespace Recovery {
+
+        /**
+         * Mapping options
+         */
+        struct MappedSourceOptions {
+            bool populate;          // Prefault the mapping (MAP_POPULATE / PrefetchVirtualMemory)
+            bool hugePages;         // Ask for transparent huge pages where the OS supports it
+            double populateLimit;   // Only prefault images up to this share of physical memory
+
+            MappedSourceOptions() :
+                populate(true),
+                hugePages(true),
+                populateLimit(0.5) {}
+        };
+
+        /**
+         * Read-only mapping of a whole disk image. Reads on failing media
+         * surface as SIGBUS / EXCEPTION_IN_PAGE_ERROR rather than
+         * SectorReadError, so devices and images on suspect disks should
+         * go through FileSectorSource.
+         */
+        class MappedImageSource : public SectorSource {
+        public:
+            explicit MappedImageSource(const std::string& path,
+                                       const MappedSourceOptions& options = MappedSourceOptions());
+            ~MappedImageSource() override;
+
+            MappedImageSource(const MappedImageSource&) = delete;
+            MappedImageSource& operator=(const MappedImageSource&) = delete;
+
+            const std::string& Path() const override { return path; }
+            uint64_t Size() const override { return size; }
+            uint32_t SectorSize() const override { return 512; }
+            size_t ReadAt(uint64_t offset, void* buffer, size_t length) override;
+            const uint8_t* View(uint64_t offset, size_t length) override;
+            bool IncursSeekPenalty() const override { return seekPenalty; }
+
+        private:
+            std::string path;
+            uint64_t size = 0;
+            bool seekPenalty = false;
+            const uint8_t* base = nullptr;
+#ifdef _WIN32
+            void* file = nullptr;
+            void* mapping = nullptr;
+#else
+            int fd = -1;
+#endif
+        };
+
+        // True for regular files that can be mapped (not devices or volumes)
+        bool IsImageFile(const std::string& path);
+
+        /**
+         * Open a scan source: image files are mapped, devices and volumes
+         * are read through FileSectorSource. Falls back to FileSectorSource
+         * when the mapping cannot be created. Callers that only touch
+         * metadata turn mapped.populate off so the image is not read whole.
+         */
+        std::unique_ptr<SectorSource> OpenSectorSource(const std::string& path,
+                                                       const SourceOptions& options = SourceOptions(),
+                                                       const MappedSourceOptions& mapped = MappedSourceOptions());
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_IMAGE_SOURCE_H
@@ -0,0 +1,359 @@
+/**
+ * Stellar Data Recovery Pro Free - Asynchronous Read Queue
+ *
+ * io_uring queue (Linux) and the synchronous fallback.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "io_queue.h"
+#include "sector_reader.h"
+#include "metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <string>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace Stellar {
+    namespace Recovery {
+
+        void IoQueue::Started(size_t requests) {
+            if (inFlight == 0 && requests > 0) {
+                busySince = std::chrono::steady_clock::now();
+            }
+            inFlight += requests;
+            stats.requests += requests;
+        }
+
+        void IoQueue::Finished(size_t bytes) {
+            inFlight--;
+            stats.bytes += bytes;
+            if (inFlight == 0) {
+                stats.busySeconds += std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - busySince).count();
+            }
+        }
+
+        namespace {
+
+            /**
+             * Reads are issued one at a time from Wait(), in submission order
+             */
+            class SyncIoQueue : public IoQueue {
+            public:
+                SyncIoQueue(SectorSource& source, const std::vector<IoBuffer>& buffers, size_t depth) :
+                    source(source), buffers(buffers), depth(std::max<size_t>(depth, 1)) {}
+
+                const char* Name() const override { return "synchronous"; }
+                size_t Depth() const override { return depth; }
+
+                void Submit(size_t buffer, uint64_t offset, size_t length) override {
+                    queued.push_back({buffer, offset, length});
+                    Started(1);
+                }
+
+                IoCompletion Wait() override {
+                    if (queued.empty()) {
+                        throw SectorReadError("No read outstanding on " + source.Path());
+                    }
+                    Request request = queued.front();
+                    queued.pop_front();
+                    size_t got;
+                    try {
+                        got = source.ReadAt(request.offset, buffers[request.buffer].data, request.length);
+                    } catch (...) {
+                        Finished(0);
+                        throw;
+                    }
+                    Finished(got);
+                    return {request.buffer, request.offset, got};
+                }
+
+            private:
+                struct Request {
+                    size_t buffer;
+                    uint64_t offset;
+                    size_t length;
+                };
+
+                SectorSource& source;
+                std::vector<IoBuffer> buffers;
+                size_t depth;
+                std::deque<Request> queued;
+            };
+
+#ifdef __linux__
+
+            int UringSetup(unsigned entries, io_uring_params* params) {
+                return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+            }
+
+            int UringEnter(int ring, unsigned submit, unsigned complete, unsigned flags) {
+                return static_cast<int>(syscall(__NR_io_uring_enter, ring, submit, complete, flags, nullptr, 0));
+            }
+
+            int UringRegister(int ring, unsigned opcode, const void* args, unsigned count) {
+                return static_cast<int>(syscall(__NR_io_uring_register, ring, opcode, args, count));
+            }
+
+            /**
+             * io_uring over raw system calls. Buffers are registered for
+             * READ_FIXED; if the memlock limit refuses that, READV is used.
+             */
+            class UringIoQueue : public IoQueue {
+            public:
+                UringIoQueue(SectorSource& gate, int fd, uint64_t sourceSize, const std::string& path,
+                             const std::vector<IoBuffer>& buffers, size_t depth) :
+                    gate(gate), fd(fd), sourceSize(sourceSize), path(path), depth(std::max<size_t>(depth, 1)),
+                    requests(buffers.size()) {
+                    io_uring_params params;
+                    std::memset(&params, 0, sizeof(params));
+                    ring = UringSetup(static_cast<unsigned>(this->depth), &params);
+                    if (ring < 0) {
+                        throw SectorReadError("io_uring unavailable: " + std::string(std::strerror(errno)));
+                    }
+
+                    sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                    cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+                        sqSize = cqSize = std::max(sqSize, cqSize);
+                    }
+                    sqRing = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  ring, IORING_OFF_SQ_RING);
+                    cqRing = (params.features & IORING_FEAT_SINGLE_MMAP) ? sqRing
+                        : mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                               ring, IORING_OFF_CQ_RING);
+                    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+                    void* entries = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                         ring, IORING_OFF_SQES);
+                    if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || entries == MAP_FAILED) {
+                        int error = errno;
+                        if (entries != MAP_FAILED) {
+                            munmap(entries, sqesSize);
+                        }
+                        Release();
+                        throw SectorReadError("io_uring ring mapping failed: " + std::string(std::strerror(error)));
+                    }
+                    sqes = static_cast<io_uring_sqe*>(entries);
+
+                    uint8_t* sq = static_cast<uint8_t*>(sqRing);
+                    uint8_t* cq = static_cast<uint8_t*>(cqRing);
+                    sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+                    sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+                    sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+                    cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+                    cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+                    cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+                    cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+                    this->depth = std::min<size_t>(this->depth, params.sq_entries);
+
+                    std::vector<iovec> vectors;
+                    for (const auto& buffer : buffers) {
+                        vectors.push_back({buffer.data, buffer.size});
+                    }
+                    fixed = !vectors.empty() &&
+                            UringRegister(ring, IORING_REGISTER_BUFFERS, vectors.data(),
+                                          static_cast<unsigned>(vectors.size())) == 0;
+                    for (size_t i = 0; i < buffers.size(); i++) {
+                        requests[i].base = buffers[i].data;
+                    }
+                }
+
+                ~UringIoQueue() override {
+                    // The kernel may still be writing into caller buffers
+                    while (inFlight > 0) {
+                        try {
+                            Wait();
+                        } catch (const SectorReadError&) {
+                        }
+                    }
+                    if (sqes) {
+                        munmap(sqes, sqesSize);
+                    }
+                    Release();
+                }
+
+                const char* Name() const override { return fixed ? "io_uring (registered buffers)" : "io_uring"; }
+                size_t Depth() const override { return depth; }
+
+                void Submit(size_t buffer, uint64_t offset, size_t length) override {
+                    gate.Admit(length);
+                    Request& request = requests[buffer];
+                    request.offset = offset;
+                    request.length = length;
+                    request.done = 0;
+                    request.submitted = std::chrono::steady_clock::now();
+                    Queue(buffer);
+                    Started(1);
+                }
+
+                IoCompletion Wait() override {
+                    for (;;) {
+                        if (pending > 0) {
+                            Enter(0);
+                        }
+                        unsigned head = *cqHead;
+                        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+                            Enter(1);
+                            continue;
+                        }
+                        io_uring_cqe cqe = cqes[head & cqMask];
+                        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+
+                        size_t index = static_cast<size_t>(cqe.user_data);
+                        Request& request = requests[index];
+                        if (cqe.res < 0) {
+                            Finished(request.done);
+                            Record(request, true);
+                            throw SectorReadError("Read failed on " + path + ": " + std::strerror(-cqe.res),
+                                                  request.offset + request.done);
+                        }
+                        request.done += static_cast<size_t>(cqe.res);
+
+                        // Short reads before the end of the source are resumed
+                        uint64_t position = request.offset + request.done;
+                        if (cqe.res > 0 && request.done < request.length && position < sourceSize) {
+                            Queue(index);
+                            continue;
+                        }
+                        Finished(request.done);
+                        Record(request, false);
+                        return {index, request.offset, request.done};
+                    }
+                }
+
+            private:
+                struct Request {
+                    uint8_t* base = nullptr;
+                    uint64_t offset = 0;
+                    size_t length = 0;
+                    size_t done = 0;
+                    iovec vector = {};
+                    std::chrono::steady_clock::time_point submitted;
+                };
+
+                // The same counters FileSectorSource::ReadAt keeps for synchronous reads
+                void Record(const Request& request, bool failed) {
+                    MetricsRegistry& metrics = MetricsRegistry::Global();
+                    metrics.Record(Histogram::READ_LATENCY, static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - request.submitted).count()));
+                    metrics.Add(Counter::BYTES_READ, request.done);
+                    if (failed) {
+                        metrics.Add(Counter::READ_ERRORS);
+                    }
+                }
+
+                void Queue(size_t index) {
+                    Request& request = requests[index];
+                    unsigned tail = *sqTail;
+                    unsigned slot = tail & sqMask;
+                    io_uring_sqe& sqe = sqes[slot];
+                    std::memset(&sqe, 0, sizeof(sqe));
+                    sqe.fd = fd;
+                    sqe.off = request.offset + request.done;
+                    sqe.user_data = index;
+                    if (fixed) {
+                        sqe.opcode = IORING_OP_READ_FIXED;
+                        sqe.addr = reinterpret_cast<uint64_t>(request.base + request.done);
+                        sqe.len = static_cast<uint32_t>(request.length - request.done);
+                        sqe.buf_index = static_cast<uint16_t>(index);
+                    } else {
+                        request.vector = {request.base + request.done, request.length - request.done};
+                        sqe.opcode = IORING_OP_READV;
+                        sqe.addr = reinterpret_cast<uint64_t>(&request.vector);
+                        sqe.len = 1;
+                    }
+                    sqArray[slot] = slot;
+                    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+                    pending++;
+                }
+
+                void Enter(unsigned complete) {
+                    int result = UringEnter(ring, pending, complete, complete ? IORING_ENTER_GETEVENTS : 0);
+                    if (result < 0) {
+                        if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                            return;
+                        }
+                        throw SectorReadError("io_uring_enter failed on " + path + ": " + std::strerror(errno));
+                    }
+                    pending -= std::min<unsigned>(pending, static_cast<unsigned>(result));
+                }
+
+                void Release() {
+                    if (cqRing && cqRing != MAP_FAILED && cqRing != sqRing) {
+                        munmap(cqRing, cqSize);
+                    }
+                    if (sqRing && sqRing != MAP_FAILED) {
+                        munmap(sqRing, sqSize);
+                    }
+                    ::close(ring);
+                }
+
+                SectorSource& gate;         // Source the caller handed in; charged for every read
+                int fd;
+                uint64_t sourceSize;
+                std::string path;
+                size_t depth;
+                int ring = -1;
+                bool fixed = false;
+                unsigned pending = 0;       // Queued but not yet handed to the kernel
+
+                void* sqRing = nullptr;
+                void* cqRing = nullptr;
+                size_t sqSize = 0;
+                size_t cqSize = 0;
+                size_t sqesSize = 0;
+                io_uring_sqe* sqes = nullptr;
+                unsigned* sqTail = nullptr;
+                unsigned* sqArray = nullptr;
+                unsigned sqMask = 0;
+                unsigned* cqHead = nullptr;
+                unsigned* cqTail = nullptr;
+                unsigned cqMask = 0;
+                io_uring_cqe* cqes = nullptr;
+
+                std::vector<Request> requests;
+            };
+
+#endif
+
+        } // namespace
+
+        std::unique_ptr<IoQueue> CreateIoQueue(SectorSource& source, const std::vector<IoBuffer>& buffers,
+                                               size_t depth, IoEngine engine) {
+#ifdef __linux__
+            // Wrappers that only gate reads are looked through; their Admit() runs on submission
+            SectorSource* target = &source;
+            while (SectorSource* inner = target->Passthrough()) {
+                target = inner;
+            }
+            auto* file = dynamic_cast<FileSectorSource*>(target);
+            if (engine != IoEngine::SYNC && file) {
+                try {
+                    return std::make_unique<UringIoQueue>(source, file->Descriptor(), file->Size(), file->Path(),
+                                                          buffers, depth);
+                } catch (const SectorReadError&) {
+                    // Kernel too old, io_uring disabled, or blocked by seccomp
+                }
+            }
+#else
+            (void)engine;
+#endif
+            return std::make_unique<SyncIoQueue>(source, buffers, depth);
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
@@ -0,0 +1,112 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Asynchronous Read Queue
+ *
+ * Keeps several reads in flight against one source. On Linux the queue
+ * is an io_uring instance driven through raw system calls, with the
+ * caller's buffers registered once so each read skips page pinning.
+ * Elsewhere, or when io_uring is unavailable, a synchronous queue with
+ * the same interface issues the reads one at a time.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_IO_QUEUE_H
+#define STELLAR_IO_QUEUE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        class SectorSource;
+
+        enum class IoEngine {
+            AUTO,       // io_uring when available, otherwise synchronous
+            IO_URING,
+            SYNC
+        };
+
+        /**
+         * Achieved throughput. Time is counted only while at least one
+         * read is outstanding, so consumer stalls do not dilute it.
+         */
+        struct IoStats {
+            uint64_t requests;
+            uint64_t bytes;
+            double busySeconds;
+
+            IoStats() : requests(0), bytes(0), busySeconds(0) {}
+
+            double Iops() const { return busySeconds > 0 ? static_cast<double>(requests) / busySeconds : 0; }
+            double BytesPerSecond() const { return busySeconds > 0 ? static_cast<double>(bytes) / busySeconds : 0; }
+        };
+
+        // A read target owned by the caller; must outlive the queue
+        struct IoBuffer {
+            uint8_t* data;
+            size_t size;
+        };
+
+        struct IoCompletion {
+            size_t buffer;      // Index into the buffers the queue was created with
+            uint64_t offset;
+            size_t bytes;       // Only short at the end of the source
+        };
+
+        /**
+         * Fixed-depth read queue over a set of registered buffers
+         */
+        class IoQueue {
+        public:
+            virtual ~IoQueue() = default;
+
+            virtual const char* Name() const = 0;
+
+            // Reads that may be outstanding at once
+            virtual size_t Depth() const = 0;
+
+            /**
+             * Queue a read into buffer. Submission may be deferred until
+             * the next Wait(). At most Depth() reads may be outstanding.
+             */
+            virtual void Submit(size_t buffer, uint64_t offset, size_t length) = 0;
+
+            /**
+             * Block until a read finishes. Completions may arrive out of
+             * order. Throws SectorReadError if the read failed.
+             */
+            virtual IoCompletion Wait() = 0;
+
+            size_t InFlight() const { return inFlight; }
+            const IoStats& Stats() const { return stats; }
+
+        protected:
+            void Started(size_t requests);
+            void Finished(size_t bytes);
+
+            size_t inFlight = 0;
+            IoStats stats;
+
+        private:
+            std::chrono::steady_clock::time_point busySince;
+        };
+
+        /**
+         * Create a queue of the given depth for source. io_uring needs a
+         * POSIX FileSectorSource, possibly behind passthrough wrappers such
+         * as BudgetedSource; anything else gets the synchronous queue.
+         */
+        std::unique_ptr<IoQueue> CreateIoQueue(SectorSource& source, const std::vector<IoBuffer>& buffers,
+                                               size_t depth, IoEngine engine = IoEngine::AUTO);
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_IO_QUEUE_H
@@ -19,13 +19,23 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
-#include <windows.h>
-#include <winioctl.h>
-#include <setupapi.h>
-#include <cfgmgr32.h>
-
-#pragma comment(lib, "setupapi.lib")
-#pragma comment(lib, "cfgmgr32.lib")
+#include <cctype>
+#include "device_enumerator.h"
+#include "sector_reader.h"
+#include "signature_carver.h"
+#include "scan_scheduler.h"
+#include "filesystem_scanner.h"
+#include "image_source.h"
+#include "result_store.h"
+#include "result_index.h"
+#include "scan_checkpoint.h"
+#include "recovery_pipeline.h"
+#include "fragment_carver.h"
+#include "dedup_index.h"
+#include "partition_recovery.h"
+#include "disk_imager.h"
+#include "batch_runner.h"
+#include "metrics.h"
 
 // Forward declarations
 class StellarRecovery;
@@ -60,7 +70,9 @@ enum class DriveType {
     SD_CARD,
     CD_DVD,
     RAID,
-    NETWORK
+    NETWORK,
+    VIRTUAL,
+    IMAGE
 };
 
 // Structures
@@ -74,22 +86,14 @@ struct DriveInfo {
     bool isAccessible;
 };
 
-struct RecoveryResult {
-    std::string fileName;
-    std::string originalPath;
-    std::string recoveryPath;
-    uint64_t fileSize;
-    std::chrono::system_clock::time_point dateModified;
-    bool isRecovered;
-    double confidence;
-};
-
 /**
  * Progress tracking class for recovery operations
  */
 class ProgressTracker {
 public:
-    void UpdateProgress(int percentage, const std::string& currentOperation) {
+    virtual ~ProgressTracker() = default;
+    
+    virtual void UpdateProgress(int percentage, const std::string& currentOperation) {
         if (percentage != lastPercentage) {
             std::cout << "\r[" << std::string(percentage / 2, '=') 
                      << std::string(50 - percentage / 2, ' ') << "] " 
@@ -98,7 +102,7 @@ public:
         }
     }
     
-    void Complete() {
+    virtual void Complete() {
         std::cout << "\n" << std::endl;
     }
     
@@ -106,6 +110,33 @@ private:
     int lastPercentage = -1;
 };
 
+/**
+ * Progress of a headless job, reported as JSON events
+ */
+class JobProgressTracker : public ProgressTracker {
+public:
+    JobProgressTracker(Stellar::Recovery::JobEventWriter& events, const std::string& job) :
+        events(events), job(job) {}
+    
+    void UpdateProgress(int percentage, const std::string& currentOperation) override {
+        if (percentage != lastPercentage || currentOperation != lastOperation) {
+            events.Progress(job, percentage, currentOperation);
+            lastPercentage = percentage;
+            lastOperation = currentOperation;
+        }
+    }
+    
+    void Complete() override {
+        lastPercentage = -1;
+    }
+    
+private:
+    Stellar::Recovery::JobEventWriter& events;
+    std::string job;
+    int lastPercentage = -1;
+    std::string lastOperation;
+};
+
 /**
  * Drive scanner class for detecting storage devices
  */
@@ -114,76 +145,67 @@ public:
     std::vector<DriveInfo> ScanAvailableDrives() {
         std::vector<DriveInfo> drives;
         
-        DWORD drivesMask = GetLogicalDrives();
+        for (const auto& drive : Stellar::Recovery::EnumerateDrives()) {
+            DriveInfo info;
+            info.driveLetter = drive.driveLetter;
+            info.label = drive.volumeLabel;
+            info.fileSystem = Stellar::Recovery::Utils::GetFileSystemString(drive.fileSystem);
+            info.type = ToDriveType(drive.deviceType);
+            info.totalSize = drive.totalCapacity;
+            info.freeSpace = drive.freeSpace;
+            info.isAccessible = drive.isAccessible;
+            drives.push_back(info);
+        }
         
-        for (char drive = 'A'; drive <= 'Z'; drive++) {
-            if (drivesMask & (1 << (drive - 'A'))) {
-                DriveInfo info;
-                info.driveLetter = std::string(1, drive) + ":";
-                
-                // Get drive type
-                std::string rootPath = info.driveLetter + "\\";
-                UINT driveType = GetDriveTypeA(rootPath.c_str());
-                
-                switch (driveType) {
-                    case DRIVE_FIXED:
-                        info.type = DriveType::HDD;
-                        break;
-                    case DRIVE_REMOVABLE:
-                        info.type = DriveType::USB;
-                        break;
-                    case DRIVE_CDROM:
-                        info.type = DriveType::CD_DVD;
-                        break;
-                    case DRIVE_REMOTE:
-                        info.type = DriveType::NETWORK;
-                        break;
-                    default:
-                        continue; // Skip unknown drives
-                }
-                
-                // Get volume information
-                char volumeName[MAX_PATH];
-                char fileSystemName[MAX_PATH];
-                DWORD serialNumber, maxComponentLen, fileSystemFlags;
-                
-                if (GetVolumeInformationA(rootPath.c_str(), volumeName, MAX_PATH,
-                                        &serialNumber, &maxComponentLen, &fileSystemFlags,
-                                        fileSystemName, MAX_PATH)) {
-                    info.label = volumeName;
-                    info.fileSystem = fileSystemName;
-                    info.isAccessible = true;
-                } else {
-                    info.label = "Unknown";
-                    info.fileSystem = "Unknown";
-                    info.isAccessible = false;
-                }
-                
-                // Get disk space
-                ULARGE_INTEGER freeBytesAvailable, totalNumberOfBytes;
-                if (GetDiskFreeSpaceExA(rootPath.c_str(), &freeBytesAvailable, 
-                                      &totalNumberOfBytes, nullptr)) {
-                    info.totalSize = totalNumberOfBytes.QuadPart;
-                    info.freeSpace = freeBytesAvailable.QuadPart;
-                } else {
-                    info.totalSize = 0;
-                    info.freeSpace = 0;
-                }
-                
-                drives.push_back(info);
+        // Disk images are listed after the physical drives
+        for (const auto& image : diskImages) {
+            DriveInfo info;
+            info.driveLetter = image;
+            info.label = std::filesystem::u8path(image).filename().u8string();
+            info.fileSystem = "Unknown";
+            info.type = DriveType::IMAGE;
+            info.totalSize = 0;
+            info.freeSpace = 0;
+            info.isAccessible = false;
+            try {
+                // Only the boot sectors are read; do not fault in the whole image
+                Stellar::Recovery::MappedSourceOptions mapped;
+                mapped.populate = false;
+                auto source = Stellar::Recovery::OpenSectorSource(image, Stellar::Recovery::SourceOptions(), mapped);
+                info.totalSize = source->Size();
+                info.fileSystem = Stellar::Recovery::Utils::GetFileSystemString(
+                    Stellar::Recovery::DetectFileSystem(*source));
+                info.isAccessible = true;
+            } catch (const Stellar::Recovery::SectorReadError&) {
             }
+            drives.push_back(info);
         }
         
         return drives;
     }
     
+    /**
+     * Register a disk image (.dd/.img/.raw) to be offered as a drive.
+     * Returns false if the path is not a regular file.
+     */
+    bool AddDiskImage(const std::string& path) {
+        if (!Stellar::Recovery::IsImageFile(path)) {
+            return false;
+        }
+        if (std::find(diskImages.begin(), diskImages.end(), path) == diskImages.end()) {
+            diskImages.push_back(path);
+        }
+        return true;
+    }
+    
     void DisplayDrives(const std::vector<DriveInfo>& drives) {
         std::cout << "\nAvailable Drives:" << std::endl;
         std::cout << "===================" << std::endl;
         
         for (size_t i = 0; i < drives.size(); i++) {
             const auto& drive = drives[i];
-            std::cout << "[" << i + 1 << "] Drive " << drive.driveLetter;
+            std::cout << "[" << i + 1 << "] " << (drive.type == DriveType::IMAGE ? "Image " : "Drive ")
+                     << drive.driveLetter;
             
             if (!drive.label.empty() && drive.label != "Unknown") {
                 std::cout << " (" << drive.label << ")";
@@ -207,6 +229,20 @@ public:
     }
     
 private:
+    DriveType ToDriveType(Stellar::Recovery::DeviceType type) {
+        switch (type) {
+            case Stellar::Recovery::DeviceType::HDD: return DriveType::HDD;
+            case Stellar::Recovery::DeviceType::SSD: return DriveType::SSD;
+            case Stellar::Recovery::DeviceType::USB: return DriveType::USB;
+            case Stellar::Recovery::DeviceType::SD_CARD:
+            case Stellar::Recovery::DeviceType::CF_CARD: return DriveType::SD_CARD;
+            case Stellar::Recovery::DeviceType::CD_DVD: return DriveType::CD_DVD;
+            case Stellar::Recovery::DeviceType::RAID: return DriveType::RAID;
+            case Stellar::Recovery::DeviceType::NETWORK: return DriveType::NETWORK;
+            default: return DriveType::VIRTUAL;
+        }
+    }
+    
     std::string GetDriveTypeString(DriveType type) {
         switch (type) {
             case DriveType::HDD: return "HDD/SSD";
@@ -216,95 +252,845 @@ private:
             case DriveType::CD_DVD: return "CD/DVD";
             case DriveType::RAID: return "RAID";
             case DriveType::NETWORK: return "Network";
+            case DriveType::VIRTUAL: return "Virtual";
+            case DriveType::IMAGE: return "Disk Image";
             default: return "Unknown";
         }
     }
+    
+    std::vector<std::string> diskImages;
+};
+
 /**
  * File recovery engine with advanced scanning capabilities
  */
 class FileRecovery {
 public:
-    FileRecovery() : progressTracker(std::make_unique<ProgressTracker>()) {}
+    FileRecovery() :
+        progressTracker(std::make_unique<ProgressTracker>()),
+        sessionDirectory(Stellar::Recovery::DefaultSessionDirectory()) {}
+    
+    /**
+     * Set the streaming read size (clamped to 1-64 MiB; 0 = by device)
+     */
+    void SetReadChunkSize(size_t bytes) {
+        readChunkSize = bytes ? Stellar::Recovery::NormalizeChunkSize(bytes) : 0;
+    }
+    
+    /**
+     * Reads kept in flight by the streaming reader (the io_uring queue
+     * depth; 0 = by device). Pair deep queues with a small chunk size on NVMe.
+     */
+    void SetQueueDepth(size_t depth) {
+        queueDepth = depth;
+    }
+    
+    /**
+     * Limit deep/raw scan threads (0 = one per logical processor)
+     */
+    void SetScanWorkers(size_t workers) {
+        scanOptions.workers = workers;
+    }
+    
+    /**
+     * Bytes of file data the recovery stages may hold at once
+     */
+    void SetRecoveryMemoryBudget(size_t bytes) {
+        recoveryOptions.memoryBudget = bytes;
+    }
+    
+    /**
+     * Image drives into directory before a deep scan (empty = scan the drive directly)
+     */
+    void SetImagingDirectory(const std::string& directory) {
+        imagingDirectory = directory;
+    }
+    
+    /**
+     * Send messages to other streams than the console (headless jobs)
+     */
+    void SetConsole(std::ostream& out, std::ostream& err) {
+        console = &out;
+        errors = &err;
+    }
+    
+    void SetProgressTracker(std::unique_ptr<ProgressTracker> tracker) {
+        progressTracker = std::move(tracker);
+    }
+    
+    /**
+     * Where the metrics sampled during scans and recoveries are written
+     * (default: nowhere; progress still reaches the tracker)
+     */
+    void SetMetricsOutput(const Stellar::Recovery::MetricsReporterOptions& options) {
+        metricsOptions = options;
+    }
+    
+    /**
+     * Charge every read of the scanned drive to a budget shared with other jobs
+     */
+    void SetIoBudget(Stellar::Recovery::IoBudget* budget) {
+        ioBudget = budget;
+    }
+    
+    /**
+     * Recover only these types (empty = everything the scan found)
+     */
+    void SetTypeFilter(const std::vector<Stellar::Recovery::TargetFileType>& types) {
+        typeFilter = types;
+    }
+    
+    /**
+     * Why the last scan or recovery stopped early or left files behind;
+     * empty when it did not
+     */
+    const std::string& LastError() const {
+        return lastError;
+    }
     
-    std::vector<RecoveryResult> ScanForFiles(const std::string& drivePath, 
-                                           RecoveryMode mode, 
-                                           FileType fileType) {
-        std::vector<RecoveryResult> results;
+    Stellar::Recovery::ResultStore ScanForFiles(const std::string& drivePath, 
+                                              RecoveryMode mode, 
+                                              FileType fileType) {
+        Stellar::Recovery::ResultStore results;
+        const auto started = std::chrono::system_clock::now();
+        std::string sessionId = Stellar::Recovery::Utils::GenerateSessionId();
+        std::unique_ptr<Stellar::Recovery::ScanCheckpoint> checkpoint;
+        std::unique_ptr<ProgressReport> report;
+        const auto metricsBefore = Stellar::Recovery::MetricsRegistry::Global().Snapshot();
+        lastError.clear();
         
-        std::cout << "\nStarting " << GetRecoveryModeString(mode) 
+        *console << "\nStarting " << GetRecoveryModeString(mode) 
                  << " for " << GetFileTypeString(fileType) 
                  << " on drive " << drivePath << std::endl;
         
-        // Simulate scanning process
-        for (int i = 0; i <= 100; i += 5) {
-            progressTracker->UpdateProgress(i, "Scanning sectors...");
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        try {
+            // Failing drives are imaged first; the scan then reads only the image
+            if (mode == RecoveryMode::DEEP_SCAN && !imagingDirectory.empty() &&
+                !Stellar::Recovery::IsImageFile(GetSourcePath(drivePath))) {
+                ImageDrive(drivePath);
+            }
+            report = std::make_unique<ProgressReport>(*this);
+            
+            // Disk images are mapped and scanned in place; only carving reads them whole
+            const bool carving = mode == RecoveryMode::DEEP_SCAN || mode == RecoveryMode::RAW_RECOVERY;
+            auto sourceHandle = OpenSource(GetScanSourcePath(drivePath), carving);
+            Stellar::Recovery::SectorSource& source = *sourceHandle;
+            
+            // Quick scans read only file system metadata when the volume is supported
+            if (mode == RecoveryMode::QUICK_SCAN &&
+                ScanFileSystem(source, drivePath, fileType, results, report->Callback())) {
+                report->Finish();
+                *console << "Scan completed. Found " << results.Count() << " recoverable files." << std::endl;
+                SaveSession(sessionId, drivePath, mode, fileType, started, results, "");
+                return results;
+            }
+            
+            // Partition recovery reads the volumes it finds; with none, carve the whole disk
+            if (mode == RecoveryMode::PARTITION_RECOVERY &&
+                ScanPartitions(source, drivePath, fileType, results, report->Callback())) {
+                report->Finish();
+                *console << "Scan completed. Found " << results.Count() << " recoverable files." << std::endl;
+                SaveSession(sessionId, drivePath, mode, fileType, started, results, "");
+                return results;
+            }
+            
+            // Raw recovery also finds files that do not start on a sector boundary
+            Stellar::Recovery::CarverOptions carverOptions;
+            carverOptions.sectorSize = source.SectorSize();
+            carverOptions.sectorAligned = mode != RecoveryMode::RAW_RECOVERY;
+            carverOptions.matchFooters = mode != RecoveryMode::QUICK_SCAN;
+            Stellar::Recovery::SignatureCarver carver(ToTargetFileType(fileType), carverOptions);
+            
+            // Deep and raw scans are CPU bound; spread extents over all cores
+            Stellar::Recovery::ParallelScanner scanner(source, carver, scanOptions);
+            const bool parallel = mode != RecoveryMode::QUICK_SCAN;
+            
+            // An interrupted scan of the same source with the same settings resumes
+            Stellar::Recovery::CheckpointKey key;
+            key.sessionId = sessionId;
+            key.sourcePath = source.Path();
+            key.sourceSize = source.Size();
+            key.startOffset = parallel ? scanOptions.startOffset : readerOptions.startOffset;
+            key.endOffset = parallel ? scanOptions.endOffset : readerOptions.endOffset;
+            key.extentSize = parallel ? scanner.ExtentSize() : 0;
+            key.scanMode = static_cast<uint32_t>(ToScanMode(mode));
+            key.targetType = static_cast<uint32_t>(ToTargetFileType(fileType));
+            key.configuration = (carverOptions.sectorAligned ? 1u : 0u) | (carverOptions.matchFooters ? 2u : 0u) |
+                                (carverOptions.sectorSize << 8);
+            Stellar::Recovery::CheckpointKey found;
+            if (Stellar::Recovery::FindCheckpoint(sessionDirectory, key, found)) {
+                sessionId = key.sessionId = found.sessionId;
+            }
+            checkpoint = std::make_unique<Stellar::Recovery::ScanCheckpoint>(
+                Stellar::Recovery::CheckpointPath(sessionDirectory, sessionId), key);
+            if (checkpoint->Resumed()) {
+                *console << "Resuming interrupted session " << sessionId << std::endl;
+            }
+            
+            std::vector<Stellar::Recovery::CarveHit> hits;
+            if (parallel) {
+                hits = scanner.Run(report->Callback(), checkpoint.get());
+            } else {
+                hits = StreamCarve(source, carver, *checkpoint, report->Callback());
+            }
+            const uint64_t rangeEnd = source.Size();
+            
+            // The file ends at its last own footer before the next header
+            std::vector<Stellar::Recovery::CarveTarget> targets;
+            for (size_t i = 0; i < hits.size(); i++) {
+                const auto& hit = hits[i];
+                if (hit.isFooter) {
+                    continue;
+                }
+                size_t next = i + 1;
+                uint64_t end = 0;
+                for (; next < hits.size() && hits[next].isFooter; next++) {
+                    if (hits[next].signature == hit.signature) {
+                        end = hits[next].offset;
+                    }
+                }
+                if (end == 0) {
+                    end = next < hits.size() ? hits[next].offset : rangeEnd;
+                }
+                targets.push_back(Stellar::Recovery::CarveTarget{
+                    hit.offset, std::min<uint64_t>(end - hit.offset, hit.signature->maxSize), hit.signature});
+            }
+            
+            // Validated formats get their exact size and are followed across a fragment gap
+            Stellar::Recovery::FragmentCarverOptions fragmentOptions;
+            fragmentOptions.blockSize = source.SectorSize();
+            fragmentOptions.workers = scanOptions.workers;
+            Stellar::Recovery::FragmentCarver fragmentCarver(source, fragmentOptions);
+            const auto carved = fragmentCarver.Carve(targets, report->Callback());
+            
+            const auto now = std::chrono::system_clock::now();
+            results.Reserve(targets.size(), targets.size() * 24);
+            std::string fileName;
+            std::string originalPath;
             
-            // Simulate finding files
-            if (i % 20 == 0 && i > 0) {
-                RecoveryResult result;
-                result.fileName = "recovered_file_" + std::to_string(i / 20) + GetFileExtension(fileType);
-                result.originalPath = drivePath + "\\" + result.fileName;
-                result.fileSize = 1024 * (i / 20 + 1);
-                result.confidence = 0.85 + (i / 200.0);
-                result.isRecovered = false;
-                result.dateModified = std::chrono::system_clock::now();
-                results.push_back(result);
+            for (size_t i = 0; i < targets.size(); i++) {
+                const auto& target = targets[i];
+                fileName = "recovered_file_" + std::to_string(results.Count() + 1) + target.signature->extension;
+                originalPath = drivePath + "\\" + fileName;
+                
+                Stellar::Recovery::ResultRecord record;
+                record.fileName = fileName;
+                record.originalPath = originalPath;
+                record.sourceOffset = target.offset;
+                record.fileSize = carved[i].size;
+                record.fileType = target.signature->type;
+                record.confidence = carved[i].confidence;
+                record.dateModified = now;
+                record.extents = carved[i].extents.data();
+                record.extentCount = carved[i].extents.size();
+                results.Add(record);
+            }
+            Stellar::Recovery::MetricsRegistry::Global().Add(Stellar::Recovery::Counter::FILES_FOUND, targets.size());
+        } catch (const Stellar::Recovery::SectorReadError& e) {
+            if (report) {
+                report->Finish();
+            }
+            *errors << "Scan aborted: " << e.what() << std::endl;
+            lastError = e.what();
+            if (checkpoint) {
+                *errors << "Progress kept; scan the drive again with the same settings to resume." << std::endl;
             }
+            SaveSession(sessionId, drivePath, mode, fileType, started, results, e.what());
+            return results;
+        } catch (const Stellar::Recovery::ScanCheckpointError& e) {
+            // The drive is fine; the session folder is not writable or full
+            if (report) {
+                report->Finish();
+            }
+            *errors << "Scan aborted: " << e.what() << std::endl;
+            *errors << "Check free space and permissions in " << sessionDirectory << " before scanning again." << std::endl;
+            lastError = e.what();
+            SaveSession(sessionId, drivePath, mode, fileType, started, results, e.what());
+            return results;
         }
         
-        progressTracker->Complete();
+        report->Finish();
         
-        std::cout << "Scan completed. Found " << results.size() << " recoverable files." << std::endl;
+        *console << "Scan completed. Found " << results.Count() << " recoverable files." << std::endl;
+        PrintScanMetrics(metricsBefore);
+        SaveSession(sessionId, drivePath, mode, fileType, started, results, "");
+        if (checkpoint) {
+            checkpoint->Discard();
+        }
         return results;
     }
     
-    bool RecoverFiles(std::vector<RecoveryResult>& files, const std::string& outputPath) {
-        std::cout << "\nStarting file recovery to: " << outputPath << std::endl;
+    /**
+     * Sessions saved by earlier scans, newest first
+     */
+    std::vector<Stellar::Recovery::RecoverySession> ListSavedSessions() {
+        return Stellar::Recovery::ListSessions(sessionDirectory);
+    }
+    
+    /**
+     * Reload the results of a saved session without rescanning
+     */
+    Stellar::Recovery::ResultStore LoadSession(const std::string& sessionId) {
+        const std::string path = Stellar::Recovery::SessionIndexPath(sessionDirectory, sessionId);
+        try {
+            // Columns stay in the mapping until recovery changes a row
+            return Stellar::Recovery::LoadResultStore(path, &currentSession);
+        } catch (const Stellar::Recovery::ResultIndexError& e) {
+            *errors << "Cannot open session " << sessionId << ": " << e.what() << std::endl;
+        }
+        return Stellar::Recovery::ResultStore();
+    }
+    
+    /**
+     * Copy the pending files of a result set from drivePath to outputPath.
+     * Reading, checking and writing run as separate stages; content that
+     * appears more than once is written once.
+     */
+    bool RecoverFiles(Stellar::Recovery::ResultStore& files, const std::string& drivePath,
+                      const std::string& outputPath) {
+        *console << "\nStarting file recovery to: " << outputPath << std::endl;
+        
+        // Files already recovered by an earlier run are not written again
+        Stellar::Recovery::ResultFilter pending;
+        pending.pendingOnly = true;
+        Stellar::Recovery::ResultSelection rows = files.Select(pending);
+        if (!typeFilter.empty()) {
+            rows.erase(std::remove_if(rows.begin(), rows.end(), [&](uint32_t row) {
+                return std::find(typeFilter.begin(), typeFilter.end(), files.Type(row)) == typeFilter.end();
+            }), rows.end());
+        }
+        lastError.clear();
         
-        int recovered = 0;
-        for (size_t i = 0; i < files.size(); i++) {
-            int progress = static_cast<int>((i * 100) / files.size());
-            progressTracker->UpdateProgress(progress, "Recovering: " + files[i].fileName);
+        Stellar::Recovery::RecoveryPipelineStats stats;
+        Stellar::Recovery::DedupStats dedupStats;
+        uint64_t linked = 0;
+        ProgressReport report(*this);
+        try {
+            const std::string sourcePath = GetScanSourcePath(drivePath);
+            auto sourceHandle = OpenSource(sourcePath, false);
+            
+            std::vector<Stellar::Recovery::RecoveryItem> items;
+            items.reserve(rows.size());
+            files.ForEach(rows, [&](size_t row) {
+                Stellar::Recovery::RecoveryItem item;
+                item.fileName = std::string(files.Name(row));
+                item.fileSize = files.Size(row);
+                auto extents = files.Extents(row);
+                auto inlineData = files.InlineData(row);
+                item.extents.assign(extents.first, extents.first + extents.second);
+                item.inlineData.assign(inlineData.first, inlineData.first + inlineData.second);
+                // Carved files are one run from their header
+                if (item.extents.empty() && item.inlineData.empty()) {
+                    item.extents.push_back(Stellar::Recovery::FileExtent{files.Offset(row), files.Size(row)});
+                }
+                item.tag = row;
+                items.push_back(std::move(item));
+            });
+            
+            // Copies found more than once, or recovered by an earlier session, are written once.
+            // Concurrent jobs share the journal: loading trims a torn tail, so it must not
+            // run while another job is appending
+            static std::mutex dedupMutex;
+            Stellar::Recovery::DedupIndex dedupIndex = [this]() {
+                std::lock_guard<std::mutex> dedupLock(dedupMutex);
+                return Stellar::Recovery::DedupIndex(Stellar::Recovery::DedupIndexPath(sessionDirectory));
+            }();
+            Stellar::Recovery::DedupOptions dedupOptions;
+            dedupOptions.workers = scanOptions.workers;
+            Stellar::Recovery::DuplicateFinder finder(*sourceHandle, dedupIndex, dedupOptions);
+            const std::vector<Stellar::Recovery::DuplicateMatch> matches = finder.Find(items, report.Callback());
+            dedupStats = finder.Stats();
+            
+            // Spinning disks are read by one reader sweeping a merged plan
+            Stellar::Recovery::RecoveryPipelineOptions options = recoveryOptions;
+            options.elevatorReads = sourceHandle->IncursSeekPenalty();
+            if (options.elevatorReads) {
+                *console << "Rotational drive detected, reading in disk order." << std::endl;
+            }
+            // Image files let the kernel move extents without a round trip through memory;
+            // those bytes never pass through the source, so a read budget rules it out
+            options.directCopy = !(ioBudget && ioBudget->Limited());
+            // Every recovered file gets a chain-of-custody digest in the same pass
+            options.checksum = Stellar::Recovery::HashAlgorithm::SHA256;
+            // Files touching sectors the imager could not read are reported as partial
+            Stellar::Recovery::RescueMap rescueMap(sourceHandle->Size());
+            if (sourcePath != GetSourcePath(drivePath) &&
+                rescueMap.Load(Stellar::Recovery::ImageMapPath(sourcePath))) {
+                options.rescueMap = &rescueMap;
+            }
+            Stellar::Recovery::RecoveryPipeline pipeline(*sourceHandle, options);
+            for (size_t i = 0; i < items.size(); i++) {
+                if (!matches[i].IsDuplicate()) {
+                    pipeline.Add(items[i]);
+                }
+            }
             
-            // Simulate recovery process
-            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            std::map<uint64_t, Stellar::Recovery::RecoveryOutcome> written;
+            Stellar::Recovery::MetricsRegistry& metrics = Stellar::Recovery::MetricsRegistry::Global();
+            stats = pipeline.Run(outputPath, report.Callback(),
+                                 [&files, &written, &metrics](const Stellar::Recovery::RecoveryOutcome& outcome) {
+                if (!outcome.path.empty()) {
+                    metrics.Add(Stellar::Recovery::Counter::FILES_RECOVERED);
+                    metrics.Add(Stellar::Recovery::Counter::BYTES_WRITTEN, files.Size(static_cast<size_t>(outcome.tag)));
+                    files.MarkRecovered(static_cast<size_t>(outcome.tag), outcome.path);
+                    files.SetChecksum(static_cast<size_t>(outcome.tag), outcome.checksum);
+                    written[outcome.tag] = outcome;
+                }
+            });
             
-            // Simulate success/failure based on confidence
-            if (files[i].confidence > 0.7) {
-                files[i].isRecovered = true;
-                files[i].recoveryPath = outputPath + "\\" + files[i].fileName;
-                recovered++;
+            // Duplicates point at the copy that was kept
+            for (size_t i = 0; i < items.size(); i++) {
+                const Stellar::Recovery::DuplicateMatch& match = matches[i];
+                const size_t row = static_cast<size_t>(items[i].tag);
+                if (!match.existingPath.empty()) {
+                    files.MarkRecovered(row, match.existingPath);
+                    files.SetChecksum(row, match.digest);
+                    linked++;
+                } else if (match.original != Stellar::Recovery::DuplicateMatch::NONE) {
+                    auto original = written.find(items[match.original].tag);
+                    if (original != written.end()) {
+                        files.MarkRecovered(row, original->second.path);
+                        files.SetChecksum(row, original->second.checksum);
+                        linked++;
+                    }
+                }
+            }
+            for (const auto& entry : written) {
+                const Stellar::Recovery::RecoveryOutcome& outcome = entry.second;
+                if (outcome.status == Stellar::Recovery::RecoveryStatus::COMPLETED && !outcome.checksum.empty()) {
+                    dedupIndex.Add(files.Size(static_cast<size_t>(outcome.tag)), outcome.checksum,
+                                   std::filesystem::absolute(std::filesystem::u8path(outcome.path)).u8string());
+                }
             }
+            std::lock_guard<std::mutex> dedupLock(dedupMutex);
+            if (!dedupIndex.Save()) {
+                *errors << "Warning: cannot update " << dedupIndex.Path() << std::endl;
+            }
+        } catch (const Stellar::Recovery::SectorReadError& e) {
+            report.Finish();
+            *errors << "Recovery aborted: " << e.what() << std::endl;
+            lastError = e.what();
+            return false;
         }
         
-        progressTracker->Complete();
+        report.Finish();
         
-        std::cout << "Recovery completed. Successfully recovered " 
-                 << recovered << " out of " << files.size() << " files." << std::endl;
+        // Recovered flags, output paths and checksums go back into the session
+        if (currentSession.sourceDrive == drivePath && currentSession.totalFilesFound == files.Count()) {
+            WriteSession(currentSession, files);
+        }
+        
+        const uint64_t recovered = stats.completed + stats.partial + linked;
+        *console << "Recovery completed. Successfully recovered " 
+                 << recovered << " out of " << rows.size() << " files." << std::endl;
+        if (stats.failed > 0) {
+            lastError = std::to_string(stats.failed) + " files not written";
+        }
+        if (stats.partial + stats.skipped + stats.failed > 0) {
+            *console << stats.partial << " with unreadable sectors, " << stats.skipped
+                     << " overwritten, " << stats.failed << " not written." << std::endl;
+        }
+        if (linked > 0) {
+            *console << linked << " duplicates linked to an existing copy, "
+                     << FormatFileSize(dedupStats.bytesSaved) << " not written." << std::endl;
+        }
+        *console << FormatFileSize(stats.bytesWritten) << " written at "
+                 << FormatFileSize(static_cast<uint64_t>(stats.BytesPerSecond())) << "/s" << std::endl;
+        if (stats.bytesCloned + stats.bytesKernelCopied > 0) {
+            *console << FormatFileSize(stats.bytesCloned) << " cloned, "
+                     << FormatFileSize(stats.bytesKernelCopied) << " copied in kernel, "
+                     << FormatFileSize(stats.BytesBuffered()) << " buffered" << std::endl;
+        }
+        const auto hashKernel = Stellar::Recovery::FileHasher::SelectKernel(Stellar::Recovery::HashAlgorithm::SHA256);
+        *console << "SHA-256 checksums recorded (" << Stellar::Recovery::HashKernelName(hashKernel) << ")";
+        if (stats.bytesRehashed > 0) {
+            *console << ", " << FormatFileSize(stats.bytesRehashed) << " read back for out-of-order segments";
+        }
+        *console << std::endl;
         
         return recovered > 0;
     }
     
-    void PreviewFile(const RecoveryResult& file) {
-        std::cout << "\nFile Preview:" << std::endl;
-        std::cout << "================" << std::endl;
-        std::cout << "Name: " << file.fileName << std::endl;
-        std::cout << "Size: " << FormatFileSize(file.fileSize) << std::endl;
-        std::cout << "Confidence: " << std::fixed << std::setprecision(1) 
-                 << (file.confidence * 100) << "%" << std::endl;
-        std::cout << "Original Path: " << file.originalPath << std::endl;
-        
-        if (file.isRecovered) {
-            std::cout << "Recovery Path: " << file.recoveryPath << std::endl;
-            std::cout << "Status: RECOVERED" << std::endl;
+    void PreviewFile(const Stellar::Recovery::ResultStore& files, size_t row) {
+        *console << "\nFile Preview:" << std::endl;
+        *console << "================" << std::endl;
+        *console << "Name: " << files.Name(row) << std::endl;
+        *console << "Size: " << FormatFileSize(files.Size(row)) << std::endl;
+        *console << "Confidence: " << std::fixed << std::setprecision(1) 
+                 << (files.Confidence(row) * 100) << "%" << std::endl;
+        *console << "Original Path: " << files.Path(row) << std::endl;
+        
+        if (files.IsRecovered(row)) {
+            std::string recoveryPath = files.RecoveryPath(row);
+            *console << "Recovery Path: " << (recoveryPath.empty() ? "(earlier session)" : recoveryPath) << std::endl;
+            if (!files.Checksum(row).empty()) {
+                *console << "SHA-256: " << files.Checksum(row) << std::endl;
+            }
+            *console << "Status: RECOVERED" << std::endl;
         } else {
-            std::cout << "Status: PENDING RECOVERY" << std::endl;
+            *console << "Status: PENDING RECOVERY" << std::endl;
         }
     }
     
 private:
+    /**
+     * Progress of one imaging, scan or recovery run. The callback only
+     * stores into a gauge; the reporter thread passes it on to the tracker
+     * at a fixed rate and writes the metrics. Finish ends the tracker line.
+     */
+    class ProgressReport {
+    public:
+        explicit ProgressReport(FileRecovery& owner) :
+            owner(owner),
+            reporter(Stellar::Recovery::MetricsRegistry::Global(), owner.metricsOptions, &gauge,
+                     [&owner](int percentage, const std::string& operation) {
+                         owner.progressTracker->UpdateProgress(percentage, operation);
+                     }),
+            callback(gauge.Sink()) {}
+        
+        ~ProgressReport() {
+            Finish();
+        }
+        
+        const Stellar::Recovery::ProgressCallback& Callback() const {
+            return callback;
+        }
+        
+        void Finish() {
+            if (!finished) {
+                reporter.Stop();
+                owner.progressTracker->Complete();
+                finished = true;
+            }
+        }
+        
+    private:
+        FileRecovery& owner;
+        Stellar::Recovery::ProgressGauge gauge;
+        Stellar::Recovery::MetricsReporter reporter;
+        Stellar::Recovery::ProgressCallback callback;
+        bool finished = false;
+    };
+    
     std::unique_ptr<ProgressTracker> progressTracker;
+    Stellar::Recovery::MetricsReporterOptions metricsOptions;
+    Stellar::Recovery::ReaderOptions readerOptions;
+    size_t queueDepth = 0;                  // 0 = DeviceReaderOptions
+    size_t readChunkSize = 0;
+    Stellar::Recovery::ParallelScanOptions scanOptions;
+    Stellar::Recovery::RecoveryPipelineOptions recoveryOptions;
+    std::string sessionDirectory;
+    Stellar::Recovery::RecoverySession currentSession;     // Last saved or loaded; recovery re-saves it
+    std::string imagingDirectory;
+    std::ostream* console = &std::cout;
+    std::ostream* errors = &std::cerr;
+    Stellar::Recovery::IoBudget* ioBudget = nullptr;
+    std::vector<Stellar::Recovery::TargetFileType> typeFilter;
+    std::string lastError;
+    
+    /**
+     * Open a drive or image for reading, charged to the I/O budget if one is set.
+     * Images are prefaulted only when the caller reads them end to end.
+     */
+    std::unique_ptr<Stellar::Recovery::SectorSource> OpenSource(const std::string& path, bool prefault) {
+        Stellar::Recovery::MappedSourceOptions mapped;
+        mapped.populate = prefault;
+        return Budgeted(Stellar::Recovery::OpenSectorSource(path, Stellar::Recovery::SourceOptions(), mapped));
+    }
+    
+    std::unique_ptr<Stellar::Recovery::SectorSource> Budgeted(std::unique_ptr<Stellar::Recovery::SectorSource> source) {
+        if (ioBudget) {
+            return std::make_unique<Stellar::Recovery::BudgetedSource>(std::move(source), *ioBudget);
+        }
+        return source;
+    }
+    
+    /**
+     * Copy a drive into its image, resuming an earlier run. Unreadable
+     * sectors stay zero in the image and are listed in its map file.
+     */
+    void ImageDrive(const std::string& drivePath) {
+        const std::string imagePath = GetImagePath(drivePath);
+        std::error_code error;
+        std::filesystem::create_directories(imagingDirectory, error);
+        if (error) {
+            throw Stellar::Recovery::SectorReadError("Cannot create imaging directory " + imagingDirectory +
+                                                     ": " + error.message());
+        }
+        
+        auto drive = Budgeted(std::make_unique<Stellar::Recovery::FileSectorSource>(GetSourcePath(drivePath)));
+        Stellar::Recovery::DiskImager imager(*drive, imagePath, Stellar::Recovery::ImageMapPath(imagePath));
+        *console << (imager.Resumed() ? "Resuming image of " : "Imaging ") << drivePath
+                 << " to " << imagePath << std::endl;
+        ProgressReport report(*this);
+        const bool complete = imager.Run(report.Callback());
+        report.Finish();
+        
+        const auto stats = imager.Stats();
+        *console << FormatFileSize(stats.bytesRescued) << " rescued, " << FormatFileSize(stats.bytesBad)
+                 << " unreadable, " << stats.readErrors << " read errors in "
+                 << std::fixed << std::setprecision(0) << stats.elapsedSeconds << " s" << std::endl;
+        if (!complete) {
+            *console << "Unreadable areas are zero-filled in the image; see "
+                     << Stellar::Recovery::ImageMapPath(imagePath) << std::endl;
+        }
+    }
+    
+    /**
+     * Image file for a drive inside the imaging directory
+     */
+    std::string GetImagePath(const std::string& drivePath) {
+        std::string name;
+        for (char c : drivePath) {
+            name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+        }
+        return (std::filesystem::path(imagingDirectory) / (name + ".img")).string();
+    }
+    
+    /**
+     * Where a drive's data is read from: its image once one has been
+     * taken, the drive itself otherwise
+     */
+    std::string GetScanSourcePath(const std::string& drivePath) {
+        if (!imagingDirectory.empty()) {
+            const std::string imagePath = GetImagePath(drivePath);
+            std::error_code error;
+            if (std::filesystem::exists(Stellar::Recovery::ImageMapPath(imagePath), error) &&
+                std::filesystem::exists(imagePath, error)) {
+                return imagePath;
+            }
+        }
+        return GetSourcePath(drivePath);
+    }
+    
+    /**
+     * Persist scan results as a session index so they can be reopened
+     */
+    void SaveSession(const std::string& sessionId, const std::string& drivePath, RecoveryMode mode,
+                     FileType fileType, std::chrono::system_clock::time_point started,
+                     const Stellar::Recovery::ResultStore& results, const std::string& error) {
+        Stellar::Recovery::RecoverySession session;
+        session.sessionId = sessionId;
+        session.sourceDrive = drivePath;
+        session.scanMode = ToScanMode(mode);
+        session.targetType = ToTargetFileType(fileType);
+        session.startTime = started;
+        session.endTime = std::chrono::system_clock::now();
+        session.totalFilesFound = static_cast<uint32_t>(results.Count());
+        session.isComplete = error.empty();
+        session.lastError = error;
+        currentSession = session;
+        WriteSession(session, results);
+    }
+    
+    void WriteSession(const Stellar::Recovery::RecoverySession& session,
+                      const Stellar::Recovery::ResultStore& results) {
+        try {
+            Stellar::Recovery::ResultIndexWriter writer(session, results);
+            writer.Write(Stellar::Recovery::SessionIndexPath(sessionDirectory, session.sessionId));
+            *console << "Session saved as " << session.sessionId << std::endl;
+        } catch (const Stellar::Recovery::ResultIndexError& e) {
+            *errors << "Could not save session: " << e.what() << std::endl;
+        }
+    }
+    
+    /**
+     * What the scan cost, from the metrics counted since it started
+     */
+    void PrintScanMetrics(const Stellar::Recovery::MetricsSnapshot& before) {
+        using Stellar::Recovery::Counter;
+        const auto after = Stellar::Recovery::MetricsRegistry::Global().Snapshot();
+        auto delta = [&](Counter counter) { return after.Get(counter) - before.Get(counter); };
+        *console << FormatFileSize(delta(Counter::BYTES_READ)) << " read, "
+                 << delta(Counter::SECTORS_SCANNED) << " sectors scanned, "
+                 << delta(Counter::SIGNATURE_HITS) << " signature hits, "
+                 << delta(Counter::READ_ERRORS) << " read errors" << std::endl;
+    }
+    
+    /**
+     * Rebuild the partition layout, then collect deleted files from every
+     * volume in it. Returns false when no volume could be read.
+     */
+    bool ScanPartitions(Stellar::Recovery::SectorSource& source, const std::string& drivePath,
+                        FileType fileType, Stellar::Recovery::ResultStore& results,
+                        const Stellar::Recovery::ProgressCallback& progress) {
+        Stellar::Recovery::PartitionSearchOptions options;
+        options.sectorSize = source.SectorSize();
+        options.workers = scanOptions.workers;
+        Stellar::Recovery::PartitionRecovery search(source, options);
+        const auto scan = search.Scan(progress);
+        
+        const char* scheme = scan.scheme == Stellar::Recovery::PartitionScheme::GPT ? "GPT"
+                           : scan.scheme == Stellar::Recovery::PartitionScheme::MBR ? "MBR" : "none";
+        *console << "\nPartition table: " << scheme << (scan.tableDamaged ? " (damaged)" : "")
+                 << ", " << scan.probes << " probes, " << FormatFileSize(scan.bytesRead) << " read" << std::endl;
+        
+        bool scanned = false;
+        for (size_t i = 0; i < scan.layout.size(); i++) {
+            const auto& partition = scan.layout[i];
+            *console << "  #" << (i + 1) << "  " << std::setw(10) << FormatFileSize(partition.offset)
+                     << "  " << std::setw(10) << FormatFileSize(partition.size)
+                     << "  " << std::setw(8) << Stellar::Recovery::Utils::GetFileSystemString(partition.fileSystem)
+                     << "  " << (partition.InTable() ? "listed" : "lost  ")
+                     << "  score " << std::fixed << std::setprecision(2) << partition.score;
+            if (!partition.name.empty()) {
+                *console << "  \"" << partition.name << "\"";
+            }
+            *console << std::endl;
+            
+            if (partition.fileSystem != Stellar::Recovery::FileSystemType::UNKNOWN &&
+                ScanFileSystem(source, drivePath + "\\Partition" + std::to_string(i + 1), fileType, results,
+                               progress, partition.offset)) {
+                scanned = true;
+            }
+        }
+        return scanned;
+    }
+    
+    /**
+     * Collect deleted files from the volume's file system metadata.
+     * Returns false when the file system is unsupported or too damaged.
+     */
+    bool ScanFileSystem(Stellar::Recovery::SectorSource& source, const std::string& drivePath,
+                        FileType fileType, Stellar::Recovery::ResultStore& results,
+                        const Stellar::Recovery::ProgressCallback& progress, uint64_t volumeOffset = 0) {
+        std::vector<Stellar::Recovery::RecoverableFile> files;
+        try {
+            auto scanner = Stellar::Recovery::CreateFileSystemScanner(source, volumeOffset);
+            if (!scanner) {
+                return false;
+            }
+            files = scanner->ScanDeleted(progress);
+        } catch (const Stellar::Recovery::FileSystemError& e) {
+            *errors << "\nFile system metadata unusable (" << e.what() << "), carving instead" << std::endl;
+            return false;
+        }
+        
+        const Stellar::Recovery::TargetFileType wanted = ToTargetFileType(fileType);
+        size_t added = 0;
+        for (const auto& file : files) {
+            if (wanted != Stellar::Recovery::TargetFileType::ALL_DATA && file.fileType != wanted) {
+                continue;
+            }
+            std::string originalPath = drivePath;
+            originalPath.append(file.originalPath);
+            
+            Stellar::Recovery::ResultRecord record;
+            record.fileName = file.fileName;
+            record.originalPath = originalPath;
+            record.sourceOffset = file.extents.empty() ? 0 : file.extents.front().offset;
+            record.fileSize = file.fileSize;
+            record.fileType = file.fileType;
+            record.extents = file.extents.data();
+            record.extentCount = file.extents.size();
+            record.inlineData = file.inlineData.data();
+            record.inlineSize = file.inlineData.size();
+            record.confidence = file.recoveryConfidence;
+            record.dateModified = file.dateModified;
+            results.Add(record);
+            added++;
+        }
+        Stellar::Recovery::MetricsRegistry::Global().Add(Stellar::Recovery::Counter::FILES_FOUND, added);
+        return true;
+    }
+    
+    /**
+     * Carve the source sequentially through the read-ahead reader,
+     * continuing from the checkpoint's cursor and recording each chunk
+     */
+    std::vector<Stellar::Recovery::CarveHit> StreamCarve(Stellar::Recovery::SectorSource& source,
+                                                        const Stellar::Recovery::SignatureCarver& carver,
+                                                        Stellar::Recovery::ScanCheckpoint& checkpoint,
+                                                        const Stellar::Recovery::ProgressCallback& progress) {
+        Stellar::Recovery::ReaderOptions options = readerOptions;
+        const Stellar::Recovery::ReaderOptions device = Stellar::Recovery::DeviceReaderOptions(source);
+        options.readAhead = queueDepth ? queueDepth : device.readAhead;
+        options.chunkSize = readChunkSize ? readChunkSize : device.chunkSize;
+        const uint64_t rangeStart = options.startOffset;
+        if (checkpoint.Cursor() > options.startOffset) {
+            options.startOffset = checkpoint.Cursor();
+        }
+        Stellar::Recovery::SectorReader reader(source, options);
+        
+        const size_t seamBytes = carver.Options().sectorAligned ? 0 : carver.Overlap();
+        const uint64_t rangeBytes = std::max<uint64_t>(reader.RangeEnd() - rangeStart, 1);
+        std::vector<Stellar::Recovery::CarveHit> hits = checkpoint.TakeStreamHits();
+        std::vector<uint8_t> seam = checkpoint.Seam();
+        uint64_t seamOffset = checkpoint.Cursor() - seam.size();
+        size_t recorded = hits.size();
+        // A run that reached the end only lacks the final seam pass
+        const bool streamed = checkpoint.Cursor() > 0 && checkpoint.Cursor() >= reader.RangeEnd();
+        Stellar::Recovery::SectorChunk chunk;
+        Stellar::Recovery::MetricsRegistry& metrics = Stellar::Recovery::MetricsRegistry::Global();
+        const uint32_t sectorSize = std::max<uint32_t>(source.SectorSize(), 1);
+        
+        while (!streamed && reader.Next(chunk)) {
+            // Magic bytes straddling the previous chunk end
+            if (!seam.empty()) {
+                size_t carried = seam.size();
+                seam.insert(seam.end(), chunk.data, chunk.data + std::min(seamBytes, chunk.length));
+                carver.Scan(seam.data(), seam.size(), seamOffset, hits, carried);
+            }
+            
+            size_t tail = std::min(seamBytes, chunk.length);
+            carver.Scan(chunk.data, chunk.length, chunk.offset, hits, chunk.length - tail);
+            seam.assign(chunk.data + chunk.length - tail, chunk.data + chunk.length);
+            seamOffset = chunk.offset + chunk.length - tail;
+            
+            checkpoint.RecordCursor(chunk.offset + chunk.length, seam, hits.data() + recorded, hits.size() - recorded);
+            checkpoint.CommitIfDue();
+            metrics.Add(Stellar::Recovery::Counter::SECTORS_SCANNED, (chunk.length + sectorSize - 1) / sectorSize);
+            metrics.Add(Stellar::Recovery::Counter::SIGNATURE_HITS, hits.size() - recorded);
+            recorded = hits.size();
+            
+            uint64_t done = chunk.offset + chunk.length - rangeStart;
+            progress(static_cast<int>((done * 100) / rangeBytes), "Scanning sectors...");
+        }
+        if (!seam.empty()) {
+            carver.Scan(seam.data(), seam.size(), seamOffset, hits);
+        }
+        
+        const auto stats = reader.IoStatistics();
+        if (stats.requests > 0) {
+            *console << "\nI/O on " << source.Path() << ": " << reader.IoEngineName()
+                     << ", queue depth " << options.readAhead << ", "
+                     << std::fixed << std::setprecision(0) << stats.Iops() << " IOPS, "
+                     << FormatFileSize(static_cast<uint64_t>(stats.BytesPerSecond())) << "/s" << std::endl;
+        }
+        return hits;
+    }
+    
+    /**
+     * Map a drive letter ("C:") to its raw volume path; device nodes and
+     * image paths pass through
+     */
+    std::string GetSourcePath(const std::string& drivePath) {
+        return Stellar::Recovery::GetDeviceSourcePath(drivePath);
+    }
+    
+    /**
+     * Map the wizard file type onto the recovery core type
+     */
+    Stellar::Recovery::TargetFileType ToTargetFileType(FileType type) {
+        switch (type) {
+            case FileType::PHOTO: return Stellar::Recovery::TargetFileType::PHOTO;
+            case FileType::VIDEO: return Stellar::Recovery::TargetFileType::VIDEO;
+            case FileType::AUDIO: return Stellar::Recovery::TargetFileType::AUDIO;
+            case FileType::DOCUMENT: return Stellar::Recovery::TargetFileType::DOCUMENT;
+            case FileType::EMAIL: return Stellar::Recovery::TargetFileType::EMAIL;
+            case FileType::ARCHIVE: return Stellar::Recovery::TargetFileType::ARCHIVE;
+            default: return Stellar::Recovery::TargetFileType::ALL_DATA;
+        }
+    }
+    
+    Stellar::Recovery::ScanMode ToScanMode(RecoveryMode mode) {
+        switch (mode) {
+            case RecoveryMode::QUICK_SCAN: return Stellar::Recovery::ScanMode::QUICK_SCAN;
+            case RecoveryMode::DEEP_SCAN: return Stellar::Recovery::ScanMode::DEEP_SCAN;
+            case RecoveryMode::RAW_RECOVERY: return Stellar::Recovery::ScanMode::RAW_RECOVERY;
+            default: return Stellar::Recovery::ScanMode::PARTITION_RECOVERY;
+        }
+    }
     
     std::string GetRecoveryModeString(RecoveryMode mode) {
         switch (mode) {
@@ -329,19 +1115,6 @@ private:
         }
     }
     
-    std::string GetFileExtension(FileType type) {
-        switch (type) {
-            case FileType::PHOTO: return ".jpg";
-            case FileType::VIDEO: return ".mp4";
-            case FileType::AUDIO: return ".mp3";
-            case FileType::DOCUMENT: return ".docx";
-            case FileType::EMAIL: return ".eml";
-            case FileType::ARCHIVE: return ".zip";
-            case FileType::ALL_DATA: return ".dat";
-            default: return ".tmp";
-        }
-    }
-    
     std::string FormatFileSize(uint64_t bytes) {
         const char* units[] = {"B", "KB", "MB", "GB", "TB"};
         int unit = 0;
@@ -429,6 +1202,12 @@ public:
                 case 4:
                     ShowAbout();
                     break;
+                case 5:
+                    AddDiskImage();
+                    break;
+                case 6:
+                    OpenSavedSession();
+                    break;
                 case 0:
                     std::cout << "\nThank you for using Stellar Data Recovery Pro Free!" << std::endl;
                     return;
@@ -493,6 +1272,16 @@ private:
                 return;
         }
         
+        // Deep scans of failing drives should run on a copy
+        if (mode == RecoveryMode::DEEP_SCAN && selectedDrive.type != DriveType::IMAGE) {
+            std::cout << "\nImage the drive first to spare failing hardware?" << std::endl;
+            std::cout << "Enter image folder (blank to scan the drive directly): ";
+            std::string imageFolder;
+            std::cin.ignore();
+            std::getline(std::cin, imageFolder);
+            fileRecovery->SetImagingDirectory(imageFolder);
+        }
+        
         // Step 3: Select file type
         std::cout << "\nSelect file type to recover:" << std::endl;
         std::cout << "[1] Photos (JPG, PNG, GIF, RAW)" << std::endl;
@@ -524,24 +1313,34 @@ private:
         // Step 4: Perform scan
         auto results = fileRecovery->ScanForFiles(selectedDrive.driveLetter, mode, fileType);
         
-        if (results.empty()) {
+        if (results.Empty()) {
             std::cout << "\nNo recoverable files found." << std::endl;
             return;
         }
         
         // Step 5: Show results and recovery options
+        ShowResults(results, selectedDrive.driveLetter);
+    }
+    
+    /**
+     * List results and offer preview and recovery
+     */
+    void ShowResults(Stellar::Recovery::ResultStore& results, const std::string& drivePath) {
         std::cout << "\nScan Results:" << std::endl;
         std::cout << "===============" << std::endl;
         
-        for (size_t i = 0; i < results.size() && i < 10; i++) {
-            std::cout << "[" << i + 1 << "] " << results[i].fileName
-                     << " (" << FormatFileSize(results[i].fileSize) << ")" 
+        // Most promising files first
+        Stellar::Recovery::ResultSelection rows = results.All();
+        results.Sort(rows, Stellar::Recovery::ResultSortKey::CONFIDENCE, true);
+        for (size_t i = 0; i < rows.size() && i < 10; i++) {
+            std::cout << "[" << i + 1 << "] " << results.Name(rows[i])
+                     << " (" << FormatFileSize(results.Size(rows[i])) << ")" 
                      << " - Confidence: " << std::fixed << std::setprecision(1)
-                     << (results[i].confidence * 100) << "%" << std::endl;
+                     << (results.Confidence(rows[i]) * 100) << "%" << std::endl;
         }
         
-        if (results.size() > 10) {
-            std::cout << "... and " << (results.size() - 10) << " more files." << std::endl;
+        if (rows.size() > 10) {
+            std::cout << "... and " << (rows.size() - 10) << " more files." << std::endl;
         }
         
         std::cout << "\nOptions:" << std::endl;
@@ -556,8 +1355,8 @@ private:
         
         switch (actionChoice) {
             case 1:
-                if (!results.empty()) {
-                    fileRecovery->PreviewFile(results[0]);
+                if (!rows.empty()) {
+                    fileRecovery->PreviewFile(results, rows[0]);
                 }
                 break;
             case 2: {
@@ -565,7 +1364,7 @@ private:
                 std::string recoveryPath;
                 std::cin.ignore();
                 std::getline(std::cin, recoveryPath);
-                fileRecovery->RecoverFiles(results, recoveryPath);
+                fileRecovery->RecoverFiles(results, drivePath, recoveryPath);
                 break;
             }
             case 3:
@@ -576,6 +1375,59 @@ private:
         }
     }
 
+    /**
+     * Reopen the results of an earlier scan
+     */
+    void OpenSavedSession() {
+        auto sessions = fileRecovery->ListSavedSessions();
+        if (sessions.empty()) {
+            std::cout << "\nNo saved sessions." << std::endl;
+            return;
+        }
+        
+        std::cout << "\nSaved Sessions:" << std::endl;
+        std::cout << "================" << std::endl;
+        for (size_t i = 0; i < sessions.size(); i++) {
+            const auto& session = sessions[i];
+            std::cout << "[" << i + 1 << "] " << session.sessionId << " - " << session.sourceDrive
+                     << " (" << Stellar::Recovery::Utils::GetScanModeString(session.scanMode) << ", "
+                     << session.totalFilesFound << " files"
+                     << (session.isComplete ? "" : ", interrupted") << ")" << std::endl;
+        }
+        std::cout << "\nSelect session (1-" << sessions.size() << "): ";
+        
+        int sessionChoice;
+        std::cin >> sessionChoice;
+        if (sessionChoice < 1 || sessionChoice > static_cast<int>(sessions.size())) {
+            std::cout << "Invalid session selection." << std::endl;
+            return;
+        }
+        
+        const auto& session = sessions[sessionChoice - 1];
+        auto results = fileRecovery->LoadSession(session.sessionId);
+        if (results.Empty()) {
+            std::cout << "\nThe session has no recoverable files." << std::endl;
+            return;
+        }
+        ShowResults(results, session.sourceDrive);
+    }
+
+    /**
+     * Offer a forensic image file as a scan source
+     */
+    void AddDiskImage() {
+        std::cout << "\nEnter disk image path (.dd, .img, .raw): ";
+        std::string path;
+        std::cin.ignore();
+        std::getline(std::cin, path);
+        
+        if (driveScanner->AddDiskImage(path)) {
+            std::cout << "Image added. It is listed with the drives in the recovery wizard." << std::endl;
+        } else {
+            std::cout << "Not a readable image file: " << path << std::endl;
+        }
+    }
+
     void ShowMainMenu() {
         std::cout << "\n========================================" << std::endl;
         std::cout << " Stellar Data Recovery Pro Free" << std::endl;
@@ -584,6 +1436,8 @@ private:
         std::cout << "[2] Show Drive Information" << std::endl;
         std::cout << "[3] System Information" << std::endl;
         std::cout << "[4] About" << std::endl;
+        std::cout << "[5] Add Disk Image" << std::endl;
+        std::cout << "[6] Open Saved Session" << std::endl;
         std::cout << "[0] Exit" << std::endl;
         std::cout << "\nChoice: ";
     }
@@ -612,30 +1466,17 @@ private:
         std::cout << " System Information" << std::endl;
         std::cout << "========================================" << std::endl;
         
-        // Get OS information
-        OSVERSIONINFO osvi;
-        ZeroMemory(&osvi, sizeof(OSVERSIONINFO));
-        osvi.dwOSVersionInfoSize = sizeof(OSVERSIONINFO);
-        
-        if (GetVersionEx(&osvi)) {
-            std::cout << "Operating System: Windows " << osvi.dwMajorVersion 
-                     << "." << osvi.dwMinorVersion << std::endl;
+        const auto host = Stellar::Recovery::GetHostInformation();
+        if (!host.operatingSystem.empty()) {
+            std::cout << "Operating System: " << host.operatingSystem << std::endl;
         }
-        
-        // Get memory information
-        MEMORYSTATUSEX memInfo;
-        memInfo.dwLength = sizeof(MEMORYSTATUSEX);
-        if (GlobalMemoryStatusEx(&memInfo)) {
+        if (host.totalMemory > 0) {
             std::cout << "Total Physical Memory: " 
-                     << FormatFileSize(memInfo.ullTotalPhys) << std::endl;
+                     << FormatFileSize(host.totalMemory) << std::endl;
             std::cout << "Available Physical Memory: " 
-                     << FormatFileSize(memInfo.ullAvailPhys) << std::endl;
+                     << FormatFileSize(host.availableMemory) << std::endl;
         }
-        
-        // Get processor information
-        SYSTEM_INFO sysInfo;
-        GetSystemInfo(&sysInfo);
-        std::cout << "Number of Processors: " << sysInfo.dwNumberOfProcessors << std::endl;
+        std::cout << "Number of Processors: " << host.processorCount << std::endl;
         
         std::cout << "\nSupported File Systems:" << std::endl;
         for (const auto& fs : supportedFileSystems) {
@@ -666,18 +1507,8 @@ private:
      * Check if system meets minimum requirements
      */
     bool CheckSystemRequirements() {
-        // Check Windows version
-        OSVERSIONINFO osvi;
-        ZeroMemory(&osvi, sizeof(OSVERSIONINFO));
-        osvi.dwOSVersionInfoSize = sizeof(OSVERSIONINFO);
-        
-        if (GetVersionEx(&osvi)) {
-            if (osvi.dwMajorVersion >= 6) { // Windows Vista or later
-                return true;
-            }
-        }
-        
-        return false;
+        // Windows Vista or later; any Linux
+        return Stellar::Recovery::GetHostInformation().meetsRequirements;
     }
 
     /**
@@ -731,15 +1562,122 @@ private:
         std::cout << "\nNote: This is a placeholder implementation." << std::endl;
         std::cout << "The actual Stellar Data Recovery Pro Free executable" << std::endl;
         std::cout << "should be placed in the 'bin' directory." << std::endl;
-        std::cout << "\nPress any key to exit..." << std::endl;
-        std::cin.get();
     }
 };
 
+/**
+ * Wizard mode for a recovery core scan mode
+ */
+RecoveryMode ToRecoveryMode(Stellar::Recovery::ScanMode mode) {
+    switch (mode) {
+        case Stellar::Recovery::ScanMode::DEEP_SCAN: return RecoveryMode::DEEP_SCAN;
+        case Stellar::Recovery::ScanMode::RAW_RECOVERY: return RecoveryMode::RAW_RECOVERY;
+        case Stellar::Recovery::ScanMode::PARTITION_RECOVERY: return RecoveryMode::PARTITION_RECOVERY;
+        default: return RecoveryMode::QUICK_SCAN;
+    }
+}
+
+/**
+ * Wizard file type to scan for; several types scan for everything and
+ * are filtered before recovery
+ */
+FileType ToFileType(const std::vector<Stellar::Recovery::TargetFileType>& types) {
+    if (types.size() != 1) {
+        return FileType::ALL_DATA;
+    }
+    switch (types[0]) {
+        case Stellar::Recovery::TargetFileType::PHOTO: return FileType::PHOTO;
+        case Stellar::Recovery::TargetFileType::VIDEO: return FileType::VIDEO;
+        case Stellar::Recovery::TargetFileType::AUDIO: return FileType::AUDIO;
+        case Stellar::Recovery::TargetFileType::DOCUMENT: return FileType::DOCUMENT;
+        case Stellar::Recovery::TargetFileType::EMAIL: return FileType::EMAIL;
+        case Stellar::Recovery::TargetFileType::ARCHIVE: return FileType::ARCHIVE;
+        default: return FileType::ALL_DATA;
+    }
+}
+
+/**
+ * Run the jobs given on the command line without prompting. Every
+ * message and progress update goes to standard output as a JSON line.
+ */
+int RunHeadless(int argc, char* argv[]) {
+    std::vector<std::string> arguments(argv + 1, argv + argc);
+    if (arguments[0] == "--help" || arguments[0] == "-h") {
+        std::cout << Stellar::Recovery::BatchUsage();
+        return 0;
+    }
+    
+    Stellar::Recovery::BatchOptions options;
+    std::vector<Stellar::Recovery::JobSpec> jobs;
+    std::string error;
+    if (!Stellar::Recovery::ParseBatchCommandLine(arguments, options, jobs, error)) {
+        std::cerr << error << "\n\n" << Stellar::Recovery::BatchUsage();
+        return 2;
+    }
+    
+    Stellar::Recovery::JobEventWriter events(std::cout);
+    Stellar::Recovery::IoBudget budget(options.readBytesPerSecond);
+    
+    // Counters of the whole batch, for a Prometheus textfile collector or a log
+    std::unique_ptr<Stellar::Recovery::MetricsReporter> metrics;
+    if (!options.metricsPath.empty()) {
+        Stellar::Recovery::MetricsReporterOptions metricsOptions;
+        const std::string extension = std::filesystem::path(options.metricsPath).extension().string();
+        metricsOptions.format = extension == ".jsonl" || extension == ".json"
+            ? Stellar::Recovery::MetricsFormat::JSON_LINES : Stellar::Recovery::MetricsFormat::PROMETHEUS;
+        metricsOptions.interval = std::chrono::milliseconds(options.metricsInterval);
+        metricsOptions.path = options.metricsPath;
+        metrics = std::make_unique<Stellar::Recovery::MetricsReporter>(
+            Stellar::Recovery::MetricsRegistry::Global(), metricsOptions);
+    }
+    const size_t failed = Stellar::Recovery::RunBatch(jobs, options, events,
+        [&](const Stellar::Recovery::JobSpec& job, size_t workers) {
+            Stellar::Recovery::JobLogBuffer outBuffer(events, job.id, "stdout");
+            Stellar::Recovery::JobLogBuffer errBuffer(events, job.id, "stderr");
+            std::ostream out(&outBuffer);
+            std::ostream err(&errBuffer);
+            
+            FileRecovery recovery;
+            recovery.SetConsole(out, err);
+            recovery.SetProgressTracker(std::make_unique<JobProgressTracker>(events, job.id));
+            recovery.SetScanWorkers(workers);
+            if (job.memoryBudget != 0) {
+                recovery.SetRecoveryMemoryBudget(job.memoryBudget);
+            }
+            recovery.SetQueueDepth(job.queueDepth);
+            recovery.SetReadChunkSize(job.chunkSize);
+            if (budget.Limited()) {
+                recovery.SetIoBudget(&budget);
+            }
+            recovery.SetImagingDirectory(job.imageDirectory);
+            recovery.SetTypeFilter(job.types);
+            
+            auto results = recovery.ScanForFiles(job.source, ToRecoveryMode(job.mode), ToFileType(job.types));
+            if (recovery.LastError().empty() && !job.output.empty() && !results.Empty()) {
+                recovery.RecoverFiles(results, job.source, job.output);
+            }
+            return recovery.LastError().empty() ? 0 : 1;
+        });
+    if (metrics) {
+        metrics->Stop();
+    }
+    return failed == 0 ? 0 : 1;
+}
+
 /**
  * Main entry point
  */
 int main(int argc, char* argv[]) {
+    // Any argument selects unattended mode
+    if (argc > 1) {
+        try {
+            return RunHeadless(argc, argv);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    
     try {
         StellarRecovery recovery;
         
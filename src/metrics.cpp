@@ -0,0 +1,331 @@
+/**
+ * Stellar Data Recovery Pro Free - Metrics
+ *
+ * Shard registration, snapshots, the progress gauge and the reporter
+ * thread with its console, JSON lines and Prometheus output.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            struct CounterInfo {
+                const char* name;
+                const char* help;
+                const char* unit;       // Prometheus name suffix before _total
+            };
+
+            const CounterInfo COUNTERS[COUNTER_COUNT] = {
+                {"bytes_read", "Bytes read from devices and image files", "_bytes"},
+                {"sectors_scanned", "Sectors passed through the signature carver", ""},
+                {"signature_hits", "File headers and footers found by the carver", ""},
+                {"files_found", "Files added to scan results", ""},
+                {"files_recovered", "Files written completely or partially", ""},
+                {"bytes_written", "Bytes of recovered file data written", "_bytes"},
+                {"read_errors", "Failed source reads", ""}
+            };
+
+            const CounterInfo HISTOGRAMS[HISTOGRAM_COUNT] = {
+                {"read_latency", "Duration of one source read", "_seconds"},
+                {"extent_scan", "Duration of carving one scan extent", "_seconds"}
+            };
+
+            std::atomic<uint64_t> nextSerial{1};
+
+            uint64_t BucketBound(size_t bucket) {
+                return uint64_t(1) << bucket;
+            }
+
+            // Metrics output must never stop a recovery, so write failures are dropped
+            void ReplaceFile(const std::string& path, const std::string& contents) {
+                const std::string temporary = path + ".tmp";
+                {
+                    std::ofstream out(temporary, std::ios::trunc | std::ios::binary);
+                    out << contents;
+                    if (!out.flush()) {
+                        return;
+                    }
+                }
+                std::error_code error;
+                std::filesystem::rename(temporary, path, error);
+            }
+
+        } // namespace
+
+        const char* CounterName(Counter counter) {
+            return COUNTERS[static_cast<size_t>(counter)].name;
+        }
+
+        const char* HistogramName(Histogram histogram) {
+            return HISTOGRAMS[static_cast<size_t>(histogram)].name;
+        }
+
+        uint64_t HistogramSnapshot::Quantile(double q) const {
+            if (count == 0) {
+                return 0;
+            }
+            uint64_t target = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(q * count)), 1);
+            uint64_t seen = 0;
+            for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+                seen += buckets[i];
+                if (seen >= target) {
+                    return BucketBound(i);
+                }
+            }
+            return BucketBound(HISTOGRAM_BUCKETS - 1);
+        }
+
+        // MetricsRegistry -------------------------------------------------
+
+        MetricsRegistry::MetricsRegistry() :
+            shards(nullptr),
+            serial(nextSerial.fetch_add(1)) {}
+
+        MetricsRegistry::~MetricsRegistry() {
+            Shard* shard = shards.load();
+            while (shard) {
+                Shard* next = shard->next;
+                delete shard;
+                shard = next;
+            }
+        }
+
+        MetricsRegistry& MetricsRegistry::Global() {
+            static MetricsRegistry registry;
+            return registry;
+        }
+
+        MetricsRegistry::Shard& MetricsRegistry::Attach() {
+            // A thread switching between registries finds its shard again
+            const std::thread::id self = std::this_thread::get_id();
+            for (Shard* shard = shards.load(std::memory_order_acquire); shard; shard = shard->next) {
+                if (shard->owner == self) {
+                    return *shard;
+                }
+            }
+            Shard* shard = new Shard;
+            shard->owner = self;
+            shard->next = shards.load(std::memory_order_relaxed);
+            while (!shards.compare_exchange_weak(shard->next, shard, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+            }
+            return *shard;
+        }
+
+        void MetricsRegistry::Record(Histogram histogram, uint64_t microseconds) {
+            size_t bucket = 0;
+            while (bucket < HISTOGRAM_BUCKETS - 1 && (microseconds >> bucket) != 0) {
+                bucket++;
+            }
+            Shard& shard = Local();
+            const size_t index = static_cast<size_t>(histogram);
+            std::atomic<uint64_t>& slot = shard.buckets[index][bucket];
+            slot.store(slot.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic<uint64_t>& sum = shard.sums[index];
+            sum.store(sum.load(std::memory_order_relaxed) + microseconds, std::memory_order_relaxed);
+        }
+
+        MetricsSnapshot MetricsRegistry::Snapshot() const {
+            MetricsSnapshot snapshot;
+            for (Shard* shard = shards.load(std::memory_order_acquire); shard; shard = shard->next) {
+                for (size_t i = 0; i < COUNTER_COUNT; i++) {
+                    snapshot.counters[i] += shard->counters[i].load(std::memory_order_relaxed);
+                }
+                for (size_t h = 0; h < HISTOGRAM_COUNT; h++) {
+                    HistogramSnapshot& histogram = snapshot.histograms[h];
+                    for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++) {
+                        uint64_t value = shard->buckets[h][b].load(std::memory_order_relaxed);
+                        histogram.buckets[b] += value;
+                        histogram.count += value;
+                    }
+                    histogram.sum += shard->sums[h].load(std::memory_order_relaxed);
+                }
+            }
+            return snapshot;
+        }
+
+        // ProgressGauge ---------------------------------------------------
+
+        void ProgressGauge::Set(int percentage, const std::string& operation) {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->percentage = percentage;
+            this->operation = operation;
+            changed = true;
+        }
+
+        bool ProgressGauge::Take(int& percentage, std::string& operation) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!changed) {
+                return false;
+            }
+            percentage = this->percentage;
+            operation = this->operation;
+            changed = false;
+            return true;
+        }
+
+        ProgressCallback ProgressGauge::Sink() {
+            return [this](int percentage, const std::string& operation) { Set(percentage, operation); };
+        }
+
+        // Formatting ------------------------------------------------------
+
+        std::string FormatMetricsPrometheus(const MetricsSnapshot& snapshot) {
+            std::ostringstream out;
+            for (size_t i = 0; i < COUNTER_COUNT; i++) {
+                const std::string name = std::string("stellar_") + COUNTERS[i].name + "_total";
+                out << "# HELP " << name << ' ' << COUNTERS[i].help << '\n'
+                    << "# TYPE " << name << " counter\n"
+                    << name << ' ' << snapshot.counters[i] << '\n';
+            }
+            for (size_t h = 0; h < HISTOGRAM_COUNT; h++) {
+                const HistogramSnapshot& histogram = snapshot.histograms[h];
+                const std::string name = std::string("stellar_") + HISTOGRAMS[h].name + HISTOGRAMS[h].unit;
+                out << "# HELP " << name << ' ' << HISTOGRAMS[h].help << '\n'
+                    << "# TYPE " << name << " histogram\n";
+                uint64_t cumulative = 0;
+                for (size_t b = 0; b + 1 < HISTOGRAM_BUCKETS; b++) {
+                    cumulative += histogram.buckets[b];
+                    out << name << "_bucket{le=\"" << BucketBound(b) * 1e-6 << "\"} " << cumulative << '\n';
+                }
+                out << name << "_bucket{le=\"+Inf\"} " << histogram.count << '\n'
+                    << name << "_sum " << histogram.sum * 1e-6 << '\n'
+                    << name << "_count " << histogram.count << '\n';
+            }
+            return out.str();
+        }
+
+        std::string FormatMetricsJson(const MetricsSnapshot& snapshot, int percentage, const std::string& operation) {
+            const auto now = std::chrono::system_clock::now().time_since_epoch();
+            std::ostringstream out;
+            out << "{\"time\":" << std::fixed << std::setprecision(3)
+                << std::chrono::duration_cast<std::chrono::milliseconds>(now).count() / 1000.0
+                << ",\"percent\":" << percentage << ",\"operation\":" << Utils::JsonString(operation);
+            for (size_t i = 0; i < COUNTER_COUNT; i++) {
+                out << ",\"" << COUNTERS[i].name << "\":" << snapshot.counters[i];
+            }
+            for (size_t h = 0; h < HISTOGRAM_COUNT; h++) {
+                const HistogramSnapshot& histogram = snapshot.histograms[h];
+                out << ",\"" << HISTOGRAMS[h].name << "\":{\"count\":" << histogram.count
+                    << ",\"sumMicroseconds\":" << histogram.sum
+                    << ",\"p50Microseconds\":" << histogram.Quantile(0.5)
+                    << ",\"p99Microseconds\":" << histogram.Quantile(0.99) << '}';
+            }
+            out << '}';
+            return out.str();
+        }
+
+        // MetricsReporter -------------------------------------------------
+
+        MetricsReporter::MetricsReporter(const MetricsRegistry& registry, const MetricsReporterOptions& options,
+                                         ProgressGauge* gauge, const ProgressCallback& progress) :
+            registry(registry),
+            options(options),
+            gauge(gauge),
+            progress(progress),
+            previous(registry.Snapshot()),
+            previousTime(std::chrono::steady_clock::now()) {
+            if (this->options.interval <= std::chrono::milliseconds(0)) {
+                this->options.interval = std::chrono::milliseconds(250);
+            }
+            worker = std::thread(&MetricsReporter::Loop, this);
+        }
+
+        MetricsReporter::~MetricsReporter() {
+            Stop();
+        }
+
+        void MetricsReporter::Stop() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            if (worker.joinable()) {
+                worker.join();
+                if (options.format == MetricsFormat::CONSOLE && options.out) {
+                    *options.out << std::endl;
+                }
+            }
+        }
+
+        void MetricsReporter::Loop() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                bool last = wake.wait_for(lock, options.interval, [this] { return stopping; });
+                lock.unlock();
+                Sample();
+                lock.lock();
+                if (last) {
+                    return;
+                }
+            }
+        }
+
+        void MetricsReporter::Sample() {
+            const MetricsSnapshot snapshot = registry.Snapshot();
+            const auto now = std::chrono::steady_clock::now();
+            if (gauge && gauge->Take(percentage, operation) && progress) {
+                progress(percentage, operation);
+            }
+
+            switch (options.format) {
+                case MetricsFormat::NONE:
+                    break;
+                case MetricsFormat::CONSOLE: {
+                    if (!options.out) {
+                        break;
+                    }
+                    const double seconds = std::max(std::chrono::duration<double>(now - previousTime).count(), 1e-3);
+                    const uint64_t read = snapshot.Get(Counter::BYTES_READ) - previous.Get(Counter::BYTES_READ);
+                    std::ostringstream line;
+                    line << '\r' << percentage << "% "
+                         << Utils::FormatFileSize(snapshot.Get(Counter::BYTES_READ)) << " read ("
+                         << Utils::FormatFileSize(static_cast<uint64_t>(read / seconds)) << "/s), "
+                         << snapshot.Get(Counter::SECTORS_SCANNED) << " sectors, "
+                         << snapshot.Get(Counter::SIGNATURE_HITS) << " hits, "
+                         << snapshot.Get(Counter::FILES_FOUND) << " found, "
+                         << snapshot.Get(Counter::READ_ERRORS) << " errors, read p99 "
+                         << snapshot.Get(Histogram::READ_LATENCY).Quantile(0.99) << " us   ";
+                    *options.out << line.str() << std::flush;
+                    break;
+                }
+                case MetricsFormat::JSON_LINES: {
+                    const std::string line = FormatMetricsJson(snapshot, percentage, operation) + "\n";
+                    if (!options.path.empty()) {
+                        std::ofstream out(options.path, std::ios::app | std::ios::binary);
+                        out << line;
+                    } else if (options.out) {
+                        *options.out << line << std::flush;
+                    }
+                    break;
+                }
+                case MetricsFormat::PROMETHEUS:
+                    if (!options.path.empty()) {
+                        ReplaceFile(options.path, FormatMetricsPrometheus(snapshot));
+                    } else if (options.out) {
+                        *options.out << FormatMetricsPrometheus(snapshot) << std::flush;
+                    }
+                    break;
+            }
+
+            previous = snapshot;
+            previousTime = now;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
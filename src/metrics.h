@@ -0,0 +1,237 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Metrics
+ *
+ * Counters and latency histograms updated from the scan and recovery
+ * hot paths. Each thread writes only its own cache-line aligned shard
+ * with relaxed atomics, so an update costs a load and a store and never
+ * contends; readers sum the shards. A reporter thread samples the
+ * registry at a fixed rate and writes it to the console, as JSON lines
+ * or as a Prometheus text file, and forwards progress to the UI at that
+ * same rate instead of on every update.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_METRICS_H
+#define STELLAR_METRICS_H
+
+#include "stellar_recovery.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace Stellar {
+    namespace Recovery {
+
+        enum class Counter : size_t {
+            BYTES_READ,         // Read from devices and image files
+            SECTORS_SCANNED,    // Passed through the signature carver
+            SIGNATURE_HITS,     // Headers and footers found by the carver
+            FILES_FOUND,        // Added to scan results
+            FILES_RECOVERED,    // Written completely or partially
+            BYTES_WRITTEN,      // Recovered file data
+            READ_ERRORS,        // Failed source reads
+            COUNT
+        };
+
+        enum class Histogram : size_t {
+            READ_LATENCY,       // One source read
+            EXTENT_SCAN,        // Carving one scan extent
+            COUNT
+        };
+
+        constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::COUNT);
+        constexpr size_t HISTOGRAM_COUNT = static_cast<size_t>(Histogram::COUNT);
+
+        // Bucket i holds values below 2^i microseconds; the last one holds the rest
+        constexpr size_t HISTOGRAM_BUCKETS = 32;
+
+        struct HistogramSnapshot {
+            uint64_t count = 0;
+            uint64_t sum = 0;                       // Microseconds
+            uint64_t buckets[HISTOGRAM_BUCKETS] = {};
+
+            // Upper bound in microseconds of the bucket holding quantile q
+            uint64_t Quantile(double q) const;
+        };
+
+        struct MetricsSnapshot {
+            uint64_t counters[COUNTER_COUNT] = {};
+            HistogramSnapshot histograms[HISTOGRAM_COUNT];
+
+            uint64_t Get(Counter counter) const { return counters[static_cast<size_t>(counter)]; }
+            const HistogramSnapshot& Get(Histogram histogram) const {
+                return histograms[static_cast<size_t>(histogram)];
+            }
+        };
+
+        const char* CounterName(Counter counter);
+        const char* HistogramName(Histogram histogram);
+
+        /**
+         * Sharded counters and histograms. Updates are wait-free after a
+         * thread's first one, which allocates its shard. Shards live as
+         * long as the registry, so counts of finished threads are kept.
+         */
+        class MetricsRegistry {
+        public:
+            MetricsRegistry();
+            ~MetricsRegistry();
+
+            MetricsRegistry(const MetricsRegistry&) = delete;
+            MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+            // Registry the library code reports to
+            static MetricsRegistry& Global();
+
+            void Add(Counter counter, uint64_t value = 1) {
+                std::atomic<uint64_t>& slot = Local().counters[static_cast<size_t>(counter)];
+                slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            }
+
+            void Record(Histogram histogram, uint64_t microseconds);
+
+            // Sum of all shards; each value is exact, the set is not one instant
+            MetricsSnapshot Snapshot() const;
+
+        private:
+            struct alignas(64) Shard {
+                std::atomic<uint64_t> counters[COUNTER_COUNT] = {};
+                std::atomic<uint64_t> buckets[HISTOGRAM_COUNT][HISTOGRAM_BUCKETS] = {};
+                std::atomic<uint64_t> sums[HISTOGRAM_COUNT] = {};
+                std::thread::id owner;
+                Shard* next = nullptr;
+            };
+
+            struct LocalShard {
+                uint64_t serial = 0;
+                Shard* shard = nullptr;
+            };
+
+            Shard& Local() {
+                thread_local LocalShard cache;
+                if (cache.serial != serial) {
+                    cache.shard = &Attach();
+                    cache.serial = serial;
+                }
+                return *cache.shard;
+            }
+
+            Shard& Attach();
+
+            std::atomic<Shard*> shards;
+            uint64_t serial;                        // Tells registries apart in the thread cache
+        };
+
+        /**
+         * Times a scope into a histogram of the global registry
+         */
+        class MetricsTimer {
+        public:
+            explicit MetricsTimer(Histogram histogram) :
+                histogram(histogram), started(std::chrono::steady_clock::now()) {}
+
+            ~MetricsTimer() {
+                auto elapsed = std::chrono::steady_clock::now() - started;
+                MetricsRegistry::Global().Record(histogram,
+                    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+            }
+
+        private:
+            Histogram histogram;
+            std::chrono::steady_clock::time_point started;
+        };
+
+        /**
+         * Latest progress of one operation. Set is called at most once per
+         * chunk or extent, so a mutex is cheap enough here.
+         */
+        class ProgressGauge {
+        public:
+            void Set(int percentage, const std::string& operation);
+
+            // The latest update; false when there was none since the last call
+            bool Take(int& percentage, std::string& operation);
+
+            // Callback for the scanners that stores into this gauge
+            ProgressCallback Sink();
+
+        private:
+            std::mutex mutex;
+            int percentage = 0;
+            std::string operation;
+            bool changed = false;
+        };
+
+        enum class MetricsFormat {
+            NONE,               // Only forward progress
+            CONSOLE,            // One status line, redrawn in place
+            JSON_LINES,         // One object per sample, appended
+            PROMETHEUS          // Text exposition format, file replaced per sample
+        };
+
+        struct MetricsReporterOptions {
+            MetricsFormat format;
+            std::chrono::milliseconds interval;
+            std::ostream* out;                      // CONSOLE and JSON_LINES when path is empty
+            std::string path;                       // JSON_LINES appends, PROMETHEUS replaces
+
+            MetricsReporterOptions() :
+                format(MetricsFormat::NONE),
+                interval(250),
+                out(nullptr) {}
+        };
+
+        /**
+         * Samples a registry (and optionally a gauge) on its own thread
+         * until stopped. progress is called from that thread only.
+         */
+        class MetricsReporter {
+        public:
+            MetricsReporter(const MetricsRegistry& registry, const MetricsReporterOptions& options,
+                            ProgressGauge* gauge = nullptr, const ProgressCallback& progress = ProgressCallback());
+            ~MetricsReporter();
+
+            MetricsReporter(const MetricsReporter&) = delete;
+            MetricsReporter& operator=(const MetricsReporter&) = delete;
+
+            // Take a last sample and join the thread; idempotent
+            void Stop();
+
+        private:
+            void Loop();
+            void Sample();
+
+            const MetricsRegistry& registry;
+            MetricsReporterOptions options;
+            ProgressGauge* gauge;
+            ProgressCallback progress;
+
+            MetricsSnapshot previous;
+            std::chrono::steady_clock::time_point previousTime;
+            int percentage = 0;
+            std::string operation;
+
+            std::mutex mutex;
+            std::condition_variable wake;
+            bool stopping = false;
+            std::thread worker;
+        };
+
+        // Sample rendered in the formats the reporter writes
+        std::string FormatMetricsPrometheus(const MetricsSnapshot& snapshot);
+        std::string FormatMetricsJson(const MetricsSnapshot& snapshot, int percentage, const std::string& operation);
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_METRICS_H
@@ -0,0 +1,525 @@
+/**
+ * Stellar Data Recovery Pro Free - NTFS Scanner
+ *
+ * Boot sector parsing, MFT streaming and record decoding.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "ntfs_scanner.h"
+#include <algorithm>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            // Attribute type codes
+            constexpr uint32_t ATTR_STANDARD_INFORMATION = 0x10;
+            constexpr uint32_t ATTR_FILE_NAME = 0x30;
+            constexpr uint32_t ATTR_DATA = 0x80;
+            constexpr uint32_t ATTR_END = 0xFFFFFFFFu;
+
+            // Record header flags
+            constexpr uint16_t RECORD_IN_USE = 0x0001;
+            constexpr uint16_t RECORD_DIRECTORY = 0x0002;
+
+            // $STANDARD_INFORMATION file attributes
+            constexpr uint32_t FILE_ATTRIBUTE_COMPRESSED = 0x0800;
+            constexpr uint32_t FILE_ATTRIBUTE_ENCRYPTED = 0x4000;
+
+            constexpr uint64_t MFT_RECORD_REFERENCE_MASK = 0x0000FFFFFFFFFFFFull;
+            constexpr uint64_t ROOT_DIRECTORY_RECORD = 5;
+            constexpr uint64_t VOLUME_BITMAP_RECORD = 6;
+            constexpr size_t UPDATE_SEQUENCE_STRIDE = 512;
+            constexpr size_t MFT_READ_CHUNK_SIZE = 4u << 20;
+            constexpr size_t MAX_PATH_DEPTH = 256;
+
+            // Seconds between 1601-01-01 and 1970-01-01
+            constexpr uint64_t FILETIME_UNIX_EPOCH = 11644473600ull;
+
+            std::chrono::system_clock::time_point FileTimeToTimePoint(uint64_t fileTime) {
+                if (fileTime < FILETIME_UNIX_EPOCH * 10000000ull) {
+                    return std::chrono::system_clock::time_point();
+                }
+                uint64_t micros = (fileTime - FILETIME_UNIX_EPOCH * 10000000ull) / 10;
+                return std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(micros)));
+            }
+
+            // Preference among $FILE_NAME namespaces: Win32 > POSIX > DOS 8.3
+            int NamespaceRank(uint8_t nameSpace) {
+                switch (nameSpace) {
+                    case 1:
+                    case 3: return 3;
+                    case 0: return 2;
+                    default: return 1;
+                }
+            }
+
+            uint32_t DecodeClusterSize(const uint8_t* sector) {
+                uint32_t bytesPerSector = ReadLE16(sector + 0x0B);
+                uint8_t sectorsPerCluster = sector[0x0D];
+                // Values above 0x80 encode 2^(256 - n) sectors
+                uint32_t sectors = sectorsPerCluster <= 0x80 ? sectorsPerCluster : 1u << (256 - sectorsPerCluster);
+                return bytesPerSector * sectors;
+            }
+
+        } // namespace
+
+        NtfsScanner::NtfsScanner(SectorSource& source, uint64_t volumeOffset) :
+            FileSystemScanner(source, volumeOffset) {
+            AlignedBuffer boot(IO_ALIGNMENT);
+            if (Read(0, boot.Data(), boot.Size()) < 512 || !IsNtfsBootSector(boot.Data())) {
+                throw FileSystemError("No NTFS boot sector on " + source.Path());
+            }
+            const uint8_t* sector = boot.Data();
+
+            sectorSize = ReadLE16(sector + 0x0B);
+            clusterSize = DecodeClusterSize(sector);
+            clusterCount = ReadLE64(sector + 0x28) / (clusterSize / sectorSize);
+
+            // Positive: clusters per record; negative: 2^-n bytes
+            int8_t perRecord = static_cast<int8_t>(sector[0x40]);
+            recordSize = perRecord > 0 ? static_cast<uint32_t>(perRecord) * clusterSize
+                                      : (perRecord >= -16 ? 1u << -perRecord : 0);
+            if (recordSize < 512 || recordSize > 65536 || recordSize % UPDATE_SEQUENCE_STRIDE) {
+                throw FileSystemError("Unsupported NTFS record size " + std::to_string(recordSize));
+            }
+
+            LoadMft();
+        }
+
+        bool NtfsScanner::IsNtfsBootSector(const uint8_t* sector) {
+            if (std::memcmp(sector + 3, "NTFS    ", 8) != 0 || sector[510] != 0x55 || sector[511] != 0xAA) {
+                return false;
+            }
+            uint32_t bytesPerSector = ReadLE16(sector + 0x0B);
+            uint8_t sectorsPerCluster = sector[0x0D];
+            bool sectorOk = bytesPerSector >= 256 && bytesPerSector <= 4096 &&
+                            (bytesPerSector & (bytesPerSector - 1)) == 0;
+            bool clusterOk = sectorsPerCluster != 0 &&
+                             (sectorsPerCluster > 0x80 ? sectorsPerCluster >= 0xF4
+                                                       : (sectorsPerCluster & (sectorsPerCluster - 1)) == 0);
+            return sectorOk && clusterOk && ReadLE64(sector + 0x28) != 0;
+        }
+
+        bool NtfsScanner::ApplyFixups(uint8_t* record, size_t length) {
+            size_t usaOffset = ReadLE16(record + 4);
+            size_t usaCount = ReadLE16(record + 6);
+            if (usaCount < 2 || usaOffset + usaCount * 2 > length ||
+                (usaCount - 1) * UPDATE_SEQUENCE_STRIDE > length) {
+                return false;
+            }
+
+            // The last two bytes of every stride hold the sequence number on disk
+            const uint8_t* usa = record + usaOffset;
+            for (size_t i = 1; i < usaCount; i++) {
+                uint8_t* tail = record + i * UPDATE_SEQUENCE_STRIDE - 2;
+                if (tail[0] != usa[0] || tail[1] != usa[1]) {
+                    return false;
+                }
+                tail[0] = usa[i * 2];
+                tail[1] = usa[i * 2 + 1];
+            }
+            return true;
+        }
+
+        bool NtfsScanner::DecodeRunlist(const uint8_t* data, size_t length, uint64_t startVcn,
+                                        std::vector<NtfsRun>& runs) {
+            size_t position = 0;
+            uint64_t vcn = startVcn;
+            int64_t lcn = 0;
+
+            while (position < length) {
+                uint8_t header = data[position++];
+                if (header == 0) {
+                    return true;
+                }
+                size_t lengthBytes = header & 0x0F;
+                size_t offsetBytes = header >> 4;
+                if (lengthBytes == 0 || lengthBytes > 8 || offsetBytes > 8 ||
+                    position + lengthBytes + offsetBytes > length) {
+                    return false;
+                }
+
+                uint64_t clusters = 0;
+                for (size_t i = 0; i < lengthBytes; i++) {
+                    clusters |= static_cast<uint64_t>(data[position + i]) << (8 * i);
+                }
+                position += lengthBytes;
+                if (clusters == 0) {
+                    return false;
+                }
+
+                if (offsetBytes == 0) {
+                    runs.push_back(NtfsRun{vcn, 0, clusters, true});
+                } else {
+                    // Signed delta from the previous run's LCN
+                    uint64_t delta = 0;
+                    for (size_t i = 0; i < offsetBytes; i++) {
+                        delta |= static_cast<uint64_t>(data[position + i]) << (8 * i);
+                    }
+                    if (offsetBytes < 8 && (data[position + offsetBytes - 1] & 0x80)) {
+                        delta |= ~0ull << (8 * offsetBytes);
+                    }
+                    lcn += static_cast<int64_t>(delta);
+                    if (lcn < 0) {
+                        return false;
+                    }
+                    runs.push_back(NtfsRun{vcn, static_cast<uint64_t>(lcn), clusters, false});
+                }
+                position += offsetBytes;
+                vcn += clusters;
+            }
+            return true;
+        }
+
+        bool NtfsScanner::ParseRecord(const uint8_t* data, size_t length, uint64_t number, NtfsRecord& record) {
+            if (length < 48 || std::memcmp(data, "FILE", 4) != 0) {
+                return false;
+            }
+            size_t used = std::min<size_t>(ReadLE32(data + 0x18), length);
+            size_t position = ReadLE16(data + 0x14);
+            uint16_t flags = ReadLE16(data + 0x16);
+
+            record = NtfsRecord();
+            record.number = number;
+            record.sequence = ReadLE16(data + 0x10);
+            record.baseRecord = ReadLE64(data + 0x20) & MFT_RECORD_REFERENCE_MASK;
+            record.inUse = (flags & RECORD_IN_USE) != 0;
+            record.isDirectory = (flags & RECORD_DIRECTORY) != 0;
+
+            int nameRank = 0;
+            bool haveTimes = false;
+
+            while (position + 16 <= used) {
+                const uint8_t* attribute = data + position;
+                uint32_t type = ReadLE32(attribute);
+                uint32_t attributeLength = ReadLE32(attribute + 4);
+                if (type == ATTR_END || attributeLength < 16 || position + attributeLength > used) {
+                    break;
+                }
+                bool nonResident = attribute[8] != 0;
+                uint8_t nameLength = attribute[9];
+
+                const uint8_t* value = nullptr;
+                size_t valueLength = 0;
+                if (!nonResident && attributeLength >= 24) {
+                    size_t valueOffset = ReadLE16(attribute + 0x14);
+                    valueLength = ReadLE32(attribute + 0x10);
+                    if (valueOffset + valueLength <= attributeLength) {
+                        value = attribute + valueOffset;
+                    } else {
+                        valueLength = 0;
+                    }
+                }
+
+                if (type == ATTR_STANDARD_INFORMATION && value && valueLength >= 36) {
+                    record.created = ReadLE64(value);
+                    record.modified = ReadLE64(value + 8);
+                    record.accessed = ReadLE64(value + 24);
+                    uint32_t attributes = ReadLE32(value + 32);
+                    record.isCompressed = record.isCompressed || (attributes & FILE_ATTRIBUTE_COMPRESSED) != 0;
+                    record.isEncrypted = (attributes & FILE_ATTRIBUTE_ENCRYPTED) != 0;
+                    haveTimes = true;
+                } else if (type == ATTR_FILE_NAME && value && valueLength >= 0x42) {
+                    size_t units = value[0x40];
+                    int rank = NamespaceRank(value[0x41]);
+                    if (rank > nameRank && 0x42 + units * 2 <= valueLength) {
+                        uint64_t parent = ReadLE64(value);
+                        record.parent = parent & MFT_RECORD_REFERENCE_MASK;
+                        record.parentSequence = static_cast<uint16_t>(parent >> 48);
+                        record.name = Utf16ToUtf8(value + 0x42, units);
+                        nameRank = rank;
+                        if (!haveTimes) {
+                            record.created = ReadLE64(value + 0x08);
+                            record.modified = ReadLE64(value + 0x10);
+                            record.accessed = ReadLE64(value + 0x20);
+                        }
+                    }
+                } else if (type == ATTR_DATA && nameLength == 0) {
+                    // Only the unnamed stream; alternate data streams are skipped
+                    record.hasData = true;
+                    if (!nonResident) {
+                        record.resident = true;
+                        record.dataSize = valueLength;
+                        if (value) {
+                            record.residentData.assign(value, value + valueLength);
+                        }
+                    } else if (attributeLength >= 0x40) {
+                        uint64_t startVcn = ReadLE64(attribute + 0x10);
+                        size_t runlistOffset = ReadLE16(attribute + 0x20);
+                        if (startVcn == 0) {
+                            record.dataSize = ReadLE64(attribute + 0x30);
+                        }
+                        record.isCompressed = record.isCompressed || (ReadLE16(attribute + 0x0C) & 0x00FF) != 0;
+                        if (runlistOffset < attributeLength &&
+                            !DecodeRunlist(attribute + runlistOffset, attributeLength - runlistOffset,
+                                           startVcn, record.runs)) {
+                            record.runs.clear();
+                        }
+                    }
+                }
+                position += attributeLength;
+            }
+            return true;
+        }
+
+        void NtfsScanner::LoadMft() {
+            AlignedBuffer boot(IO_ALIGNMENT);
+            Read(0, boot.Data(), boot.Size());
+            const uint64_t locations[] = {ReadLE64(boot.Data() + 0x30), ReadLE64(boot.Data() + 0x38)};
+
+            // Record 0 describes the $MFT itself; fall back to $MFTMirr
+            AlignedBuffer buffer(std::max<size_t>(recordSize, IO_ALIGNMENT));
+            for (uint64_t lcn : locations) {
+                if (lcn >= clusterCount) {
+                    continue;
+                }
+                if (Read(lcn * clusterSize, buffer.Data(), recordSize) < recordSize ||
+                    !ApplyFixups(buffer.Data(), recordSize)) {
+                    continue;
+                }
+                NtfsRecord record;
+                if (!ParseRecord(buffer.Data(), recordSize, 0, record) || record.resident || record.runs.empty()) {
+                    continue;
+                }
+
+                uint64_t mapped = 0;
+                for (const auto& run : record.runs) {
+                    mapped += run.clusters * clusterSize;
+                }
+                mftRuns = std::move(record.runs);
+                mftSize = std::min(record.dataSize, mapped);
+                mftSize -= mftSize % recordSize;
+                return;
+            }
+            throw FileSystemError("Unreadable $MFT on " + source.Path());
+        }
+
+        std::vector<RecoverableFile> NtfsScanner::ScanDeleted(const ProgressCallback& progress) {
+            std::unordered_map<uint64_t, DirectoryEntry> directories;
+            std::unordered_map<uint64_t, std::vector<NtfsRecord>> extensions;
+            std::vector<NtfsRecord> deleted;
+            NtfsRecord volumeBitmap;
+
+            std::vector<uint8_t> record(recordSize);
+            size_t partial = 0;
+            uint64_t number = 0;
+            uint64_t streamed = 0;
+            NtfsRecord parsed;
+
+            auto handleRecord = [&]() {
+                uint64_t current = number++;
+                if (!ApplyFixups(record.data(), recordSize) ||
+                    !ParseRecord(record.data(), recordSize, current, parsed)) {
+                    return;
+                }
+                if (current == VOLUME_BITMAP_RECORD) {
+                    volumeBitmap = parsed;
+                }
+                if (parsed.baseRecord != 0) {
+                    // Freed extension records keep the runs of large fragmented files
+                    if (!parsed.inUse && parsed.hasData) {
+                        extensions[parsed.baseRecord].push_back(std::move(parsed));
+                    }
+                } else if (parsed.isDirectory) {
+                    directories[current] = DirectoryEntry{parsed.name, parsed.parent, parsed.parentSequence,
+                                                          parsed.sequence, parsed.inUse};
+                } else if (!parsed.inUse && parsed.hasData && !parsed.name.empty()) {
+                    deleted.push_back(std::move(parsed));
+                }
+            };
+
+            for (const auto& run : mftRuns) {
+                if (streamed >= mftSize) {
+                    break;
+                }
+                uint64_t runBytes = std::min(run.clusters * clusterSize, mftSize - streamed);
+                streamed += runBytes;
+                if (run.sparse) {
+                    number += runBytes / recordSize;
+                    continue;
+                }
+
+                ReaderOptions options;
+                options.chunkSize = MFT_READ_CHUNK_SIZE;
+                options.startOffset = volumeOffset + run.lcn * clusterSize;
+                options.endOffset = options.startOffset + runBytes;
+                SectorReader reader(source, options);
+
+                SectorChunk chunk;
+                while (reader.Next(chunk)) {
+                    bytesRead += chunk.length;
+                    size_t position = 0;
+                    // Records straddle runs when clusters are smaller than records
+                    while (position < chunk.length) {
+                        size_t take = std::min<size_t>(recordSize - partial, chunk.length - position);
+                        std::memcpy(record.data() + partial, chunk.data + position, take);
+                        partial += take;
+                        position += take;
+                        if (partial == recordSize) {
+                            handleRecord();
+                            partial = 0;
+                        }
+                    }
+                    if (progress) {
+                        uint64_t done = std::min<uint64_t>(number * recordSize, mftSize);
+                        progress(static_cast<int>(done * 100 / std::max<uint64_t>(mftSize, 1)),
+                                 "Reading MFT records...");
+                    }
+                }
+            }
+
+            std::vector<uint8_t> bitmap;
+            if (volumeBitmap.hasData) {
+                uint64_t bitmapSize = std::min(volumeBitmap.dataSize, (clusterCount + 7) / 8);
+                bitmap = volumeBitmap.resident ? volumeBitmap.residentData
+                                               : ReadAttributeData(volumeBitmap.runs, bitmapSize);
+            }
+
+            std::vector<RecoverableFile> files;
+            files.reserve(deleted.size());
+            for (auto& entry : deleted) {
+                auto extension = extensions.find(entry.number);
+                if (!entry.resident && extension != extensions.end()) {
+                    for (auto& part : extension->second) {
+                        entry.runs.insert(entry.runs.end(), part.runs.begin(), part.runs.end());
+                        if (entry.dataSize == 0) {
+                            entry.dataSize = part.dataSize;
+                        }
+                    }
+                    std::sort(entry.runs.begin(), entry.runs.end(),
+                              [](const NtfsRun& a, const NtfsRun& b) { return a.vcn < b.vcn; });
+                }
+
+                // Runs outside the volume mean the record was overwritten with garbage
+                bool valid = true;
+                for (const auto& run : entry.runs) {
+                    valid = valid && (run.sparse || run.lcn + run.clusters <= clusterCount);
+                }
+                if (!valid || (!entry.resident && entry.dataSize > 0 && entry.runs.empty())) {
+                    continue;
+                }
+
+                RecoverableFile file;
+                file.fileName = entry.name;
+                file.originalPath = ResolvePath(entry.parent, entry.parentSequence, directories) + "\\" + entry.name;
+                file.fileType = ClassifyFileName(entry.name);
+                file.fileSize = entry.dataSize;
+                file.dateCreated = FileTimeToTimePoint(entry.created);
+                file.dateModified = FileTimeToTimePoint(entry.modified);
+                file.dateAccessed = FileTimeToTimePoint(entry.accessed);
+                file.isCompressed = entry.isCompressed;
+                file.isEncrypted = entry.isEncrypted;
+
+                if (entry.resident) {
+                    // Content lives in the freed record until it is reused
+                    file.inlineData.assign(entry.residentData.begin(), entry.residentData.end());
+                    file.recoveryConfidence = 0.95;
+                } else {
+                    std::vector<FileExtent> extents = ToExtents(entry.runs, entry.dataSize);
+                    file.extents.assign(extents.begin(), extents.end());
+                    double freeRatio = bitmap.empty() ? 0.6 : FreeClusterRatio(entry.runs, bitmap);
+                    file.recoveryConfidence = std::max(0.05, 0.95 * freeRatio);
+                }
+                if (file.isCompressed || file.isEncrypted) {
+                    file.recoveryConfidence *= 0.5;
+                }
+                files.push_back(std::move(file));
+            }
+
+            if (progress) {
+                progress(100, "Reading MFT records...");
+            }
+            return files;
+        }
+
+        std::vector<uint8_t> NtfsScanner::ReadAttributeData(const std::vector<NtfsRun>& runs, uint64_t size) {
+            std::vector<uint8_t> data(static_cast<size_t>(size), 0);
+            for (const auto& run : runs) {
+                uint64_t start = run.vcn * clusterSize;
+                if (run.sparse || start >= size) {
+                    continue;
+                }
+                size_t length = static_cast<size_t>(std::min(run.clusters * clusterSize, size - start));
+                Read(run.lcn * clusterSize, data.data() + start, length);
+            }
+            return data;
+        }
+
+        std::string NtfsScanner::ResolvePath(uint64_t parent, uint16_t parentSequence,
+                                             const std::unordered_map<uint64_t, DirectoryEntry>& directories) const {
+            std::vector<const std::string*> components;
+            for (size_t depth = 0; parent != ROOT_DIRECTORY_RECORD; depth++) {
+                auto entry = directories.find(parent);
+                // A freed directory's sequence was bumped when it was deleted
+                bool matches = entry != directories.end() &&
+                               (entry->second.sequence == parentSequence ||
+                                (!entry->second.inUse && static_cast<uint16_t>(entry->second.sequence - 1) == parentSequence));
+                if (!matches || depth == MAX_PATH_DEPTH) {
+                    components.clear();
+                    static const std::string orphan = "$Orphan";
+                    components.push_back(&orphan);
+                    break;
+                }
+                components.push_back(&entry->second.name);
+                parentSequence = entry->second.parentSequence;
+                parent = entry->second.parent;
+            }
+
+            std::string path;
+            for (auto it = components.rbegin(); it != components.rend(); ++it) {
+                path += "\\" + **it;
+            }
+            return path;
+        }
+
+        std::vector<FileExtent> NtfsScanner::ToExtents(const std::vector<NtfsRun>& runs, uint64_t dataSize) const {
+            std::vector<FileExtent> extents;
+            uint64_t remaining = dataSize;
+            for (const auto& run : runs) {
+                if (remaining == 0) {
+                    break;
+                }
+                uint64_t length = std::min(run.clusters * clusterSize, remaining);
+                uint64_t offset = run.sparse ? SPARSE_EXTENT : volumeOffset + run.lcn * clusterSize;
+                remaining -= length;
+
+                // Merge physically adjacent runs
+                if (!extents.empty()) {
+                    FileExtent& last = extents.back();
+                    bool bothSparse = last.offset == SPARSE_EXTENT && offset == SPARSE_EXTENT;
+                    bool adjacent = last.offset != SPARSE_EXTENT && offset == last.offset + last.length;
+                    if (bothSparse || adjacent) {
+                        last.length += length;
+                        continue;
+                    }
+                }
+                extents.push_back(FileExtent{offset, length});
+            }
+            return extents;
+        }
+
+        double NtfsScanner::FreeClusterRatio(const std::vector<NtfsRun>& runs, const std::vector<uint8_t>& bitmap) const {
+            uint64_t total = 0;
+            uint64_t unallocated = 0;
+            for (const auto& run : runs) {
+                if (run.sparse) {
+                    continue;
+                }
+                for (uint64_t lcn = run.lcn; lcn < run.lcn + run.clusters; lcn++) {
+                    size_t byte = static_cast<size_t>(lcn / 8);
+                    bool allocated = byte < bitmap.size() && (bitmap[byte] >> (lcn % 8)) & 1;
+                    unallocated += allocated ? 0 : 1;
+                }
+                total += run.clusters;
+            }
+            return total ? static_cast<double>(unallocated) / static_cast<double>(total) : 1.0;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
@@ -0,0 +1,125 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - NTFS Scanner
+ *
+ * Quick-scan backend for NTFS. The $MFT is located from the boot sector
+ * and streamed in large sequential reads; records that are no longer in
+ * use are decoded into deleted files with their $DATA runlists. Only
+ * metadata is read, never file content.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_NTFS_SCANNER_H
+#define STELLAR_NTFS_SCANNER_H
+
+#include "filesystem_scanner.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        // Run of a non-resident attribute; sparse runs have no clusters
+        struct NtfsRun {
+            uint64_t vcn;       // First virtual cluster in the attribute
+            uint64_t lcn;       // First logical cluster on the volume
+            uint64_t clusters;
+            bool sparse;
+        };
+
+        /**
+         * Attributes of one MFT record relevant to recovery
+         */
+        struct NtfsRecord {
+            uint64_t number = 0;
+            uint64_t baseRecord = 0;      // Non-zero for extension records
+            uint16_t sequence = 0;
+            bool inUse = false;
+            bool isDirectory = false;
+
+            std::string name;             // Best $FILE_NAME (Win32 over DOS)
+            uint64_t parent = 0;          // Parent directory record
+            uint16_t parentSequence = 0;
+            uint64_t created = 0;         // FILETIME values from $STANDARD_INFORMATION
+            uint64_t modified = 0;
+            uint64_t accessed = 0;
+            bool isCompressed = false;
+            bool isEncrypted = false;
+
+            bool hasData = false;         // Unnamed $DATA present
+            bool resident = false;
+            uint64_t dataSize = 0;
+            std::vector<uint8_t> residentData;
+            std::vector<NtfsRun> runs;
+        };
+
+        /**
+         * NTFS backend. The constructor validates the boot sector and loads
+         * the $MFT runlist from record 0.
+         */
+        class NtfsScanner : public FileSystemScanner {
+        public:
+            NtfsScanner(SectorSource& source, uint64_t volumeOffset = 0);
+
+            FileSystemType Type() const override { return FileSystemType::NTFS; }
+            std::vector<RecoverableFile> ScanDeleted(const ProgressCallback& progress = ProgressCallback()) override;
+
+            uint32_t ClusterSize() const { return clusterSize; }
+            uint32_t RecordSize() const { return recordSize; }
+            uint64_t ClusterCount() const { return clusterCount; }
+
+            // Checks the OEM id and geometry fields of a boot sector
+            static bool IsNtfsBootSector(const uint8_t* sector);
+
+            /**
+             * Verify and undo the update sequence of a record in place.
+             * Returns false for torn or corrupt records.
+             */
+            static bool ApplyFixups(uint8_t* record, size_t length);
+
+            /**
+             * Decode a mapping-pairs array into runs starting at startVcn.
+             * Returns false if the array is malformed.
+             */
+            static bool DecodeRunlist(const uint8_t* data, size_t length, uint64_t startVcn,
+                                      std::vector<NtfsRun>& runs);
+
+            /**
+             * Parse a fixed-up record. Returns false if it is not a file record.
+             */
+            static bool ParseRecord(const uint8_t* data, size_t length, uint64_t number, NtfsRecord& record);
+
+        private:
+            struct DirectoryEntry {
+                std::string name;
+                uint64_t parent;
+                uint16_t parentSequence;
+                uint16_t sequence;
+                bool inUse;
+            };
+
+            void LoadMft();
+            std::vector<uint8_t> ReadAttributeData(const std::vector<NtfsRun>& runs, uint64_t size);
+            std::string ResolvePath(uint64_t parent, uint16_t parentSequence,
+                                    const std::unordered_map<uint64_t, DirectoryEntry>& directories) const;
+            std::vector<FileExtent> ToExtents(const std::vector<NtfsRun>& runs, uint64_t dataSize) const;
+            double FreeClusterRatio(const std::vector<NtfsRun>& runs, const std::vector<uint8_t>& bitmap) const;
+
+            uint32_t sectorSize = 512;
+            uint32_t clusterSize = 4096;
+            uint32_t recordSize = 1024;
+            uint64_t clusterCount = 0;
+            uint64_t mftSize = 0;                // Bytes of $MFT holding records
+            std::vector<NtfsRun> mftRuns;
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_NTFS_SCANNER_H
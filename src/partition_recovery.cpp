@@ -0,0 +1,632 @@
+/**
+ * Stellar Data Recovery Pro Free - Partition Recovery
+ *
+ * MBR and GPT parsing, volume probing and layout selection.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "partition_recovery.h"
+#include "filesystem_scanner.h"
+#include "ntfs_scanner.h"
+#include "fat_scanner.h"
+#include "ext4_scanner.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            constexpr size_t PROBE_BYTES = 8 * 1024;       // Boot sector, ext superblock and FAT backups
+            constexpr uint32_t TRACK_SECTORS = 63;
+            constexpr uint32_t CYLINDER_SECTORS = 255 * 63;
+            constexpr size_t MAX_LOGICAL_PARTITIONS = 128;
+            constexpr uint32_t MAX_GPT_ENTRIES = 16384;
+            constexpr int SWEEP_COARSEST = 64;              // First sweep splits the disk this many ways
+
+            constexpr uint32_t EXT_INCOMPAT_64BIT = 0x80;
+
+            // IEEE 802.3 CRC32 as used by GPT
+            uint32_t Crc32(const uint8_t* data, size_t length) {
+                static const auto table = [] {
+                    std::vector<uint32_t> t(256);
+                    for (uint32_t i = 0; i < 256; i++) {
+                        uint32_t c = i;
+                        for (int k = 0; k < 8; k++) {
+                            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                        }
+                        t[i] = c;
+                    }
+                    return t;
+                }();
+                uint32_t crc = 0xFFFFFFFFu;
+                for (size_t i = 0; i < length; i++) {
+                    crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+                }
+                return crc ^ 0xFFFFFFFFu;
+            }
+
+            uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+                return (value + alignment - 1) / alignment * alignment;
+            }
+
+            bool IsExtended(uint8_t type) {
+                return type == 0x05 || type == 0x0F || type == 0x85;
+            }
+
+            // NTFS, FAT or exFAT boot sector; size is the volume length in bytes
+            bool ParseBootSector(const uint8_t* sector, FileSystemType& type, uint64_t& size) {
+                if (NtfsScanner::IsNtfsBootSector(sector)) {
+                    type = FileSystemType::NTFS;
+                    // The backup boot sector sits in the sector after the counted ones
+                    size = (ReadLE64(sector + 0x28) + 1) * ReadLE16(sector + 0x0B);
+                    return true;
+                }
+                FatVariant variant;
+                if (!FatScanner::DetectVariant(sector, variant)) {
+                    return false;
+                }
+                if (variant == FatVariant::EXFAT) {
+                    type = FileSystemType::EXFAT;
+                    size = ReadLE64(sector + 0x48) << sector[0x6C];
+                } else {
+                    type = variant == FatVariant::FAT32 ? FileSystemType::FAT32 : FileSystemType::FAT16;
+                    uint32_t totalSectors = ReadLE16(sector + 0x13) ? ReadLE16(sector + 0x13) : ReadLE32(sector + 0x20);
+                    size = static_cast<uint64_t>(totalSectors) * ReadLE16(sector + 0x0B);
+                }
+                return size != 0;
+            }
+
+            uint64_t ExtBlockSize(const uint8_t* superblock) {
+                uint32_t shift = ReadLE32(superblock + 0x18);
+                return shift <= 6 ? 1024ull << shift : 0;
+            }
+
+            uint64_t ExtVolumeSize(const uint8_t* superblock) {
+                uint64_t blocks = ReadLE32(superblock + 0x04);
+                if (ReadLE32(superblock + 0x60) & EXT_INCOMPAT_64BIT) {
+                    blocks |= static_cast<uint64_t>(ReadLE32(superblock + 0x150)) << 32;
+                }
+                return blocks * ExtBlockSize(superblock);
+            }
+
+            // Byte offset of the superblock copy of group within its volume
+            uint64_t ExtSuperblockOffset(const uint8_t* superblock, uint32_t group) {
+                if (group == 0) {
+                    return 1024;
+                }
+                uint64_t firstDataBlock = ReadLE32(superblock + 0x14);
+                uint64_t blocksPerGroup = ReadLE32(superblock + 0x20);
+                return (group * blocksPerGroup + firstDataBlock) * ExtBlockSize(superblock);
+            }
+
+        } // namespace
+
+        PartitionRecovery::PartitionRecovery(SectorSource& source, const PartitionSearchOptions& options)
+            : source(source),
+              options(options),
+              pool(options.workers ? options.workers : GetDefaultWorkerCount()) {
+            if (this->options.sectorSize < 512) {
+                this->options.sectorSize = 512;
+            }
+            if (this->options.minStride < this->options.sectorSize) {
+                this->options.minStride = this->options.sectorSize;
+            }
+        }
+
+        PartitionScan PartitionRecovery::Scan(const ProgressCallback& progress) {
+            auto report = [&](int percentage, const std::string& operation) {
+                if (progress) {
+                    progress(percentage, operation);
+                }
+            };
+
+            candidates.clear();
+            probed.clear();
+            probes = 0;
+            bytesRead = 0;
+
+            const uint64_t sectorSize = options.sectorSize;
+            const uint64_t diskSize = source.Size();
+            PartitionScan scan;
+
+            report(0, "Reading partition tables");
+            ParseMbr(scan);
+
+            // Confirm every listed partition, from its start or its last sector
+            std::vector<uint64_t> seeds = {0, TRACK_SECTORS * sectorSize, 128 * sectorSize, 1 * MiB};
+            std::vector<uint64_t> ends;
+            for (const RecoveredPartition& entry : scan.table) {
+                seeds.push_back(entry.offset);
+                if (entry.size >= sectorSize) {
+                    ends.push_back(entry.offset + entry.size - sectorSize);
+                }
+            }
+            ProbeAll(seeds);
+            ProbeAll(ends, true);
+
+            // Volumes usually follow each other: chase the end of each one found,
+            // and look for an NTFS backup boot sector just before its start
+            auto chase = [&] {
+                size_t fresh;
+                do {
+                    fresh = ProbeAll(ChainOffsets());
+                    std::vector<uint64_t> before;
+                    for (const RecoveredPartition& candidate : candidates) {
+                        if (candidate.fileSystem != FileSystemType::UNKNOWN && candidate.offset >= sectorSize) {
+                            before.push_back(candidate.offset - sectorSize);
+                        }
+                    }
+                    fresh += ProbeAll(before, true);
+                } while (fresh != 0);
+            };
+            chase();
+            report(10, "Searching for volumes");
+
+            // Coarse-to-fine sweep of the space no volume accounts for
+            if (options.probeBudget != 0 && diskSize > 0) {
+                uint64_t stride = options.minStride;
+                while (stride < diskSize / SWEEP_COARSEST) {
+                    stride *= 2;
+                }
+                const uint64_t track = TRACK_SECTORS * sectorSize;
+                const uint64_t cylinder = CYLINDER_SECTORS * sectorSize;
+                size_t budget = options.probeBudget;
+                int pass = 0;
+                int passes = 1;
+                for (uint64_t s = stride; s > options.minStride; s /= 2) {
+                    passes++;
+                }
+
+                for (; stride >= options.minStride && budget != 0; stride /= 2, pass++) {
+                    std::vector<uint64_t> offsets;
+                    uint64_t cylinderStep = std::max<uint64_t>(1, stride / cylinder) * cylinder;
+                    // DOS-era tools start volumes on a cylinder or one track past it
+                    const std::pair<uint64_t, uint64_t> grids[] = {
+                        {stride, stride}, {cylinderStep, cylinderStep}, {cylinderStep + track, cylinderStep}
+                    };
+                    for (const auto& [first, grid] : grids) {
+                        for (uint64_t offset = first; offset < diskSize && offsets.size() < budget; offset += grid) {
+                            if (probed.count(offset) == 0 && !Covered(offset)) {
+                                offsets.push_back(offset);
+                            }
+                        }
+                    }
+                    budget -= ProbeAll(offsets);
+                    chase();
+                    report(10 + 85 * (pass + 1) / passes, "Searching for volumes");
+                    if (stride == options.minStride) {
+                        break;
+                    }
+                }
+            }
+
+            // Merge what the table and the probes say about each volume
+            std::map<uint64_t, std::vector<RecoveredPartition>> byOffset;
+            for (const RecoveredPartition& candidate : candidates) {
+                byOffset[candidate.offset].push_back(candidate);
+            }
+            std::vector<RecoveredPartition> merged;
+            for (auto& [offset, list] : byOffset) {
+                std::vector<RecoveredPartition> volumes;
+                RecoveredPartition listed;
+                for (const RecoveredPartition& candidate : list) {
+                    if (candidate.InTable()) {
+                        listed.offset = offset;
+                        listed.size = std::max(listed.size, candidate.size);
+                        listed.evidence |= candidate.evidence;
+                        listed.name = candidate.name.empty() ? listed.name : candidate.name;
+                        listed.mbrType = candidate.mbrType ? candidate.mbrType : listed.mbrType;
+                        continue;
+                    }
+                    auto same = std::find_if(volumes.begin(), volumes.end(), [&](const RecoveredPartition& v) {
+                        return v.fileSystem == candidate.fileSystem;
+                    });
+                    if (same == volumes.end()) {
+                        volumes.push_back(candidate);
+                    } else {
+                        same->evidence |= candidate.evidence;
+                        same->size = std::max(same->size, candidate.size);
+                    }
+                }
+                if (volumes.empty()) {
+                    listed.score = 0.25;
+                    merged.push_back(listed);
+                    continue;
+                }
+                for (RecoveredPartition volume : volumes) {
+                    double score = 0;
+                    if (volume.evidence & EVIDENCE_BOOT_SECTOR) {
+                        score += 0.45;
+                    }
+                    if (volume.evidence & EVIDENCE_BACKUP_BOOT) {
+                        score += 0.25;
+                    }
+                    if (listed.evidence) {
+                        score += 0.25;
+                        // A volume may end short of its partition, never past it
+                        if (volume.size <= listed.size && listed.size - volume.size < 1 * MiB) {
+                            score += 0.1;
+                        }
+                        volume.evidence |= listed.evidence;
+                        volume.name = listed.name;
+                        volume.mbrType = listed.mbrType;
+                    }
+                    if (offset % MiB == 0 || offset % (TRACK_SECTORS * sectorSize) == 0) {
+                        score += 0.05;
+                    }
+                    if (offset + volume.size > diskSize) {
+                        score *= 0.3;
+                    }
+                    volume.score = std::min(score, 1.0);
+                    merged.push_back(volume);
+                }
+            }
+
+            scan.layout = ChooseLayout(std::move(merged));
+            for (const RecoveredPartition& partition : scan.layout) {
+                // Entries without a known volume (swap, LVM) are fine; volumes the table lost are not
+                if (scan.scheme != PartitionScheme::NONE && !partition.InTable()) {
+                    scan.tableDamaged = true;
+                }
+            }
+            scan.probes = probes;
+            scan.bytesRead = bytesRead;
+            report(100, "Partition search complete");
+            return scan;
+        }
+
+        void PartitionRecovery::ParseMbr(PartitionScan& scan) {
+            const uint64_t sectorSize = options.sectorSize;
+            std::vector<uint8_t> sector(sectorSize, 0);
+            try {
+                source.ReadAt(0, sector.data(), sectorSize);
+            } catch (const SectorReadError&) {
+                scan.tableDamaged = true;
+            }
+
+            // A volume without a table (superfloppy) is found by the probes
+            FileSystemType type;
+            uint64_t size;
+            if (ParseBootSector(sector.data(), type, size)) {
+                return;
+            }
+
+            bool signature = sector[510] == 0x55 && sector[511] == 0xAA;
+            bool protective = false;
+            std::vector<RecoveredPartition> entries;
+            for (int i = 0; signature && i < 4; i++) {
+                const uint8_t* entry = sector.data() + 446 + 16 * i;
+                uint8_t partitionType = entry[4];
+                uint64_t start = ReadLE32(entry + 8);
+                uint64_t count = ReadLE32(entry + 12);
+                if (partitionType == 0 || start == 0 || count == 0) {
+                    continue;
+                }
+                if (partitionType == 0xEE) {
+                    protective = true;
+                    continue;
+                }
+                if (!IsExtended(partitionType)) {
+                    RecoveredPartition partition;
+                    partition.offset = start * sectorSize;
+                    partition.size = count * sectorSize;
+                    partition.evidence = EVIDENCE_MBR;
+                    partition.mbrType = partitionType;
+                    entries.push_back(partition);
+                    continue;
+                }
+
+                // Logical partitions: each EBR lists one and links the next
+                std::vector<uint8_t> ebr(sectorSize);
+                uint64_t current = start;
+                for (size_t n = 0; n < MAX_LOGICAL_PARTITIONS; n++) {
+                    try {
+                        if (source.ReadAt(current * sectorSize, ebr.data(), sectorSize) < sectorSize) {
+                            break;
+                        }
+                    } catch (const SectorReadError&) {
+                        scan.tableDamaged = true;
+                        break;
+                    }
+                    if (ebr[510] != 0x55 || ebr[511] != 0xAA) {
+                        scan.tableDamaged = true;
+                        break;
+                    }
+                    const uint8_t* logical = ebr.data() + 446;
+                    const uint8_t* next = ebr.data() + 446 + 16;
+                    if (logical[4] != 0 && ReadLE32(logical + 8) != 0 && ReadLE32(logical + 12) != 0) {
+                        RecoveredPartition partition;
+                        partition.offset = (current + ReadLE32(logical + 8)) * sectorSize;
+                        partition.size = static_cast<uint64_t>(ReadLE32(logical + 12)) * sectorSize;
+                        partition.evidence = EVIDENCE_MBR;
+                        partition.mbrType = logical[4];
+                        entries.push_back(partition);
+                    }
+                    if (!IsExtended(next[4]) || ReadLE32(next + 8) == 0) {
+                        break;
+                    }
+                    uint64_t following = start + ReadLE32(next + 8);
+                    if (following <= current) {
+                        scan.tableDamaged = true;
+                        break;
+                    }
+                    current = following;
+                }
+            }
+
+            // GPT is tried even without a protective MBR, which is often what got wiped
+            bool primary = ParseGpt(1, true, scan);
+            uint64_t lastLba = source.Size() / sectorSize;
+            bool backup = lastLba > 1 && ParseGpt(lastLba - 1, false, scan);
+            if (primary || backup) {
+                scan.scheme = PartitionScheme::GPT;
+                scan.tableDamaged |= !(primary && backup) || !protective;
+                return;
+            }
+            if (protective) {
+                scan.tableDamaged = true;
+            }
+            if (!entries.empty()) {
+                scan.scheme = PartitionScheme::MBR;
+                scan.table = entries;
+                for (const RecoveredPartition& entry : entries) {
+                    AddCandidate(entry);
+                }
+            } else if (!signature) {
+                scan.tableDamaged = true;
+            }
+        }
+
+        bool PartitionRecovery::ParseGpt(uint64_t headerLba, bool primary, PartitionScan& scan) {
+            const uint64_t sectorSize = options.sectorSize;
+            std::vector<uint8_t> header(sectorSize);
+            try {
+                if (source.ReadAt(headerLba * sectorSize, header.data(), sectorSize) < sectorSize) {
+                    return false;
+                }
+            } catch (const SectorReadError&) {
+                return false;
+            }
+            if (std::memcmp(header.data(), "EFI PART", 8) != 0) {
+                return false;
+            }
+            uint32_t headerSize = ReadLE32(header.data() + 12);
+            if (headerSize < 92 || headerSize > sectorSize || ReadLE64(header.data() + 24) != headerLba) {
+                return false;
+            }
+            uint32_t headerCrc = ReadLE32(header.data() + 16);
+            std::memset(header.data() + 16, 0, 4);
+            if (Crc32(header.data(), headerSize) != headerCrc) {
+                return false;
+            }
+
+            uint64_t entriesLba = ReadLE64(header.data() + 72);
+            uint32_t entryCount = ReadLE32(header.data() + 80);
+            uint32_t entrySize = ReadLE32(header.data() + 84);
+            if (entryCount > MAX_GPT_ENTRIES || entrySize < 128 || entrySize > 4096 || entrySize % 8 != 0) {
+                return false;
+            }
+            std::vector<uint8_t> array(static_cast<size_t>(entryCount) * entrySize);
+            try {
+                if (source.ReadAt(entriesLba * sectorSize, array.data(), array.size()) < array.size()) {
+                    return false;
+                }
+            } catch (const SectorReadError&) {
+                return false;
+            }
+            if (Crc32(array.data(), array.size()) != ReadLE32(header.data() + 88)) {
+                return false;
+            }
+
+            std::vector<RecoveredPartition> entries;
+            static const uint8_t unused[16] = {};
+            for (uint32_t i = 0; i < entryCount; i++) {
+                const uint8_t* entry = array.data() + static_cast<size_t>(i) * entrySize;
+                uint64_t first = ReadLE64(entry + 32);
+                uint64_t last = ReadLE64(entry + 40);
+                if (std::memcmp(entry, unused, 16) == 0 || last < first) {
+                    continue;
+                }
+                RecoveredPartition partition;
+                partition.offset = first * sectorSize;
+                partition.size = (last - first + 1) * sectorSize;
+                partition.evidence = primary ? EVIDENCE_GPT_PRIMARY : EVIDENCE_GPT_BACKUP;
+                std::string name = Utf16ToUtf8(entry + 56, 36);
+                partition.name = name.substr(0, name.find('\0'));
+                entries.push_back(partition);
+                AddCandidate(partition);
+            }
+            // The primary copy wins when both are valid
+            if (scan.table.empty()) {
+                scan.table = entries;
+            }
+            return true;
+        }
+
+        void PartitionRecovery::Probe(uint64_t offset, bool volumeEnd) {
+            const uint64_t sectorSize = options.sectorSize;
+            const uint64_t diskSize = source.Size();
+            std::vector<uint8_t> data(PROBE_BYTES, 0);
+            size_t got = 0;
+            try {
+                got = source.ReadAt(offset, data.data(), data.size());
+            } catch (const SectorReadError&) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                probes++;
+                bytesRead += got;
+            }
+            if (got < 512) {
+                return;
+            }
+
+            auto add = [&](uint64_t start, FileSystemType type, uint64_t size, uint32_t evidence) {
+                if (size == 0 || start >= diskSize) {
+                    return;
+                }
+                RecoveredPartition partition;
+                partition.offset = start;
+                partition.size = size;
+                partition.fileSystem = type;
+                partition.evidence = evidence;
+                AddCandidate(partition);
+            };
+
+            FileSystemType type;
+            uint64_t size;
+            if (volumeEnd) {
+                // NTFS keeps a copy of its boot sector in the last sector of the partition
+                if (NtfsScanner::IsNtfsBootSector(data.data()) && ParseBootSector(data.data(), type, size) &&
+                    size <= offset + sectorSize) {
+                    add(offset + sectorSize - size, type, size, EVIDENCE_BACKUP_BOOT);
+                }
+                return;
+            }
+
+            if (ParseBootSector(data.data(), type, size)) {
+                add(offset, type, size, EVIDENCE_BOOT_SECTOR);
+            } else {
+                // FAT32 backup boot sector in sector 6, exFAT backup region from sector 12
+                FatVariant variant;
+                for (uint64_t backup : {6 * sectorSize, 12 * sectorSize}) {
+                    if (backup + 512 <= got && FatScanner::DetectVariant(data.data() + backup, variant) &&
+                        (variant == FatVariant::FAT32) == (backup == 6 * sectorSize) &&
+                        ParseBootSector(data.data() + backup, type, size)) {
+                        add(offset, type, size, EVIDENCE_BACKUP_BOOT);
+                    }
+                }
+            }
+
+            if (got >= 2048 && Ext4Scanner::IsExtSuperblock(data.data() + 1024) &&
+                ReadLE16(data.data() + 1024 + 0x5A) == 0) {
+                add(offset, Ext4Scanner::TypeFromSuperblock(data.data() + 1024), ExtVolumeSize(data.data() + 1024),
+                    EVIDENCE_BOOT_SECTOR);
+            }
+            // Backup superblocks start their block when blocks are 2 KiB or larger
+            if (Ext4Scanner::IsExtSuperblock(data.data())) {
+                uint32_t group = ReadLE16(data.data() + 0x5A);
+                uint64_t within = ExtSuperblockOffset(data.data(), group);
+                if (group != 0 && within <= offset) {
+                    add(offset - within, Ext4Scanner::TypeFromSuperblock(data.data()), ExtVolumeSize(data.data()),
+                        EVIDENCE_BACKUP_BOOT);
+                }
+            }
+        }
+
+        size_t PartitionRecovery::ProbeAll(const std::vector<uint64_t>& offsets, bool volumeEnd) {
+            const uint64_t sectorSize = options.sectorSize;
+            const uint64_t diskSize = source.Size();
+            std::vector<uint64_t> fresh;
+            for (uint64_t offset : offsets) {
+                if (offset % sectorSize != 0 || offset >= diskSize) {
+                    continue;
+                }
+                // Start and end probes of the same sector look for different things
+                uint64_t key = volumeEnd ? offset | 1 : offset;
+                if (probed.insert(key).second) {
+                    fresh.push_back(offset);
+                }
+            }
+            for (size_t i = 0; i < fresh.size(); i++) {
+                uint64_t offset = fresh[i];
+                pool.Submit(i % pool.WorkerCount(), [this, offset, volumeEnd](size_t) {
+                    Probe(offset, volumeEnd);
+                });
+            }
+            pool.WaitIdle();
+            return fresh.size();
+        }
+
+        void PartitionRecovery::AddCandidate(const RecoveredPartition& partition) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (RecoveredPartition& existing : candidates) {
+                if (existing.offset == partition.offset && existing.fileSystem == partition.fileSystem &&
+                    existing.InTable() == partition.InTable()) {
+                    existing.evidence |= partition.evidence;
+                    existing.size = std::max(existing.size, partition.size);
+                    if (existing.name.empty()) {
+                        existing.name = partition.name;
+                    }
+                    return;
+                }
+            }
+            candidates.push_back(partition);
+        }
+
+        std::vector<uint64_t> PartitionRecovery::ChainOffsets() {
+            const uint64_t sectorSize = options.sectorSize;
+            const uint64_t track = TRACK_SECTORS * sectorSize;
+            const uint64_t cylinder = CYLINDER_SECTORS * sectorSize;
+            std::vector<uint64_t> offsets;
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const RecoveredPartition& candidate : candidates) {
+                if (candidate.fileSystem == FileSystemType::UNKNOWN) {
+                    continue;
+                }
+                uint64_t end = candidate.offset + candidate.size;
+                // Next primary partition, or the logical one a track or 1 MiB past its EBR
+                for (uint64_t start : {end, AlignUp(end, track), AlignUp(end, cylinder), AlignUp(end, 1 * MiB)}) {
+                    offsets.push_back(start);
+                    offsets.push_back(start + track);
+                    offsets.push_back(start + 1 * MiB);
+                }
+            }
+            return offsets;
+        }
+
+        bool PartitionRecovery::Covered(uint64_t offset) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const RecoveredPartition& candidate : candidates) {
+                if ((candidate.evidence & EVIDENCE_BOOT_SECTOR) && offset >= candidate.offset &&
+                    offset - candidate.offset < candidate.size) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::vector<RecoveredPartition> PartitionRecovery::ChooseLayout(std::vector<RecoveredPartition> merged) const {
+            // Weighted interval scheduling: the non-overlapping set with the highest total score
+            merged.erase(std::remove_if(merged.begin(), merged.end(),
+                                        [](const RecoveredPartition& p) { return p.size == 0; }),
+                         merged.end());
+            std::sort(merged.begin(), merged.end(), [](const RecoveredPartition& a, const RecoveredPartition& b) {
+                return a.offset + a.size < b.offset + b.size;
+            });
+
+            size_t count = merged.size();
+            std::vector<double> best(count + 1, 0);
+            std::vector<size_t> previous(count);
+            for (size_t i = 0; i < count; i++) {
+                // Last candidate ending at or before this one starts
+                auto it = std::upper_bound(merged.begin(), merged.begin() + i, merged[i].offset,
+                                           [](uint64_t start, const RecoveredPartition& p) {
+                                               return start < p.offset + p.size;
+                                           });
+                previous[i] = static_cast<size_t>(it - merged.begin());
+                best[i + 1] = std::max(best[i], best[previous[i]] + merged[i].score);
+            }
+
+            std::vector<RecoveredPartition> layout;
+            for (size_t i = count; i > 0;) {
+                if (best[i] == best[i - 1]) {
+                    i--;
+                } else {
+                    layout.push_back(merged[i - 1]);
+                    i = previous[i - 1];
+                }
+            }
+            std::reverse(layout.begin(), layout.end());
+            return layout;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
@@ -0,0 +1,131 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Partition Recovery
+ *
+ * Rebuilds the partition layout of a disk. The MBR (with its extended
+ * partition chain) and both GPT copies are parsed and checked; then
+ * volume boot sectors and superblocks are probed to confirm the table
+ * and to find partitions it no longer lists. Probing never reads the
+ * whole disk: it starts at the usual partition starts and at the end of
+ * every volume already found, then samples the remaining gaps on 1 MiB
+ * and cylinder (63-sector track) boundaries, coarse to fine, on the scan
+ * thread pool until a probe budget is spent. Every candidate volume is
+ * scored, and the best non-overlapping set becomes the recovered layout.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_PARTITION_RECOVERY_H
+#define STELLAR_PARTITION_RECOVERY_H
+
+#include "stellar_recovery.h"
+#include "sector_reader.h"
+#include "file_signatures.h"
+#include "scan_scheduler.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        enum class PartitionScheme {
+            NONE,           // No valid table
+            MBR,
+            GPT
+        };
+
+        // Evidence a partition was found by; a candidate can have several
+        enum PartitionEvidence : uint32_t {
+            EVIDENCE_MBR = 0x01,
+            EVIDENCE_GPT_PRIMARY = 0x02,
+            EVIDENCE_GPT_BACKUP = 0x04,
+            EVIDENCE_BOOT_SECTOR = 0x08,        // Boot sector or superblock at the start
+            EVIDENCE_BACKUP_BOOT = 0x10         // Backup boot sector or backup superblock
+        };
+
+        struct RecoveredPartition {
+            uint64_t offset;                    // Byte offset on the disk
+            uint64_t size;                      // Bytes; from the volume when it was probed
+            FileSystemType fileSystem;          // UNKNOWN for table entries without a readable volume
+            uint32_t evidence;                  // PartitionEvidence bits
+            double score;                       // 0.0 to 1.0
+            std::string name;                   // GPT partition name
+            uint8_t mbrType;                    // MBR type byte; 0 for GPT entries
+
+            RecoveredPartition() :
+                offset(0), size(0), fileSystem(FileSystemType::UNKNOWN), evidence(0), score(0), mbrType(0) {}
+
+            bool InTable() const { return (evidence & (EVIDENCE_MBR | EVIDENCE_GPT_PRIMARY | EVIDENCE_GPT_BACKUP)) != 0; }
+        };
+
+        struct PartitionSearchOptions {
+            uint32_t sectorSize;                // Logical sector size of the disk
+            uint64_t minStride;                 // Finest sampling step of the gap search
+            size_t probeBudget;                 // Gap probes allowed; 0 searches the table only
+            size_t workers;                     // 0 = GetDefaultWorkerCount()
+
+            PartitionSearchOptions() :
+                sectorSize(512),
+                minStride(1 * MiB),
+                probeBudget(65536),
+                workers(0) {}
+        };
+
+        struct PartitionScan {
+            PartitionScheme scheme;
+            bool tableDamaged;                  // A table copy failed its checks or disagreed with the volumes
+            std::vector<RecoveredPartition> table;      // Entries of the valid table, in table order
+            std::vector<RecoveredPartition> layout;     // Best-scoring set of volumes, by offset
+            uint64_t probes;
+            uint64_t bytesRead;
+
+            PartitionScan() : scheme(PartitionScheme::NONE), tableDamaged(false), probes(0), bytesRead(0) {}
+        };
+
+        /**
+         * Partition table parser and volume search for one disk
+         */
+        class PartitionRecovery {
+        public:
+            PartitionRecovery(SectorSource& source, const PartitionSearchOptions& options = PartitionSearchOptions());
+
+            /**
+             * Parse the tables and search for volumes. Read errors on a
+             * probe only skip that probe. progress is called from the
+             * calling thread.
+             */
+            PartitionScan Scan(const ProgressCallback& progress = ProgressCallback());
+
+        private:
+            void ParseMbr(PartitionScan& scan);
+            bool ParseGpt(uint64_t headerLba, bool primary, PartitionScan& scan);
+            // volumeEnd: offset is the last sector of a listed partition
+            void Probe(uint64_t offset, bool volumeEnd);
+            // Probe offsets not probed before; returns how many were new
+            size_t ProbeAll(const std::vector<uint64_t>& offsets, bool volumeEnd = false);
+            void AddCandidate(const RecoveredPartition& partition);
+            std::vector<uint64_t> ChainOffsets();
+            bool Covered(uint64_t offset);
+            std::vector<RecoveredPartition> ChooseLayout(std::vector<RecoveredPartition> merged) const;
+
+            SectorSource& source;
+            PartitionSearchOptions options;
+            WorkStealingPool pool;
+
+            std::mutex mutex;                   // Guards the fields below during probing
+            std::vector<RecoveredPartition> candidates;
+            std::unordered_set<uint64_t> probed;
+            uint64_t probes = 0;
+            uint64_t bytesRead = 0;
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_PARTITION_RECOVERY_H
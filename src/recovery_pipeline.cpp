@@ -0,0 +1,917 @@
+/**
+ * Stellar Data Recovery Pro Free - Recovery Pipeline
+ *
+ * Segment planning, stage threads and output file management.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "recovery_pipeline.h"
+#include "file_signatures.h"
+#include "extent_copier.h"
+#include "disk_imager.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            // Output files are guarded by striped locks rather than one per file
+            constexpr size_t LOCK_STRIPES = 64;
+            constexpr size_t QUEUE_DEPTH = 64;
+            constexpr size_t DIRECT_PROBE = 4096;     // Bytes read of a kernel-copied file for verification
+            constexpr size_t REHASH_CHUNK = 1024 * 1024;
+
+            /**
+             * Blocking queue between two stages. Push waits while the queue is
+             * full; Pop returns false once the queue is closed and drained.
+             */
+            template <typename T>
+            class BoundedQueue {
+            public:
+                explicit BoundedQueue(size_t capacity) : capacity(capacity) {}
+
+                void Push(T value) {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    notFull.wait(lock, [this]() { return queue.size() < capacity; });
+                    queue.push_back(std::move(value));
+                    notEmpty.notify_one();
+                }
+
+                bool Pop(T& value) {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    notEmpty.wait(lock, [this]() { return closed || !queue.empty(); });
+                    if (queue.empty()) {
+                        return false;
+                    }
+                    value = std::move(queue.front());
+                    queue.pop_front();
+                    notFull.notify_one();
+                    return true;
+                }
+
+                void Close() {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    closed = true;
+                    notEmpty.notify_all();
+                }
+
+            private:
+                std::mutex mutex;
+                std::condition_variable notEmpty;
+                std::condition_variable notFull;
+                std::deque<T> queue;
+                size_t capacity;
+                bool closed = false;
+            };
+
+            /**
+             * Bytes of file data allowed in flight. A request larger than
+             * the whole budget is admitted once nothing else is held.
+             */
+            class MemoryBudget {
+            public:
+                explicit MemoryBudget(size_t limit) : limit(std::max<size_t>(limit, 1)) {}
+
+                void Acquire(size_t bytes) {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    released.wait(lock, [this, bytes]() { return used == 0 || used + bytes <= limit; });
+                    used += bytes;
+                }
+
+                void Release(size_t bytes) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    used -= bytes;
+                    released.notify_all();
+                }
+
+            private:
+                std::mutex mutex;
+                std::condition_variable released;
+                size_t limit;
+                size_t used = 0;
+            };
+
+            struct Segment {
+                size_t item;
+                uint64_t fileOffset;
+                size_t length;
+                uint64_t physical;      // Source offset of the first byte; 0 for inline or sparse data
+            };
+
+            // Data of one segment moving through the stages
+            struct Block {
+                size_t segment = 0;
+                AlignedBuffer storage;
+                const uint8_t* data = nullptr;
+                size_t charged = 0;     // Bytes taken from the budget
+                bool direct = false;    // Moved by the extent copier; data holds at most DIRECT_PROBE bytes
+                bool damaged = false;
+                uint64_t badOffset = 0;
+            };
+
+            struct FileState {
+                std::unique_ptr<std::fstream> out;    // Read back only to hash out-of-order segments
+                std::unique_ptr<DirectOutput> direct;
+                std::string path;
+                std::unique_ptr<FileHasher> hasher;
+                uint64_t hashed = 0;                    // File bytes fed to the hasher
+                std::map<uint64_t, size_t> unhashed;    // Written segments past hashed, by file offset
+                size_t remaining = 0;   // Segments not yet written
+                bool damaged = false;
+                bool rejected = false;
+                bool failed = false;
+                std::string error;
+            };
+
+            std::string LowerExtension(const std::string& name) {
+                size_t dot = name.find_last_of('.');
+                std::string extension = dot == std::string::npos ? std::string() : name.substr(dot);
+                for (char& c : extension) {
+                    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                }
+                return extension;
+            }
+
+            /**
+             * Whether the start of a file matches a signature registered for
+             * its extension. Extensions without a signature always pass.
+             */
+            bool MatchesSignature(const std::string& name, const uint8_t* data, size_t length) {
+                static const auto byExtension = []() {
+                    std::unordered_map<std::string, std::vector<const FileSignature*>> table;
+                    for (const FileSignature& signature : FILE_SIGNATURES) {
+                        table[signature.extension].push_back(&signature);
+                    }
+                    return table;
+                }();
+
+                auto found = byExtension.find(LowerExtension(name));
+                if (found == byExtension.end()) {
+                    return true;
+                }
+                for (const FileSignature* signature : found->second) {
+                    size_t end = static_cast<size_t>(signature->headerOffset) + signature->headerLength;
+                    if (end <= length && std::memcmp(data + signature->headerOffset, signature->header,
+                                                     signature->headerLength) == 0) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            // Source offset holding a file byte, or 0 when it is not on the source
+            uint64_t PhysicalOffset(const RecoveryItem& item, uint64_t fileOffset) {
+                uint64_t position = 0;
+                for (const auto& extent : item.extents) {
+                    if (fileOffset < position + extent.length) {
+                        return extent.offset == SPARSE_EXTENT ? 0 : extent.offset + (fileOffset - position);
+                    }
+                    position += extent.length;
+                }
+                return 0;
+            }
+
+            // Whether file bytes [offset, offset + length) lie in one run on the source
+            bool IsContiguous(const RecoveryItem& item, uint64_t offset, size_t length, uint64_t& physical) {
+                uint64_t position = 0;
+                for (const auto& extent : item.extents) {
+                    if (offset < position + extent.length) {
+                        physical = extent.offset + (offset - position);
+                        return extent.offset != SPARSE_EXTENT && offset + length <= position + extent.length;
+                    }
+                    position += extent.length;
+                }
+                return false;
+            }
+
+            constexpr uint64_t NO_OFFSET = ~0ull;
+
+            // First source byte of the file's data that the imager did not rescue, or NO_OFFSET
+            uint64_t UnrescuedOffset(const RescueMap& map, const RecoveryItem& item) {
+                uint64_t remaining = item.fileSize;
+                for (const FileExtent& extent : item.extents) {
+                    if (remaining == 0) {
+                        break;
+                    }
+                    const uint64_t length = std::min(extent.length, remaining);
+                    remaining -= length;
+                    if (extent.offset == SPARSE_EXTENT) {
+                        continue;
+                    }
+                    const uint64_t unfinished = map.Unfinished(extent.offset, length);
+                    if (unfinished != extent.offset + length) {
+                        return unfinished;
+                    }
+                }
+                return NO_OFFSET;
+            }
+
+            /**
+             * Copy file bytes [offset, offset + length) into out. Holes,
+             * bytes past the last extent and unreadable runs read as zeros.
+             */
+            uint64_t ReadRange(SectorSource& source, const RecoveryItem& item, uint64_t offset,
+                               size_t length, uint8_t* out, Block& block, uint64_t& reads) {
+                const uint64_t end = offset + length;
+                uint64_t position = 0;
+                uint64_t bytesRead = 0;
+                for (const auto& extent : item.extents) {
+                    if (position >= end) {
+                        break;
+                    }
+                    uint64_t extentEnd = position + extent.length;
+                    if (extentEnd > offset) {
+                        uint64_t from = std::max(position, offset);
+                        size_t count = static_cast<size_t>(std::min(extentEnd, end) - from);
+                        uint8_t* target = out + (from - offset);
+                        if (extent.offset == SPARSE_EXTENT) {
+                            std::memset(target, 0, count);
+                        } else {
+                            uint64_t physical = extent.offset + (from - position);
+                            size_t got = 0;
+                            reads++;
+                            try {
+                                got = source.ReadAt(physical, target, count);
+                            } catch (const SectorReadError& e) {
+                                block.badOffset = block.damaged ? block.badOffset : e.Offset();
+                                block.damaged = true;
+                            }
+                            if (got < count) {
+                                std::memset(target + got, 0, count - got);
+                                if (!block.damaged) {
+                                    block.badOffset = physical + got;
+                                    block.damaged = true;
+                                }
+                            }
+                            bytesRead += got;
+                        }
+                    }
+                    position = extentEnd;
+                }
+                if (position < end) {
+                    uint64_t from = std::max(position, offset);
+                    std::memset(out + (from - offset), 0, static_cast<size_t>(end - from));
+                }
+                return bytesRead;
+            }
+
+            /**
+             * Append the on-disk parts of file bytes [offset, offset + length)
+             * to pieces, aimed at buffer target. Holes and bytes past the
+             * last extent are left to the caller's zero fill.
+             */
+            void AddPieces(const RecoveryItem& item, uint64_t offset, size_t length, size_t target,
+                           std::vector<PlannedPiece>& pieces) {
+                const uint64_t end = offset + length;
+                uint64_t position = 0;
+                for (const auto& extent : item.extents) {
+                    if (position >= end) {
+                        break;
+                    }
+                    uint64_t extentEnd = position + extent.length;
+                    if (extentEnd > offset && extent.offset != SPARSE_EXTENT) {
+                        uint64_t from = std::max(position, offset);
+                        pieces.push_back(PlannedPiece{extent.offset + (from - position),
+                                                      std::min(extentEnd, end) - from, target, from - offset});
+                    }
+                    position = extentEnd;
+                }
+            }
+
+            // Strip path separators and characters Windows rejects in names
+            std::string SafeFileName(const std::string& name) {
+                std::string safe = name.empty() ? std::string("unnamed") : name;
+                for (char& c : safe) {
+                    if (std::strchr("\\/:*?\"<>|", c) || static_cast<unsigned char>(c) < 0x20) {
+                        c = '_';
+                    }
+                }
+                return safe;
+            }
+
+        } // namespace
+
+        RecoveryPipeline::RecoveryPipeline(SectorSource& source, const RecoveryPipelineOptions& options) :
+            source(source), options(options) {
+            this->options.readers = std::max<size_t>(this->options.readers, 1);
+            this->options.verifiers = std::max<size_t>(this->options.verifiers, 1);
+            this->options.writers = std::max<size_t>(this->options.writers, 1);
+            this->options.segmentSize = std::max<size_t>(this->options.segmentSize, IO_ALIGNMENT);
+        }
+
+        void RecoveryPipeline::Add(RecoveryItem item) {
+            items.push_back(std::move(item));
+        }
+
+        RecoveryPipelineStats RecoveryPipeline::Run(const std::string& directory, const ProgressCallback& progress,
+                                                    const RecoveryCallback& completed) {
+            const auto started = std::chrono::steady_clock::now();
+            RecoveryPipelineStats stats;
+            stats.files = items.size();
+            if (items.empty()) {
+                return stats;
+            }
+
+            const std::filesystem::path outputDirectory = std::filesystem::u8path(directory);
+            std::error_code directoryError;
+            std::filesystem::create_directories(outputDirectory, directoryError);
+
+            // Split files into segments and read them in source order
+            std::vector<Segment> segments;
+            std::vector<FileState> files(items.size());
+            uint64_t totalBytes = 0;
+            for (size_t i = 0; i < items.size(); i++) {
+                const RecoveryItem& item = items[i];
+                uint64_t offset = 0;
+                do {
+                    size_t length = static_cast<size_t>(std::min<uint64_t>(options.segmentSize, item.fileSize - offset));
+                    segments.push_back(Segment{i, offset, length, PhysicalOffset(item, offset)});
+                    files[i].remaining++;
+                    offset += length;
+                } while (offset < item.fileSize);
+                totalBytes += item.fileSize;
+            }
+            std::stable_sort(segments.begin(), segments.end(),
+                             [](const Segment& a, const Segment& b) { return a.physical < b.physical; });
+
+            // Kernel copies need an image file on a platform that has them
+            std::unique_ptr<ExtentCopier> copier;
+            if (options.directCopy) {
+                copier = std::make_unique<ExtentCopier>(source.Path());
+                if (!copier->Available()) {
+                    copier.reset();
+                }
+            }
+
+            MemoryBudget budget(options.memoryBudget);
+            BoundedQueue<Block> verifyQueue(QUEUE_DEPTH);
+            BoundedQueue<Block> writeQueue(QUEUE_DEPTH);
+            std::mutex fileLocks[LOCK_STRIPES];
+            std::mutex namesMutex;
+            std::unordered_set<std::string> claimedNames;
+
+            std::atomic<size_t> nextSegment(0);
+            // Planned reads only pay off on disks that seek; mapped images fault
+            // their pages in from the same disk, so they count too
+            const bool elevator = options.elevatorReads && source.IncursSeekPenalty();
+            const size_t readerCount = elevator ? 1 : options.readers;
+            std::atomic<size_t> activeReaders(readerCount);
+            std::atomic<size_t> activeVerifiers(options.verifiers);
+            std::atomic<size_t> activeWriters(options.writers);
+            std::atomic<uint64_t> reads(0);
+            std::atomic<uint64_t> bytesRead(0);
+            std::atomic<uint64_t> bytesWritten(0);
+            std::atomic<uint64_t> bytesCloned(0);
+            std::atomic<uint64_t> bytesKernelCopied(0);
+            std::atomic<uint64_t> bytesRehashed(0);
+            std::atomic<bool> aborted(false);
+            std::mutex errorMutex;
+            std::exception_ptr error;
+
+            std::mutex outcomeMutex;
+            std::vector<RecoveryOutcome> outcomes;
+
+            auto fail = [&]() {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                aborted = true;
+            };
+
+            // Output name for an item; clashes get " (2)", " (3)", ...
+            auto claimPath = [&](const std::string& name) {
+                std::string safe = SafeFileName(name);
+                size_t dot = safe.find_last_of('.');
+                std::string stem = dot == std::string::npos || dot == 0 ? safe : safe.substr(0, dot);
+                std::string extension = dot == std::string::npos || dot == 0 ? std::string() : safe.substr(dot);
+
+                std::lock_guard<std::mutex> lock(namesMutex);
+                for (size_t attempt = 1;; attempt++) {
+                    std::string candidate = attempt == 1 ? safe : stem + " (" + std::to_string(attempt) + ")" + extension;
+                    std::string key = candidate;
+                    for (char& c : key) {
+                        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                    }
+                    std::error_code exists;
+                    std::filesystem::path path = outputDirectory / std::filesystem::u8path(candidate);
+                    if (!claimedNames.count(key) && !std::filesystem::exists(path, exists)) {
+                        claimedNames.insert(key);
+                        return path;
+                    }
+                }
+            };
+
+            auto finishFile = [&](size_t item, FileState& state) {
+                RecoveryOutcome outcome;
+                outcome.tag = items[item].tag;
+                if (state.out) {
+                    state.out->close();
+                    if (state.out->fail() && !state.failed) {
+                        state.failed = true;
+                        state.error = "write failed";
+                    }
+                    state.out.reset();
+                }
+                if (state.direct) {
+                    if (!state.direct->Close(items[item].fileSize) && !state.failed) {
+                        state.failed = true;
+                        state.error = "write failed";
+                    }
+                    state.direct.reset();
+                }
+                if (state.rejected || state.failed) {
+                    outcome.status = state.rejected ? RecoveryStatus::SKIPPED : RecoveryStatus::FAILED;
+                    if (!state.path.empty()) {
+                        std::error_code ignored;
+                        std::filesystem::remove(std::filesystem::u8path(state.path), ignored);
+                    }
+                } else {
+                    // Image sectors the imager never rescued read back as zeros, not as errors
+                    uint64_t unrescued = options.rescueMap ? UnrescuedOffset(*options.rescueMap, items[item]) : NO_OFFSET;
+                    if (unrescued != NO_OFFSET && !state.damaged) {
+                        state.damaged = true;
+                        state.error = "unrescued sectors near offset " + std::to_string(unrescued);
+                    }
+                    outcome.status = state.damaged ? RecoveryStatus::PARTIALLY_RECOVERED : RecoveryStatus::COMPLETED;
+                    outcome.path = state.path;
+                    if (state.hasher && state.hashed == items[item].fileSize) {
+                        outcome.checksum = state.hasher->Final();
+                    }
+                }
+                state.hasher.reset();
+                state.unhashed.clear();
+                outcome.error = state.error;
+                std::lock_guard<std::mutex> lock(outcomeMutex);
+                outcomes.push_back(std::move(outcome));
+            };
+
+            // Point block at the data of segment index. Returns true when the
+            // block got a budgeted buffer that still has to be read from the source.
+            auto prepareBlock = [&](size_t index, Block& block) {
+                const Segment& segment = segments[index];
+                const RecoveryItem& item = items[segment.item];
+                block.segment = index;
+
+                if (item.extents.empty() && segment.fileOffset + segment.length <= item.inlineData.size()) {
+                    block.data = item.inlineData.data() + segment.fileOffset;
+                    return false;
+                }
+                if (segment.length == 0) {
+                    return false;
+                }
+                // Image extents are moved by the kernel; only the start is read, for verification
+                if (copier && !item.extents.empty()) {
+                    block.direct = true;
+                    if (segment.fileOffset == 0 && options.verifyContent) {
+                        const size_t probe = std::min(segment.length, DIRECT_PROBE);
+                        budget.Acquire(probe);
+                        block.charged = probe;
+                        block.storage = AlignedBuffer(probe);
+                        block.data = block.storage.Data();
+                        uint64_t issued = 0;
+                        bytesRead += ReadRange(source, item, 0, probe, block.storage.Data(), block, issued);
+                        reads += issued;
+                    }
+                    return false;
+                }
+                // Runs of a mapped image are handed on in place
+                uint64_t physical = 0;
+                if (IsContiguous(item, segment.fileOffset, segment.length, physical)) {
+                    if (const uint8_t* view = source.View(physical, segment.length)) {
+                        block.data = view;
+                        bytesRead += segment.length;
+                        return false;
+                    }
+                }
+                budget.Acquire(segment.length);
+                block.charged = segment.length;
+                block.storage = AlignedBuffer(segment.length);
+                block.data = block.storage.Data();
+                if (item.extents.empty()) {
+                    size_t copied = segment.fileOffset < item.inlineData.size()
+                        ? static_cast<size_t>(std::min<uint64_t>(segment.length,
+                              item.inlineData.size() - segment.fileOffset)) : 0;
+                    std::memcpy(block.storage.Data(), item.inlineData.data() + segment.fileOffset, copied);
+                    std::memset(block.storage.Data() + copied, 0, segment.length - copied);
+                    return false;
+                }
+                return true;
+            };
+
+            auto readStage = [&]() {
+                try {
+                    for (size_t index = nextSegment++; index < segments.size() && !aborted; index = nextSegment++) {
+                        Block block;
+                        if (prepareBlock(index, block)) {
+                            const Segment& segment = segments[index];
+                            uint64_t issued = 0;
+                            bytesRead += ReadRange(source, items[segment.item], segment.fileOffset, segment.length,
+                                                   block.storage.Data(), block, issued);
+                            reads += issued;
+                        }
+                        verifyQueue.Push(std::move(block));
+                    }
+                } catch (...) {
+                    fail();
+                }
+                if (--activeReaders == 0) {
+                    verifyQueue.Close();
+                }
+            };
+
+            // Single reader for spinning disks: segments are taken in batches of
+            // up to half the budget, the extents of a whole batch are merged into
+            // one elevator plan, and each planned read is split back into blocks.
+            auto plannedReadStage = [&]() {
+                try {
+                    const uint64_t batchLimit = std::max<uint64_t>(options.memoryBudget / 2, 1);
+                    AlignedBuffer scratch(std::max<size_t>(static_cast<size_t>(options.planner.maxReadSize),
+                                                           options.segmentSize));
+                    auto markDamaged = [](Block& block, uint64_t offset) {
+                        if (!block.damaged) {
+                            block.damaged = true;
+                            block.badOffset = offset;
+                        }
+                    };
+
+                    size_t index = 0;
+                    while (index < segments.size() && !aborted) {
+                        std::vector<Block> batch;
+                        std::vector<PlannedPiece> pieces;
+                        uint64_t batchBytes = 0;
+                        for (; index < segments.size() &&
+                               (batchBytes == 0 || batchBytes + segments[index].length <= batchLimit); index++) {
+                            Block block;
+                            if (prepareBlock(index, block)) {
+                                const Segment& segment = segments[index];
+                                std::memset(block.storage.Data(), 0, segment.length);
+                                AddPieces(items[segment.item], segment.fileOffset, segment.length, batch.size(), pieces);
+                            }
+                            // Every buffer of the batch is held until the batch is queued
+                            batchBytes += block.charged;
+                            batch.push_back(std::move(block));
+                        }
+
+                        ReadPlan plan = PlanElevatorReads(std::move(pieces), options.planner);
+                        for (const auto& read : plan.reads) {
+                            if (aborted) {
+                                break;
+                            }
+                            const size_t length = static_cast<size_t>(read.length);
+                            size_t got = 0;
+                            reads++;
+                            try {
+                                got = source.ReadAt(read.offset, scratch.Data(), length);
+                            } catch (const SectorReadError&) {
+                                got = 0;
+                            }
+                            for (size_t i = read.firstPiece; i < read.firstPiece + read.pieceCount; i++) {
+                                const PlannedPiece& piece = plan.pieces[i];
+                                Block& block = batch[piece.target];
+                                uint8_t* target = block.storage.Data() + piece.targetOffset;
+                                const size_t count = static_cast<size_t>(piece.length);
+                                if (got == length) {
+                                    std::memcpy(target, scratch.Data() + (piece.source - read.offset), count);
+                                    continue;
+                                }
+                                // The merged read hit a bad spot; retry piece by piece
+                                // so only the pieces covering it are zero filled
+                                size_t pieceGot = 0;
+                                reads++;
+                                try {
+                                    pieceGot = source.ReadAt(piece.source, target, count);
+                                } catch (const SectorReadError& e) {
+                                    markDamaged(block, e.Offset());
+                                    pieceGot = 0;
+                                }
+                                if (pieceGot < count) {
+                                    std::memset(target + pieceGot, 0, count - pieceGot);
+                                    markDamaged(block, piece.source + pieceGot);
+                                }
+                                bytesRead += pieceGot;
+                            }
+                            if (got == length) {
+                                bytesRead += got;
+                            }
+                        }
+                        for (auto& block : batch) {
+                            verifyQueue.Push(std::move(block));
+                        }
+                    }
+                } catch (...) {
+                    fail();
+                }
+                if (--activeReaders == 0) {
+                    verifyQueue.Close();
+                }
+            };
+
+            auto verifyStage = [&]() {
+                Block block;
+                while (verifyQueue.Pop(block)) {
+                    const Segment& segment = segments[block.segment];
+                    const RecoveryItem& item = items[segment.item];
+                    if (options.verifyContent && segment.fileOffset == 0 && segment.length > 0 &&
+                        !MatchesSignature(item.fileName, block.data,
+                                          block.direct ? std::min(segment.length, DIRECT_PROBE) : segment.length)) {
+                        std::lock_guard<std::mutex> lock(fileLocks[segment.item % LOCK_STRIPES]);
+                        files[segment.item].rejected = true;
+                        files[segment.item].error = "content does not match its file type";
+                    }
+                    writeQueue.Push(std::move(block));
+                }
+                if (--activeVerifiers == 0) {
+                    writeQueue.Close();
+                }
+            };
+
+            // Move the on-image parts of a segment; holes and the tail are zeroed when the file is closed
+            auto copySegment = [&](const Segment& segment, DirectOutput& out, Block& block) {
+                const RecoveryItem& item = items[segment.item];
+                const uint64_t end = segment.fileOffset + segment.length;
+                uint64_t position = 0;
+                for (const auto& extent : item.extents) {
+                    if (position >= end) {
+                        break;
+                    }
+                    uint64_t extentEnd = position + extent.length;
+                    if (extentEnd > segment.fileOffset && extent.offset != SPARSE_EXTENT) {
+                        uint64_t from = std::max(position, segment.fileOffset);
+                        uint64_t count = std::min(extentEnd, end) - from;
+                        CopyMethod method;
+                        uint64_t moved = copier->Copy(out, from, extent.offset + (from - position), count, method);
+                        (method == CopyMethod::REFLINK ? bytesCloned : bytesKernelCopied) += moved;
+                        if (moved < count) {
+                            // The kernel refused the rest; read it through the source
+                            const size_t rest = static_cast<size_t>(count - moved);
+                            AlignedBuffer buffer(rest);
+                            uint64_t issued = 0;
+                            bytesRead += ReadRange(source, item, from + moved, rest, buffer.Data(), block, issued);
+                            reads += issued;
+                            if (!out.WriteAt(from + moved, buffer.Data(), rest)) {
+                                return false;
+                            }
+                        }
+                    }
+                    position = extentEnd;
+                }
+                return true;
+            };
+
+            // Feed written bytes [offset, offset + length) back from the output file
+            auto rehash = [&](FileState& state, uint64_t offset, size_t length) {
+                std::vector<uint8_t> chunk(std::min(length, REHASH_CHUNK));
+                if (state.out) {
+                    state.out->flush();
+                    state.out->seekg(static_cast<std::streamoff>(offset));
+                }
+                for (size_t done = 0; done < length;) {
+                    const size_t count = std::min(length - done, chunk.size());
+                    if (state.direct) {
+                        if (!state.direct->ReadAt(offset + done, chunk.data(), count)) {
+                            return false;
+                        }
+                    } else if (!state.out->read(reinterpret_cast<char*>(chunk.data()),
+                                                static_cast<std::streamsize>(count))) {
+                        state.out->clear();
+                        return false;
+                    }
+                    state.hasher->Update(chunk.data(), count);
+                    done += count;
+                }
+                bytesRehashed += length;
+                return true;
+            };
+
+            // Kernel-copied bytes never reach memory; hash them from the mapped
+            // image where possible and from the output otherwise
+            auto hashDirect = [&](const RecoveryItem& item, FileState& state, uint64_t offset, size_t length) {
+                static const uint8_t zeros[64 * 1024] = {};
+                const uint64_t end = offset + length;
+                uint64_t position = 0;
+                uint64_t covered = offset;
+                auto feedZeros = [&](uint64_t count) {
+                    for (; count > 0;) {
+                        size_t piece = static_cast<size_t>(std::min<uint64_t>(count, sizeof(zeros)));
+                        state.hasher->Update(zeros, piece);
+                        count -= piece;
+                    }
+                };
+                for (const auto& extent : item.extents) {
+                    if (position >= end) {
+                        break;
+                    }
+                    uint64_t extentEnd = position + extent.length;
+                    if (extentEnd > offset) {
+                        uint64_t from = std::max(position, offset);
+                        size_t count = static_cast<size_t>(std::min(extentEnd, end) - from);
+                        const uint8_t* view = extent.offset == SPARSE_EXTENT ? nullptr
+                            : source.View(extent.offset + (from - position), count);
+                        if (extent.offset == SPARSE_EXTENT) {
+                            feedZeros(count);
+                        } else if (view) {
+                            state.hasher->Update(view, count);
+                        } else if (!rehash(state, from, count)) {
+                            return false;
+                        }
+                        covered = from + count;
+                    }
+                    position = extentEnd;
+                }
+                feedZeros(end - covered);
+                return true;
+            };
+
+            // Hashes run in file order: a segment that arrives early waits in
+            // unhashed and is read back from the output once the gap closes
+            auto hashSegment = [&](const Segment& segment, const Block& block, FileState& state) {
+                const RecoveryItem& item = items[segment.item];
+                if (segment.fileOffset != state.hashed) {
+                    state.unhashed.emplace(segment.fileOffset, segment.length);
+                    return true;
+                }
+                if (block.direct) {
+                    if (!hashDirect(item, state, segment.fileOffset, segment.length)) {
+                        return false;
+                    }
+                } else {
+                    state.hasher->Update(block.data, segment.length);
+                }
+                state.hashed += segment.length;
+                for (auto next = state.unhashed.begin();
+                     next != state.unhashed.end() && next->first == state.hashed; next = state.unhashed.erase(next)) {
+                    bool fed = block.direct ? hashDirect(item, state, next->first, next->second)
+                                            : rehash(state, next->first, next->second);
+                    if (!fed) {
+                        return false;
+                    }
+                    state.hashed += next->second;
+                }
+                return true;
+            };
+
+            auto writeStage = [&]() {
+                Block block;
+                while (writeQueue.Pop(block)) {
+                    const Segment& segment = segments[block.segment];
+                    try {
+                        std::lock_guard<std::mutex> lock(fileLocks[segment.item % LOCK_STRIPES]);
+                        FileState& state = files[segment.item];
+                        if (!state.rejected && !state.failed && !aborted) {
+                            if (!state.out && !state.direct) {
+                                std::filesystem::path path = claimPath(items[segment.item].fileName);
+                                state.path = path.u8string();
+                                if (block.direct) {
+                                    state.direct = std::make_unique<DirectOutput>();
+                                    state.direct->Open(state.path);
+                                } else {
+                                    state.out = std::make_unique<std::fstream>(
+                                        path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+                                }
+                                if (options.checksum != HashAlgorithm::NONE) {
+                                    state.hasher = std::make_unique<FileHasher>(options.checksum);
+                                }
+                            }
+                            // Segments of one file may arrive out of order
+                            bool written;
+                            if (block.direct) {
+                                written = state.direct->IsOpen() && copySegment(segment, *state.direct, block);
+                            } else {
+                                state.out->seekp(static_cast<std::streamoff>(segment.fileOffset));
+                                state.out->write(reinterpret_cast<const char*>(block.data),
+                                                 static_cast<std::streamsize>(segment.length));
+                                written = static_cast<bool>(*state.out);
+                            }
+                            if (!written) {
+                                state.failed = true;
+                                state.error = "cannot write " + state.path;
+                            } else {
+                                bytesWritten += segment.length;
+                                if (state.hasher && !hashSegment(segment, block, state)) {
+                                    state.hasher.reset();   // Keep the file, without a checksum
+                                }
+                            }
+                        } else if (aborted && !state.rejected && !state.failed) {
+                            // A dropped segment leaves a hole; the file must not finish as COMPLETED
+                            state.failed = true;
+                            state.error = "recovery aborted";
+                        }
+                        if (block.damaged && !state.damaged) {
+                            state.damaged = true;
+                            state.error = "unreadable sectors near offset " + std::to_string(block.badOffset) +
+                                          " were zero filled";
+                        }
+                        if (--state.remaining == 0) {
+                            finishFile(segment.item, state);
+                        }
+                    } catch (...) {
+                        fail();
+                    }
+                    if (block.charged) {
+                        block.storage = AlignedBuffer();
+                        budget.Release(block.charged);
+                    }
+                }
+                --activeWriters;
+            };
+
+            std::vector<std::thread> threads;
+            if (elevator) {
+                threads.emplace_back(plannedReadStage);
+            } else {
+                for (size_t i = 0; i < readerCount; i++) {
+                    threads.emplace_back(readStage);
+                }
+            }
+            for (size_t i = 0; i < options.verifiers; i++) {
+                threads.emplace_back(verifyStage);
+            }
+            for (size_t i = 0; i < options.writers; i++) {
+                threads.emplace_back(writeStage);
+            }
+
+            size_t delivered = 0;
+            auto deliver = [&]() {
+                std::vector<RecoveryOutcome> batch;
+                {
+                    std::lock_guard<std::mutex> lock(outcomeMutex);
+                    batch.swap(outcomes);
+                }
+                for (const auto& outcome : batch) {
+                    switch (outcome.status) {
+                        case RecoveryStatus::COMPLETED: stats.completed++; break;
+                        case RecoveryStatus::PARTIALLY_RECOVERED: stats.partial++; break;
+                        case RecoveryStatus::SKIPPED: stats.skipped++; break;
+                        default: stats.failed++; break;
+                    }
+                    if (completed) {
+                        completed(outcome);
+                    }
+                }
+                delivered += batch.size();
+            };
+
+            while (activeWriters.load() > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                deliver();
+                if (progress && totalBytes > 0) {
+                    progress(static_cast<int>(std::min<uint64_t>(bytesWritten.load() * 100 / totalBytes, 100)),
+                             "Recovering files...");
+                }
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            deliver();
+
+            // Files cut short by an abort are removed and reported as failed
+            if (delivered < items.size()) {
+                for (size_t i = 0; i < files.size(); i++) {
+                    if (files[i].remaining > 0) {
+                        files[i].failed = true;
+                        files[i].error = "recovery aborted";
+                        files[i].remaining = 0;
+                        finishFile(i, files[i]);
+                    }
+                }
+                deliver();
+            }
+            if (progress) {
+                progress(100, "Recovering files...");
+            }
+
+            stats.reads = reads.load();
+            stats.bytesRead = bytesRead.load();
+            stats.bytesWritten = bytesWritten.load();
+            stats.bytesCloned = bytesCloned.load();
+            stats.bytesKernelCopied = bytesKernelCopied.load();
+            stats.bytesRehashed = bytesRehashed.load();
+            stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            return stats;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
@@ -0,0 +1,148 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Recovery Pipeline
+ *
+ * Writes recovered files out in three stages, each with its own threads:
+ * readers pull file data from the source in physical offset order,
+ * verifiers check that the content still looks like the file it claims
+ * to be, and writers place it in the output directory. Large files are
+ * split into segments, and a memory budget bounds the data in flight
+ * between stages, so throughput is limited by the target disk rather
+ * than by per-file latency. On spinning disks a single reader can
+ * instead follow an elevator-ordered plan built from the extents of
+ * every file in a batch. Files on an image can skip the buffers altogether
+ * and be moved by the kernel. Checksums are computed from the data as it
+ * passes the writers, in file order.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_RECOVERY_PIPELINE_H
+#define STELLAR_RECOVERY_PIPELINE_H
+
+#include "stellar_recovery.h"
+#include "sector_reader.h"
+#include "recovery_planner.h"
+#include "file_hasher.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        /**
+         * One file to recover
+         */
+        struct RecoveryItem {
+            std::string fileName;               // Name inside the output directory
+            uint64_t fileSize;
+            std::vector<FileExtent> extents;    // Data on the source; empty for inline or empty files
+            std::vector<uint8_t> inlineData;    // Used when extents is empty
+            uint64_t tag;                       // Caller's identifier, returned in the outcome
+
+            RecoveryItem() : fileSize(0), tag(0) {}
+        };
+
+        /**
+         * Result of one file. COMPLETED and PARTIALLY_RECOVERED files were
+         * written; PARTIALLY_RECOVERED means unreadable sectors were zero
+         * filled. SKIPPED files failed verification and were not kept.
+         */
+        struct RecoveryOutcome {
+            uint64_t tag;
+            RecoveryStatus status;
+            std::string path;                   // Written file, empty unless kept
+            std::string checksum;               // Hex digest of the written file, when requested
+            std::string error;
+        };
+
+        class RescueMap;
+
+        struct RecoveryPipelineOptions {
+            size_t readers;
+            size_t verifiers;
+            size_t writers;
+            size_t memoryBudget;                // Bytes of file data held between stages
+            size_t segmentSize;                 // Largest piece of a file moved at once
+            bool verifyContent;                 // Check magic bytes against the file extension
+            bool elevatorReads;                 // One reader sweeping a merged read plan (spinning disks)
+            ReadPlannerOptions planner;         // Coalescing used when elevatorReads is set
+            bool directCopy;                    // Move image extents in the kernel where the platform allows
+            HashAlgorithm checksum;             // Digest of every written file, or NONE
+            const RescueMap* rescueMap;         // Source is an image; its unrescued regions count as unreadable
+
+            RecoveryPipelineOptions() :
+                readers(2),
+                verifiers(1),
+                writers(2),
+                memoryBudget(256 * 1024 * 1024),
+                segmentSize(8 * 1024 * 1024),
+                verifyContent(true),
+                elevatorReads(false),
+                directCopy(false),
+                checksum(HashAlgorithm::NONE),
+                rescueMap(nullptr) {}
+        };
+
+        struct RecoveryPipelineStats {
+            uint64_t files;
+            uint64_t completed;
+            uint64_t partial;
+            uint64_t skipped;
+            uint64_t failed;
+            uint64_t reads;                     // Requests issued to the source
+            uint64_t bytesRead;
+            uint64_t bytesWritten;              // By every method
+            uint64_t bytesCloned;               // Shared with the image by reflink
+            uint64_t bytesKernelCopied;         // Moved by copy_file_range
+            uint64_t bytesRehashed;             // Read back from the output for segments hashed out of order
+            double seconds;
+
+            RecoveryPipelineStats() :
+                files(0), completed(0), partial(0), skipped(0), failed(0),
+                reads(0), bytesRead(0), bytesWritten(0), bytesCloned(0), bytesKernelCopied(0),
+                bytesRehashed(0), seconds(0) {}
+
+            uint64_t BytesBuffered() const { return bytesWritten - bytesCloned - bytesKernelCopied; }
+
+            double BytesPerSecond() const { return seconds > 0 ? bytesWritten / seconds : 0; }
+        };
+
+        using RecoveryCallback = std::function<void(const RecoveryOutcome& outcome)>;
+
+        /**
+         * Recovers a batch of files from one source
+         */
+        class RecoveryPipeline {
+        public:
+            RecoveryPipeline(SectorSource& source,
+                             const RecoveryPipelineOptions& options = RecoveryPipelineOptions());
+
+            void Add(RecoveryItem item);
+            size_t Count() const { return items.size(); }
+
+            /**
+             * Recover every item into directory, which is created if needed.
+             * progress and completed are invoked from the calling thread;
+             * completed runs once per item. Name clashes in the output get
+             * a numbered suffix rather than overwriting anything.
+             */
+            RecoveryPipelineStats Run(const std::string& directory,
+                                      const ProgressCallback& progress = ProgressCallback(),
+                                      const RecoveryCallback& completed = RecoveryCallback());
+
+        private:
+            SectorSource& source;
+            RecoveryPipelineOptions options;
+            std::vector<RecoveryItem> items;
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_RECOVERY_PIPELINE_H
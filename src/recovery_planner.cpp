@@ -0,0 +1,63 @@
+/**
+ * Stellar Data Recovery Pro Free - Recovery Read Planner
+ *
+ * Elevator ordering and read coalescing.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "recovery_planner.h"
+#include <algorithm>
+
+namespace Stellar {
+    namespace Recovery {
+
+        uint64_t ReadPlan::BytesRead() const {
+            uint64_t total = 0;
+            for (const auto& read : reads) {
+                total += read.length;
+            }
+            return total;
+        }
+
+        uint64_t ReadPlan::BytesWanted() const {
+            uint64_t total = 0;
+            for (const auto& piece : pieces) {
+                total += piece.length;
+            }
+            return total;
+        }
+
+        ReadPlan PlanElevatorReads(std::vector<PlannedPiece> pieces, const ReadPlannerOptions& options) {
+            ReadPlan plan;
+            pieces.erase(std::remove_if(pieces.begin(), pieces.end(),
+                                        [](const PlannedPiece& piece) { return piece.length == 0; }),
+                         pieces.end());
+            std::stable_sort(pieces.begin(), pieces.end(), [](const PlannedPiece& a, const PlannedPiece& b) {
+                return a.source < b.source;
+            });
+            plan.pieces = std::move(pieces);
+
+            for (size_t i = 0; i < plan.pieces.size(); i++) {
+                const PlannedPiece& piece = plan.pieces[i];
+                uint64_t pieceEnd = piece.source + piece.length;
+                if (!plan.reads.empty()) {
+                    PlannedRead& read = plan.reads.back();
+                    uint64_t readEnd = read.offset + read.length;
+                    // Overlapping pieces (shared clusters) always join; neighbours join within the gap
+                    bool near = piece.source <= readEnd || piece.source - readEnd <= options.gapReadThrough;
+                    if (near && std::max(readEnd, pieceEnd) - read.offset <= options.maxReadSize) {
+                        read.length = std::max(readEnd, pieceEnd) - read.offset;
+                        read.pieceCount++;
+                        continue;
+                    }
+                }
+                plan.reads.push_back(PlannedRead{piece.source, piece.length, i, 1});
+            }
+            return plan;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
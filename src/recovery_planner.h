@@ -0,0 +1,72 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Recovery Read Planner
+ *
+ * Turns the data runs of many files into one read plan for a spinning
+ * disk. Pieces are ordered by source offset so the head sweeps in one
+ * direction, pieces close together are merged into a single read, and
+ * short gaps between them are read through rather than seeked over.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_RECOVERY_PLANNER_H
+#define STELLAR_RECOVERY_PLANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        /**
+         * Bytes wanted from the source and where they go
+         */
+        struct PlannedPiece {
+            uint64_t source;            // Offset on the source
+            uint64_t length;
+            size_t target;              // Caller's destination buffer
+            uint64_t targetOffset;      // Offset inside that buffer
+        };
+
+        /**
+         * One read of the plan, covering pieces [firstPiece, firstPiece + pieceCount)
+         */
+        struct PlannedRead {
+            uint64_t offset;
+            uint64_t length;
+            size_t firstPiece;
+            size_t pieceCount;
+        };
+
+        struct ReadPlan {
+            std::vector<PlannedPiece> pieces;   // In source order
+            std::vector<PlannedRead> reads;     // Ascending offsets
+
+            uint64_t BytesRead() const;
+            uint64_t BytesWanted() const;
+        };
+
+        struct ReadPlannerOptions {
+            uint64_t gapReadThrough;    // Gaps up to this size are read rather than seeked over
+            uint64_t maxReadSize;       // Merged reads stop growing past this size
+
+            ReadPlannerOptions() :
+                gapReadThrough(256 * 1024),
+                maxReadSize(8 * 1024 * 1024) {}
+        };
+
+        /**
+         * Sort pieces by source offset and merge neighbours into reads.
+         * A piece longer than maxReadSize becomes a read of its own.
+         */
+        ReadPlan PlanElevatorReads(std::vector<PlannedPiece> pieces,
+                                   const ReadPlannerOptions& options = ReadPlannerOptions());
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_RECOVERY_PLANNER_H
@@ -0,0 +1,530 @@
+/**
+ * Stellar Data Recovery Pro Free - Persistent Result Index
+ *
+ * Index file writer, mapped reader and session directory helpers.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "result_index.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <system_error>
+#include <type_traits>
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            constexpr char INDEX_MAGIC[8] = {'S', 'T', 'L', 'R', 'I', 'D', 'X', '\0'};
+            constexpr uint32_t INDEX_VERSION = 2;
+            constexpr uint32_t BYTE_ORDER_TAG = 0x01020304;
+            constexpr const char* INDEX_EXTENSION = ".sri";
+            constexpr size_t TYPE_COUNT = static_cast<size_t>(TargetFileType::ALL_DATA) + 1;
+
+            enum SectionId : uint32_t {
+                SECTION_SESSION = 1,        // sessionId, sourceDrive, targetPath, lastError; NUL separated
+                SECTION_TYPE_RANGES,        // TYPE_COUNT + 1 row boundaries
+                SECTION_OFFSETS,
+                SECTION_SIZES,
+                SECTION_MODIFIED,
+                SECTION_CONFIDENCE,
+                SECTION_FLAGS,
+                SECTION_DIRECTORY_IDS,
+                SECTION_DIRECTORY_INDEX,
+                SECTION_DIRECTORY_DATA,
+                SECTION_NAME_INDEX,
+                SECTION_NAME_DATA,
+                SECTION_EXTENT_INDEX,
+                SECTION_EXTENT_DATA,
+                SECTION_INLINE_INDEX,
+                SECTION_INLINE_DATA,
+                SECTION_TYPES,              // Per row, so a reopened store needs no range search
+                SECTION_RECOVERY_IDS,       // Directory table entries; ~0u while pending
+                SECTION_CHECKSUM_INDEX,
+                SECTION_CHECKSUM_DATA,
+                SECTION_COUNT = SECTION_CHECKSUM_DATA
+            };
+
+            struct FileHeader {
+                char magic[8];
+                uint32_t version;
+                uint32_t byteOrder;
+                uint64_t rows;
+                uint32_t sectionCount;
+                uint32_t scanMode;
+                uint32_t targetType;
+                uint32_t complete;
+                int64_t startTime;          // Seconds since the epoch
+                int64_t endTime;
+                uint64_t reserved;
+            };
+            static_assert(sizeof(FileHeader) == 64, "index header layout");
+
+            struct SectionEntry {
+                uint32_t id;
+                uint32_t elementSize;
+                uint64_t offset;            // From the start of the file, 8-byte aligned
+                uint64_t count;
+            };
+            static_assert(sizeof(SectionEntry) == 24, "index section layout");
+            static_assert(sizeof(FileExtent) == 16, "extent layout");
+
+            int64_t ToSeconds(std::chrono::system_clock::time_point time) {
+                return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+            }
+
+            std::chrono::system_clock::time_point FromSeconds(int64_t seconds) {
+                return std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::seconds(seconds)));
+            }
+
+            /**
+             * Streams sections after a reserved header and section table
+             */
+            class SectionWriter {
+            public:
+                explicit SectionWriter(const std::string& path) :
+                    out(std::filesystem::u8path(path), std::ios::binary | std::ios::trunc) {
+                    if (!out) {
+                        throw ResultIndexError("Cannot create " + path);
+                    }
+                    std::vector<char> reserved(sizeof(FileHeader) + SECTION_COUNT * sizeof(SectionEntry));
+                    out.write(reserved.data(), static_cast<std::streamsize>(reserved.size()));
+                    position = reserved.size();
+                }
+
+                void Begin(uint32_t id, uint32_t elementSize) {
+                    static const char padding[8] = {};
+                    size_t pad = (8 - position % 8) % 8;
+                    out.write(padding, static_cast<std::streamsize>(pad));
+                    position += pad;
+                    entries.push_back({id, elementSize, position, 0});
+                }
+
+                void Put(const void* data, size_t length) {
+                    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(length));
+                    position += length;
+                }
+
+                template <typename T>
+                void Section(uint32_t id, const std::vector<T>& values) {
+                    Begin(id, sizeof(T));
+                    Put(values.data(), values.size() * sizeof(T));
+                    End(values.size());
+                }
+
+                void End(uint64_t count) {
+                    entries.back().count = count;
+                }
+
+                void Finish(FileHeader header) {
+                    header.sectionCount = static_cast<uint32_t>(entries.size());
+                    out.seekp(0);
+                    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                    out.write(reinterpret_cast<const char*>(entries.data()),
+                              static_cast<std::streamsize>(entries.size() * sizeof(SectionEntry)));
+                    out.flush();
+                    if (!out) {
+                        throw ResultIndexError("Write failed");
+                    }
+                }
+
+            private:
+                std::ofstream out;
+                uint64_t position = 0;
+                std::vector<SectionEntry> entries;
+            };
+
+        } // namespace
+
+        // ResultIndexWriter -----------------------------------------------
+
+        ResultIndexWriter::ResultIndexWriter(const RecoverySession& session, const ResultStore& results) :
+            session(session), results(results) {}
+
+        void ResultIndexWriter::Write(const std::string& path) const {
+            const auto& types = results.types;
+            const auto& offsets = results.offsets;
+            const auto& nameIndex = results.nameIndex;
+            const auto& extentIndex = results.extentIndex;
+            const auto& inlineIndex = results.inlineIndex;
+            const size_t rows = offsets.Size();
+            std::vector<size_t> order(rows);
+            std::iota(order.begin(), order.end(), size_t(0));
+            std::stable_sort(order.begin(), order.end(), [&types, &offsets](size_t a, size_t b) {
+                return types[a] != types[b] ? types[a] < types[b] : offsets[a] < offsets[b];
+            });
+
+            auto permuted = [&order](const auto& column) {
+                std::vector<std::decay_t<decltype(column[0])>> out;
+                out.reserve(order.size());
+                for (size_t row : order) {
+                    out.push_back(column[row]);
+                }
+                return out;
+            };
+
+            std::error_code error;
+            std::filesystem::path target = std::filesystem::u8path(path);
+            if (target.has_parent_path()) {
+                std::filesystem::create_directories(target.parent_path(), error);
+            }
+            std::string temporary = path + ".tmp";
+
+            {
+                SectionWriter writer(temporary);
+
+                std::string strings = session.sessionId + '\0' + session.sourceDrive + '\0' +
+                                      session.targetPath + '\0' + session.lastError + '\0';
+                writer.Begin(SECTION_SESSION, 1);
+                writer.Put(strings.data(), strings.size());
+                writer.End(strings.size());
+
+                std::vector<uint64_t> typeRanges(TYPE_COUNT + 1, 0);
+                for (size_t row = 0; row < rows; row++) {
+                    typeRanges[std::min<size_t>(types[row], TYPE_COUNT - 1) + 1]++;
+                }
+                std::partial_sum(typeRanges.begin(), typeRanges.end(), typeRanges.begin());
+                writer.Section(SECTION_TYPE_RANGES, typeRanges);
+
+                writer.Section(SECTION_OFFSETS, permuted(offsets));
+                writer.Section(SECTION_SIZES, permuted(results.sizes));
+                writer.Section(SECTION_MODIFIED, permuted(results.modified));
+                writer.Section(SECTION_CONFIDENCE, permuted(results.confidence));
+                writer.Section(SECTION_FLAGS, permuted(results.flags));
+                writer.Section(SECTION_TYPES, permuted(types));
+                writer.Section(SECTION_DIRECTORY_IDS, permuted(results.directoryIds));
+                writer.Section(SECTION_RECOVERY_IDS, permuted(results.recoveryIds));
+
+                std::vector<uint64_t> directoryIndex(1, 0);
+                writer.Begin(SECTION_DIRECTORY_DATA, 1);
+                for (std::string_view directory : results.directories) {
+                    writer.Put(directory.data(), directory.size());
+                    directoryIndex.push_back(directoryIndex.back() + directory.size());
+                }
+                writer.End(directoryIndex.back());
+                writer.Section(SECTION_DIRECTORY_INDEX, directoryIndex);
+
+                // Variable-length columns are rewritten in row order with fresh indexes
+                std::vector<uint64_t> index(1, 0);
+                writer.Begin(SECTION_NAME_DATA, 1);
+                for (size_t row : order) {
+                    writer.Put(results.names.Data() + nameIndex[row], nameIndex[row + 1] - nameIndex[row]);
+                    index.push_back(index.back() + nameIndex[row + 1] - nameIndex[row]);
+                }
+                writer.End(index.back());
+                writer.Section(SECTION_NAME_INDEX, index);
+
+                index.assign(1, 0);
+                writer.Begin(SECTION_EXTENT_DATA, sizeof(FileExtent));
+                for (size_t row : order) {
+                    uint64_t count = extentIndex[row + 1] - extentIndex[row];
+                    writer.Put(results.extentData.Data() + extentIndex[row], count * sizeof(FileExtent));
+                    index.push_back(index.back() + count);
+                }
+                writer.End(index.back());
+                writer.Section(SECTION_EXTENT_INDEX, index);
+
+                index.assign(1, 0);
+                writer.Begin(SECTION_INLINE_DATA, 1);
+                for (size_t row : order) {
+                    uint64_t count = inlineIndex[row + 1] - inlineIndex[row];
+                    writer.Put(results.inlineData.Data() + inlineIndex[row], count);
+                    index.push_back(index.back() + count);
+                }
+                writer.End(index.back());
+                writer.Section(SECTION_INLINE_INDEX, index);
+
+                index.assign(1, 0);
+                writer.Begin(SECTION_CHECKSUM_DATA, 1);
+                for (size_t row : order) {
+                    std::string_view checksum = results.Checksum(row);
+                    writer.Put(checksum.data(), checksum.size());
+                    index.push_back(index.back() + checksum.size());
+                }
+                writer.End(index.back());
+                writer.Section(SECTION_CHECKSUM_INDEX, index);
+
+                FileHeader header = {};
+                std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+                header.version = INDEX_VERSION;
+                header.byteOrder = BYTE_ORDER_TAG;
+                header.rows = rows;
+                header.scanMode = static_cast<uint32_t>(session.scanMode);
+                header.targetType = static_cast<uint32_t>(session.targetType);
+                header.complete = session.isComplete ? 1 : 0;
+                header.startTime = ToSeconds(session.startTime);
+                header.endTime = ToSeconds(session.endTime);
+                writer.Finish(header);
+            }
+
+            std::filesystem::rename(std::filesystem::u8path(temporary), target, error);
+            if (error) {
+                std::filesystem::remove(std::filesystem::u8path(temporary), error);
+                throw ResultIndexError("Cannot replace " + path);
+            }
+        }
+
+        // ResultIndex -----------------------------------------------------
+
+        ResultIndex::ResultIndex(const std::string& path) {
+            // Sessions are reopened to browse a few rows; do not prefault the whole file
+            MappedSourceOptions options;
+            options.populate = false;
+            options.hugePages = false;
+            try {
+                file = std::make_unique<MappedImageSource>(path, options);
+            } catch (const SectorReadError& e) {
+                throw ResultIndexError(e.what());
+            }
+            fileSize = file->Size();
+            base = file->View(0, static_cast<size_t>(fileSize));
+
+            FileHeader header;
+            if (!base || fileSize < sizeof(header)) {
+                throw ResultIndexError(path + " is not a result index");
+            }
+            std::memcpy(&header, base, sizeof(header));
+            if (std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+                header.byteOrder != BYTE_ORDER_TAG) {
+                throw ResultIndexError(path + " is not a result index");
+            }
+            if (header.version != INDEX_VERSION) {
+                throw ResultIndexError(path + " has unsupported index version " + std::to_string(header.version));
+            }
+            if (header.sectionCount > (fileSize - sizeof(header)) / sizeof(SectionEntry)) {
+                throw ResultIndexError(path + " has a truncated section table");
+            }
+            sectionCount = header.sectionCount;
+            rows = static_cast<size_t>(header.rows);
+
+            const char* strings = Column<char>(SECTION_SESSION, ~0ull);
+            const SectionEntry* entry = reinterpret_cast<const SectionEntry*>(base + sizeof(FileHeader));
+            uint64_t stringBytes = 0;
+            for (uint32_t i = 0; i < sectionCount; i++) {
+                if (entry[i].id == SECTION_SESSION) {
+                    stringBytes = entry[i].count;
+                }
+            }
+            std::string_view packed(strings, static_cast<size_t>(stringBytes));
+            std::string* fields[] = {&session.sessionId, &session.sourceDrive, &session.targetPath, &session.lastError};
+            for (std::string* field : fields) {
+                size_t end = std::min(packed.find('\0'), packed.size());
+                field->assign(packed.substr(0, end));
+                packed.remove_prefix(std::min(end + 1, packed.size()));
+            }
+            session.scanMode = static_cast<ScanMode>(header.scanMode);
+            session.targetType = static_cast<TargetFileType>(header.targetType);
+            session.isComplete = header.complete != 0;
+            session.startTime = FromSeconds(header.startTime);
+            session.endTime = FromSeconds(header.endTime);
+            session.totalFilesFound = static_cast<uint32_t>(rows);
+
+            typeRanges = Column<uint64_t>(SECTION_TYPE_RANGES, TYPE_COUNT + 1);
+            offsets = Column<uint64_t>(SECTION_OFFSETS, rows);
+            sizes = Column<uint64_t>(SECTION_SIZES, rows);
+            modified = Column<int64_t>(SECTION_MODIFIED, rows);
+            confidence = Column<uint16_t>(SECTION_CONFIDENCE, rows);
+            flags = Column<uint8_t>(SECTION_FLAGS, rows);
+            directoryIds = Column<uint32_t>(SECTION_DIRECTORY_IDS, rows);
+            types = Column<uint8_t>(SECTION_TYPES, rows);
+            recoveryIds = Column<uint32_t>(SECTION_RECOVERY_IDS, rows);
+            checksumIndex = Column<uint64_t>(SECTION_CHECKSUM_INDEX, rows + 1);
+            nameIndex = Column<uint64_t>(SECTION_NAME_INDEX, rows + 1);
+            extentIndex = Column<uint64_t>(SECTION_EXTENT_INDEX, rows + 1);
+            inlineIndex = Column<uint64_t>(SECTION_INLINE_INDEX, rows + 1);
+            if (typeRanges[TYPE_COUNT] != rows) {
+                throw ResultIndexError(path + " has inconsistent type sections");
+            }
+
+            for (uint32_t i = 0; i < sectionCount; i++) {
+                switch (entry[i].id) {
+                    case SECTION_DIRECTORY_INDEX: directoryCount = entry[i].count ? entry[i].count - 1 : 0; break;
+                    case SECTION_DIRECTORY_DATA: directoryBytes = entry[i].count; break;
+                    case SECTION_NAME_DATA: nameBytes = entry[i].count; break;
+                    case SECTION_EXTENT_DATA: extentCount = entry[i].count; break;
+                    case SECTION_INLINE_DATA: inlineCount = entry[i].count; break;
+                    case SECTION_CHECKSUM_DATA: checksumBytes = entry[i].count; break;
+                    default: break;
+                }
+            }
+            directoryIndex = Column<uint64_t>(SECTION_DIRECTORY_INDEX, directoryCount + 1);
+            directoryData = Column<char>(SECTION_DIRECTORY_DATA, directoryBytes);
+            nameData = Column<char>(SECTION_NAME_DATA, nameBytes);
+            extentData = Column<FileExtent>(SECTION_EXTENT_DATA, extentCount);
+            inlineBytes = Column<uint8_t>(SECTION_INLINE_DATA, inlineCount);
+            checksumData = Column<char>(SECTION_CHECKSUM_DATA, checksumBytes);
+
+            // Variable-length sections must end where their indexes say
+            if (nameIndex[rows] != nameBytes || extentIndex[rows] != extentCount ||
+                inlineIndex[rows] != inlineCount || checksumIndex[rows] != checksumBytes ||
+                directoryIndex[directoryCount] != directoryBytes) {
+                throw ResultIndexError(path + " has inconsistent variable-length sections");
+            }
+        }
+
+        template <typename T>
+        const T* ResultIndex::Column(uint32_t id, uint64_t count) const {
+            const SectionEntry* entries = reinterpret_cast<const SectionEntry*>(base + sizeof(FileHeader));
+            for (uint32_t i = 0; i < sectionCount; i++) {
+                SectionEntry entry;
+                std::memcpy(&entry, entries + i, sizeof(entry));
+                if (entry.id != id) {
+                    continue;
+                }
+                if (count == ~0ull) {
+                    count = entry.count;
+                }
+                if (entry.elementSize != sizeof(T) || entry.count != count || entry.offset % 8 != 0 ||
+                    entry.offset > fileSize || count > (fileSize - entry.offset) / sizeof(T)) {
+                    break;
+                }
+                return reinterpret_cast<const T*>(base + entry.offset);
+            }
+            throw ResultIndexError(file->Path() + " has a missing or damaged section " + std::to_string(id));
+        }
+
+        std::pair<size_t, size_t> ResultIndex::TypeRange(TargetFileType type) const {
+            size_t index = std::min<size_t>(static_cast<size_t>(type), TYPE_COUNT - 1);
+            uint64_t first = std::min<uint64_t>(typeRanges[index], rows);
+            uint64_t last = std::min<uint64_t>(std::max(typeRanges[index + 1], first), rows);
+            return {static_cast<size_t>(first), static_cast<size_t>(last - first)};
+        }
+
+        TargetFileType ResultIndex::Type(size_t row) const {
+            const uint64_t* upper = std::upper_bound(typeRanges, typeRanges + TYPE_COUNT + 1, row);
+            size_t type = static_cast<size_t>(upper - typeRanges);
+            return static_cast<TargetFileType>(type > 0 ? std::min(type - 1, TYPE_COUNT - 1) : 0);
+        }
+
+        std::chrono::system_clock::time_point ResultIndex::Modified(size_t row) const {
+            return FromSeconds(modified[row]);
+        }
+
+        bool ResultIndex::IsRecovered(size_t row) const {
+            return (flags[row] & ResultStore::FLAG_RECOVERED) != 0;
+        }
+
+        std::string_view ResultIndex::Slice(const uint64_t* index, const char* data, uint64_t dataSize,
+                                            size_t row) const {
+            uint64_t first = index[row];
+            uint64_t last = index[row + 1];
+            if (first > last || last > dataSize) {
+                return {};
+            }
+            return std::string_view(data + first, static_cast<size_t>(last - first));
+        }
+
+        std::string_view ResultIndex::Name(size_t row) const {
+            return Slice(nameIndex, nameData, nameBytes, row);
+        }
+
+        std::string ResultIndex::Path(size_t row) const {
+            uint32_t directory = directoryIds[row];
+            std::string path;
+            if (directory < directoryCount) {
+                path = std::string(Slice(directoryIndex, directoryData, directoryBytes, directory));
+            }
+            if (!(flags[row] & ResultStore::FLAG_VERBATIM_PATH)) {
+                path += Name(row);
+            }
+            return path;
+        }
+
+        std::string ResultIndex::RecoveryPath(size_t row) const {
+            uint32_t directory = recoveryIds[row];
+            if (!(flags[row] & ResultStore::FLAG_RECOVERED) || directory >= directoryCount) {
+                return std::string();
+            }
+            std::string path(Slice(directoryIndex, directoryData, directoryBytes, directory));
+            if (!(flags[row] & ResultStore::FLAG_VERBATIM_RECOVERY)) {
+                path += Name(row);
+            }
+            return path;
+        }
+
+        std::string_view ResultIndex::Checksum(size_t row) const {
+            return Slice(checksumIndex, checksumData, checksumBytes, row);
+        }
+
+        std::pair<const FileExtent*, size_t> ResultIndex::Extents(size_t row) const {
+            uint64_t first = extentIndex[row];
+            uint64_t last = extentIndex[row + 1];
+            if (first > last || last > extentCount) {
+                return {nullptr, 0};
+            }
+            return {extentData + first, static_cast<size_t>(last - first)};
+        }
+
+        std::pair<const uint8_t*, size_t> ResultIndex::InlineData(size_t row) const {
+            uint64_t first = inlineIndex[row];
+            uint64_t last = inlineIndex[row + 1];
+            if (first > last || last > inlineCount) {
+                return {nullptr, 0};
+            }
+            return {inlineBytes + first, static_cast<size_t>(last - first)};
+        }
+
+        // Sessions --------------------------------------------------------
+
+        std::string DefaultSessionDirectory() {
+#ifdef _WIN32
+            const char* root = std::getenv("LOCALAPPDATA");
+            if (root && *root) {
+                return std::string(root) + "\\Stellar\\Sessions";
+            }
+#else
+            const char* data = std::getenv("XDG_DATA_HOME");
+            if (data && *data) {
+                return std::string(data) + "/stellar-recovery/sessions";
+            }
+            const char* home = std::getenv("HOME");
+            if (home && *home) {
+                return std::string(home) + "/.local/share/stellar-recovery/sessions";
+            }
+#endif
+            return "sessions";
+        }
+
+        ResultStore LoadResultStore(const std::string& path, RecoverySession* session) {
+            auto index = std::make_shared<const ResultIndex>(path);
+            if (session) {
+                *session = index->Session();
+            }
+            return ResultStore(index);
+        }
+
+        std::string SessionIndexPath(const std::string& directory, const std::string& sessionId) {
+            return (std::filesystem::u8path(directory) / std::filesystem::u8path(sessionId + INDEX_EXTENSION)).u8string();
+        }
+
+        std::vector<RecoverySession> ListSessions(const std::string& directory) {
+            std::vector<RecoverySession> sessions;
+            std::error_code error;
+            for (std::filesystem::directory_iterator it(std::filesystem::u8path(directory), error), end;
+                 !error && it != end; it.increment(error)) {
+                if (it->path().extension() != INDEX_EXTENSION) {
+                    continue;
+                }
+                try {
+                    sessions.push_back(ResultIndex(it->path().u8string()).Session());
+                } catch (const ResultIndexError&) {
+                    // Partial writes are renamed into place, so these are foreign or damaged files
+                }
+            }
+            std::sort(sessions.begin(), sessions.end(), [](const RecoverySession& a, const RecoverySession& b) {
+                return a.startTime > b.startTime;
+            });
+            return sessions;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
@@ -0,0 +1,158 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Persistent Result Index
+ *
+ * Scan results are saved per session as a columnar binary file: a
+ * fixed header, a section table, and one 8-byte aligned section per
+ * column. Rows are sorted by file type and source offset, so each type
+ * is a contiguous row range. Reopening a session maps the file and
+ * reads columns in place, either through ResultIndex or through a
+ * ResultStore whose columns point into the mapping.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_RESULT_INDEX_H
+#define STELLAR_RESULT_INDEX_H
+
+#include "stellar_recovery.h"
+#include "image_source.h"
+#include "result_store.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        /**
+         * Raised when an index cannot be written or is malformed
+         */
+        class ResultIndexError : public std::runtime_error {
+        public:
+            explicit ResultIndexError(const std::string& message) : std::runtime_error(message) {}
+        };
+
+        /**
+         * Writes the rows of a result store as an index file
+         */
+        class ResultIndexWriter {
+        public:
+            ResultIndexWriter(const RecoverySession& session, const ResultStore& results);
+
+            size_t Count() const { return results.Count(); }
+
+            /**
+             * Sort rows by type and offset and write the index. The file is
+             * written beside path and renamed over it, so a crash never
+             * leaves a truncated index behind.
+             */
+            void Write(const std::string& path) const;
+
+        private:
+            RecoverySession session;
+            const ResultStore& results;
+        };
+
+        /**
+         * Read-only view of a saved index. Accessors read the mapping
+         * directly; row numbers are in (type, offset) order.
+         */
+        class ResultIndex {
+        public:
+            explicit ResultIndex(const std::string& path);
+
+            const RecoverySession& Session() const { return session; }
+            size_t Count() const { return rows; }
+
+            // Rows holding one file type, as [first, first + count)
+            std::pair<size_t, size_t> TypeRange(TargetFileType type) const;
+
+            TargetFileType Type(size_t row) const;
+            uint64_t Offset(size_t row) const { return offsets[row]; }
+            uint64_t Size(size_t row) const { return sizes[row]; }
+            std::chrono::system_clock::time_point Modified(size_t row) const;
+            double Confidence(size_t row) const { return confidence[row] / 65535.0; }
+            bool IsRecovered(size_t row) const;
+
+            std::string_view Name(size_t row) const;
+            std::string Path(size_t row) const;
+            std::string RecoveryPath(size_t row) const;
+            std::string_view Checksum(size_t row) const;
+
+            // Data runs of a row; empty for carved results
+            std::pair<const FileExtent*, size_t> Extents(size_t row) const;
+            std::pair<const uint8_t*, size_t> InlineData(size_t row) const;
+
+        private:
+            friend class ResultStore;
+
+            template <typename T>
+            const T* Column(uint32_t id, uint64_t count) const;
+            std::string_view Slice(const uint64_t* index, const char* data, uint64_t dataSize, size_t row) const;
+
+            std::unique_ptr<MappedImageSource> file;
+            const uint8_t* base = nullptr;
+            uint64_t fileSize = 0;
+            uint32_t sectionCount = 0;
+            RecoverySession session;
+            size_t rows = 0;
+
+            const uint64_t* typeRanges = nullptr;
+            const uint64_t* offsets = nullptr;
+            const uint64_t* sizes = nullptr;
+            const int64_t* modified = nullptr;
+            const uint16_t* confidence = nullptr;
+            const uint8_t* flags = nullptr;
+            const uint8_t* types = nullptr;
+            const uint32_t* directoryIds = nullptr;
+            const uint32_t* recoveryIds = nullptr;
+            const uint64_t* directoryIndex = nullptr;
+            const char* directoryData = nullptr;
+            const uint64_t* nameIndex = nullptr;
+            const char* nameData = nullptr;
+            const uint64_t* extentIndex = nullptr;
+            const FileExtent* extentData = nullptr;
+            const uint64_t* inlineIndex = nullptr;
+            const uint8_t* inlineBytes = nullptr;
+            const uint64_t* checksumIndex = nullptr;
+            const char* checksumData = nullptr;
+            uint64_t directoryCount = 0;
+            uint64_t directoryBytes = 0;
+            uint64_t nameBytes = 0;
+            uint64_t extentCount = 0;
+            uint64_t inlineCount = 0;
+            uint64_t checksumBytes = 0;
+        };
+
+        /**
+         * Reopen a saved session as a result store. Columns are read from
+         * the mapping and copied only when a row is changed, so loading
+         * costs the same for ten rows as for ten million. The session
+         * header is copied to session when one is given.
+         */
+        ResultStore LoadResultStore(const std::string& path, RecoverySession* session = nullptr);
+
+        // Per-user directory holding saved sessions
+        std::string DefaultSessionDirectory();
+
+        // Index file of a session inside directory
+        std::string SessionIndexPath(const std::string& directory, const std::string& sessionId);
+
+        /**
+         * Headers of the sessions saved in directory, newest first.
+         * Unreadable files are skipped.
+         */
+        std::vector<RecoverySession> ListSessions(const std::string& directory);
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_RESULT_INDEX_H
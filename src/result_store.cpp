@@ -0,0 +1,261 @@
+/**
+ * Stellar Data Recovery Pro Free - Columnar Result Store
+ *
+ * Row append, accessors, selection and sorting.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "result_store.h"
+#include "result_index.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Stellar {
+    namespace Recovery {
+
+        ResultStore::ResultStore() {
+            nameIndex.PushBack(0);
+            extentIndex.PushBack(0);
+            inlineIndex.PushBack(0);
+        }
+
+        ResultStore::ResultStore(std::shared_ptr<const ResultIndex> index) : index(index) {
+            const size_t rows = index->Count();
+            types.Attach(index->types, rows);
+            offsets.Attach(index->offsets, rows);
+            sizes.Attach(index->sizes, rows);
+            modified.Attach(index->modified, rows);
+            confidence.Attach(index->confidence, rows);
+            flags.Attach(index->flags, rows);
+            directoryIds.Attach(index->directoryIds, rows);
+            recoveryIds.Attach(index->recoveryIds, rows);
+            nameIndex.Attach(index->nameIndex, rows + 1);
+            names.Attach(index->nameData, index->nameBytes);
+            extentIndex.Attach(index->extentIndex, rows + 1);
+            extentData.Attach(index->extentData, index->extentCount);
+            inlineIndex.Attach(index->inlineIndex, rows + 1);
+            inlineData.Attach(index->inlineBytes, index->inlineCount);
+            checksumIndex.Attach(index->checksumIndex, rows + 1);
+            checksumData.Attach(index->checksumData, index->checksumBytes);
+
+            directories.reserve(index->directoryCount);
+            for (size_t id = 0; id < index->directoryCount; id++) {
+                directories.push_back(index->Slice(index->directoryIndex, index->directoryData,
+                                                   index->directoryBytes, id));
+            }
+        }
+
+        void ResultStore::Reserve(size_t rows, size_t nameBytes) {
+            types.Reserve(rows);
+            offsets.Reserve(rows);
+            sizes.Reserve(rows);
+            modified.Reserve(rows);
+            confidence.Reserve(rows);
+            flags.Reserve(rows);
+            directoryIds.Reserve(rows);
+            recoveryIds.Reserve(rows);
+            nameIndex.Reserve(rows + 1);
+            extentIndex.Reserve(rows + 1);
+            inlineIndex.Reserve(rows + 1);
+            names.Reserve(nameBytes);
+        }
+
+        uint32_t ResultStore::Add(const ResultRecord& record) {
+            const uint32_t row = static_cast<uint32_t>(offsets.Size());
+            types.PushBack(static_cast<uint8_t>(record.fileType));
+            offsets.PushBack(record.sourceOffset);
+            sizes.PushBack(record.fileSize);
+            modified.PushBack(std::chrono::duration_cast<std::chrono::seconds>(
+                record.dateModified.time_since_epoch()).count());
+            double clamped = std::min(std::max(record.confidence, 0.0), 1.0);
+            confidence.PushBack(static_cast<uint16_t>(std::lround(clamped * 65535.0)));
+
+            // Paths share their directory; only the prefix before the name is interned
+            uint8_t flag = record.isRecovered ? FLAG_RECOVERED : 0;
+            std::string_view path = record.originalPath;
+            std::string_view name = record.fileName;
+            std::string_view prefix;
+            if (path.size() >= name.size() && path.substr(path.size() - name.size()) == name) {
+                prefix = path.substr(0, path.size() - name.size());
+            } else {
+                prefix = path;
+                flag |= FLAG_VERBATIM_PATH;
+            }
+            flags.PushBack(flag);
+            directoryIds.PushBack(Intern(prefix));
+            recoveryIds.PushBack(NO_DIRECTORY);
+
+            names.Append(name.data(), name.size());
+            nameIndex.PushBack(names.Size());
+            extentData.Append(record.extents, record.extentCount);
+            extentIndex.PushBack(extentData.Size());
+            inlineData.Append(record.inlineData, record.inlineSize);
+            inlineIndex.PushBack(inlineData.Size());
+            return row;
+        }
+
+        uint32_t ResultStore::Intern(std::string_view directory) {
+            // Directories of a reopened session are looked up from the first new one on
+            for (size_t id = directoryLookup.size(); id < directories.size(); id++) {
+                directoryLookup.emplace(std::string(directories[id]), static_cast<uint32_t>(id));
+            }
+            auto inserted = directoryLookup.emplace(std::string(directory), static_cast<uint32_t>(directories.size()));
+            if (inserted.second) {
+                directories.push_back(inserted.first->first);
+            }
+            return inserted.first->second;
+        }
+
+        std::chrono::system_clock::time_point ResultStore::Modified(size_t row) const {
+            return std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::seconds(modified[row])));
+        }
+
+        std::string_view ResultStore::Name(size_t row) const {
+            return std::string_view(names.Data() + nameIndex[row], static_cast<size_t>(nameIndex[row + 1] - nameIndex[row]));
+        }
+
+        std::string ResultStore::Path(size_t row) const {
+            // Ids of a reopened session come from disk; ResultIndex checks the section sizes only
+            uint32_t directory = directoryIds[row];
+            std::string path(directory < directories.size() ? directories[directory] : std::string_view());
+            if (!(flags[row] & FLAG_VERBATIM_PATH)) {
+                path.append(Name(row));
+            }
+            return path;
+        }
+
+        std::string ResultStore::RecoveryPath(size_t row) const {
+            if (recoveryIds[row] >= directories.size()) {
+                return std::string();
+            }
+            std::string path(directories[recoveryIds[row]]);
+            if (!(flags[row] & FLAG_VERBATIM_RECOVERY)) {
+                path.append(Name(row));
+            }
+            return path;
+        }
+
+        std::pair<const FileExtent*, size_t> ResultStore::Extents(size_t row) const {
+            return {extentData.Data() + extentIndex[row], static_cast<size_t>(extentIndex[row + 1] - extentIndex[row])};
+        }
+
+        std::pair<const uint8_t*, size_t> ResultStore::InlineData(size_t row) const {
+            return {inlineData.Data() + inlineIndex[row], static_cast<size_t>(inlineIndex[row + 1] - inlineIndex[row])};
+        }
+
+        void ResultStore::MarkRecovered(size_t row, std::string_view path) {
+            // Renamed outputs (name clashes) keep their whole path
+            std::string_view name = Name(row);
+            uint8_t& flag = flags.Mutable(row);
+            flag |= FLAG_RECOVERED;
+            if (path.size() >= name.size() && path.substr(path.size() - name.size()) == name) {
+                flag &= static_cast<uint8_t>(~FLAG_VERBATIM_RECOVERY);
+                recoveryIds.Mutable(row) = Intern(path.substr(0, path.size() - name.size()));
+            } else {
+                flag |= FLAG_VERBATIM_RECOVERY;
+                recoveryIds.Mutable(row) = Intern(path);
+            }
+        }
+
+        void ResultStore::SetChecksum(size_t row, std::string_view checksum) {
+            // An empty entry also hides a digest saved with the session
+            if (checksum.empty() && row + 1 >= checksumIndex.Size()) {
+                checksums.erase(static_cast<uint32_t>(row));
+            } else {
+                checksums[static_cast<uint32_t>(row)] = std::string(checksum);
+            }
+        }
+
+        std::string_view ResultStore::Checksum(size_t row) const {
+            auto found = checksums.find(static_cast<uint32_t>(row));
+            if (found != checksums.end()) {
+                return found->second;
+            }
+            if (row + 1 < checksumIndex.Size()) {
+                return std::string_view(checksumData.Data() + checksumIndex[row],
+                                        static_cast<size_t>(checksumIndex[row + 1] - checksumIndex[row]));
+            }
+            return std::string_view();
+        }
+
+        ResultSelection ResultStore::All() const {
+            ResultSelection rows(Count());
+            std::iota(rows.begin(), rows.end(), 0u);
+            return rows;
+        }
+
+        ResultSelection ResultStore::Select(const ResultFilter& filter) const {
+            const bool anyType = filter.fileType == TargetFileType::ALL_DATA;
+            const uint8_t type = static_cast<uint8_t>(filter.fileType);
+            const uint16_t minConfidence = static_cast<uint16_t>(
+                std::ceil(std::min(std::max(filter.minConfidence, 0.0), 1.0) * 65535.0));
+
+            ResultSelection rows;
+            for (size_t row = 0; row < Count(); row++) {
+                if ((anyType || types[row] == type) &&
+                    sizes[row] >= filter.minSize && sizes[row] <= filter.maxSize &&
+                    confidence[row] >= minConfidence &&
+                    !(filter.pendingOnly && (flags[row] & FLAG_RECOVERED))) {
+                    rows.push_back(static_cast<uint32_t>(row));
+                }
+            }
+            return rows;
+        }
+
+        void ResultStore::Sort(ResultSelection& rows, ResultSortKey key, bool descending) const {
+            auto sortBy = [&rows, descending](const auto& less) {
+                if (descending) {
+                    std::stable_sort(rows.begin(), rows.end(), [&less](uint32_t a, uint32_t b) { return less(b, a); });
+                } else {
+                    std::stable_sort(rows.begin(), rows.end(), less);
+                }
+            };
+
+            switch (key) {
+                case ResultSortKey::OFFSET:
+                    sortBy([this](uint32_t a, uint32_t b) { return offsets[a] < offsets[b]; });
+                    break;
+                case ResultSortKey::SIZE:
+                    sortBy([this](uint32_t a, uint32_t b) { return sizes[a] < sizes[b]; });
+                    break;
+                case ResultSortKey::NAME:
+                    sortBy([this](uint32_t a, uint32_t b) { return Name(a) < Name(b); });
+                    break;
+                case ResultSortKey::TYPE:
+                    sortBy([this](uint32_t a, uint32_t b) {
+                        return types[a] != types[b] ? types[a] < types[b] : offsets[a] < offsets[b];
+                    });
+                    break;
+                case ResultSortKey::CONFIDENCE:
+                    sortBy([this](uint32_t a, uint32_t b) { return confidence[a] < confidence[b]; });
+                    break;
+                case ResultSortKey::MODIFIED:
+                    sortBy([this](uint32_t a, uint32_t b) { return modified[a] < modified[b]; });
+                    break;
+            }
+        }
+
+        size_t ResultStore::MemoryUsage() const {
+            // Mapped columns are page cache, not heap
+            size_t bytes = types.MemoryUsage() + offsets.MemoryUsage() + sizes.MemoryUsage() +
+                           modified.MemoryUsage() + confidence.MemoryUsage() + flags.MemoryUsage() +
+                           directoryIds.MemoryUsage() + recoveryIds.MemoryUsage() + nameIndex.MemoryUsage() +
+                           names.MemoryUsage() + extentIndex.MemoryUsage() + extentData.MemoryUsage() +
+                           inlineIndex.MemoryUsage() + inlineData.MemoryUsage() +
+                           directories.capacity() * sizeof(std::string_view);
+            for (const auto& directory : directoryLookup) {
+                bytes += directory.first.capacity() + sizeof(std::string) + sizeof(uint32_t);
+            }
+            for (const auto& checksum : checksums) {
+                bytes += checksum.second.capacity() + sizeof(std::string) + sizeof(uint32_t);
+            }
+            return bytes;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
@@ -0,0 +1,264 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Columnar Result Store
+ *
+ * Scan results held column by column instead of as one struct per file.
+ * Names live in a single arena, directory prefixes are interned once,
+ * offsets and sizes are packed 64-bit columns and confidence is
+ * quantized to 16 bits. Filters and sorts work on row selections, so
+ * narrowing by type or size touches only the columns involved. A store
+ * reopened from a session index reads its columns from the mapping.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_RESULT_STORE_H
+#define STELLAR_RESULT_STORE_H
+
+#include "stellar_recovery.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        /**
+         * One scan result as handed to a store. Views must stay valid
+         * until Add() returns.
+         */
+        struct ResultRecord {
+            std::string_view fileName;
+            std::string_view originalPath;
+            TargetFileType fileType;
+            uint64_t sourceOffset;
+            uint64_t fileSize;
+            std::chrono::system_clock::time_point dateModified;
+            double confidence;
+            bool isRecovered;
+            const FileExtent* extents;
+            size_t extentCount;
+            const uint8_t* inlineData;
+            size_t inlineSize;
+
+            ResultRecord() :
+                fileType(TargetFileType::ALL_DATA),
+                sourceOffset(0),
+                fileSize(0),
+                confidence(0.0),
+                isRecovered(false),
+                extents(nullptr),
+                extentCount(0),
+                inlineData(nullptr),
+                inlineSize(0) {}
+        };
+
+        // Row numbers picked out of a store, in the order they are listed
+        using ResultSelection = std::vector<uint32_t>;
+
+        /**
+         * Row predicate for ResultStore::Select. Defaults match every row.
+         */
+        struct ResultFilter {
+            TargetFileType fileType;    // ALL_DATA matches any type
+            uint64_t minSize;
+            uint64_t maxSize;
+            double minConfidence;
+            bool pendingOnly;           // Skip rows already recovered
+
+            ResultFilter() :
+                fileType(TargetFileType::ALL_DATA),
+                minSize(0),
+                maxSize(std::numeric_limits<uint64_t>::max()),
+                minConfidence(0.0),
+                pendingOnly(false) {}
+        };
+
+        enum class ResultSortKey {
+            OFFSET,
+            SIZE,
+            NAME,
+            TYPE,
+            CONFIDENCE,
+            MODIFIED
+        };
+
+        class ResultIndex;
+
+        /**
+         * One column of a result store. Rows appended in memory are owned;
+         * a column opened from a session index reads the mapping in place
+         * and is copied only when it is first written.
+         */
+        template <typename T>
+        class ResultColumn {
+        public:
+            size_t Size() const { return mapped ? mappedCount : owned.size(); }
+            const T* Data() const { return mapped ? mapped : owned.data(); }
+            const T& operator[](size_t index) const { return Data()[index]; }
+
+            void Reserve(size_t count) {
+                Own();
+                owned.reserve(count);
+            }
+
+            void PushBack(const T& value) {
+                Own();
+                owned.push_back(value);
+            }
+
+            void Append(const T* values, size_t count) {
+                Own();
+                owned.insert(owned.end(), values, values + count);
+            }
+
+            T& Mutable(size_t index) {
+                Own();
+                return owned[index];
+            }
+
+            // Read count values in place; they must outlive the column
+            void Attach(const T* values, size_t count) {
+                owned = std::vector<T>();
+                mapped = values;
+                mappedCount = count;
+            }
+
+            size_t MemoryUsage() const { return owned.capacity() * sizeof(T); }
+
+        private:
+            void Own() {
+                if (mapped) {
+                    owned.assign(mapped, mapped + mappedCount);
+                    mapped = nullptr;
+                }
+            }
+
+            std::vector<T> owned;
+            const T* mapped = nullptr;
+            size_t mappedCount = 0;
+        };
+
+        /**
+         * Append-only columnar store of scan results
+         */
+        class ResultStore {
+        public:
+            // Row flags, shared with the session index format
+            static constexpr uint8_t FLAG_RECOVERED = 0x01;
+            static constexpr uint8_t FLAG_VERBATIM_PATH = 0x02;    // Directory string is the whole path
+            static constexpr uint8_t FLAG_VERBATIM_RECOVERY = 0x04;  // Recovery string is the whole path
+
+            ResultStore();
+
+            // Reserve room for rows and their name bytes ahead of a large scan
+            void Reserve(size_t rows, size_t nameBytes = 0);
+
+            // Append a row and return its number
+            uint32_t Add(const ResultRecord& record);
+
+            size_t Count() const { return offsets.Size(); }
+            bool Empty() const { return offsets.Size() == 0; }
+
+            TargetFileType Type(size_t row) const { return static_cast<TargetFileType>(types[row]); }
+            uint64_t Offset(size_t row) const { return offsets[row]; }
+            uint64_t Size(size_t row) const { return sizes[row]; }
+            std::chrono::system_clock::time_point Modified(size_t row) const;
+            double Confidence(size_t row) const { return confidence[row] / 65535.0; }
+            bool IsRecovered(size_t row) const { return (flags[row] & FLAG_RECOVERED) != 0; }
+
+            std::string_view Name(size_t row) const;
+            std::string Path(size_t row) const;
+
+            // Where a recovered row was written; empty while pending
+            std::string RecoveryPath(size_t row) const;
+
+            // Data runs of a row; empty for carved results
+            std::pair<const FileExtent*, size_t> Extents(size_t row) const;
+            std::pair<const uint8_t*, size_t> InlineData(size_t row) const;
+
+            // Record that a row was written to path
+            void MarkRecovered(size_t row, std::string_view path);
+
+            // Hex digest of the recovered file; empty when none was computed
+            void SetChecksum(size_t row, std::string_view checksum);
+            std::string_view Checksum(size_t row) const;
+
+            // Every row in insertion order
+            ResultSelection All() const;
+
+            // Rows matching filter, in insertion order
+            ResultSelection Select(const ResultFilter& filter) const;
+
+            // Stable sort of a selection by one column
+            void Sort(ResultSelection& rows, ResultSortKey key, bool descending = false) const;
+
+            template <typename Function>
+            void ForEach(const ResultSelection& rows, Function&& function) const {
+                for (uint32_t row : rows) {
+                    function(static_cast<size_t>(row));
+                }
+            }
+
+            template <typename Function>
+            void ForEach(Function&& function) const {
+                for (size_t row = 0; row < Count(); row++) {
+                    function(row);
+                }
+            }
+
+            // Heap bytes held by the columns and arenas
+            size_t MemoryUsage() const;
+
+        private:
+            friend class ResultIndexWriter;
+            friend ResultStore LoadResultStore(const std::string& path, RecoverySession* session);
+
+            static constexpr uint32_t NO_DIRECTORY = std::numeric_limits<uint32_t>::max();
+
+            // Columns of a saved session, read in place from its mapping
+            explicit ResultStore(std::shared_ptr<const ResultIndex> index);
+
+            uint32_t Intern(std::string_view directory);
+
+            ResultColumn<uint8_t> types;
+            ResultColumn<uint64_t> offsets;
+            ResultColumn<uint64_t> sizes;
+            ResultColumn<int64_t> modified;         // Seconds since the epoch
+            ResultColumn<uint16_t> confidence;      // Quantized to 1/65535
+            ResultColumn<uint8_t> flags;
+            ResultColumn<uint32_t> directoryIds;
+            ResultColumn<uint32_t> recoveryIds;     // NO_DIRECTORY until recovered
+            ResultColumn<uint64_t> nameIndex;       // Row i spans [nameIndex[i], nameIndex[i + 1])
+            ResultColumn<char> names;
+            ResultColumn<uint64_t> extentIndex;
+            ResultColumn<FileExtent> extentData;
+            ResultColumn<uint64_t> inlineIndex;
+            ResultColumn<uint8_t> inlineData;
+
+            // Digests saved with the session, overridden by checksums set since
+            ResultColumn<uint64_t> checksumIndex;
+            ResultColumn<char> checksumData;
+            std::unordered_map<uint32_t, std::string> checksums;   // Sparse: recovered rows only
+
+            // Interned directory prefixes. Views point at lookup keys (map
+            // nodes keep them in place) or into the session mapping.
+            std::unordered_map<std::string, uint32_t> directoryLookup;
+            std::vector<std::string_view> directories;
+
+            std::shared_ptr<const ResultIndex> index;   // Keeps mapped columns alive
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_RESULT_STORE_H
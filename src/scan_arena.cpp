@@ -0,0 +1,84 @@
+/**
+ * Stellar Data Recovery Pro Free - Scan Arena
+ *
+ * Block management for the per-worker bump allocator.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "scan_arena.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace Stellar {
+    namespace Recovery {
+
+        ScanArena::ScanArena(size_t blockSize) : blockSize(std::max<size_t>(blockSize, 4096)) {}
+
+        ScanArena::~ScanArena() {
+            Release();
+        }
+
+        ScanArena::Block ScanArena::NewBlock(size_t size) {
+            uint8_t* data = static_cast<uint8_t*>(std::malloc(size));
+            if (!data) {
+                throw std::bad_alloc();
+            }
+            return Block{data, size};
+        }
+
+        void* ScanArena::do_allocate(size_t bytes, size_t alignment) {
+            bytes = std::max<size_t>(bytes, 1);
+            if (bytes + alignment > blockSize) {
+                oversized.push_back(NewBlock(bytes + alignment));
+                uintptr_t address = reinterpret_cast<uintptr_t>(oversized.back().data);
+                allocated += bytes;
+                return reinterpret_cast<void*>(address + (alignment - address % alignment) % alignment);
+            }
+
+            // Fill the current block, then move on to retained or new ones
+            for (;; current++, used = 0) {
+                if (current == blocks.size()) {
+                    blocks.push_back(NewBlock(blockSize));
+                }
+                uintptr_t address = reinterpret_cast<uintptr_t>(blocks[current].data) + used;
+                size_t padding = (alignment - address % alignment) % alignment;
+                if (padding + bytes <= blockSize - used) {
+                    used += padding + bytes;
+                    allocated += bytes;
+                    return reinterpret_cast<void*>(address + padding);
+                }
+            }
+        }
+
+        void ScanArena::Reset() {
+            for (const Block& block : oversized) {
+                std::free(block.data);
+            }
+            oversized.clear();
+            current = 0;
+            used = 0;
+            allocated = 0;
+        }
+
+        void ScanArena::Release() {
+            Reset();
+            for (const Block& block : blocks) {
+                std::free(block.data);
+            }
+            blocks.clear();
+        }
+
+        size_t ScanArena::Capacity() const {
+            size_t total = blocks.size() * blockSize;
+            for (const Block& block : oversized) {
+                total += block.size;
+            }
+            return total;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
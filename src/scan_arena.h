@@ -0,0 +1,82 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Scan Arena
+ *
+ * Bump allocator for short-lived scan metadata. Each scan worker owns
+ * one arena, so allocations never contend on the global heap, and all
+ * memory handed out for a chunk is dropped at once by Reset(). The arena
+ * is a std::pmr::memory_resource, so pmr containers and allocator-aware
+ * records such as RecoverableFile can be placed in it directly.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_SCAN_ARENA_H
+#define STELLAR_SCAN_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        constexpr size_t DEFAULT_ARENA_BLOCK_SIZE = 1024 * 1024;
+
+        /**
+         * Single-threaded arena. Deallocation is a no-op; memory comes back
+         * when the arena is reset or destroyed.
+         */
+        class ScanArena : public std::pmr::memory_resource {
+        public:
+            explicit ScanArena(size_t blockSize = DEFAULT_ARENA_BLOCK_SIZE);
+            ~ScanArena() override;
+
+            ScanArena(const ScanArena&) = delete;
+            ScanArena& operator=(const ScanArena&) = delete;
+
+            /**
+             * Drop every allocation at once. Regular blocks are kept for the
+             * next chunk; blocks made for oversized requests are freed.
+             */
+            void Reset();
+
+            // Return all blocks to the system
+            void Release();
+
+            // Bytes handed out since the last reset
+            size_t BytesAllocated() const { return allocated; }
+
+            // Bytes held in blocks
+            size_t Capacity() const;
+
+        protected:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void*, size_t, size_t) override {}
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+
+        private:
+            struct Block {
+                uint8_t* data;
+                size_t size;
+            };
+
+            Block NewBlock(size_t size);
+
+            size_t blockSize;
+            std::vector<Block> blocks;
+            std::vector<Block> oversized;   // One per request larger than a block
+            size_t current = 0;         // Block being filled
+            size_t used = 0;            // Bytes used in the current block
+            size_t allocated = 0;
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_SCAN_ARENA_H
@@ -0,0 +1,373 @@
+/**
+ * Stellar Data Recovery Pro Free - Scan Checkpoints
+ *
+ * Journal encoding, torn-tail recovery and fsync-backed commits.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "scan_checkpoint.h"
+#include "file_signatures.h"
+#include "byte_order.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            constexpr char CHECKPOINT_MAGIC[8] = {'S', 'T', 'L', 'R', 'C', 'K', 'P', '\0'};
+            constexpr uint32_t CHECKPOINT_VERSION = 1;
+            constexpr const char* CHECKPOINT_EXTENSION = ".ckpt";
+
+            enum RecordType : uint32_t {
+                RECORD_EXTENTS = 1,     // u32 count, then per extent: u64 extent, u32 hits, hits
+                RECORD_CURSOR = 2       // u64 next, u32 seam bytes, seam, u32 hits, hits
+            };
+
+            constexpr size_t RECORD_HEADER = 16;   // u32 type, u32 length, u64 checksum
+            constexpr size_t HIT_BYTES = 12;       // u64 offset, u32 signature | footer bit
+
+            uint64_t Fnv1a(const uint8_t* data, size_t length) {
+                uint64_t hash = 14695981039346656037ull;
+                for (size_t i = 0; i < length; i++) {
+                    hash = (hash ^ data[i]) * 1099511628211ull;
+                }
+                return hash;
+            }
+
+            void PutHits(std::vector<uint8_t>& out, const CarveHit* hits, size_t count) {
+                PutLE32(out, static_cast<uint32_t>(count));
+                for (size_t i = 0; i < count; i++) {
+                    PutLE64(out, hits[i].offset);
+                    uint32_t signature = static_cast<uint32_t>(hits[i].signature - FILE_SIGNATURES);
+                    PutLE32(out, signature | (hits[i].isFooter ? 0x80000000u : 0));
+                }
+            }
+
+            /**
+             * Bounds-checked little-endian reader over a byte range
+             */
+            class ByteReader {
+            public:
+                ByteReader(const uint8_t* data, size_t length) : data(data), length(length) {}
+
+                bool Has(size_t bytes) const { return bytes <= length - position; }
+
+                uint32_t Get32() {
+                    uint32_t value = Has(4) ? ReadLE32(data + position) : 0;
+                    position += Has(4) ? 4 : 0;
+                    return value;
+                }
+
+                uint64_t Get64() {
+                    uint64_t value = Has(8) ? ReadLE64(data + position) : 0;
+                    position += Has(8) ? 8 : 0;
+                    return value;
+                }
+
+                bool GetString(std::string& value) {
+                    uint32_t size = Get32();
+                    if (!Has(size)) {
+                        return false;
+                    }
+                    value.assign(reinterpret_cast<const char*>(data + position), size);
+                    position += size;
+                    return true;
+                }
+
+                bool GetBytes(std::vector<uint8_t>& value, size_t size) {
+                    if (!Has(size)) {
+                        return false;
+                    }
+                    value.assign(data + position, data + position + size);
+                    position += size;
+                    return true;
+                }
+
+                bool GetHits(std::vector<CarveHit>& hits) {
+                    uint32_t count = Get32();
+                    if (count > (length - position) / HIT_BYTES) {
+                        return false;
+                    }
+                    for (uint32_t i = 0; i < count; i++) {
+                        uint64_t offset = Get64();
+                        uint32_t signature = Get32();
+                        if ((signature & 0x7FFFFFFFu) >= FILE_SIGNATURE_COUNT) {
+                            return false;
+                        }
+                        hits.emplace_back(offset, &FILE_SIGNATURES[signature & 0x7FFFFFFFu],
+                                          (signature & 0x80000000u) != 0);
+                    }
+                    return true;
+                }
+
+                void Skip(size_t bytes) {
+                    position += Has(bytes) ? bytes : length - position;
+                }
+
+                size_t Position() const { return position; }
+
+            private:
+                const uint8_t* data;
+                size_t length;
+                size_t position = 0;
+            };
+
+            std::vector<uint8_t> EncodeKey(const CheckpointKey& key) {
+                std::vector<uint8_t> out(CHECKPOINT_MAGIC, CHECKPOINT_MAGIC + sizeof(CHECKPOINT_MAGIC));
+                PutLE32(out, CHECKPOINT_VERSION);
+                PutLE64(out, key.sourceSize);
+                PutLE64(out, key.startOffset);
+                PutLE64(out, key.endOffset);
+                PutLE64(out, key.extentSize);
+                PutLE32(out, key.scanMode);
+                PutLE32(out, key.targetType);
+                PutLE32(out, key.configuration);
+                PutString(out, key.sessionId);
+                PutString(out, key.sourcePath);
+                PutLE64(out, Fnv1a(out.data(), out.size()));
+                return out;
+            }
+
+            bool DecodeKey(ByteReader& in, const uint8_t* data, CheckpointKey& key) {
+                if (!in.Has(sizeof(CHECKPOINT_MAGIC)) ||
+                    std::memcmp(data, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0) {
+                    return false;
+                }
+                in.Get64();
+                if (in.Get32() != CHECKPOINT_VERSION) {
+                    return false;
+                }
+                key.sourceSize = in.Get64();
+                key.startOffset = in.Get64();
+                key.endOffset = in.Get64();
+                key.extentSize = in.Get64();
+                key.scanMode = in.Get32();
+                key.targetType = in.Get32();
+                key.configuration = in.Get32();
+                if (!in.GetString(key.sessionId) || !in.GetString(key.sourcePath)) {
+                    return false;
+                }
+                size_t end = in.Position();
+                return in.Has(8) && in.Get64() == Fnv1a(data, end);
+            }
+
+            std::vector<uint8_t> ReadJournal(const std::string& path, size_t limit = SIZE_MAX) {
+                std::ifstream in(std::filesystem::u8path(path), std::ios::binary | std::ios::ate);
+                if (!in) {
+                    return {};
+                }
+                std::vector<uint8_t> data(static_cast<size_t>(std::min<std::streamoff>(
+                    in.tellg(), static_cast<std::streamoff>(std::min<size_t>(limit, PTRDIFF_MAX)))));
+                in.seekg(0);
+                in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+                data.resize(static_cast<size_t>(in.gcount()));
+                return data;
+            }
+
+        } // namespace
+
+        bool CheckpointKey::Matches(const CheckpointKey& other) const {
+            return sourcePath == other.sourcePath && sourceSize == other.sourceSize &&
+                   startOffset == other.startOffset && endOffset == other.endOffset &&
+                   extentSize == other.extentSize && scanMode == other.scanMode &&
+                   targetType == other.targetType && configuration == other.configuration;
+        }
+
+        ScanCheckpoint::ScanCheckpoint(const std::string& path, const CheckpointKey& key,
+                                       std::chrono::milliseconds commitInterval) :
+            path(path), key(key), commitInterval(commitInterval),
+            lastCommit(std::chrono::steady_clock::now()) {
+            std::error_code error;
+            std::filesystem::path location = std::filesystem::u8path(path);
+            if (location.has_parent_path()) {
+                std::filesystem::create_directories(location.parent_path(), error);
+            }
+            Load();
+        }
+
+        ScanCheckpoint::~ScanCheckpoint() {
+            if (file) {
+                try {
+                    Commit();
+                } catch (const ScanCheckpointError&) {
+                }
+                std::fclose(file);
+            }
+        }
+
+        void ScanCheckpoint::Load() {
+            std::vector<uint8_t> data = ReadJournal(path);
+            ByteReader in(data.data(), data.size());
+            CheckpointKey stored;
+            size_t valid = 0;
+
+            if (DecodeKey(in, data.data(), stored) && stored.Matches(key)) {
+                key.sessionId = stored.sessionId;
+                valid = in.Position();
+
+                // Replay records up to the first torn or corrupt one
+                while (in.Has(RECORD_HEADER)) {
+                    uint32_t type = in.Get32();
+                    uint32_t length = in.Get32();
+                    uint64_t checksum = in.Get64();
+                    size_t start = in.Position();
+                    if (!in.Has(length) || Fnv1a(data.data() + start, length) != checksum) {
+                        break;
+                    }
+                    ByteReader record(data.data() + start, length);
+                    bool ok = true;
+                    if (type == RECORD_EXTENTS) {
+                        uint32_t count = record.Get32();
+                        for (uint32_t i = 0; i < count && ok; i++) {
+                            uint64_t extent = record.Get64();
+                            std::vector<CarveHit> hits;
+                            ok = record.GetHits(hits);
+                            extents[extent] = std::move(hits);
+                        }
+                    } else if (type == RECORD_CURSOR) {
+                        cursor = record.Get64();
+                        ok = record.GetBytes(seam, record.Get32()) && record.GetHits(streamHits);
+                    }
+                    if (!ok) {
+                        break;
+                    }
+                    in.Skip(length);
+                    valid = in.Position();
+                }
+                resumed = true;
+            }
+
+            if (resumed) {
+                std::error_code error;
+                std::filesystem::resize_file(std::filesystem::u8path(path), valid, error);
+                file = std::fopen(path.c_str(), "ab");
+            } else {
+                extents.clear();
+                cursor = 0;
+                seam.clear();
+                streamHits.clear();
+                file = std::fopen(path.c_str(), "wb");
+                if (file) {
+                    std::vector<uint8_t> header = EncodeKey(key);
+                    std::fwrite(header.data(), 1, header.size(), file);
+                }
+            }
+            if (!file) {
+                throw ScanCheckpointError("Cannot write checkpoint " + path + ": " + std::strerror(errno));
+            }
+            if (!resumed) {
+                Commit();
+            }
+        }
+
+        std::vector<CarveHit> ScanCheckpoint::TakeExtentHits(uint64_t extent) {
+            auto it = extents.find(extent);
+            return it != extents.end() ? std::move(it->second) : std::vector<CarveHit>();
+        }
+
+        std::vector<CarveHit> ScanCheckpoint::TakeStreamHits() {
+            return std::move(streamHits);
+        }
+
+        void ScanCheckpoint::RecordExtent(uint64_t extent, const std::vector<CarveHit>& hits) {
+            std::vector<uint8_t> payload;
+            PutLE32(payload, 1);
+            PutLE64(payload, extent);
+            PutHits(payload, hits.data(), hits.size());
+            Append(RECORD_EXTENTS, payload);
+            extents[extent];
+        }
+
+        void ScanCheckpoint::RecordCursor(uint64_t next, const std::vector<uint8_t>& seamBytes,
+                                          const CarveHit* hits, size_t hitCount) {
+            std::vector<uint8_t> payload;
+            PutLE64(payload, next);
+            PutLE32(payload, static_cast<uint32_t>(seamBytes.size()));
+            payload.insert(payload.end(), seamBytes.begin(), seamBytes.end());
+            PutHits(payload, hits, hitCount);
+            Append(RECORD_CURSOR, payload);
+            cursor = next;
+        }
+
+        void ScanCheckpoint::Append(uint32_t type, const std::vector<uint8_t>& payload) {
+            PutLE32(pending, type);
+            PutLE32(pending, static_cast<uint32_t>(payload.size()));
+            PutLE64(pending, Fnv1a(payload.data(), payload.size()));
+            pending.insert(pending.end(), payload.begin(), payload.end());
+        }
+
+        void ScanCheckpoint::Commit() {
+            if (!file) {
+                return;
+            }
+            if (!pending.empty() && std::fwrite(pending.data(), 1, pending.size(), file) != pending.size()) {
+                throw ScanCheckpointError("Cannot write checkpoint " + path + ": " + std::strerror(errno));
+            }
+            pending.clear();
+            std::fflush(file);
+#ifdef _WIN32
+            _commit(_fileno(file));
+#else
+            fsync(fileno(file));
+#endif
+            lastCommit = std::chrono::steady_clock::now();
+        }
+
+        void ScanCheckpoint::CommitIfDue() {
+            if (std::chrono::steady_clock::now() - lastCommit >= commitInterval) {
+                Commit();
+            }
+        }
+
+        void ScanCheckpoint::Discard() {
+            if (file) {
+                std::fclose(file);
+                file = nullptr;
+            }
+            pending.clear();
+            std::error_code error;
+            std::filesystem::remove(std::filesystem::u8path(path), error);
+        }
+
+        std::string CheckpointPath(const std::string& directory, const std::string& sessionId) {
+            return (std::filesystem::u8path(directory) /
+                    std::filesystem::u8path(sessionId + CHECKPOINT_EXTENSION)).u8string();
+        }
+
+        bool FindCheckpoint(const std::string& directory, const CheckpointKey& key, CheckpointKey& found) {
+            std::error_code error;
+            for (std::filesystem::directory_iterator it(std::filesystem::u8path(directory), error), end;
+                 !error && it != end; it.increment(error)) {
+                if (it->path().extension() != CHECKPOINT_EXTENSION) {
+                    continue;
+                }
+                // The key sits at the front; hit records are not needed
+                std::vector<uint8_t> data = ReadJournal(it->path().u8string(), 64 * 1024);
+                ByteReader in(data.data(), data.size());
+                CheckpointKey stored;
+                if (DecodeKey(in, data.data(), stored) && stored.Matches(key)) {
+                    found = stored;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
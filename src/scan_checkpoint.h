@@ -0,0 +1,153 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Scan Checkpoints
+ *
+ * Append-only journal that lets an interrupted carving scan resume.
+ * Parallel scans record each finished extent with its hits; sequential
+ * scans record the stream cursor, the seam bytes the carver still has
+ * to rescan, and the hits found since the previous record. Records are
+ * checksummed, so a torn tail left by a crash is dropped on reload.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_SCAN_CHECKPOINT_H
+#define STELLAR_SCAN_CHECKPOINT_H
+
+#include "signature_carver.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        /**
+         * Raised when the checkpoint journal cannot be written
+         */
+        class ScanCheckpointError : public std::runtime_error {
+        public:
+            explicit ScanCheckpointError(const std::string& message) : std::runtime_error(message) {}
+        };
+
+        /**
+         * Identifies the scan a checkpoint belongs to. A checkpoint is only
+         * resumed by a scan with the same key (the session id aside).
+         */
+        struct CheckpointKey {
+            std::string sessionId;
+            std::string sourcePath;
+            uint64_t sourceSize;
+            uint64_t startOffset;
+            uint64_t endOffset;
+            uint64_t extentSize;        // Parallel extent size; 0 for sequential scans
+            uint32_t scanMode;
+            uint32_t targetType;
+            uint32_t configuration;     // Carver settings that change the hits
+
+            CheckpointKey() :
+                sourceSize(0),
+                startOffset(0),
+                endOffset(0),
+                extentSize(0),
+                scanMode(0),
+                targetType(0),
+                configuration(0) {}
+
+            bool Matches(const CheckpointKey& other) const;
+        };
+
+        /**
+         * Checkpoint journal of one scan. Not thread-safe; scanners call it
+         * from their coordinating thread.
+         */
+        class ScanCheckpoint {
+        public:
+            /**
+             * Open the journal at path. An existing journal with a matching
+             * key is loaded for resumption; anything else is replaced.
+             * Throws ScanCheckpointError if the file cannot be written.
+             */
+            ScanCheckpoint(const std::string& path, const CheckpointKey& key,
+                           std::chrono::milliseconds commitInterval = std::chrono::seconds(5));
+            ~ScanCheckpoint();
+
+            ScanCheckpoint(const ScanCheckpoint&) = delete;
+            ScanCheckpoint& operator=(const ScanCheckpoint&) = delete;
+
+            const CheckpointKey& Key() const { return key; }
+            const std::string& Path() const { return path; }
+            bool Resumed() const { return resumed; }
+
+            // Parallel scans -------------------------------------------------
+
+            bool IsExtentDone(uint64_t extent) const { return extents.count(extent) != 0; }
+            size_t CompletedExtents() const { return extents.size(); }
+
+            // Hits recorded for a finished extent; moved out, so call once
+            std::vector<CarveHit> TakeExtentHits(uint64_t extent);
+
+            void RecordExtent(uint64_t extent, const std::vector<CarveHit>& hits);
+
+            // Sequential scans -----------------------------------------------
+
+            // Next byte to read, or 0 with nothing recorded
+            uint64_t Cursor() const { return cursor; }
+
+            // Tail of the previous chunk the carver must rescan with the next
+            const std::vector<uint8_t>& Seam() const { return seam; }
+
+            std::vector<CarveHit> TakeStreamHits();
+
+            void RecordCursor(uint64_t next, const std::vector<uint8_t>& seamBytes,
+                              const CarveHit* hits, size_t hitCount);
+
+            // Durability -------------------------------------------------------
+
+            // Write buffered records and flush them to stable storage
+            void Commit();
+
+            // Commit if the interval has passed since the last commit
+            void CommitIfDue();
+
+            // Delete the journal once the scan has finished and been saved
+            void Discard();
+
+        private:
+            void Load();
+            void Append(uint32_t type, const std::vector<uint8_t>& payload);
+
+            std::string path;
+            CheckpointKey key;
+            std::chrono::milliseconds commitInterval;
+            std::chrono::steady_clock::time_point lastCommit;
+            std::FILE* file = nullptr;
+            bool resumed = false;
+
+            std::unordered_map<uint64_t, std::vector<CarveHit>> extents;
+            uint64_t cursor = 0;
+            std::vector<uint8_t> seam;
+            std::vector<CarveHit> streamHits;
+            std::vector<uint8_t> pending;       // Records not yet written
+        };
+
+        // Checkpoint file of a session inside directory
+        std::string CheckpointPath(const std::string& directory, const std::string& sessionId);
+
+        /**
+         * Look for an unfinished scan in directory matching key. On success
+         * found holds the stored key, including its session id.
+         */
+        bool FindCheckpoint(const std::string& directory, const CheckpointKey& key, CheckpointKey& found);
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_SCAN_CHECKPOINT_H
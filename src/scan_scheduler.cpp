@@ -0,0 +1,338 @@
+/**
+ * Stellar Data Recovery Pro Free - Parallel Scan Scheduler
+ *
+ * Work-stealing pool and partitioned carving scan.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "scan_scheduler.h"
+#include "scan_checkpoint.h"
+#include "scan_arena.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            /**
+             * Read a range one sector at a time after a larger read failed.
+             * Unreadable sectors are zero filled (the source counts each
+             * failure); returns the bytes up to the end of the source.
+             */
+            size_t ReadSectorsZeroFilled(SectorSource& source, uint64_t offset, uint8_t* buffer,
+                                         size_t length, uint32_t sectorSize) {
+                size_t total = 0;
+                while (total < length) {
+                    size_t request = std::min<size_t>(sectorSize, length - total);
+                    size_t got = 0;
+                    try {
+                        got = source.ReadAt(offset + total, buffer + total, request);
+                    } catch (const SectorReadError&) {
+                        std::memset(buffer + total, 0, request);
+                        got = request;
+                    }
+                    total += got;
+                    if (got < request) {
+                        break;
+                    }
+                }
+                return total;
+            }
+
+        } // namespace
+
+        size_t GetDefaultWorkerCount() {
+#ifdef _WIN32
+            SYSTEM_INFO sysInfo;
+            GetSystemInfo(&sysInfo);
+            size_t count = sysInfo.dwNumberOfProcessors;
+#else
+            size_t count = std::thread::hardware_concurrency();
+#endif
+            return std::max<size_t>(count, 1);
+        }
+
+        // WorkStealingPool ------------------------------------------------
+
+        WorkStealingPool::WorkStealingPool(size_t workers) {
+            size_t count = workers ? workers : GetDefaultWorkerCount();
+            for (size_t i = 0; i < count; i++) {
+                queues.push_back(std::make_unique<Queue>());
+            }
+            for (size_t i = 0; i < count; i++) {
+                threads.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+            }
+        }
+
+        WorkStealingPool::~WorkStealingPool() {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                stopping = true;
+            }
+            workAvailable.notify_all();
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+
+        void WorkStealingPool::Submit(size_t worker, Task task) {
+            Queue& queue = *queues[worker % queues.size()];
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(std::move(task));
+            }
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                pending++;
+                queued++;
+            }
+            workAvailable.notify_one();
+        }
+
+        void WorkStealingPool::WaitIdle() {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            idle.wait(lock, [this] { return pending == 0; });
+        }
+
+        bool WorkStealingPool::WaitIdleFor(std::chrono::milliseconds timeout) {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            return idle.wait_for(lock, timeout, [this] { return pending == 0; });
+        }
+
+        bool WorkStealingPool::TakeTask(size_t worker, Task& task) {
+            {
+                Queue& own = *queues[worker];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.front());
+                    own.tasks.pop_front();
+                    return true;
+                }
+            }
+
+            // Steal from the far end so the owner keeps its sequential run
+            for (size_t step = 1; step < queues.size(); step++) {
+                Queue& victim = *queues[(worker + step) % queues.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.back());
+                    victim.tasks.pop_back();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void WorkStealingPool::WorkerLoop(size_t worker) {
+            while (true) {
+                Task task;
+                if (TakeTask(worker, task)) {
+                    {
+                        std::lock_guard<std::mutex> lock(stateMutex);
+                        queued--;
+                    }
+                    task(worker);
+
+                    std::lock_guard<std::mutex> lock(stateMutex);
+                    if (--pending == 0) {
+                        idle.notify_all();
+                    }
+                    continue;
+                }
+
+                // queued may briefly count a task another worker just took
+                std::unique_lock<std::mutex> lock(stateMutex);
+                workAvailable.wait(lock, [this] { return stopping || queued > 0; });
+                if (stopping) {
+                    return;
+                }
+            }
+        }
+
+        // ParallelScanner -------------------------------------------------
+
+        ParallelScanner::ParallelScanner(SectorSource& source, const SignatureCarver& carver,
+                                         const ParallelScanOptions& options) :
+            source(source),
+            carver(carver),
+            options(options),
+            workers(options.workers ? options.workers : GetDefaultWorkerCount()) {
+            size_t extent = std::max<size_t>(this->options.extentSize, IO_ALIGNMENT);
+            this->options.extentSize = extent - extent % IO_ALIGNMENT;
+        }
+
+        std::vector<CarveHit> ParallelScanner::Run(const ProgressCallback& progress, ScanCheckpoint* checkpoint) {
+            const uint32_t sectorSize = std::max<uint32_t>(source.SectorSize(), 1);
+            const uint64_t start = options.startOffset - options.startOffset % sectorSize;
+            const uint64_t end = options.endOffset ? std::min(options.endOffset, source.Size()) : source.Size();
+            if (start >= end) {
+                return {};
+            }
+
+            const size_t extentSize = options.extentSize;
+            const size_t overlap = carver.Overlap();
+            const size_t extentCount = static_cast<size_t>((end - start + extentSize - 1) / extentSize);
+
+            std::vector<std::vector<CarveHit>> extentHits(extentCount);
+            std::atomic<uint64_t> bytesDone(0);
+
+            // Extents a previous run finished are taken from the checkpoint
+            std::vector<size_t> remaining;
+            remaining.reserve(extentCount);
+            for (size_t extent = 0; extent < extentCount; extent++) {
+                if (checkpoint && checkpoint->IsExtentDone(extent)) {
+                    extentHits[extent] = checkpoint->TakeExtentHits(extent);
+                    uint64_t offset = start + static_cast<uint64_t>(extent) * extentSize;
+                    bytesDone += std::min<uint64_t>(extentSize, end - offset);
+                } else {
+                    remaining.push_back(extent);
+                }
+            }
+            const size_t poolSize = std::min(workers, remaining.size());
+
+            // Mapped sources are scanned in place; others are copied per extent
+            const uint8_t* mapped = source.View(start, static_cast<size_t>(end - start));
+            std::vector<AlignedBuffer> buffers;
+            for (size_t i = 0; i < poolSize && !mapped; i++) {
+                buffers.emplace_back(extentSize + overlap + IO_ALIGNMENT);
+            }
+            // Per-worker scratch for candidate lists, emptied before each extent
+            std::vector<std::unique_ptr<ScanArena>> arenas;
+            for (size_t i = 0; i < poolSize; i++) {
+                arenas.push_back(std::make_unique<ScanArena>());
+            }
+
+            std::atomic<bool> aborted(false);
+            std::mutex errorMutex;
+            std::exception_ptr error;
+            // Extents scanned to completion, waiting to be recorded
+            std::mutex finishedMutex;
+            std::vector<size_t> finished;
+
+            auto extentFinished = [&](size_t extent) {
+                if (checkpoint) {
+                    std::lock_guard<std::mutex> lock(finishedMutex);
+                    finished.push_back(extent);
+                }
+            };
+            auto recordFinished = [&]() {
+                std::vector<size_t> batch;
+                {
+                    std::lock_guard<std::mutex> lock(finishedMutex);
+                    batch.swap(finished);
+                }
+                for (size_t extent : batch) {
+                    checkpoint->RecordExtent(extent, extentHits[extent]);
+                }
+            };
+
+            auto extentScanned = [&](size_t extent, size_t length) {
+                MetricsRegistry& metrics = MetricsRegistry::Global();
+                metrics.Add(Counter::SECTORS_SCANNED, (length + sectorSize - 1) / sectorSize);
+                metrics.Add(Counter::SIGNATURE_HITS, extentHits[extent].size());
+                extentFinished(extent);
+            };
+
+            auto scanExtent = [&](size_t extent, size_t worker) {
+                if (aborted.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                MetricsTimer timer(Histogram::EXTENT_SCAN);
+                uint64_t offset = start + static_cast<uint64_t>(extent) * extentSize;
+                size_t length = static_cast<size_t>(std::min<uint64_t>(extentSize, end - offset));
+                size_t window = static_cast<size_t>(std::min<uint64_t>(length + overlap, end - offset));
+
+                ScanArena& arena = *arenas[worker];
+                arena.Reset();
+                try {
+                    if (mapped) {
+                        carver.Scan(mapped + (offset - start), window, offset, extentHits[extent], length, &arena);
+                        bytesDone += length;
+                        MetricsRegistry::Global().Add(Counter::BYTES_READ, length);
+                        extentScanned(extent, length);
+                        return;
+                    }
+                    AlignedBuffer& buffer = buffers[worker];
+                    size_t request = std::min(buffer.Size(), window + (sectorSize - window % sectorSize) % sectorSize);
+                    size_t got = 0;
+                    try {
+                        got = source.ReadAt(offset, buffer.Data(), request);
+                    } catch (const SectorReadError&) {
+                        // One bad sector must not end the scan or fail every resume on this extent
+                        got = ReadSectorsZeroFilled(source, offset, buffer.Data(), request, sectorSize);
+                    }
+                    carver.Scan(buffer.Data(), std::min(got, window), offset, extentHits[extent], length, &arena);
+                    extentScanned(extent, length);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    aborted = true;
+                }
+                bytesDone += length;
+            };
+
+            if (poolSize > 0) {
+                WorkStealingPool pool(poolSize);
+                // Contiguous runs per worker keep each worker's reads sequential
+                for (size_t worker = 0; worker < poolSize; worker++) {
+                    size_t first = worker * remaining.size() / poolSize;
+                    size_t last = (worker + 1) * remaining.size() / poolSize;
+                    for (size_t i = first; i < last; i++) {
+                        size_t extent = remaining[i];
+                        pool.Submit(worker, [&scanExtent, extent](size_t running) {
+                            scanExtent(extent, running);
+                        });
+                    }
+                }
+
+                const uint64_t total = end - start;
+                while (!pool.WaitIdleFor(std::chrono::milliseconds(200))) {
+                    if (checkpoint) {
+                        recordFinished();
+                        checkpoint->CommitIfDue();
+                    }
+                    if (progress) {
+                        progress(static_cast<int>(bytesDone.load() * 100 / total), "Scanning sectors...");
+                    }
+                }
+            }
+            if (progress) {
+                progress(100, "Scanning sectors...");
+            }
+            // Keep finished work even when the scan failed, so a rerun resumes
+            if (checkpoint) {
+                recordFinished();
+                checkpoint->Commit();
+            }
+
+            if (error) {
+                std::rethrow_exception(error);
+            }
+
+            std::vector<CarveHit> hits;
+            for (auto& extent : extentHits) {
+                hits.insert(hits.end(), extent.begin(), extent.end());
+            }
+            // Offset headers and footers near a boundary can land out of order
+            SortCarveHits(hits);
+            return hits;
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
@@ -0,0 +1,140 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Parallel Scan Scheduler
+ *
+ * Work-stealing thread pool and the partitioned carving scan that runs on
+ * it. The source is split into extents; each worker owns a contiguous run
+ * of extents and steals from the far end of other workers' runs when idle.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_SCAN_SCHEDULER_H
+#define STELLAR_SCAN_SCHEDULER_H
+
+#include "stellar_recovery.h"
+#include "sector_reader.h"
+#include "signature_carver.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        class ScanCheckpoint;
+
+        /**
+         * Logical processors available to the scan (at least 1)
+         */
+        size_t GetDefaultWorkerCount();
+
+        /**
+         * Fixed-size pool with one task deque per worker. Owners take tasks
+         * from the front of their deque; idle workers steal from the back of
+         * the others.
+         */
+        class WorkStealingPool {
+        public:
+            using Task = std::function<void(size_t worker)>;
+
+            explicit WorkStealingPool(size_t workers = 0);
+            ~WorkStealingPool();
+
+            WorkStealingPool(const WorkStealingPool&) = delete;
+            WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+            // Queue a task on a specific worker's deque
+            void Submit(size_t worker, Task task);
+
+            // Block until every submitted task has finished
+            void WaitIdle();
+
+            // Like WaitIdle, but give up after timeout; true when idle
+            bool WaitIdleFor(std::chrono::milliseconds timeout);
+
+            size_t WorkerCount() const { return queues.size(); }
+
+        private:
+            struct Queue {
+                std::mutex mutex;
+                std::deque<Task> tasks;
+            };
+
+            void WorkerLoop(size_t worker);
+            bool TakeTask(size_t worker, Task& task);
+
+            std::vector<std::unique_ptr<Queue>> queues;
+            std::vector<std::thread> threads;
+
+            std::mutex stateMutex;
+            std::condition_variable workAvailable;
+            std::condition_variable idle;
+            size_t pending = 0;     // Submitted and not yet finished
+            size_t queued = 0;      // Submitted and not yet taken
+            bool stopping = false;
+        };
+
+        /**
+         * Partitioned scan options
+         */
+        struct ParallelScanOptions {
+            size_t workers;          // 0 = GetDefaultWorkerCount()
+            size_t extentSize;       // Bytes per task, rounded to the I/O alignment
+            uint64_t startOffset;
+            uint64_t endOffset;      // 0 = end of source
+
+            ParallelScanOptions() :
+                workers(0),
+                extentSize(16u << 20),
+                startOffset(0),
+                endOffset(0) {}
+        };
+
+        /**
+         * Carves a source on a work-stealing pool. Each extent is read
+         * together with the carver's overlap window so signatures that
+         * straddle an extent boundary are matched by the extent they start in.
+         */
+        class ParallelScanner {
+        public:
+            ParallelScanner(SectorSource& source, const SignatureCarver& carver,
+                            const ParallelScanOptions& options = ParallelScanOptions());
+
+            /**
+             * Scan the range and return hits in offset order. progress is
+             * invoked from the calling thread. An extent that fails to read
+             * is reread sector by sector with unreadable sectors zero filled,
+             * and still counts as done; other errors stop the scan and the
+             * first is rethrown. With a checkpoint, extents it already holds are not read again
+             * and each finished extent is recorded into it.
+             */
+            std::vector<CarveHit> Run(const ProgressCallback& progress = ProgressCallback(),
+                                      ScanCheckpoint* checkpoint = nullptr);
+
+            size_t WorkerCount() const { return workers; }
+
+            // Extent size after alignment; part of a checkpoint's key
+            size_t ExtentSize() const { return options.extentSize; }
+
+        private:
+            SectorSource& source;
+            const SignatureCarver& carver;
+            ParallelScanOptions options;
+            size_t workers;
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_SCAN_SCHEDULER_H
@@ -0,0 +1,491 @@
+/**
+ * Stellar Data Recovery Pro Free - Sector Source and Streaming Reader
+ *
+ * Implements raw device/image access for Windows and POSIX systems and
+ * the queued read-ahead reader used by the scan engines.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "sector_reader.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <new>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <winioctl.h>
+#include <malloc.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/sysmacros.h>
+#include <fstream>
+#endif
+#endif
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            uint64_t AlignDown(uint64_t value, uint64_t alignment) {
+                return value - (value % alignment);
+            }
+
+            uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+                return AlignDown(value + alignment - 1, alignment);
+            }
+
+            bool IsAligned(uint64_t offset, const void* buffer, size_t length, size_t alignment) {
+                return offset % alignment == 0 &&
+                       length % alignment == 0 &&
+                       reinterpret_cast<uintptr_t>(buffer) % alignment == 0;
+            }
+
+        } // namespace
+
+        /**
+         * Clamp a requested chunk size into the supported range
+         */
+        size_t NormalizeChunkSize(size_t requested) {
+            size_t size = std::min(std::max(requested, MIN_READ_CHUNK_SIZE), MAX_READ_CHUNK_SIZE);
+            return static_cast<size_t>(AlignDown(size, IO_ALIGNMENT));
+        }
+
+        ReaderOptions DeviceReaderOptions(const SectorSource& source) {
+            ReaderOptions options;
+            const bool rotational = source.IncursSeekPenalty();
+            options.readAhead = rotational ? ROTATIONAL_QUEUE_DEPTH : SOLID_STATE_QUEUE_DEPTH;
+            options.chunkSize = rotational ? ROTATIONAL_CHUNK_SIZE : SOLID_STATE_CHUNK_SIZE;
+            return options;
+        }
+
+        // AlignedBuffer ---------------------------------------------------
+
+        AlignedBuffer::AlignedBuffer(size_t size, size_t alignment) : size(size) {
+            size_t allocated = static_cast<size_t>(AlignUp(std::max<size_t>(size, 1), alignment));
+#ifdef _WIN32
+            data = static_cast<uint8_t*>(_aligned_malloc(allocated, alignment));
+#else
+            data = static_cast<uint8_t*>(std::aligned_alloc(alignment, allocated));
+#endif
+            if (!data) {
+                throw std::bad_alloc();
+            }
+        }
+
+        AlignedBuffer::~AlignedBuffer() {
+#ifdef _WIN32
+            _aligned_free(data);
+#else
+            std::free(data);
+#endif
+        }
+
+        AlignedBuffer::AlignedBuffer(AlignedBuffer&& other) noexcept :
+            data(other.data), size(other.size) {
+            other.data = nullptr;
+            other.size = 0;
+        }
+
+        AlignedBuffer& AlignedBuffer::operator=(AlignedBuffer&& other) noexcept {
+            if (this != &other) {
+                AlignedBuffer released(std::move(*this));
+                data = other.data;
+                size = other.size;
+                other.data = nullptr;
+                other.size = 0;
+            }
+            return *this;
+        }
+
+        // FileSectorSource ------------------------------------------------
+
+#ifdef _WIN32
+
+        FileSectorSource::FileSectorSource(const std::string& path, const SourceOptions& options) :
+            path(path) {
+            DWORD flags = FILE_FLAG_SEQUENTIAL_SCAN;
+            if (options.unbuffered) {
+                flags |= FILE_FLAG_NO_BUFFERING;
+            }
+
+            HANDLE h = CreateFileA(path.c_str(), GENERIC_READ,
+                                   FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                   OPEN_EXISTING, flags, nullptr);
+            if (h == INVALID_HANDLE_VALUE) {
+                throw SectorReadError("Cannot open " + path + " (error " +
+                                      std::to_string(GetLastError()) + ")");
+            }
+            handle = h;
+            unbuffered = options.unbuffered;
+
+            DWORD returned = 0;
+            GET_LENGTH_INFORMATION lengthInfo;
+            LARGE_INTEGER fileSize;
+            if (DeviceIoControl(h, IOCTL_DISK_GET_LENGTH_INFO, nullptr, 0,
+                                &lengthInfo, sizeof(lengthInfo), &returned, nullptr)) {
+                size = static_cast<uint64_t>(lengthInfo.Length.QuadPart);
+            } else if (GetFileSizeEx(h, &fileSize)) {
+                size = static_cast<uint64_t>(fileSize.QuadPart);
+            }
+
+            DISK_GEOMETRY geometry;
+            if (DeviceIoControl(h, IOCTL_DISK_GET_DRIVE_GEOMETRY, nullptr, 0,
+                                &geometry, sizeof(geometry), &returned, nullptr) &&
+                geometry.BytesPerSector >= 512) {
+                sectorSize = geometry.BytesPerSector;
+            }
+
+            // Only devices that report no seek penalty are treated as solid state
+            STORAGE_PROPERTY_QUERY query = {};
+            query.PropertyId = StorageDeviceSeekPenaltyProperty;
+            query.QueryType = PropertyStandardQuery;
+            DEVICE_SEEK_PENALTY_DESCRIPTOR penalty = {};
+            if (DeviceIoControl(h, IOCTL_STORAGE_QUERY_PROPERTY, &query, sizeof(query),
+                                &penalty, sizeof(penalty), &returned, nullptr) &&
+                returned >= sizeof(penalty)) {
+                seekPenalty = penalty.IncursSeekPenalty != FALSE;
+            }
+        }
+
+        FileSectorSource::~FileSectorSource() {
+            if (handle) {
+                CloseHandle(static_cast<HANDLE>(handle));
+            }
+        }
+
+        size_t FileSectorSource::ReadAt(uint64_t offset, void* buffer, size_t length) {
+            if (unbuffered && !IsAligned(offset, buffer, length, sectorSize)) {
+                uint64_t first = AlignDown(offset, sectorSize);
+                AlignedBuffer bounce(static_cast<size_t>(AlignUp(offset + length, sectorSize) - first));
+                size_t got = ReadAt(first, bounce.Data(), bounce.Size());
+                size_t skip = static_cast<size_t>(offset - first);
+                size_t copied = got > skip ? std::min(length, got - skip) : 0;
+                std::memcpy(buffer, bounce.Data() + skip, copied);
+                return copied;
+            }
+
+            MetricsTimer timer(Histogram::READ_LATENCY);
+            MetricsRegistry& metrics = MetricsRegistry::Global();
+            size_t total = 0;
+            uint8_t* out = static_cast<uint8_t*>(buffer);
+            while (total < length) {
+                uint64_t position = offset + total;
+                OVERLAPPED overlapped = {};
+                overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFFu);
+                overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+                DWORD request = static_cast<DWORD>(std::min<size_t>(length - total, MAX_READ_CHUNK_SIZE));
+                DWORD got = 0;
+                if (!ReadFile(static_cast<HANDLE>(handle), out + total, request, &got, &overlapped)) {
+                    DWORD error = GetLastError();
+                    if (error == ERROR_HANDLE_EOF) {
+                        break;
+                    }
+                    metrics.Add(Counter::READ_ERRORS);
+                    throw SectorReadError("Read failed on " + path + " (error " +
+                                          std::to_string(error) + ")", position);
+                }
+                if (got == 0) {
+                    break;
+                }
+                total += got;
+            }
+            metrics.Add(Counter::BYTES_READ, total);
+            return total;
+        }
+
+#else
+
+        FileSectorSource::FileSectorSource(const std::string& path, const SourceOptions& options) :
+            path(path) {
+            int flags = O_RDONLY | O_CLOEXEC;
+#ifdef __linux__
+            if (options.unbuffered) {
+                fd = ::open(path.c_str(), flags | O_DIRECT);
+                unbuffered = fd >= 0;
+            }
+#else
+            (void)options;
+#endif
+            if (fd < 0) {
+                // tmpfs and some network filesystems reject O_DIRECT
+                fd = ::open(path.c_str(), flags);
+            }
+            if (fd < 0) {
+                throw SectorReadError("Cannot open " + path + ": " + std::strerror(errno));
+            }
+
+            struct stat info;
+            if (fstat(fd, &info) == 0) {
+#ifdef __linux__
+                if (S_ISBLK(info.st_mode)) {
+                    uint64_t deviceSize = 0;
+                    int logicalSector = 0;
+                    if (ioctl(fd, BLKGETSIZE64, &deviceSize) == 0) {
+                        size = deviceSize;
+                    }
+                    if (ioctl(fd, BLKSSZGET, &logicalSector) == 0 && logicalSector >= 512) {
+                        sectorSize = static_cast<uint32_t>(logicalSector);
+                    }
+                } else
+#endif
+                {
+                    size = static_cast<uint64_t>(info.st_size);
+                }
+            }
+
+#ifdef __linux__
+            posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+            seekPenalty = DescriptorIncursSeekPenalty(fd);
+        }
+
+        bool DescriptorIncursSeekPenalty(int fd) {
+#ifdef __linux__
+            // Images inherit the disk of their file system; partitions keep
+            // the queue attributes on their parent device
+            struct stat info;
+            if (fstat(fd, &info) == 0) {
+                dev_t device = S_ISBLK(info.st_mode) ? info.st_rdev : info.st_dev;
+                std::string sysfs = "/sys/dev/block/" + std::to_string(major(device)) + ":" +
+                                    std::to_string(minor(device));
+                for (const char* attribute : {"/queue/rotational", "/../queue/rotational"}) {
+                    std::ifstream rotational(sysfs + attribute);
+                    int value = 0;
+                    if (rotational >> value) {
+                        return value != 0;
+                    }
+                }
+            }
+#else
+            (void)fd;
+#endif
+            return false;
+        }
+
+        FileSectorSource::~FileSectorSource() {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+
+        size_t FileSectorSource::ReadAt(uint64_t offset, void* buffer, size_t length) {
+            if (unbuffered && !IsAligned(offset, buffer, length, sectorSize)) {
+                uint64_t first = AlignDown(offset, sectorSize);
+                AlignedBuffer bounce(static_cast<size_t>(AlignUp(offset + length, sectorSize) - first));
+                size_t got = ReadAt(first, bounce.Data(), bounce.Size());
+                size_t skip = static_cast<size_t>(offset - first);
+                size_t copied = got > skip ? std::min(length, got - skip) : 0;
+                std::memcpy(buffer, bounce.Data() + skip, copied);
+                return copied;
+            }
+
+            MetricsTimer timer(Histogram::READ_LATENCY);
+            MetricsRegistry& metrics = MetricsRegistry::Global();
+            size_t total = 0;
+            uint8_t* out = static_cast<uint8_t*>(buffer);
+            while (total < length) {
+                ssize_t got = ::pread(fd, out + total, length - total,
+                                      static_cast<off_t>(offset + total));
+                if (got < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    metrics.Add(Counter::READ_ERRORS);
+                    throw SectorReadError("Read failed on " + path + ": " + std::strerror(errno),
+                                          offset + total);
+                }
+                if (got == 0) {
+                    break;
+                }
+                total += static_cast<size_t>(got);
+            }
+            metrics.Add(Counter::BYTES_READ, total);
+            return total;
+        }
+
+#endif
+
+        // SectorReader ----------------------------------------------------
+
+        SectorReader::SectorReader(SectorSource& source, const ReaderOptions& options) :
+            source(source),
+            chunkSize(NormalizeChunkSize(options.chunkSize)),
+            ioEngine(options.ioEngine) {
+            uint32_t sector = std::max<uint32_t>(source.SectorSize(), 1);
+            rangeStart = AlignDown(options.startOffset, sector);
+            rangeEnd = options.endOffset == 0 ? source.Size()
+                                              : std::min(options.endOffset, source.Size());
+            if (rangeStart > rangeEnd) {
+                rangeStart = rangeEnd;
+            }
+
+            // Chunks of a mapped source are slices of the mapping
+            mapped = rangeEnd > rangeStart
+                ? source.View(rangeStart, static_cast<size_t>(rangeEnd - rangeStart)) : nullptr;
+            if (mapped) {
+                return;
+            }
+
+            slots.resize(std::max<size_t>(options.readAhead, 1) + 1);
+            for (auto& slot : slots) {
+                slot.buffer = AlignedBuffer(chunkSize);
+            }
+
+            worker = std::thread(&SectorReader::ReadLoop, this);
+        }
+
+        SectorReader::~SectorReader() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            slotFree.notify_all();
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+
+        IoStats SectorReader::IoStatistics() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return ioStats;
+        }
+
+        bool SectorReader::Next(SectorChunk& chunk) {
+            if (mapped) {
+                uint64_t offset = rangeStart + bytesConsumed;
+                if (offset >= rangeEnd) {
+                    return false;
+                }
+                chunk.offset = offset;
+                chunk.data = mapped + bytesConsumed;
+                chunk.length = static_cast<size_t>(std::min<uint64_t>(chunkSize, rangeEnd - offset));
+                bytesConsumed += chunk.length;
+                // Paged in from the image as the carver touches it
+                MetricsRegistry::Global().Add(Counter::BYTES_READ, chunk.length);
+                return true;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            if (holding) {
+                holding = false;
+                slots[(head + slots.size() - 1) % slots.size()].state = SlotState::FREE;
+                slotFree.notify_one();
+            }
+
+            slotReady.wait(lock, [this] { return slots[head].state == SlotState::READY || finished; });
+
+            Slot& slot = slots[head];
+            if (slot.state != SlotState::READY || slot.length == 0) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+                return false;
+            }
+
+            chunk.offset = slot.offset;
+            chunk.data = slot.buffer.Data();
+            chunk.length = slot.length;
+
+            slot.state = SlotState::HELD;
+            head = (head + 1) % slots.size();
+            holding = true;
+            bytesConsumed += slot.length;
+            return true;
+        }
+
+        void SectorReader::ReadLoop() {
+            uint32_t sector = std::max<uint32_t>(source.SectorSize(), 1);
+            uint64_t offset = rangeStart;
+            size_t issue = 0;           // Next slot to read into; slots are filled in ring order
+            bool ended = false;         // A read came back short; nothing past it is requested
+
+            try {
+                std::vector<IoBuffer> buffers;
+                for (auto& slot : slots) {
+                    buffers.push_back({slot.buffer.Data(), slot.buffer.Size()});
+                }
+                auto queue = CreateIoQueue(source, buffers, slots.size(), ioEngine);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    engineName = queue->Name();
+                }
+
+                std::vector<size_t> batch;
+                for (;;) {
+                    batch.clear();
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        if (queue->InFlight() == 0) {
+                            slotFree.wait(lock, [&] {
+                                return stopping || ended || offset >= rangeEnd ||
+                                       slots[issue].state == SlotState::FREE;
+                            });
+                        }
+                        if (stopping) {
+                            break;
+                        }
+                        while (!ended && offset < rangeEnd && slots[issue].state == SlotState::FREE &&
+                               queue->InFlight() + batch.size() < queue->Depth()) {
+                            Slot& slot = slots[issue];
+                            slot.state = SlotState::READING;
+                            slot.offset = offset;
+                            slot.length = static_cast<size_t>(std::min<uint64_t>(chunkSize, rangeEnd - offset));
+                            offset += slot.length;
+                            batch.push_back(issue);
+                            issue = (issue + 1) % slots.size();
+                        }
+                    }
+
+                    // The slots in flight are owned by this thread until they are published
+                    for (size_t index : batch) {
+                        const Slot& slot = slots[index];
+                        size_t request = static_cast<size_t>(std::min<uint64_t>(AlignUp(slot.length, sector), chunkSize));
+                        queue->Submit(index, slot.offset, request);
+                    }
+                    if (queue->InFlight() == 0) {
+                        break;
+                    }
+
+                    IoCompletion done = queue->Wait();
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        Slot& slot = slots[done.buffer];
+                        if (done.bytes < slot.length) {
+                            slot.length = done.bytes;
+                            ended = true;
+                        }
+                        slot.state = SlotState::READY;
+                        ioStats = queue->Stats();
+                    }
+                    slotReady.notify_one();
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished = true;
+            }
+            slotReady.notify_all();
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
@@ -0,0 +1,293 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Sector Source and Streaming Reader
+ *
+ * Raw access to block devices and disk image files, plus a read-ahead
+ * reader that streams a source in large aligned chunks.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_SECTOR_READER_H
+#define STELLAR_SECTOR_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include "io_queue.h"
+
+namespace Stellar {
+    namespace Recovery {
+
+        // Read chunk limits (bytes)
+        constexpr size_t MIN_READ_CHUNK_SIZE = 1u << 20;      // 1 MiB
+        constexpr size_t MAX_READ_CHUNK_SIZE = 64u << 20;     // 64 MiB
+        constexpr size_t DEFAULT_READ_CHUNK_SIZE = 8u << 20;  // 8 MiB
+
+        // Streaming defaults by device: many small reads in flight keep
+        // flash busy; disks that seek get a few large sequential reads
+        constexpr size_t SOLID_STATE_QUEUE_DEPTH = 32;
+        constexpr size_t SOLID_STATE_CHUNK_SIZE = MIN_READ_CHUNK_SIZE;
+        constexpr size_t ROTATIONAL_QUEUE_DEPTH = 2;
+        constexpr size_t ROTATIONAL_CHUNK_SIZE = DEFAULT_READ_CHUNK_SIZE;
+
+        // Alignment satisfying unbuffered I/O on 512e and 4Kn devices
+        constexpr size_t IO_ALIGNMENT = 4096;
+
+        /**
+         * Raised when a source cannot be opened or a read fails
+         */
+        class SectorReadError : public std::runtime_error {
+        public:
+            SectorReadError(const std::string& message, uint64_t offset = 0) :
+                std::runtime_error(message), offset(offset) {}
+
+            uint64_t Offset() const { return offset; }
+
+        private:
+            uint64_t offset;
+        };
+
+        /**
+         * Heap buffer aligned for unbuffered (O_DIRECT / NO_BUFFERING) reads
+         */
+        class AlignedBuffer {
+        public:
+            AlignedBuffer() = default;
+            explicit AlignedBuffer(size_t size, size_t alignment = IO_ALIGNMENT);
+            ~AlignedBuffer();
+
+            AlignedBuffer(AlignedBuffer&& other) noexcept;
+            AlignedBuffer& operator=(AlignedBuffer&& other) noexcept;
+            AlignedBuffer(const AlignedBuffer&) = delete;
+            AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+            uint8_t* Data() { return data; }
+            const uint8_t* Data() const { return data; }
+            size_t Size() const { return size; }
+
+        private:
+            uint8_t* data = nullptr;
+            size_t size = 0;
+        };
+
+        /**
+         * Random-access source of raw sectors (device, volume or image file)
+         */
+        class SectorSource {
+        public:
+            virtual ~SectorSource() = default;
+
+            virtual const std::string& Path() const = 0;
+            virtual uint64_t Size() const = 0;
+            virtual uint32_t SectorSize() const = 0;
+
+            /**
+             * Read up to length bytes at offset. Returns the number of bytes
+             * read, which is only short at the end of the source.
+             * Must be safe to call from several threads at once.
+             * Throws SectorReadError on I/O failure.
+             */
+            virtual size_t ReadAt(uint64_t offset, void* buffer, size_t length) = 0;
+
+            /**
+             * Pointer to [offset, offset + length) when the source is memory
+             * resident, valid for the lifetime of the source; nullptr when
+             * the range must be copied out with ReadAt.
+             */
+            virtual const uint8_t* View(uint64_t offset, size_t length) {
+                (void)offset;
+                (void)length;
+                return nullptr;
+            }
+
+            /**
+             * True when the source sits on a rotational disk, where reads
+             * should be issued in ascending offset order
+             */
+            virtual bool IncursSeekPenalty() const { return false; }
+
+            /**
+             * Source that does the reading for a wrapper which only gates
+             * reads, so queues can submit to it directly; nullptr for
+             * sources that read for themselves
+             */
+            virtual SectorSource* Passthrough() { return nullptr; }
+
+            // Called before each read submitted past this source; may block
+            virtual void Admit(size_t length) { (void)length; }
+        };
+
+        /**
+         * Source options
+         */
+        struct SourceOptions {
+            bool unbuffered;  // Bypass the OS cache (O_DIRECT / FILE_FLAG_NO_BUFFERING)
+
+            SourceOptions() : unbuffered(true) {}
+        };
+
+        /**
+         * Sector source backed by a block device, volume or raw image file
+         */
+        class FileSectorSource : public SectorSource {
+        public:
+            explicit FileSectorSource(const std::string& path,
+                                      const SourceOptions& options = SourceOptions());
+            ~FileSectorSource() override;
+
+            FileSectorSource(const FileSectorSource&) = delete;
+            FileSectorSource& operator=(const FileSectorSource&) = delete;
+
+            const std::string& Path() const override { return path; }
+            uint64_t Size() const override { return size; }
+            uint32_t SectorSize() const override { return sectorSize; }
+            size_t ReadAt(uint64_t offset, void* buffer, size_t length) override;
+            bool IncursSeekPenalty() const override { return seekPenalty; }
+
+            // True when reads bypass the OS cache and must be aligned
+            bool IsUnbuffered() const { return unbuffered; }
+
+#ifndef _WIN32
+            int Descriptor() const { return fd; }
+#endif
+
+        private:
+            std::string path;
+            uint64_t size = 0;
+            uint32_t sectorSize = 512;
+            bool unbuffered = false;
+            bool seekPenalty = false;
+#ifdef _WIN32
+            void* handle = nullptr;
+#else
+            int fd = -1;
+#endif
+        };
+
+        /**
+         * Streaming reader options
+         */
+        struct ReaderOptions {
+            size_t chunkSize;       // Clamped to [MIN_READ_CHUNK_SIZE, MAX_READ_CHUNK_SIZE]
+            size_t readAhead;       // Chunks kept in flight ahead of the consumer (>= 1); the queue depth
+            uint64_t startOffset;   // First byte to stream (rounded down to a sector)
+            uint64_t endOffset;     // One past the last byte; 0 means end of source
+            IoEngine ioEngine;
+
+            ReaderOptions() :
+                chunkSize(DEFAULT_READ_CHUNK_SIZE),
+                readAhead(1),
+                startOffset(0),
+                endOffset(0),
+                ioEngine(IoEngine::AUTO) {}
+        };
+
+        /**
+         * A chunk handed to the consumer; valid until the next call to Next()
+         */
+        struct SectorChunk {
+            uint64_t offset;
+            const uint8_t* data;
+            size_t length;
+
+            SectorChunk() : offset(0), data(nullptr), length(0) {}
+        };
+
+        /**
+         * Sequential read-ahead reader. A background thread keeps up to
+         * readAhead chunk reads in flight on an IoQueue while the consumer
+         * scans the current chunk. Memory-resident sources are handed out
+         * in place, without the thread or the copy.
+         */
+        class SectorReader {
+        public:
+            explicit SectorReader(SectorSource& source,
+                                  const ReaderOptions& options = ReaderOptions());
+            ~SectorReader();
+
+            SectorReader(const SectorReader&) = delete;
+            SectorReader& operator=(const SectorReader&) = delete;
+
+            /**
+             * Release the previous chunk and wait for the next one.
+             * Returns false at end of range. Rethrows reader-thread errors.
+             */
+            bool Next(SectorChunk& chunk);
+
+            uint64_t RangeStart() const { return rangeStart; }
+            uint64_t RangeEnd() const { return rangeEnd; }
+            uint64_t BytesConsumed() const { return bytesConsumed; }
+            size_t ChunkSize() const { return chunkSize; }
+
+            // Engine in use and the throughput it achieved so far
+            const char* IoEngineName() const { return engineName; }
+            IoStats IoStatistics() const;
+
+        private:
+            enum class SlotState {
+                FREE,
+                READING,
+                READY,
+                HELD        // Handed to the consumer
+            };
+
+            struct Slot {
+                AlignedBuffer buffer;
+                uint64_t offset = 0;
+                size_t length = 0;      // Bytes the consumer should see
+                SlotState state = SlotState::FREE;
+            };
+
+            void ReadLoop();
+
+            SectorSource& source;
+            const uint8_t* mapped = nullptr;   // View of the whole range, if available
+            size_t chunkSize;
+            uint64_t rangeStart;
+            uint64_t rangeEnd;
+            uint64_t bytesConsumed = 0;
+
+            std::vector<Slot> slots;
+            size_t head = 0;          // Next slot the consumer takes
+            bool holding = false;     // Consumer holds the slot before head
+            bool finished = false;    // Reader thread reached the end
+            bool stopping = false;
+            std::exception_ptr error;
+            IoEngine ioEngine;
+            const char* engineName = "memory map";
+            IoStats ioStats;
+
+            mutable std::mutex mutex;
+            std::condition_variable slotReady;
+            std::condition_variable slotFree;
+            std::thread worker;
+        };
+
+        // Clamp and align a requested chunk size
+        size_t NormalizeChunkSize(size_t requested);
+
+        /**
+         * Queue depth and chunk size for streaming a source: the solid-state
+         * pair unless the source incurs a seek penalty
+         */
+        ReaderOptions DeviceReaderOptions(const SectorSource& source);
+
+#ifndef _WIN32
+        // Rotational flag of the disk under an open device or image file (Linux sysfs)
+        bool DescriptorIncursSeekPenalty(int fd);
+#endif
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_SECTOR_READER_H
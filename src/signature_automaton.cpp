@@ -0,0 +1,63 @@
+/**
+ * Stellar Data Recovery Pro Free - Compiled Signature Automata
+ *
+ * One constexpr automaton instance per TargetFileType.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "signature_automaton.h"
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            template <uint32_t TypeMask>
+            struct CompiledInstance {
+                static constexpr SignatureAutomaton<TypeMask> automaton{};
+
+                static size_t Anchored(const uint8_t* data, size_t length, size_t position,
+                                       uint16_t* found, size_t capacity) {
+                    return automaton.Anchored(data, length, position, found, capacity);
+                }
+
+                static const CompiledSignatureSet& Get() {
+                    static const CompiledSignatureSet set = {
+                        automaton.patterns.data(),
+                        automaton.patterns.size(),
+                        automaton.MaxLength(),
+                        automaton.HeaderOffsets(),
+                        automaton.HeaderOffsetCount(),
+                        &Anchored
+                    };
+                    return set;
+                }
+            };
+
+            template <TargetFileType Type>
+            const CompiledSignatureSet& Compiled() {
+                return CompiledInstance<SignatureTypeMask(Type)>::Get();
+            }
+
+        } // namespace
+
+        const CompiledSignatureSet& GetSignatureSet(TargetFileType type) {
+            switch (type) {
+                case TargetFileType::PHOTO: return Compiled<TargetFileType::PHOTO>();
+                case TargetFileType::VIDEO: return Compiled<TargetFileType::VIDEO>();
+                case TargetFileType::AUDIO: return Compiled<TargetFileType::AUDIO>();
+                case TargetFileType::DOCUMENT: return Compiled<TargetFileType::DOCUMENT>();
+                case TargetFileType::EMAIL: return Compiled<TargetFileType::EMAIL>();
+                case TargetFileType::ARCHIVE: return Compiled<TargetFileType::ARCHIVE>();
+                case TargetFileType::EXECUTABLE: return Compiled<TargetFileType::EXECUTABLE>();
+                case TargetFileType::DATABASE: return Compiled<TargetFileType::DATABASE>();
+                case TargetFileType::ALL_DATA:
+                default: return Compiled<TargetFileType::ALL_DATA>();
+            }
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
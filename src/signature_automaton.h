@@ -0,0 +1,195 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Compiled Signature Automata
+ *
+ * Tries over the header and footer patterns of FILE_SIGNATURES, built
+ * entirely at compile time. Each TargetFileType has its own instance
+ * containing only its patterns, so a PHOTO scan walks a small PHOTO trie
+ * instead of filtering ALL_DATA matches. The carver's prefilters pick the
+ * candidate offsets, so matching is anchored: a walk starts at one
+ * position and never needs failure links.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_SIGNATURE_AUTOMATON_H
+#define STELLAR_SIGNATURE_AUTOMATON_H
+
+#include "file_signatures.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Stellar {
+    namespace Recovery {
+
+        enum class PatternKind : uint8_t {
+            HEADER,
+            FOOTER
+        };
+
+        // One automaton pattern: a signature's header or footer bytes
+        struct SignaturePattern {
+            const char* bytes;
+            uint16_t signature;     // Index into FILE_SIGNATURES
+            PatternKind kind;
+            uint8_t length;
+        };
+
+        constexpr uint32_t SignatureTypeMask(TargetFileType type) {
+            return type == TargetFileType::ALL_DATA ? ~0u : 1u << static_cast<uint32_t>(type);
+        }
+
+        constexpr bool IsSignatureSelected(const FileSignature& signature, uint32_t typeMask) {
+            return (typeMask & (1u << static_cast<uint32_t>(signature.type))) != 0;
+        }
+
+        constexpr size_t CountSignaturePatterns(uint32_t typeMask) {
+            size_t count = 0;
+            for (const auto& signature : FILE_SIGNATURES) {
+                if (IsSignatureSelected(signature, typeMask)) {
+                    count += signature.footer ? 2 : 1;
+                }
+            }
+            return count;
+        }
+
+        constexpr size_t CountSignatureStates(uint32_t typeMask) {
+            size_t count = 1;
+            for (const auto& signature : FILE_SIGNATURES) {
+                if (IsSignatureSelected(signature, typeMask)) {
+                    count += signature.headerLength + signature.footerLength;
+                }
+            }
+            return count;
+        }
+
+        /**
+         * Trie of the signatures selected by TypeMask. Missing transitions
+         * lead back to the root, so each byte of an anchored walk costs one
+         * table lookup.
+         */
+        template <uint32_t TypeMask>
+        class SignatureAutomaton {
+        public:
+            static constexpr size_t PATTERN_COUNT = CountSignaturePatterns(TypeMask);
+            static constexpr size_t STATE_COUNT = CountSignatureStates(TypeMask);
+            using State = std::conditional_t<(STATE_COUNT <= 256), uint8_t, uint16_t>;
+
+            constexpr SignatureAutomaton() :
+                patterns{}, transitions{}, depth{}, terminal{}, sameBytes{}, headerOffsets{} {
+                AddPatterns();
+                BuildTrie();
+            }
+
+            /**
+             * Patterns starting exactly at position. The walk stops at the
+             * first byte without a trie edge, so a rejected candidate
+             * typically costs one or two lookups.
+             */
+            size_t Anchored(const uint8_t* data, size_t length, size_t position,
+                            uint16_t* found, size_t capacity) const {
+                size_t count = 0;
+                size_t end = std::min(length, position + maxLength);
+                State state = 0;
+                for (size_t i = position; i < end; i++) {
+                    state = transitions[state][data[i]];
+                    if (depth[state] != i - position + 1) {
+                        break;
+                    }
+                    for (uint16_t pattern = terminal[state]; pattern && count < capacity;
+                         pattern = sameBytes[pattern - 1]) {
+                        found[count++] = static_cast<uint16_t>(pattern - 1);
+                    }
+                }
+                return count;
+            }
+
+            constexpr size_t MaxLength() const { return maxLength; }
+
+            // Distinct header offsets; aligned scans probe sector + offset
+            constexpr size_t HeaderOffsetCount() const { return headerOffsetCount; }
+            constexpr const uint8_t* HeaderOffsets() const { return headerOffsets.data(); }
+
+            std::array<SignaturePattern, PATTERN_COUNT> patterns;
+
+        private:
+            constexpr void AddPatterns() {
+                size_t count = 0;
+                for (size_t i = 0; i < FILE_SIGNATURE_COUNT; i++) {
+                    const FileSignature& signature = FILE_SIGNATURES[i];
+                    if (!IsSignatureSelected(signature, TypeMask)) {
+                        continue;
+                    }
+                    patterns[count++] = SignaturePattern{signature.header, static_cast<uint16_t>(i),
+                                                         PatternKind::HEADER, signature.headerLength};
+                    bool knownOffset = false;
+                    for (size_t j = 0; j < headerOffsetCount; j++) {
+                        knownOffset = knownOffset || headerOffsets[j] == signature.headerOffset;
+                    }
+                    if (!knownOffset) {
+                        headerOffsets[headerOffsetCount++] = signature.headerOffset;
+                    }
+                    maxLength = signature.headerLength > maxLength ? signature.headerLength : maxLength;
+
+                    if (signature.footer) {
+                        patterns[count++] = SignaturePattern{signature.footer, static_cast<uint16_t>(i),
+                                                             PatternKind::FOOTER, signature.footerLength};
+                        maxLength = signature.footerLength > maxLength ? signature.footerLength : maxLength;
+                    }
+                }
+            }
+
+            constexpr void BuildTrie() {
+                size_t states = 1;
+                for (size_t p = 0; p < PATTERN_COUNT; p++) {
+                    size_t state = 0;
+                    for (size_t i = 0; i < patterns[p].length; i++) {
+                        uint8_t byte = static_cast<uint8_t>(patterns[p].bytes[i]);
+                        if (transitions[state][byte] == 0) {
+                            depth[states] = static_cast<uint8_t>(i + 1);
+                            transitions[state][byte] = static_cast<State>(states++);
+                        }
+                        state = transitions[state][byte];
+                    }
+                    // Identical byte strings (shared footers) end in one state
+                    sameBytes[p] = terminal[state];
+                    terminal[state] = static_cast<uint16_t>(p + 1);
+                }
+            }
+
+            std::array<std::array<State, 256>, STATE_COUNT> transitions;
+            std::array<uint8_t, STATE_COUNT> depth;       // Pattern prefix length of each state
+            std::array<uint16_t, STATE_COUNT> terminal;   // Last pattern ending here + 1
+            std::array<uint16_t, PATTERN_COUNT> sameBytes;
+            std::array<uint8_t, PATTERN_COUNT> headerOffsets;
+            size_t headerOffsetCount = 0;
+            size_t maxLength = 0;
+        };
+
+        /**
+         * Type-erased view of a compiled trie, selected per scan
+         */
+        struct CompiledSignatureSet {
+            const SignaturePattern* patterns;
+            size_t patternCount;
+            size_t maxLength;         // Longest header or footer
+            const uint8_t* headerOffsets;
+            size_t headerOffsetCount;
+            size_t (*anchored)(const uint8_t* data, size_t length, size_t position,
+                               uint16_t* found, size_t capacity);
+        };
+
+        /**
+         * Compiled trie for a file type (ALL_DATA covers every signature)
+         */
+        const CompiledSignatureSet& GetSignatureSet(TargetFileType type);
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_SIGNATURE_AUTOMATON_H
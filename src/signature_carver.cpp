@@ -0,0 +1,393 @@
+/**
+ * Stellar Data Recovery Pro Free - Signature Carving Engine
+ *
+ * SSSE3, AVX2 and AVX-512 prefilters in front of the compiled signature
+ * automaton.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#include "signature_carver.h"
+#include "cpu_features.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef STELLAR_X86
+#include <immintrin.h>
+#endif
+
+namespace Stellar {
+    namespace Recovery {
+
+        namespace {
+
+            constexpr size_t PREFILTER_BLOCK = 64 * 1024;
+            constexpr size_t MAX_PATTERNS_PER_OFFSET = 8;
+
+            inline int CountTrailingZeros(uint64_t value) {
+#ifdef _MSC_VER
+                unsigned long index;
+                _BitScanForward64(&index, value);
+                return static_cast<int>(index);
+#else
+                return __builtin_ctzll(value);
+#endif
+            }
+
+            /**
+             * Assign patterns to the 8 shufti buckets. Greedy placement that
+             * keeps the number of byte pairs each bucket admits small, so the
+             * nibble tables produce few false candidates.
+             */
+            std::vector<uint8_t> AssignBuckets(const std::vector<const SignaturePattern*>& patterns) {
+                std::vector<size_t> order(patterns.size());
+                for (size_t i = 0; i < order.size(); i++) {
+                    order[i] = i;
+                }
+                std::sort(order.begin(), order.end(), [&patterns](size_t a, size_t b) {
+                    return std::memcmp(patterns[a]->bytes, patterns[b]->bytes, 2) < 0;
+                });
+
+                uint8_t firstLow[8][16] = {}, firstHigh[8][16] = {};
+                uint8_t secondLow[8][16] = {}, secondHigh[8][16] = {};
+                auto admitted = [](const uint8_t low[16], const uint8_t high[16]) {
+                    size_t lows = 0, highs = 0;
+                    for (int i = 0; i < 16; i++) {
+                        lows += low[i] ? 1 : 0;
+                        highs += high[i] ? 1 : 0;
+                    }
+                    return lows * highs;
+                };
+
+                std::vector<uint8_t> buckets(patterns.size(), 0);
+                for (size_t index : order) {
+                    uint8_t first = static_cast<uint8_t>(patterns[index]->bytes[0]);
+                    uint8_t second = static_cast<uint8_t>(patterns[index]->bytes[1]);
+
+                    size_t bestCost = SIZE_MAX;
+                    uint8_t bestBucket = 0;
+                    for (uint8_t bucket = 0; bucket < 8; bucket++) {
+                        uint8_t fl[16], fh[16], sl[16], sh[16];
+                        std::memcpy(fl, firstLow[bucket], 16);
+                        std::memcpy(fh, firstHigh[bucket], 16);
+                        std::memcpy(sl, secondLow[bucket], 16);
+                        std::memcpy(sh, secondHigh[bucket], 16);
+                        size_t before = admitted(fl, fh) * admitted(sl, sh);
+                        fl[first & 0x0F] = fh[first >> 4] = 1;
+                        sl[second & 0x0F] = sh[second >> 4] = 1;
+                        size_t cost = admitted(fl, fh) * admitted(sl, sh) - before;
+                        if (cost < bestCost) {
+                            bestCost = cost;
+                            bestBucket = bucket;
+                        }
+                    }
+
+                    buckets[index] = bestBucket;
+                    firstLow[bestBucket][first & 0x0F] = firstHigh[bestBucket][first >> 4] = 1;
+                    secondLow[bestBucket][second & 0x0F] = secondHigh[bestBucket][second >> 4] = 1;
+                }
+                return buckets;
+            }
+
+#ifdef STELLAR_X86
+            /**
+             * SSSE3: nibble-table (shufti) classification of each byte and its
+             * successor into 8 signature buckets; both must share a bucket
+             */
+            STELLAR_TARGET("ssse3")
+            void PrefilterSsse3(const uint8_t* data, size_t begin, size_t end,
+                                const SignatureCarver::PrefilterTables& tables,
+                                std::pmr::vector<uint32_t>& candidates) {
+                const __m128i nibble = _mm_set1_epi8(0x0F);
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i firstLow = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.firstLow));
+                const __m128i firstHigh = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.firstHigh));
+                const __m128i secondLow = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.secondLow));
+                const __m128i secondHigh = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.secondHigh));
+
+                size_t position = begin;
+                for (; position + 16 < end + 1; position += 16) {
+                    __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+                    __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position + 1));
+
+                    __m128i first = _mm_and_si128(
+                        _mm_shuffle_epi8(firstLow, _mm_and_si128(current, nibble)),
+                        _mm_shuffle_epi8(firstHigh, _mm_and_si128(_mm_srli_epi16(current, 4), nibble)));
+                    __m128i second = _mm_and_si128(
+                        _mm_shuffle_epi8(secondLow, _mm_and_si128(next, nibble)),
+                        _mm_shuffle_epi8(secondHigh, _mm_and_si128(_mm_srli_epi16(next, 4), nibble)));
+
+                    __m128i buckets = _mm_and_si128(first, second);
+                    uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(buckets, zero))) & 0xFFFFu;
+                    while (mask) {
+                        candidates.push_back(static_cast<uint32_t>(position + CountTrailingZeros(mask)));
+                        mask &= mask - 1;
+                    }
+                }
+                for (; position < end; position++) {
+                    candidates.push_back(static_cast<uint32_t>(position));
+                }
+            }
+
+            /**
+             * AVX2: the same classification 32 bytes at a time
+             */
+            STELLAR_TARGET("avx2")
+            void PrefilterAvx2(const uint8_t* data, size_t begin, size_t end,
+                               const SignatureCarver::PrefilterTables& tables,
+                               std::pmr::vector<uint32_t>& candidates) {
+                const __m256i nibble = _mm256_set1_epi8(0x0F);
+                const __m256i zero = _mm256_setzero_si256();
+                const __m256i firstLow = _mm256_broadcastsi128_si256(
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(tables.firstLow)));
+                const __m256i firstHigh = _mm256_broadcastsi128_si256(
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(tables.firstHigh)));
+                const __m256i secondLow = _mm256_broadcastsi128_si256(
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(tables.secondLow)));
+                const __m256i secondHigh = _mm256_broadcastsi128_si256(
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(tables.secondHigh)));
+
+                size_t position = begin;
+                for (; position + 32 < end + 1; position += 32) {
+                    __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position));
+                    __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position + 1));
+
+                    __m256i first = _mm256_and_si256(
+                        _mm256_shuffle_epi8(firstLow, _mm256_and_si256(current, nibble)),
+                        _mm256_shuffle_epi8(firstHigh, _mm256_and_si256(_mm256_srli_epi16(current, 4), nibble)));
+                    __m256i second = _mm256_and_si256(
+                        _mm256_shuffle_epi8(secondLow, _mm256_and_si256(next, nibble)),
+                        _mm256_shuffle_epi8(secondHigh, _mm256_and_si256(_mm256_srli_epi16(next, 4), nibble)));
+
+                    __m256i buckets = _mm256_and_si256(first, second);
+                    uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(buckets, zero)));
+                    while (mask) {
+                        candidates.push_back(static_cast<uint32_t>(position + CountTrailingZeros(mask)));
+                        mask &= mask - 1;
+                    }
+                }
+                for (; position < end; position++) {
+                    candidates.push_back(static_cast<uint32_t>(position));
+                }
+            }
+
+            /**
+             * AVX-512BW: 64 bytes at a time; vptestmb yields the candidate
+             * mask directly instead of compare plus movemask
+             */
+            STELLAR_TARGET("avx512f,avx512bw")
+            void PrefilterAvx512(const uint8_t* data, size_t begin, size_t end,
+                                 const SignatureCarver::PrefilterTables& tables,
+                                 std::pmr::vector<uint32_t>& candidates) {
+                // Zero-masked broadcasts: the unmasked form trips -Wuninitialized in GCC 12 headers
+                const __m512i nibble = _mm512_set1_epi8(0x0F);
+                const __m512i firstLow = _mm512_maskz_broadcast_i32x4(0xFFFF,
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(tables.firstLow)));
+                const __m512i firstHigh = _mm512_maskz_broadcast_i32x4(0xFFFF,
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(tables.firstHigh)));
+                const __m512i secondLow = _mm512_maskz_broadcast_i32x4(0xFFFF,
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(tables.secondLow)));
+                const __m512i secondHigh = _mm512_maskz_broadcast_i32x4(0xFFFF,
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(tables.secondHigh)));
+
+                size_t position = begin;
+                for (; position + 64 < end + 1; position += 64) {
+                    __m512i current = _mm512_loadu_si512(data + position);
+                    __m512i next = _mm512_loadu_si512(data + position + 1);
+
+                    __m512i first = _mm512_and_si512(
+                        _mm512_shuffle_epi8(firstLow, _mm512_and_si512(current, nibble)),
+                        _mm512_shuffle_epi8(firstHigh, _mm512_and_si512(_mm512_srli_epi16(current, 4), nibble)));
+                    __m512i second = _mm512_and_si512(
+                        _mm512_shuffle_epi8(secondLow, _mm512_and_si512(next, nibble)),
+                        _mm512_shuffle_epi8(secondHigh, _mm512_and_si512(_mm512_srli_epi16(next, 4), nibble)));
+
+                    uint64_t mask = _mm512_test_epi8_mask(first, second);
+                    while (mask) {
+                        candidates.push_back(static_cast<uint32_t>(position + CountTrailingZeros(mask)));
+                        mask &= mask - 1;
+                    }
+                }
+                for (; position < end; position++) {
+                    candidates.push_back(static_cast<uint32_t>(position));
+                }
+            }
+#endif
+
+        } // namespace
+
+        SignatureCarver::SignatureCarver(TargetFileType type, const CarverOptions& options) :
+            set(GetSignatureSet(type)),
+            options(options),
+            kernel(CarverKernel::SCALAR) {
+            if (this->options.sectorSize == 0) {
+                this->options.sectorSize = 512;
+            }
+
+            std::vector<const SignaturePattern*> prefiltered;
+            for (size_t i = 0; i < set.patternCount; i++) {
+                if (set.patterns[i].kind == PatternKind::HEADER || this->options.matchFooters) {
+                    prefiltered.push_back(&set.patterns[i]);
+                }
+            }
+
+            std::memset(&tables, 0, sizeof(tables));
+            std::vector<uint8_t> buckets = AssignBuckets(prefiltered);
+            for (size_t i = 0; i < prefiltered.size(); i++) {
+                uint8_t first = static_cast<uint8_t>(prefiltered[i]->bytes[0]);
+                uint8_t second = static_cast<uint8_t>(prefiltered[i]->bytes[1]);
+                uint8_t bucket = static_cast<uint8_t>(1u << buckets[i]);
+
+                tables.firstLow[first & 0x0F] |= bucket;
+                tables.firstHigh[first >> 4] |= bucket;
+                tables.secondLow[second & 0x0F] |= bucket;
+                tables.secondHigh[second >> 4] |= bucket;
+                uint32_t pair = (static_cast<uint32_t>(first) << 8) | second;
+                pairs[pair >> 6] |= 1ull << (pair & 63);
+            }
+
+#ifdef STELLAR_X86
+            const CpuFeatures& cpu = GetCpuFeatures();
+            if (cpu.avx512f && cpu.avx512bw) {
+                kernel = CarverKernel::AVX512;
+            } else if (cpu.avx2) {
+                kernel = CarverKernel::AVX2;
+            } else if (cpu.ssse3) {
+                kernel = CarverKernel::SSSE3;
+            }
+#endif
+        }
+
+        void SignatureCarver::Scan(const uint8_t* data, size_t length, uint64_t base,
+                                   std::vector<CarveHit>& hits, size_t reportLimit,
+                                   std::pmr::memory_resource* scratch) const {
+            if (set.patternCount == 0 || length == 0) {
+                return;
+            }
+
+            size_t limit = std::min(reportLimit, length);
+            size_t first = hits.size();
+
+            // Footers are not sector aligned, so they need the byte-granular path
+            if (options.sectorAligned && !options.matchFooters) {
+                ScanAligned(data, length, base, hits, limit);
+            } else {
+                ScanUnaligned(data, length, base, hits, limit,
+                              scratch ? scratch : std::pmr::get_default_resource());
+            }
+
+            // Magic at an offset (e.g. MP4 "ftyp") reports after earlier hits
+            SortCarveHits(hits, first);
+        }
+
+        void SortCarveHits(std::vector<CarveHit>& hits, size_t first) {
+            auto begin = hits.begin() + static_cast<std::ptrdiff_t>(first);
+            std::stable_sort(begin, hits.end(), [](const CarveHit& a, const CarveHit& b) {
+                return a.offset < b.offset;
+            });
+
+            // Keep the most specific header per start (DOCX over ZIP)
+            size_t kept = first;
+            for (size_t i = first; i < hits.size(); i++) {
+                if (kept > first && !hits[i].isFooter && !hits[kept - 1].isFooter &&
+                    hits[kept - 1].offset == hits[i].offset) {
+                    if (hits[i].signature->headerLength > hits[kept - 1].signature->headerLength) {
+                        hits[kept - 1] = hits[i];
+                    }
+                    continue;
+                }
+                hits[kept++] = hits[i];
+            }
+            hits.resize(kept);
+        }
+
+        void SignatureCarver::ScanAligned(const uint8_t* data, size_t length, uint64_t base,
+                                          std::vector<CarveHit>& hits, size_t limit) const {
+            const uint32_t sectorSize = options.sectorSize;
+            size_t start = static_cast<size_t>((sectorSize - base % sectorSize) % sectorSize);
+            uint16_t found[MAX_PATTERNS_PER_OFFSET];
+
+            for (size_t sector = start; sector < limit; sector += sectorSize) {
+                for (size_t i = 0; i < set.headerOffsetCount; i++) {
+                    size_t position = sector + set.headerOffsets[i];
+                    size_t count = set.anchored(data, length, position, found, MAX_PATTERNS_PER_OFFSET);
+                    for (size_t j = 0; j < count; j++) {
+                        Emit(found[j], position, base, hits);
+                    }
+                }
+            }
+        }
+
+        void SignatureCarver::ScanUnaligned(const uint8_t* data, size_t length, uint64_t base,
+                                            std::vector<CarveHit>& hits, size_t limit,
+                                            std::pmr::memory_resource* scratch) const {
+            // The prefilter looks at the byte after each position
+            size_t end = std::min(limit, length - 1);
+            std::pmr::vector<uint32_t> candidates(scratch);
+            candidates.reserve(1024);
+            uint16_t found[MAX_PATTERNS_PER_OFFSET];
+
+            for (size_t block = 0; block < end; block += PREFILTER_BLOCK) {
+                size_t blockEnd = std::min(block + PREFILTER_BLOCK, end);
+                candidates.clear();
+
+                switch (kernel) {
+#ifdef STELLAR_X86
+                    case CarverKernel::AVX512:
+                        PrefilterAvx512(data, block, blockEnd, tables, candidates);
+                        break;
+                    case CarverKernel::AVX2:
+                        PrefilterAvx2(data, block, blockEnd, tables, candidates);
+                        break;
+                    case CarverKernel::SSSE3:
+                        PrefilterSsse3(data, block, blockEnd, tables, candidates);
+                        break;
+#endif
+                    default:
+                        for (size_t position = block; position < blockEnd; position++) {
+                            uint32_t pair = (static_cast<uint32_t>(data[position]) << 8) | data[position + 1];
+                            if (pairs[pair >> 6] & (1ull << (pair & 63))) {
+                                candidates.push_back(static_cast<uint32_t>(position));
+                            }
+                        }
+                        break;
+                }
+
+                for (uint32_t position : candidates) {
+                    size_t count = set.anchored(data, length, position, found, MAX_PATTERNS_PER_OFFSET);
+                    for (size_t j = 0; j < count; j++) {
+                        Emit(found[j], position, base, hits);
+                    }
+                }
+            }
+
+            // The final byte can only complete a one-byte pattern, and none exist
+        }
+
+        void SignatureCarver::Emit(uint16_t patternIndex, size_t start, uint64_t base,
+                                   std::vector<CarveHit>& hits) const {
+            const SignaturePattern& pattern = set.patterns[patternIndex];
+            const FileSignature* signature = &FILE_SIGNATURES[pattern.signature];
+            uint64_t position = base + start;
+
+            if (pattern.kind == PatternKind::FOOTER) {
+                if (options.matchFooters) {
+                    hits.emplace_back(position + pattern.length + signature->footerTrailer, signature, true);
+                }
+                return;
+            }
+
+            if (position < signature->headerOffset) {
+                return;
+            }
+            uint64_t fileStart = position - signature->headerOffset;
+            if (options.sectorAligned && fileStart % options.sectorSize != 0) {
+                return;
+            }
+            hits.emplace_back(fileStart, signature);
+        }
+
+    } // namespace Recovery
+} // namespace Stellar
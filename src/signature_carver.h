@@ -0,0 +1,118 @@
+#pragma once
+/**
+ * Stellar Data Recovery Pro Free - Signature Carving Engine
+ *
+ * Single-pass multi-signature header/footer matcher used by RAW_RECOVERY
+ * and the sector scans. Candidate offsets are found with SSSE3/AVX2/AVX-512
+ * prefilters on the first two pattern bytes; only those offsets are walked
+ * through the compiled signature automaton.
+ *
+ * @author Stellar Information Technology
+ * @version 1.0.0
+ * @date 2026-10-16
+ */
+
+#ifndef STELLAR_SIGNATURE_CARVER_H
+#define STELLAR_SIGNATURE_CARVER_H
+
+#include "stellar_recovery.h"
+#include "file_signatures.h"
+#include "signature_automaton.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace Stellar {
+    namespace Recovery {
+
+        // A carved file start, or a file end when isFooter is set
+        struct CarveHit {
+            uint64_t offset;                  // File start, or one past the footer
+            const FileSignature* signature;
+            bool isFooter;
+
+            CarveHit() : offset(0), signature(nullptr), isFooter(false) {}
+            CarveHit(uint64_t offset, const FileSignature* signature, bool isFooter = false) :
+                offset(offset), signature(signature), isFooter(isFooter) {}
+        };
+
+        /**
+         * Sort hits[first..] by offset and collapse headers sharing a start
+         */
+        void SortCarveHits(std::vector<CarveHit>& hits, size_t first = 0);
+
+        // Carver options
+        struct CarverOptions {
+            uint32_t sectorSize;
+            bool sectorAligned;   // Only report files starting on a sector boundary
+            bool matchFooters;    // Also report footers (scans every byte)
+
+            CarverOptions() : sectorSize(512), sectorAligned(true), matchFooters(false) {}
+        };
+
+        // Prefilter implementation selected at runtime
+        enum class CarverKernel {
+            SCALAR,     // Exact two-byte bitmap
+            SSSE3,      // 16-byte shufti (pshufb needs SSSE3, not plain SSE2)
+            AVX2,       // 32-byte shufti
+            AVX512      // 64-byte shufti (AVX-512BW byte shuffles and masks)
+        };
+
+        /**
+         * Matches every signature of a TargetFileType in one pass using the
+         * type's compiled automaton
+         */
+        class SignatureCarver {
+        public:
+            explicit SignatureCarver(TargetFileType type,
+                                     const CarverOptions& options = CarverOptions());
+
+            /**
+             * Scan data whose first byte sits at absolute offset base and
+             * append hits in offset order. Only magic bytes starting before
+             * reportLimit are reported; bytes up to length may be read to
+             * complete them, so a caller streaming buffers passes
+             * length - Overlap() and rescans the seam. Candidate positions
+             * are kept in scratch (the default heap when null), which lets
+             * each scan thread use its own arena.
+             */
+            void Scan(const uint8_t* data, size_t length, uint64_t base,
+                      std::vector<CarveHit>& hits, size_t reportLimit = SIZE_MAX,
+                      std::pmr::memory_resource* scratch = nullptr) const;
+
+            // Bytes a pattern may extend past its first byte
+            size_t Overlap() const { return set.maxLength > 0 ? set.maxLength - 1 : 0; }
+
+            CarverKernel Kernel() const { return kernel; }
+            const CarverOptions& Options() const { return options; }
+            size_t PatternCount() const { return set.patternCount; }
+
+            // Prefilter tables shared with the SIMD kernels
+            struct PrefilterTables {
+                alignas(32) uint8_t firstLow[16];
+                alignas(32) uint8_t firstHigh[16];
+                alignas(32) uint8_t secondLow[16];
+                alignas(32) uint8_t secondHigh[16];
+            };
+
+        private:
+            void ScanAligned(const uint8_t* data, size_t length, uint64_t base,
+                             std::vector<CarveHit>& hits, size_t limit) const;
+            void ScanUnaligned(const uint8_t* data, size_t length, uint64_t base,
+                               std::vector<CarveHit>& hits, size_t limit,
+                               std::pmr::memory_resource* scratch) const;
+            void Emit(uint16_t pattern, size_t start, uint64_t base, std::vector<CarveHit>& hits) const;
+
+            const CompiledSignatureSet& set;
+            CarverOptions options;
+            CarverKernel kernel;
+            PrefilterTables tables;
+            std::array<uint64_t, 1024> pairs{};   // Exact first-two-byte bitmap (scalar path)
+        };
+
+    } // namespace Recovery
+} // namespace Stellar
+
+#endif // STELLAR_SIGNATURE_CARVER_H
@@ -16,15 +16,16 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <chrono>
 #include <functional>
-#include <windows.h>
+#include <cstdint>
 
 namespace Stellar {
     namespace Recovery {
         
         // Version information
-        constexpr const char* VERSION = \"1.0.0\";
+        constexpr const char* VERSION = "1.0.0";
         constexpr const char* BUILD_DATE = __DATE__;
         constexpr const char* BUILD_TIME = __TIME__;
         
@@ -120,11 +121,23 @@ namespace Stellar {
                 isSystemDrive(false) {}
         };
         
-        // Recoverable file information
+        // Extent offset of a hole (sparse run) that reads back as zeros
+        constexpr uint64_t SPARSE_EXTENT = ~0ull;
+        
+        // Contiguous run of a file's data on the source
+        struct FileExtent {
+            uint64_t offset;    // Byte offset on the source, or SPARSE_EXTENT
+            uint64_t length;    // Bytes in the run
+        };
+        
+        // Recoverable file information. Allocator-aware: inside a pmr
+        // container its strings and extent list come from the same resource.
         struct RecoverableFile {
-            std::string fileName;
-            std::string originalPath;
-            std::string recoveryPath;
+            using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+            std::pmr::string fileName;
+            std::pmr::string originalPath;
+            std::pmr::string recoveryPath;
             TargetFileType fileType;
             uint64_t fileSize;
             std::chrono::system_clock::time_point dateCreated;
@@ -135,16 +148,44 @@ namespace Stellar {
             bool isEncrypted;
             bool isCompressed;
             bool hasPreview;
-            std::string checksum;
+            std::pmr::string checksum;
+            std::pmr::vector<FileExtent> extents;  // Data runs in file order; empty if unknown
+            std::pmr::vector<uint8_t> inlineData;  // Content stored inside metadata (NTFS resident data)
             
-            RecoverableFile() :
+            RecoverableFile() : RecoverableFile(allocator_type()) {}
+
+            explicit RecoverableFile(const allocator_type& allocator) :
+                fileName(allocator),
+                originalPath(allocator),
+                recoveryPath(allocator),
                 fileType(TargetFileType::ALL_DATA),
                 fileSize(0),
                 recoveryConfidence(0.0),
                 status(RecoveryStatus::PENDING),
                 isEncrypted(false),
                 isCompressed(false),
-                hasPreview(false) {}
+                hasPreview(false),
+                checksum(allocator),
+                extents(allocator),
+                inlineData(allocator) {}
+
+            RecoverableFile(const RecoverableFile& other) = default;
+            RecoverableFile(RecoverableFile&& other) = default;
+            RecoverableFile& operator=(const RecoverableFile& other) = default;
+            RecoverableFile& operator=(RecoverableFile&& other) = default;
+
+            RecoverableFile(const RecoverableFile& other, const allocator_type& allocator) :
+                RecoverableFile(allocator) {
+                *this = other;
+            }
+
+            // Moves storage only when other already uses the same resource
+            RecoverableFile(RecoverableFile&& other, const allocator_type& allocator) :
+                RecoverableFile(allocator) {
+                *this = std::move(other);
+            }
+
+            allocator_type get_allocator() const { return fileName.get_allocator(); }
         };
         
         // Recovery session information
@@ -184,6 +225,7 @@ namespace Stellar {
             std::string GetFileSystemString(FileSystemType fs);
             bool IsValidRecoveryPath(const std::string& path);
             std::string GenerateSessionId();
+            std::string JsonString(const std::string& value);   // Quoted and escaped JSON string
         }
         
         // Forward declarations
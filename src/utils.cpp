@@ -8,12 +8,14 @@
  * @date 2024-09-27
  */
 
-#include \"stellar_recovery.h\"
+#include "stellar_recovery.h"
+#include <cstdio>
 #include <sstream>
 #include <iomanip>
 #include <random>
 #include <filesystem>
 #include <ctime>
+#include <mutex>
 
 namespace Stellar {
     namespace Recovery {
@@ -23,7 +25,7 @@ namespace Stellar {
              * Format file size in human-readable format
              */
             std::string FormatFileSize(uint64_t bytes) {
-                const char* units[] = {\"B\", \"KB\", \"MB\", \"GB\", \"TB\", \"PB\"};
+                const char* units[] = {"B", "KB", "MB", "GB", "TB", "PB"};
                 int unit = 0;
                 double size = static_cast<double>(bytes);
                 
@@ -34,9 +36,9 @@ namespace Stellar {
                 
                 std::ostringstream oss;
                 if (unit == 0) {
-                    oss << static_cast<uint64_t>(size) << \" \" << units[unit];
+                    oss << static_cast<uint64_t>(size) << " " << units[unit];
                 } else {
-                    oss << std::fixed << std::setprecision(2) << size << \" \" << units[unit];
+                    oss << std::fixed << std::setprecision(2) << size << " " << units[unit];
                 }
                 return oss.str();
             }
@@ -48,15 +50,15 @@ namespace Stellar {
                 auto seconds = duration.count();
                 
                 if (seconds < 60) {
-                    return std::to_string(static_cast<int>(seconds)) + \" seconds\";
+                    return std::to_string(static_cast<int>(seconds)) + " seconds";
                 } else if (seconds < 3600) {
                     int minutes = static_cast<int>(seconds / 60);
                     int remainingSeconds = static_cast<int>(seconds) % 60;
-                    return std::to_string(minutes) + \"m \" + std::to_string(remainingSeconds) + \"s\";
+                    return std::to_string(minutes) + "m " + std::to_string(remainingSeconds) + "s";
                 } else {
                     int hours = static_cast<int>(seconds / 3600);
                     int minutes = static_cast<int>((seconds - hours * 3600) / 60);
-                    return std::to_string(hours) + \"h \" + std::to_string(minutes) + \"m\";
+                    return std::to_string(hours) + "h " + std::to_string(minutes) + "m";
                 }
             }
             
@@ -65,16 +67,16 @@ namespace Stellar {
              */
             std::string GetFileTypeString(TargetFileType type) {
                 switch (type) {
-                    case TargetFileType::PHOTO: return \"Photos\";
-                    case TargetFileType::VIDEO: return \"Videos\";
-                    case TargetFileType::AUDIO: return \"Audio Files\";
-                    case TargetFileType::DOCUMENT: return \"Documents\";
-                    case TargetFileType::EMAIL: return \"Email Files\";
-                    case TargetFileType::ARCHIVE: return \"Archives\";
-                    case TargetFileType::EXECUTABLE: return \"Executables\";
-                    case TargetFileType::DATABASE: return \"Databases\";
-                    case TargetFileType::ALL_DATA: return \"All Data\";
-                    default: return \"Unknown\";
+                    case TargetFileType::PHOTO: return "Photos";
+                    case TargetFileType::VIDEO: return "Videos";
+                    case TargetFileType::AUDIO: return "Audio Files";
+                    case TargetFileType::DOCUMENT: return "Documents";
+                    case TargetFileType::EMAIL: return "Email Files";
+                    case TargetFileType::ARCHIVE: return "Archives";
+                    case TargetFileType::EXECUTABLE: return "Executables";
+                    case TargetFileType::DATABASE: return "Databases";
+                    case TargetFileType::ALL_DATA: return "All Data";
+                    default: return "Unknown";
                 }
             }
             
@@ -83,12 +85,12 @@ namespace Stellar {
              */
             std::string GetScanModeString(ScanMode mode) {
                 switch (mode) {
-                    case ScanMode::QUICK_SCAN: return \"Quick Scan\";
-                    case ScanMode::DEEP_SCAN: return \"Deep Scan\";
-                    case ScanMode::RAW_RECOVERY: return \"Raw Recovery\";
-                    case ScanMode::PARTITION_RECOVERY: return \"Partition Recovery\";
-                    case ScanMode::CUSTOM_SCAN: return \"Custom Scan\";
-                    default: return \"Unknown Mode\";
+                    case ScanMode::QUICK_SCAN: return "Quick Scan";
+                    case ScanMode::DEEP_SCAN: return "Deep Scan";
+                    case ScanMode::RAW_RECOVERY: return "Raw Recovery";
+                    case ScanMode::PARTITION_RECOVERY: return "Partition Recovery";
+                    case ScanMode::CUSTOM_SCAN: return "Custom Scan";
+                    default: return "Unknown Mode";
                 }
             }
             
@@ -97,17 +99,17 @@ namespace Stellar {
              */
             std::string GetDeviceTypeString(DeviceType type) {
                 switch (type) {
-                    case DeviceType::HDD: return \"Hard Disk Drive\";
-                    case DeviceType::SSD: return \"Solid State Drive\";
-                    case DeviceType::USB: return \"USB Drive\";
-                    case DeviceType::SD_CARD: return \"SD Card\";
-                    case DeviceType::CF_CARD: return \"CompactFlash Card\";
-                    case DeviceType::CD_DVD: return \"CD/DVD\";
-                    case DeviceType::RAID: return \"RAID Array\";
-                    case DeviceType::NETWORK: return \"Network Drive\";
-                    case DeviceType::VIRTUAL: return \"Virtual Drive\";
-                    case DeviceType::UNKNOWN: return \"Unknown Device\";
-                    default: return \"Unspecified\";
+                    case DeviceType::HDD: return "Hard Disk Drive";
+                    case DeviceType::SSD: return "Solid State Drive";
+                    case DeviceType::USB: return "USB Drive";
+                    case DeviceType::SD_CARD: return "SD Card";
+                    case DeviceType::CF_CARD: return "CompactFlash Card";
+                    case DeviceType::CD_DVD: return "CD/DVD";
+                    case DeviceType::RAID: return "RAID Array";
+                    case DeviceType::NETWORK: return "Network Drive";
+                    case DeviceType::VIRTUAL: return "Virtual Drive";
+                    case DeviceType::UNKNOWN: return "Unknown Device";
+                    default: return "Unspecified";
                 }
             }
             
@@ -116,22 +118,22 @@ namespace Stellar {
              */
             std::string GetFileSystemString(FileSystemType fs) {
                 switch (fs) {
-                    case FileSystemType::NTFS: return \"NTFS\";
-                    case FileSystemType::FAT16: return \"FAT16\";
-                    case FileSystemType::FAT32: return \"FAT32\";
-                    case FileSystemType::EXFAT: return \"exFAT\";
-                    case FileSystemType::REFS: return \"ReFS\";
-                    case FileSystemType::APFS: return \"APFS\";
-                    case FileSystemType::HFS_PLUS: return \"HFS+\";
-                    case FileSystemType::EXT2: return \"ext2\";
-                    case FileSystemType::EXT3: return \"ext3\";
-                    case FileSystemType::EXT4: return \"ext4\";
-                    case FileSystemType::XFS: return \"XFS\";
-                    case FileSystemType::BTRFS: return \"Btrfs\";
-                    case FileSystemType::UDF: return \"UDF\";
-                    case FileSystemType::ISO9660: return \"ISO 9660\";
-                    case FileSystemType::UNKNOWN: return \"Unknown\";
-                    default: return \"Unspecified\";
+                    case FileSystemType::NTFS: return "NTFS";
+                    case FileSystemType::FAT16: return "FAT16";
+                    case FileSystemType::FAT32: return "FAT32";
+                    case FileSystemType::EXFAT: return "exFAT";
+                    case FileSystemType::REFS: return "ReFS";
+                    case FileSystemType::APFS: return "APFS";
+                    case FileSystemType::HFS_PLUS: return "HFS+";
+                    case FileSystemType::EXT2: return "ext2";
+                    case FileSystemType::EXT3: return "ext3";
+                    case FileSystemType::EXT4: return "ext4";
+                    case FileSystemType::XFS: return "XFS";
+                    case FileSystemType::BTRFS: return "Btrfs";
+                    case FileSystemType::UDF: return "UDF";
+                    case FileSystemType::ISO9660: return "ISO 9660";
+                    case FileSystemType::UNKNOWN: return "Unknown";
+                    default: return "Unspecified";
                 }
             }
             
@@ -161,16 +163,50 @@ namespace Stellar {
              * Generate unique session ID
              */
             std::string GenerateSessionId() {
+                // Batch jobs start sessions from several threads, often in the same millisecond
+                static std::mutex mutex;
+                static std::string last;
+                static int repeat = 0;
+                std::lock_guard<std::mutex> lock(mutex);
+                
                 auto now = std::chrono::system_clock::now();
                 auto time_t = std::chrono::system_clock::to_time_t(now);
                 auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                     now.time_since_epoch()) % 1000;
                 
                 std::ostringstream oss;
-                oss << \"STELLAR_\" << std::put_time(std::localtime(&time_t), \"%Y%m%d_%H%M%S\") 
-                    << \"_\" << std::setfill('0') << std::setw(3) << ms.count();
+                oss << "STELLAR_" << std::put_time(std::localtime(&time_t), "%Y%m%d_%H%M%S") 
+                    << "_" << std::setfill('0') << std::setw(3) << ms.count();
                 
-                return oss.str();
+                std::string id = oss.str();
+                if (id == last) {
+                    return id + "_" + std::to_string(++repeat);
+                }
+                last = id;
+                repeat = 0;
+                return id;
+            }
+            
+            std::string JsonString(const std::string& value) {
+                std::string out = "\"";
+                for (unsigned char c : value) {
+                    switch (c) {
+                        case '"': out += "\\\""; break;
+                        case '\\': out += "\\\\"; break;
+                        case '\n': out += "\\n"; break;
+                        case '\r': out += "\\r"; break;
+                        case '\t': out += "\\t"; break;
+                        default:
+                            if (c < 0x20) {
+                                char escaped[8];
+                                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                                out += escaped;
+                            } else {
+                                out += static_cast<char>(c);
+                            }
+                    }
+                }
+                return out + "\"";
             }
             
         } // namespace Utils